@@ -285,6 +285,139 @@ class Parser:
 
 
 
+class ColumnParser:
+    """
+    loads a column file written by log_decoder so that large logs do not
+    have to be parsed by python, get_data returns the same dictionary as
+    Parser so the result can be passed to graph.DebugGraph
+
+    build log_decoder with
+        g++ -std=c++17 -O2 -pthread log_decoder.cpp -o log_decoder
+    then run ./log_decoder log.txt <output directory> and load the .col
+    file of the chassis source
+    """
+    def __init__(self):
+        self.__columns = {}
+        self.__rows = 0
+
+        self.__brakemode_names = {
+            0:"Coast",
+            1:"Brake",
+            2:"Hold",
+        }
+
+        self.__gearset_names = {
+            0:"36:1",
+            1:"18:1",
+            2:"6:1"
+        }
+
+
+    def parse_file(self, file):
+        """
+        reads the header and maps each column, the format is
+            "VCOL", uint32 rows, uint32 columns, column names ending in a
+            null byte, then each column as rows float64 values
+        """
+        import numpy as np
+
+        with open(file, "rb") as f:
+            header = f.read(12)
+            if header[:4] != b"VCOL":
+                raise ValueError(file + " is not a column file")
+            self.__rows = int.from_bytes(header[4:8], "little")
+            num_columns = int.from_bytes(header[8:12], "little")
+
+            names = []
+            name = b""
+            while len(names) < num_columns:
+                c = f.read(1)
+                if c == b"\0":
+                    names.append(name.decode())
+                    name = b""
+                else:
+                    name += c
+
+            values = np.fromfile(f, dtype="<f8", count=self.__rows * num_columns)
+
+        values = values.reshape(num_columns, self.__rows)
+        self.__columns = { names[i]:values[i] for i in range(num_columns) }
+
+
+    def __column(self, name):
+        """
+        returns a column as a list, columns that were never logged are empty
+        """
+        if name not in self.__columns:
+            return []
+        return self.__columns[name].tolist()
+
+
+    def __first(self, name, default=0):
+        """
+        returns the first value of a column that was logged
+        """
+        column = self.__columns.get(name)
+        if column is None:
+            return default
+        for value in column:
+            if not math.isnan(value):
+                return value
+        return default
+
+
+    def print_data(self):
+        """
+        prints the columns that were loaded
+
+        useful for debugging
+        """
+        print("\n", self.__rows, "data points")
+        for name in self.__columns:
+            print(name)
+
+
+    def get_data(self):
+        """
+        returns a dictionary of the data that was loaded in the same form
+        as Parser.get_data
+        """
+        data = {
+            "voltage":{
+                "back_right":self.__column("Actual_Vol4"),
+                "back_left":self.__column("Actual_Vol3"),
+                "front_right":self.__column("Actual_Vol2"),
+                "front_left":self.__column("Actual_Vol1")
+            },
+            "velocity":{
+                "back_right":self.__column("Actual_Vel4"),
+                "back_left":self.__column("Actual_Vel3"),
+                "front_right":self.__column("Actual_Vel2"),
+                "front_left":self.__column("Actual_Vel1")
+            },
+            "integral":self.__column("I"),
+            "vel_setpoint":self.__column("Vel_Sp"),
+            "heading_setpoint":self.__column("Heading_Sp"),
+            "heading_data":self.__column("Relative_Heading"),
+            "position_sp":self.__column("Position_Sp"),
+            "position_r":self.__column("position_r"),
+            "position_l":self.__column("position_l"),
+            "time":self.__column("Time"),
+            "brakemode":self.__brakemode_names.get(int(self.__first("Brake", -1)), "???"),
+            "gearset":self.__gearset_names.get(int(self.__first("Gear", -1)), "???"),
+            "slew_rate":int(self.__first("Slew")),
+            "correction":self.__column("Correction"),
+            "pid_constants":{
+                "kP":float(self.__first("kP")),
+                "kI":float(self.__first("kI")),
+                "kD":float(self.__first("kD")),
+                "I_max":float(self.__first("I_max"))
+            }
+        }
+
+        return data
+
+
 def gen_sample_data(num_data_pts=1000, setpoint=100, file="ut.txt"):
     """
     makes a random set of data that can be used for a unit test
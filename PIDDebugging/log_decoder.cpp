@@ -0,0 +1,552 @@
+/**
+ * @file: ./PIDDebugging/log_decoder.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * host tool that decodes robot logs into one column file per log source
+ * so that graph.py does not have to parse text line by line
+ *
+ * reads both the text logs from the serial terminal, lines like
+ *     12345 [INFO] CHASSIS_PID, Time: 31159, Actual_Vol1: 6911.000000, ...
+ * and the binary black box files written to the sd card by BlackBox.cpp
+ *
+ * build: g++ -std=c++17 -O2 -pthread log_decoder.cpp -o log_decoder
+ * usage: ./log_decoder <log file> <output directory> [--csv] [--threads n] [--bench]
+ *
+ * writes <source>.col (or <source>.csv with --csv) for every source and
+ * index.csv with the number of rows and the time range of each source
+ * a .col file is
+ *     "VCOL", uint32 rows, uint32 columns, then each column name ending in '\0',
+ *     then each column as rows float64 values, the first column is time
+ * missing values are NaN
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+
+
+// must match BlackBox.hpp
+#define BLACKBOX_BLOCK_SIZE 512
+#define BLACKBOX_PAYLOAD_SIZE (BLACKBOX_BLOCK_SIZE - 24)
+#define BLACKBOX_MAX_CHANNELS 16
+#define BLACKBOX_NAME_LENGTH 12
+#define BLACKBOX_HEADER_MAGIC 0x58424256
+#define BLACKBOX_DATA_MAGIC   0x54414442
+#define BLACKBOX_SCHEMA_MAGIC 0x48435342
+
+#define COLUMN_FILE_MAGIC "VCOL"
+
+
+typedef struct {
+    std::uint32_t magic;
+    std::uint32_t sequence;
+    std::uint32_t time;
+    std::uint16_t length;
+    std::uint16_t count;
+    std::uint32_t reserved;
+    std::uint8_t payload[BLACKBOX_PAYLOAD_SIZE];
+    std::uint32_t checksum;
+} blackbox_block;
+
+static_assert(sizeof(blackbox_block) == BLACKBOX_BLOCK_SIZE, "blackbox_block does not match BlackBox.hpp");
+
+
+
+/**
+ * rows for one log source, columns are added the first time a field is seen
+ * and earlier rows are filled with NaN
+ */
+struct source_table
+{
+    std::vector<std::string> names;  // names.at(0) is always "Time"
+    std::unordered_map<std::string, int> column_ids;
+    std::vector<std::vector<double>> columns;
+    int rows = 0;
+
+    source_table() {
+        add_column("Time");
+    }
+
+    int add_column(const std::string& name) {
+        auto found = column_ids.find(name);
+        if(found != column_ids.end()) {
+            return found->second;
+        }
+
+        column_ids.emplace(name, names.size());
+        names.push_back(name);
+        columns.emplace_back(rows, NAN);
+        return names.size() - 1;
+    }
+
+    void start_row(double time) {
+        for(std::vector<double>& column : columns) {
+            column.push_back(NAN);
+        }
+        columns.at(0).back() = time;
+        rows += 1;
+    }
+
+    void set(int column, double value) {
+        columns.at(column).back() = value;
+    }
+
+    /**
+     * adds the rows of other to the end of this table by column name
+     */
+    void append(const source_table& other) {
+        std::vector<int> mapping;
+        for(const std::string& name : other.names) {
+            mapping.push_back(add_column(name));
+        }
+
+        for(std::vector<double>& column : columns) {
+            column.resize(rows + other.rows, NAN);
+        }
+        for(int i = 0; i < other.names.size(); i++) {
+            std::copy(other.columns.at(i).begin(), other.columns.at(i).end(), columns.at(mapping.at(i)).begin() + rows);
+        }
+        rows += other.rows;
+    }
+};
+
+typedef std::vector<std::pair<std::string, source_table>> source_list;  // in order of first appearance
+
+
+
+/**
+ * gets the table for a source, a small cache of the last source is kept
+ * because logs usually repeat the same source many times in a row
+ */
+class SourceSet
+{
+    private:
+        std::unordered_map<std::string, int> ids;
+        std::string last_name;
+        int last_id = -1;
+
+    public:
+        source_list sources;
+
+        source_table& get(std::string_view name) {
+            if(last_id >= 0 && name == last_name) {
+                return sources.at(last_id).second;
+            }
+
+            std::string key(name);
+            auto found = ids.find(key);
+            if(found == ids.end()) {
+                found = ids.emplace(key, sources.size()).first;
+                sources.emplace_back(key, source_table());
+            }
+
+            last_name = key;
+            last_id = found->second;
+            return sources.at(last_id).second;
+        }
+};
+
+
+
+static std::string_view trim(std::string_view text) {
+    while(!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '\r')) {
+        text.remove_prefix(1);
+    }
+    while(!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+
+
+/**
+ * parses the number at the start of text, trailing text is ignored
+ * because some log lines are missing separators between fields
+ */
+static bool parse_number(std::string_view text, double& value) {
+    text = trim(text);
+    if(!text.empty() && text.front() == '+') {
+        text.remove_prefix(1);
+    }
+    std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr != text.data();
+}
+
+
+
+/**
+ * splits a line into the level prefix, the source, and "Key: value" fields
+ * the first token after the level that is not a number is the source
+ * lines without a level are skipped
+ */
+static void parse_line(std::string_view line, SourceSet& sources, std::vector<std::pair<std::string_view, double>>& fields) {
+    std::size_t level = line.find("[INFO]");
+    if(level == std::string_view::npos) {
+        level = line.find("[ERROR]");
+        if(level == std::string_view::npos) {
+            return;
+        }
+    }
+
+    double prefix_time = NAN;
+    parse_number(line.substr(0, level), prefix_time);  // the logger puts millis in front of the level
+
+    std::string_view rest = line.substr(line.find(']', level) + 1);
+    std::string_view source;
+    double time = prefix_time;
+    fields.clear();
+
+    while(!rest.empty()) {
+        std::size_t comma = rest.find(',');
+        std::string_view token = trim(rest.substr(0, comma));
+        rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+        if(token.empty()) {
+            continue;
+        }
+
+        std::size_t colon = token.find(':');
+        double value;
+        if(colon != std::string_view::npos) {
+            std::string_view key = trim(token.substr(0, colon));
+            if(parse_number(token.substr(colon + 1), value)) {
+                if(key == "Time") {
+                    time = value;
+                } else {
+                    fields.emplace_back(key, value);
+                }
+            }
+        } else if(source.empty() && !parse_number(token, value)) {
+            source = token;
+        }
+    }
+
+    if(source.empty()) {
+        source = "misc";
+    }
+
+    source_table& table = sources.get(source);
+    table.start_row(time);
+    for(const std::pair<std::string_view, double>& field : fields) {
+        auto found = table.column_ids.find(std::string(field.first));
+        int column = found != table.column_ids.end() ? found->second : table.add_column(std::string(field.first));
+        table.set(column, field.second);
+    }
+}
+
+
+
+static void parse_text_chunk(const char* begin, const char* end, SourceSet* sources) {
+    std::vector<std::pair<std::string_view, double>> fields;
+    const char* line = begin;
+    while(line < end) {
+        const char* newline = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if(newline == NULL) {
+            newline = end;
+        }
+        parse_line(std::string_view(line, newline - line), *sources, fields);
+        line = newline + 1;
+    }
+}
+
+
+
+/**
+ * splits the file at line breaks into one chunk per thread, each thread
+ * keeps its own tables and they are joined in file order at the end so
+ * rows stay in the order they were logged
+ */
+static source_list parse_text(const char* data, std::size_t size, int num_threads) {
+    std::vector<const char*> bounds = {data};
+    for(int i = 1; i < num_threads; i++) {
+        const char* split = std::max(data + (size * i) / num_threads, bounds.back());
+        const char* newline = static_cast<const char*>(std::memchr(split, '\n', data + size - split));
+        bounds.push_back(newline == NULL ? data + size : newline + 1);
+    }
+    bounds.push_back(data + size);
+
+    std::vector<SourceSet> results(num_threads);
+    std::vector<std::thread> threads;
+    for(int i = 0; i < num_threads; i++) {
+        threads.emplace_back(parse_text_chunk, bounds.at(i), bounds.at(i + 1), &results.at(i));
+    }
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+
+    SourceSet merged;
+    for(SourceSet& result : results) {
+        for(std::pair<std::string, source_table>& source : result.sources) {
+            merged.get(source.first).append(source.second);
+        }
+    }
+
+    return merged.sources;
+}
+
+
+
+static std::uint32_t crc32(const std::uint8_t* bytes, std::size_t length) {
+    static std::uint32_t table[256];
+    static bool table_built = false;
+    if(!table_built) {
+        for(std::uint32_t i = 0; i < 256; i++) {
+            std::uint32_t crc = i;
+            for(int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+            }
+            table[i] = crc;
+        }
+        table_built = true;
+    }
+
+    std::uint32_t crc = 0xFFFFFFFF;
+    for(std::size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+
+
+/**
+ * blocks with a bad checksum are skipped, they are the block that was being
+ * written when the robot lost power
+ * the file is small next to text logs so it is decoded on one thread
+ */
+static source_list parse_blackbox(const char* data, std::size_t size, int& bad_blocks) {
+    struct channel {
+        std::string name;
+        std::vector<std::string> fields;
+    };
+    std::vector<channel> channels(BLACKBOX_MAX_CHANNELS);
+    SourceSet sources;
+    bad_blocks = 0;
+
+    for(std::size_t offset = 0; offset + BLACKBOX_BLOCK_SIZE <= size; offset += BLACKBOX_BLOCK_SIZE) {
+        blackbox_block block;
+        std::memcpy(&block, data + offset, sizeof(blackbox_block));
+        if(crc32(reinterpret_cast<const std::uint8_t*>(&block), offsetof(blackbox_block, checksum)) != block.checksum || block.length > BLACKBOX_PAYLOAD_SIZE) {
+            bad_blocks += 1;
+            continue;
+        }
+
+        const std::uint8_t* payload = block.payload;
+        const std::uint8_t* payload_end = block.payload + block.length;
+        if(block.magic == BLACKBOX_SCHEMA_MAGIC) {
+            while(payload + 2 <= payload_end) {
+                int id = payload[0];
+                int num_fields = payload[1];
+                if(id >= BLACKBOX_MAX_CHANNELS || payload + 2 + BLACKBOX_NAME_LENGTH * (1 + num_fields) > payload_end) {
+                    break;
+                }
+                channel& current = channels.at(id);
+                current.name = std::string(reinterpret_cast<const char*>(payload + 2), strnlen(reinterpret_cast<const char*>(payload + 2), BLACKBOX_NAME_LENGTH));
+                current.fields.clear();
+                for(int i = 0; i < num_fields; i++) {
+                    const char* name = reinterpret_cast<const char*>(payload + 2 + BLACKBOX_NAME_LENGTH * (i + 1));
+                    current.fields.emplace_back(name, strnlen(name, BLACKBOX_NAME_LENGTH));
+                }
+                payload += 2 + BLACKBOX_NAME_LENGTH * (1 + num_fields);
+            }
+        } else if(block.magic == BLACKBOX_DATA_MAGIC) {
+            while(payload + 3 <= payload_end) {
+                int id = payload[0];
+                if(id >= BLACKBOX_MAX_CHANNELS || channels.at(id).name.empty()) {
+                    break;  // a schema block was lost so the rest of this block can not be read
+                }
+                const channel& current = channels.at(id);
+                if(payload + 3 + 4 * current.fields.size() > payload_end) {
+                    break;
+                }
+
+                std::uint16_t time_offset;
+                std::memcpy(&time_offset, payload + 1, 2);
+                source_table& table = sources.get(current.name);
+                table.start_row(block.time + time_offset);
+                for(int i = 0; i < current.fields.size(); i++) {
+                    float value;
+                    std::memcpy(&value, payload + 3 + 4 * i, 4);
+                    table.set(table.add_column(current.fields.at(i)), value);
+                }
+                payload += 3 + 4 * current.fields.size();
+            }
+        }
+    }
+
+    return sources.sources;
+}
+
+
+
+static std::string file_name(const std::string& source) {
+    std::string name;
+    for(char c : source) {
+        name.push_back(std::isalnum(static_cast<unsigned char>(c)) || c == '-' ? c : '_');
+    }
+    return name;
+}
+
+
+
+static bool write_columns(const std::string& path, const source_table& table) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if(file == NULL) {
+        return false;
+    }
+
+    std::uint32_t rows = table.rows;
+    std::uint32_t num_columns = table.names.size();
+    std::fwrite(COLUMN_FILE_MAGIC, 1, 4, file);
+    std::fwrite(&rows, 4, 1, file);
+    std::fwrite(&num_columns, 4, 1, file);
+    for(const std::string& name : table.names) {
+        std::fwrite(name.c_str(), 1, name.size() + 1, file);
+    }
+    for(const std::vector<double>& column : table.columns) {
+        std::fwrite(column.data(), sizeof(double), column.size(), file);
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+
+
+static bool write_csv(const std::string& path, const source_table& table) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if(file == NULL) {
+        return false;
+    }
+
+    for(int i = 0; i < table.names.size(); i++) {
+        std::fprintf(file, i == 0 ? "%s" : ",%s", table.names.at(i).c_str());
+    }
+    std::fprintf(file, "\n");
+
+    for(int row = 0; row < table.rows; row++) {
+        for(int i = 0; i < table.columns.size(); i++) {
+            double value = table.columns.at(i).at(row);
+            if(i > 0) {
+                std::fputc(',', file);
+            }
+            if(!std::isnan(value)) {
+                std::fprintf(file, "%.9g", value);
+            }
+        }
+        std::fputc('\n', file);
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        std::fprintf(stderr, "usage: %s <log file> <output directory> [--csv] [--threads n] [--bench]\n", argv[0]);
+        return 1;
+    }
+
+    std::string output_directory = argv[2];
+    bool csv = false;
+    bool bench = false;
+    int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    for(int i = 3; i < argc; i++) {
+        if(std::strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if(std::strcmp(argv[i], "--bench") == 0) {
+            bench = true;
+        } else if(std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            num_threads = std::max(1, std::atoi(argv[i + 1]));
+            i += 1;
+        }
+    }
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat file_stat;
+    if(fd < 0 || fstat(fd, &file_stat) != 0) {
+        std::fprintf(stderr, "could not open %s\n", argv[1]);
+        return 1;
+    }
+    std::size_t size = file_stat.st_size;
+    const char* data = size == 0 ? NULL : static_cast<const char*>(mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0));
+    if(size != 0 && data == MAP_FAILED) {
+        std::fprintf(stderr, "could not map %s\n", argv[1]);
+        return 1;
+    }
+    if(size != 0) {
+        madvise(const_cast<char*>(data), size, MADV_SEQUENTIAL);
+    }
+
+    std::uint32_t magic = 0;
+    if(size >= 4) {
+        std::memcpy(&magic, data, 4);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    source_list sources;
+    int bad_blocks = 0;
+    if(magic == BLACKBOX_HEADER_MAGIC) {
+        sources = parse_blackbox(data, size, bad_blocks);
+    } else {
+        sources = parse_text(data, size, num_threads);
+    }
+    double parse_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if(bench) {
+        long rows = 0;
+        for(const std::pair<std::string, source_table>& source : sources) {
+            rows += source.second.rows;
+        }
+        std::printf("%.1f MB in %.3f s with %d threads, %.1f MB/s, %ld rows\n", size / 1e6, parse_seconds, num_threads, size / 1e6 / parse_seconds, rows);
+        return 0;
+    }
+
+    std::FILE* index = std::fopen((output_directory + "/index.csv").c_str(), "w");
+    if(index == NULL) {
+        std::fprintf(stderr, "could not write to %s\n", output_directory.c_str());
+        return 1;
+    }
+    std::fprintf(index, "source,file,rows,columns,first_time,last_time\n");
+
+    for(const std::pair<std::string, source_table>& source : sources) {
+        const source_table& table = source.second;
+        std::string name = file_name(source.first) + (csv ? ".csv" : ".col");
+        bool written = csv ? write_csv(output_directory + "/" + name, table) : write_columns(output_directory + "/" + name, table);
+        if(!written) {
+            std::fprintf(stderr, "could not write %s\n", name.c_str());
+            continue;
+        }
+
+        const std::vector<double>& times = table.columns.at(0);
+        auto [first, last] = std::minmax_element(times.begin(), times.end());
+        std::fprintf(index, "\"%s\",%s,%d,%zu,%.0f,%.0f\n", source.first.c_str(), name.c_str(), table.rows, table.names.size(), times.empty() ? NAN : *first, times.empty() ? NAN : *last);
+    }
+    std::fclose(index);
+
+    if(bad_blocks > 0) {
+        std::fprintf(stderr, "%d blocks had bad checksums and were skipped\n", bad_blocks);
+    }
+    std::printf("decoded %zu sources in %.3f s\n", sources.size(), parse_seconds);
+    return 0;
+}
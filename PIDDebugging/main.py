@@ -17,7 +17,10 @@ import graph
 file = "./log.txt"
 
 # parser.gen_sample_data()    
-p = data_parser.Parser()
+if file.endswith(".col"):  # output of log_decoder
+    p = data_parser.ColumnParser()
+else:
+    p = data_parser.Parser()
 p.parse_file(file)
 p.print_data()
 g = graph.DebugGraph(
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Created on Mon Oct 19 09:12:41 2026
+
+@author: aiden
+
+converts config.json to the binary config.bin read by Configuration::init
+the layout has to match config_image in src/Configuration.hpp
+
+usage: python3 config_compiler.py [config.json] [config.bin]
+"""
+
+import json
+import struct
+import sys
+
+MAGIC = 0x47464356
+VERSION = 1
+NUM_MOTORS = 8
+MAX_SETPOINTS = 8
+
+# little endian, no padding, same order as config_image without the checksum
+LAYOUT = "<IHH4d4d4d8b8B4B8h8h8hi12s"
+SIZE = struct.calcsize(LAYOUT) + 4
+
+MOTORS = [
+    "front_right", "back_left", "front_left", "back_right",
+    "left_intake", "right_intake", "upper_indexer", "lower_indexer"
+]
+
+# same as the defaults in the Configuration constructor
+DEFAULTS = {
+    "internal_motor_pid": [30, 37, 11, 2**31 - 1],
+    "lift_pid": [.1, .0001, 0, 2**31 - 1],
+    "chassis_pid": [.0035, 0, 0, 2**31 - 1],
+    "front_right_port": 12, "back_left_port": 15, "front_left_port": 16, "back_right_port": 13,
+    "left_intake_port": 8, "right_intake_port": 7, "upper_indexer_port": 9, "lower_indexer_port": 17,
+    "front_right_reversed": 1, "back_left_reversed": 1, "front_left_reversed": 0, "back_right_reversed": 0,
+    "left_intake_reversed": 0, "right_intake_reversed": 1, "upper_indexer_reversed": 0, "lower_indexer_reversed": 0,
+    "lift_setpoints": [100, 300, 400, 500],
+    "tilter_setpoints": [100, 300, 400, 500],
+    "intake_speeds": [-63, -30, 0, 30, 63],
+    "filter_threshold": 2880,
+    "filter_color": "blue"
+}
+
+
+def padded(values):
+    values = list(values)[:MAX_SETPOINTS]
+    return values + [0] * (MAX_SETPOINTS - len(values))
+
+
+def compile_config(contents):
+    config = dict(DEFAULTS)
+    config.update(contents)
+
+    lists = [config["lift_setpoints"], config["tilter_setpoints"], config["intake_speeds"]]
+    body = struct.pack(
+        LAYOUT,
+        MAGIC, VERSION, SIZE,
+        *config["internal_motor_pid"][:4],
+        *config["lift_pid"][:4],
+        *config["chassis_pid"][:4],
+        *[config[motor + "_port"] for motor in MOTORS],
+        *[1 if config[motor + "_reversed"] == 1 else 0 for motor in MOTORS],
+        *[min(len(values), MAX_SETPOINTS) for values in lists], 0,
+        *padded(lists[0]), *padded(lists[1]), *padded(lists[2]),
+        config["filter_threshold"],
+        config["filter_color"].encode()[:11]
+    )
+
+    return body + struct.pack("<I", sum(body) & 0xFFFFFFFF)
+
+
+if __name__ == "__main__":
+    in_file = sys.argv[1] if len(sys.argv) > 1 else "config.json"
+    out_file = sys.argv[2] if len(sys.argv) > 2 else "config.bin"
+
+    with open(in_file) as f:
+        image = compile_config(json.load(f))
+
+    with open(out_file, "wb") as f:
+        f.write(image)
+
+    print("wrote", len(image), "bytes to", out_file)
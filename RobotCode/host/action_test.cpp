@@ -0,0 +1,221 @@
+/**
+ * @file: ./RobotCode/host/action_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * runs chassis actions on the chassis task against the simulated drivetrain
+ * and checks that a drive that loses a race or a turn that times out is
+ * cancelled, so the chassis stops right away instead of at the timeout of
+ * the command, that commands queued behind it are dropped, and that a
+ * command sent after a cancel still runs
+ * then measures how long stepping a combinator takes against handing off
+ * between two threads, which is what running each subsystem loop in its
+ * own task costs every tick
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "objects/actions/Action.hpp"
+#include "objects/actions/RobotActions.hpp"
+#include "objects/motors/Motor.hpp"
+#include "objects/sensors/Sensors.hpp"
+#include "objects/subsystems/chassis.hpp"
+#include "drivetrain_sim.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define PACE 50  // us of real time per simulated ms so run() and the chassis task keep up with each other
+#define LONG_DRIVE 6000  // encoder ticks, takes seconds so it is still running when it is cancelled
+#define RACE_TIME 300  // ms the wait the drive races against takes
+#define TURN_TIMEOUT 250  // ms the turn is given before it is stopped
+#define ALLOWED_DELAY 40  // ms past the cancel that the chassis can take to notice it
+#define STEPS 1000000  // combinator steps timed
+#define HANDOFFS 20000  // round trips between two threads timed
+
+
+void Indexer::increment() { }
+void Indexer::stop() { }
+void Intakes::intake() { }
+void Intakes::stop() { }
+
+
+namespace
+{
+    std::mutex handoff_lock;
+    std::condition_variable handoff;
+    int turn = 0;  // whose turn it is to run
+}
+
+
+
+/**
+ * @return: int -> the value after name in a log entry, -1 if it is not in the entry
+ */
+int log_field(const std::string& entry, const std::string& name)
+{
+    std::size_t start = entry.find(name + ": ");
+    if(start == std::string::npos) {
+        return -1;
+    }
+    return std::stoi(entry.substr(start + name.size() + 2));
+}
+
+
+
+/**
+ * @return: int -> ms the command that was running took according to the chassis
+ *
+ * waits for the chassis to log the end of the command and for the robot to stop
+ */
+int wait_for_stop()
+{
+    while(host::get_last_log().find("CHASSIS_COMMAND_DURATION") == std::string::npos) {
+        std::this_thread::yield();  // the chassis task moves the clock
+    }
+    int actual = log_field(host::get_last_log(), "Actual_Time");
+    while(host::get_drive_speed() > 0) {
+        host::advance_time(10);
+    }
+    return actual;
+}
+
+
+
+/**
+ * @return: double -> inches the robot is from where it started
+ */
+double distance_moved()
+{
+    position pose = host::get_pose();
+    return std::hypot(pose.x_pos, pose.y_pos);
+}
+
+
+
+/**
+ * @return: double -> ns for a round trip between two threads that take turns
+ */
+double time_handoffs()
+{
+    std::thread other([]() {
+        for(int i = 0; i < HANDOFFS; i++) {
+            std::unique_lock<std::mutex> guard(handoff_lock);
+            handoff.wait(guard, []() { return turn == 1; });
+            turn = 0;
+            handoff.notify_one();
+        }
+    });
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int i = 0; i < HANDOFFS; i++) {
+        std::unique_lock<std::mutex> guard(handoff_lock);
+        turn = 1;
+        handoff.notify_one();
+        handoff.wait(guard, []() { return turn == 0; });
+    }
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+    other.join();
+
+    return (double)elapsed.count() / HANDOFFS;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("actions\n");
+
+    host::run_tasks(true);
+    host::pace_time(PACE, true);
+    Motor front_left(1, pros::E_MOTOR_GEARSET_06, false);
+    Motor front_right(2, pros::E_MOTOR_GEARSET_06, true);
+    Motor back_left(3, pros::E_MOTOR_GEARSET_06, false);
+    Motor back_right(4, pros::E_MOTOR_GEARSET_06, true);
+    host::drivetrain_constants drive;
+    host::set_drivetrain(front_left, front_right, back_left, back_right, drive);
+    Chassis chassis(front_left, front_right, back_left, back_right, Sensors::left_encoder, Sensors::right_encoder, drive.width, 1, drive.wheel_diameter);
+    std::streambuf* console = std::cout.rdbuf(NULL);  // the drives print every loop
+
+    // a drive that loses a race is cancelled when the wait wins
+    auto lost = race(::drive(chassis, LONG_DRIVE), wait_for(RACE_TIME));
+    run(lost);
+    int raced = wait_for_stop();
+    double raced_distance = distance_moved();
+    std::cout.rdbuf(console);
+    std::printf("    drive that lost a %d ms race: winner %d, drove for %d ms, %.1f in\n", RACE_TIME, lost.get_winner(), raced, raced_distance);
+    if(lost.get_winner() != 1 || raced > RACE_TIME + ALLOWED_DELAY || raced_distance <= 0) {
+        std::printf("the drive was not stopped when it lost the race\n");
+        errors += 1;
+    }
+
+    // a turn that times out is cancelled along with the drives queued before and after it
+    std::cout.rdbuf(NULL);
+    host::set_pose({0, 0, 0});
+    int running = chassis.okapi_pid_straight_drive(LONG_DRIVE, 11000, INT32_MAX, true);
+    int queued = chassis.okapi_pid_straight_drive(LONG_DRIVE, 11000, INT32_MAX, true);
+    auto timed = with_timeout(turn_right(chassis, 720), TURN_TIMEOUT);
+    run(timed);
+    bool dropped = chassis.is_finished(queued);
+    int cut_off = wait_for_stop();
+    bool running_finished = chassis.is_finished(running);
+    double timed_distance = distance_moved();
+    host::advance_time(1000);  // the queued drive would have started by now
+    bool stayed = std::abs(distance_moved() - timed_distance) < 0.1;
+    std::cout.rdbuf(console);
+    std::printf(
+        "    turn that timed out after %d ms: timed out %d, running drive stopped after %d ms, queued drive dropped %d, robot stayed stopped %d\n",
+        TURN_TIMEOUT, timed.timed_out(), cut_off, dropped, stayed
+    );
+    if(!timed.timed_out() || cut_off > TURN_TIMEOUT + ALLOWED_DELAY || !dropped || !running_finished || !stayed) {
+        std::printf("the chassis kept running after the turn timed out\n");
+        errors += 1;
+    }
+
+    // the cancel is not left behind for the next command
+    std::cout.rdbuf(NULL);
+    host::set_pose({0, 0, 0});
+    auto won = race(::drive(chassis, 1500), wait_for(10000));
+    run(won);
+    double won_distance = distance_moved();
+    std::cout.rdbuf(console);
+    std::printf("    drive after a cancel: winner %d, %.1f in\n", won.get_winner(), won_distance);
+    if(won.get_winner() != 0 || won_distance < 10) {
+        std::printf("a drive sent after a cancel did not finish\n");
+        errors += 1;
+    }
+    host::stop_tasks();
+    host::pace_time(0);
+
+    // stepping a few combinators is the whole cost of switching between subsystems
+    std::atomic<int> ticks(0);  // so the steps are not folded into one add
+    auto step_only = all(
+        race(wait_until([]() { return false; }), every_tick([&ticks]() { ticks.fetch_add(1, std::memory_order_relaxed); }, []() {})),
+        sequence(wait_until([&ticks]() { return ticks < 0; }), wait_for(1))
+    );
+    step_only.start();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int i = 0; i < STEPS; i++) {
+        step_only.step();
+    }
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+    double step_time = (double)elapsed.count() / STEPS;
+    double handoff_time = time_handoffs();
+    std::printf("    combinator step: %.1f ns, thread round trip: %.1f ns\n", step_time, handoff_time);
+    if(ticks != STEPS || step_time > handoff_time) {
+        errors += 1;
+    }
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
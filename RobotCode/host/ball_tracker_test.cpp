@@ -0,0 +1,329 @@
+/**
+ * @file: ./RobotCode/host/ball_tracker_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * runs BallDetector classification and BallTracker on a simulated indexer
+ * processing a stream of balls, the wrong color is filtered out the back and
+ * the rest are scored one at a time like Indexer::eject_ball and
+ * Indexer::score_ball
+ * checks that every event matches what happened to the simulated ball and
+ * compares ending actions on events against the old fixed delays
+ * positions are from where the filter level sensor first sees a ball, the
+ * top sensor sees a ball until it leaves the top of the indexer
+ * roller speed is randomized per trial to mimic battery level and friction
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "objects/sensors/BallDetector.hpp"
+#include "objects/subsystems/BallTracker.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define TOP_TRAVEL 290    // deg of upper roller travel, same as the BallTracker defaults
+#define EJECT_TRAVEL 180
+#define SCORE_TRAVEL 120
+#define MIDDLE_WIDTH 80   // deg of travel the filter level sensor sees a ball for
+#define EJECT_MARGIN 15   // deg added to the eject travel given to the tracker, a transition can be seen up to half a sample from when it is expected
+
+#define FIXED_FILTER_TIME 225  // ms, old Indexer::auto_filter_ball delay
+#define FIXED_SCORE_TIME 700   // ms, delay Autons used after Indexer::index
+#define EJECT_TIMEOUT 400
+#define SCORE_TIMEOUT 1000
+#define FEED_TIMEOUT 1000
+
+#define TRIALS 300
+#define BALLS_PER_TRIAL 10
+
+
+typedef struct {
+    int color;        // 1 is blue, 2 is red
+    double position;  // deg of upper roller travel above where the filter level sensor first sees it
+    bool present;
+    bool ejecting;    // went down past the filter level onto the path out the back
+    bool scored;
+    bool ejected;
+    int exit_time;
+} simulated_ball;
+
+
+typedef struct {
+    int balls_filtered;
+    int balls_scored;
+    int balls_not_ejected;  // filter action ended with the ball still in the robot
+    int balls_not_scored;
+    int wrong_events;
+    int total_time;
+    std::vector<int> filter_times;
+    std::vector<int> event_latencies;  // ms from the ball leaving to the event, negative is early
+    ball_detector_latency detection;   // ms from the ball reaching the filter level to its color being known
+} trial_result;
+
+
+
+/**
+ * simulated indexer with the detector sampled every 10 ms and the tracker
+ * updated every 5 ms like the indexer task
+ */
+class SimulatedIndexer
+{
+    private:
+        std::mt19937& rng;
+        double speed;  // deg/s of both rollers at full voltage
+
+        BallDetector detector;
+        std::uint8_t detector_state;
+
+    public:
+        BallTracker tracker;
+        simulated_ball ball;
+        double upper_position;
+        int time;
+
+        SimulatedIndexer(std::mt19937& random, double roller_speed) :
+            rng(random), speed(roller_speed), detector(1, 2, 245), tracker(TOP_TRAVEL, EJECT_TRAVEL + EJECT_MARGIN, SCORE_TRAVEL)
+        {
+            detector_state = 0;
+            upper_position = 0;
+            time = 0;
+            ball.present = false;
+            tracker.update(false, false, 0, upper_position, time);
+        }
+
+        ball_detector_sample read_sensors()
+        {
+            std::normal_distribution<double> noise(0, 6);
+            ball_detector_sample sample = {time, 60, 200, 90};
+            if(ball.present && !ball.ejecting && ball.position >= 0 && ball.position < MIDDLE_WIDTH) {
+                sample.proximity = 255;
+                double hue = (ball.color == 1 ? 215 : 8) + noise(rng);
+                if(ball.position < 10 || ball.position > MIDDLE_WIDTH - 10) {  // edge of the ball, the sensor sees the indexer
+                    hue = 90 + noise(rng);
+                }
+                sample.hue = static_cast<int>(hue + 360) % 360;
+            }
+            if(ball.present && ball.position >= TOP_TRAVEL) {
+                sample.distance = 30;
+            }
+            return sample;
+        }
+
+        /**
+         * @param: int upper -> -1, 0, or 1 for the direction of the upper roller
+         * @param: int lower -> -1, 0, or 1 for the direction of the lower roller
+         */
+        void step(int upper, int lower)
+        {
+            time += 5;
+            host::set_time(time);
+            double travel = upper * speed * 5 / 1000;
+            upper_position += travel;
+
+            if(ball.present) {
+                if(ball.position < 0 && !ball.ejecting) {  // below the filter level, only the lower roller reaches it
+                    ball.position += lower * speed * 5 / 1000;
+                } else {
+                    ball.position += travel;
+                }
+                if(ball.position < 0 && travel < 0) {
+                    ball.ejecting = true;
+                }
+                if(ball.position >= TOP_TRAVEL + SCORE_TRAVEL) {
+                    ball.present = false;
+                    ball.scored = true;
+                    ball.exit_time = time;
+                } else if(ball.position <= -EJECT_TRAVEL) {
+                    ball.present = false;
+                    ball.ejected = true;
+                    ball.exit_time = time;
+                }
+            }
+
+            if(time % 10 == 0) {
+                detector_state = detector.process_sample(read_sensors());
+            }
+            tracker.update(
+                detector_state & BALL_TOP,
+                detector_state & BALL_MIDDLE,
+                BallDetector::state_color(detector_state),
+                upper_position,
+                time
+            );
+        }
+
+        std::uint8_t get_state()
+        {
+            return detector_state;
+        }
+
+        ball_detector_latency get_detection_latency()
+        {
+            return detector.get_detection_latency();
+        }
+
+        void add_ball(int color)
+        {
+            ball = {color, -60, true, false, false, false, 0};
+        }
+};
+
+
+
+/**
+ * @return: bool -> if the events since start_time are the ball entering and leaving the way it did
+ */
+bool check_events(SimulatedIndexer& indexer, int start_time, trial_result& result)
+{
+    std::vector<ball_event> events = indexer.tracker.get_events(start_time);
+    ball_event_type exit_type = indexer.ball.scored ? e_ball_scored : e_ball_ejected;
+    int entered = 0;
+    int exited = 0;
+    bool correct = true;
+    for(ball_event event : events) {
+        if(event.type == e_ball_entered) {
+            entered += 1;
+        } else if(event.type == exit_type) {
+            exited += 1;
+            correct = correct && event.color == indexer.ball.color;
+            if(indexer.ball.exit_time != 0) {
+                result.event_latencies.push_back(event.time - indexer.ball.exit_time);
+            }
+        } else if(event.type != e_ball_at_top) {
+            correct = false;
+        }
+    }
+
+    return correct && entered == 1 && exited == (indexer.ball.present ? 0 : 1);
+}
+
+
+
+trial_result run_trial(int seed, bool event_driven, int filter_color)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    double roller_speed = 700 + (600 * uniform(rng));  // deg/s
+    SimulatedIndexer indexer(rng, roller_speed);
+    trial_result result = {0, 0, 0, 0, 0, 0, {}, {}, {0, 0, 0, 0}};
+
+    for(int i = 0; i < BALLS_PER_TRIAL; i++) {
+        int color = uniform(rng) < .3 ? filter_color : 3 - filter_color;
+        int start_time = indexer.time;
+        indexer.add_ball(color);
+
+        // bring the ball up to the filter level until it is classified
+        int start = indexer.time;
+        while(BallDetector::state_color(indexer.get_state()) <= 0 && indexer.time - start < FEED_TIMEOUT) {
+            indexer.step(1, 1);
+        }
+
+        start = indexer.time;
+        if(BallDetector::state_color(indexer.get_state()) == filter_color) {
+            int ejected = indexer.tracker.get_event_count(e_ball_ejected);
+            while(indexer.time - start < (event_driven ? EJECT_TIMEOUT : FIXED_FILTER_TIME)) {
+                if(event_driven && indexer.tracker.get_event_count(e_ball_ejected) != ejected) {
+                    break;
+                }
+                indexer.step(-1, 1);
+            }
+            result.balls_filtered += 1;
+            result.filter_times.push_back(indexer.time - start);
+            result.balls_not_ejected += indexer.ball.ejected ? 0 : 1;
+        } else {
+            int scored = indexer.tracker.get_event_count(e_ball_scored);
+            while(indexer.time - start < (event_driven ? SCORE_TIMEOUT : FIXED_SCORE_TIME)) {
+                if(event_driven && indexer.tracker.get_event_count(e_ball_scored) != scored) {
+                    break;
+                }
+                indexer.step(1, 0);
+            }
+            result.balls_scored += indexer.ball.scored ? 1 : 0;
+            result.balls_not_scored += indexer.ball.scored ? 0 : 1;
+        }
+
+        // a ball left behind is cleared by hand so the next one starts empty
+        if(!check_events(indexer, start_time, result)) {
+            result.wrong_events += 1;
+        }
+        if(indexer.ball.present) {
+            indexer.ball.present = false;
+            indexer.tracker.reset(indexer.upper_position);
+        }
+        for(int settle = 0; settle < 4; settle++) {  // sensors see the indexer is empty
+            indexer.step(0, 0);
+        }
+    }
+    result.total_time = indexer.time;
+    result.detection = indexer.get_detection_latency();
+
+    return result;
+}
+
+
+
+int percentile(std::vector<int> values, double fraction)
+{
+    if(values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values.at(std::min<int>(values.size() - 1, fraction * values.size()));
+}
+
+
+
+int main()
+{
+    int failures = 0;
+
+    for(int event_driven = 0; event_driven < 2; event_driven++) {
+        trial_result total = {0, 0, 0, 0, 0, 0, {}, {}, {0, 0, 0, 0}};
+        double min_throughput = 1e9;
+        for(int trial = 0; trial < TRIALS; trial++) {
+            trial_result result = run_trial(trial, event_driven, trial % 2 ? 1 : 2);
+            min_throughput = std::min(min_throughput, 1000.0 * result.balls_scored / result.total_time);
+            total.balls_filtered += result.balls_filtered;
+            total.balls_scored += result.balls_scored;
+            total.balls_not_ejected += result.balls_not_ejected;
+            total.balls_not_scored += result.balls_not_scored;
+            total.wrong_events += result.wrong_events;
+            total.total_time += result.total_time;
+            total.detection.count += result.detection.count;
+            total.detection.total += result.detection.total;
+            total.detection.max = std::max(total.detection.max, result.detection.max);
+            total.filter_times.insert(total.filter_times.end(), result.filter_times.begin(), result.filter_times.end());
+            total.event_latencies.insert(total.event_latencies.end(), result.event_latencies.begin(), result.event_latencies.end());
+        }
+
+        std::printf("%s\n", event_driven ? "event driven" : "fixed delay");
+        std::printf("    balls scored per second: mean %.2f  min %.2f\n", 1000.0 * total.balls_scored / total.total_time, min_throughput);
+        std::printf(
+            "    filter time (ms): p50 %d  p90 %d  max %d\n",
+            percentile(total.filter_times, .5), percentile(total.filter_times, .9), percentile(total.filter_times, 1)
+        );
+        std::printf(
+            "    color detection latency (ms): mean %.1f  max %d\n",
+            static_cast<double>(total.detection.total) / std::max(total.detection.count, 1), total.detection.max
+        );
+        std::printf("    balls not ejected: %d  balls not scored: %d\n", total.balls_not_ejected, total.balls_not_scored);
+        std::printf(
+            "    event latency (ms): min %d  p50 %d  max %d, events not matching the ball: %d\n",
+            percentile(total.event_latencies, 0), percentile(total.event_latencies, .5),
+            percentile(total.event_latencies, 1), total.wrong_events
+        );
+
+        if(event_driven && (total.balls_not_ejected || total.balls_not_scored || total.wrong_events)) {
+            failures += 1;
+        }
+    }
+
+    std::printf("%s\n", failures ? "FAILED" : "passed");
+    return failures;
+}
@@ -0,0 +1,277 @@
+/**
+ * @file: ./RobotCode/host/battery_compensator_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * checks the battery voltage filter, the limits on the scale, and the
+ * headroom and saturation BatteryCompensator reports
+ * then drives the same legs with a pd controller on a simulated drive at
+ * several battery voltages with and without compensation and prints how
+ * long the path takes at each
+ * the drive is current limited per side and the battery has internal
+ * resistance, so it sags when the drive accelerates like a real one does
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "objects/motors/BatteryCompensator.hpp"
+
+
+
+#define CONTROL_PERIOD 5  // ms, the same as the motor thread
+#define PHYSICS_STEP 0.001  // s
+#define INTERNAL_RESISTANCE 0.15  // ohms of the battery
+#define MOTOR_RESISTANCE 1.2  // ohms of the two motors on one side together
+#define CURRENT_LIMIT 5  // A per side
+#define FREE_SPEED 60  // in/s at 12 V with no load
+#define ACCELERATION_PER_AMP 40  // in/s^2
+#define DRAG 2  // in/s^2 per in/s
+#define MAX_COMMAND 11000  // mv, what routines cap their drives at
+#define KP 600  // mv per in
+#define KD 40  // mv per in/s
+#define LEG_TIMEOUT 5  // s
+#define ALLOWED_SPREAD 0.01  // of the mean path time with compensation
+
+
+typedef struct {
+    double position = 0;  // in
+    double velocity = 0;  // in/s
+    double current = 0;  // A of both sides
+} drive_state;
+
+
+
+/**
+ * @return: int -> the number of checks that failed
+ */
+int check_filter()
+{
+    int errors = 0;
+    BatteryCompensator compensator;
+    battery_compensation_constants constants;
+    compensator.configure(constants);
+
+    compensator.update(12000, CONTROL_PERIOD);  // the first reading is used as is
+    compensator.update(0, CONTROL_PERIOD);  // a missing reading is ignored
+    if(compensator.get_stats().battery_voltage != 12000) {
+        std::printf("first reading was not used as is or a reading of 0 was not ignored\n");
+        errors += 1;
+    }
+
+    // a step of 1000 mv has moved 1 - e^-1 of the way after one time constant
+    for(int t = 0; t < constants.time_constant; t += CONTROL_PERIOD) {
+        compensator.update(13000, CONTROL_PERIOD);
+    }
+    double alpha = static_cast<double>(CONTROL_PERIOD) / (constants.time_constant + CONTROL_PERIOD);
+    double expected = 13000 - (1000 * std::pow(1 - alpha, constants.time_constant / CONTROL_PERIOD));
+    double filtered = compensator.get_stats().battery_voltage;
+    std::printf("    filter: %.0f mv one time constant after a 1000 mv step, expected %.0f mv\n", filtered, expected);
+    if(std::abs(filtered - expected) > 1 || std::abs(filtered - (13000 - (1000 * std::exp(-1)))) > 50) {
+        errors += 1;
+    }
+
+    return errors;
+}
+
+
+
+/**
+ * @return: int -> the number of checks that failed
+ */
+int check_scale()
+{
+    int errors = 0;
+    battery_compensation_constants constants;
+    for(int battery : {6000, 10000, 12000, 13000, 20000}) {
+        BatteryCompensator compensator;
+        compensator.configure(constants);
+        compensator.update(battery, CONTROL_PERIOD);
+        double disabled_scale = compensator.get_stats().scale;
+        compensator.enable();
+        compensator.update(battery, CONTROL_PERIOD);
+        double scale = compensator.get_stats().scale;
+
+        double expected = std::max(constants.min_scale, std::min(constants.max_scale, constants.nominal_voltage / static_cast<double>(battery)));
+        if(disabled_scale != 1 || std::abs(scale - expected) > 1e-9 || scale < constants.min_scale || scale > constants.max_scale) {
+            std::printf("battery at %d mv gave a scale of %.3f, expected %.3f, and %.3f disabled\n", battery, scale, expected, disabled_scale);
+            errors += 1;
+        }
+    }
+    std::printf("    scale: clamped to [%.2f, %.2f] and 1 while disabled\n", constants.min_scale, constants.max_scale);
+
+    return errors;
+}
+
+
+
+/**
+ * @return: int -> the number of checks that failed
+ */
+int check_headroom()
+{
+    int errors = 0;
+    BatteryCompensator compensator;
+    compensator.configure(battery_compensation_constants());
+    compensator.enable();
+    compensator.update(10000, CONTROL_PERIOD);  // scale of 1.2
+
+    // two commands are cut off, the largest one by 1200 mv
+    int forward = compensator.compensate(11000);
+    int backward = compensator.compensate(-11000);
+    int small = compensator.compensate(5000);
+    compensator.update(10000, CONTROL_PERIOD);
+    battery_compensation_stats saturated = compensator.get_stats();
+    if(forward != MOTOR_MAX_VOLTAGE || backward != -MOTOR_MAX_VOLTAGE || small != 6000) {
+        std::printf("commands were scaled to %d, %d, %d\n", forward, backward, small);
+        errors += 1;
+    }
+    if(saturated.headroom != -1200 || saturated.saturated_motors != 2 || saturated.saturated_cycles != 1 || saturated.min_headroom != -1200) {
+        std::printf("a saturated cycle reported %d mv of headroom with %d motors cut off\n", saturated.headroom, saturated.saturated_motors);
+        errors += 1;
+    }
+
+    // a cycle that fits keeps the worst headroom until the stats are reset
+    compensator.compensate(5000);
+    compensator.update(10000, CONTROL_PERIOD);
+    battery_compensation_stats fits = compensator.get_stats();
+    compensator.reset_stats();
+    battery_compensation_stats reset = compensator.get_stats();
+    if(fits.headroom != 6000 || fits.saturated_motors != 0 || fits.saturated_cycles != 1 || fits.min_headroom != -1200) {
+        std::printf("a cycle that fit reported %d mv of headroom, %d mv at the least\n", fits.headroom, fits.min_headroom);
+        errors += 1;
+    }
+    if(reset.min_headroom != MOTOR_MAX_VOLTAGE || reset.saturated_cycles != 0) {
+        std::printf("stats were not reset\n");
+        errors += 1;
+    }
+    std::printf("    headroom: %d mv when saturated, %d mv after, %d mv at the least\n", saturated.headroom, fits.headroom, fits.min_headroom);
+
+    return errors;
+}
+
+
+
+/**
+ * @return: double -> the terminal voltage of the battery in V after moving the drive one step
+ *
+ * the command is a fraction of the battery voltage at the motor, current is
+ * what the motors draw against their back emf, limited per side
+ */
+double step_drive(drive_state& drive, int command, double open_circuit_voltage)
+{
+    double battery = open_circuit_voltage - (INTERNAL_RESISTANCE * std::abs(drive.current));
+    double applied = battery * command / 12000.0;
+    double back_emf = 12.0 * drive.velocity / FREE_SPEED;
+    double side_current = std::max(-1.0 * CURRENT_LIMIT, std::min(1.0 * CURRENT_LIMIT, (applied - back_emf) / MOTOR_RESISTANCE));
+
+    drive.velocity += ((ACCELERATION_PER_AMP * side_current) - (DRAG * drive.velocity)) * PHYSICS_STEP;
+    drive.position += drive.velocity * PHYSICS_STEP;
+    drive.current = 2 * side_current;
+
+    return battery;
+}
+
+
+
+/**
+ * @return: double -> s to drive every leg with a pd controller capped at MAX_COMMAND
+ */
+double drive_path(double open_circuit_voltage, bool compensate, int& min_headroom)
+{
+    const std::vector<double> legs = {24, 48, -24, 36, -48, 12, 60, -36, 24, -12, 48, -72};
+    BatteryCompensator compensator;
+    compensator.configure(battery_compensation_constants());
+    if(compensate) {
+        compensator.enable();
+    }
+
+    drive_state drive;
+    double battery = open_circuit_voltage;
+    double time = 0;
+    double setpoint = 0;
+    for(double leg : legs) {
+        setpoint += leg;
+        double start = time;
+        int command = 0;
+        int step = 0;
+        while(time - start < LEG_TIMEOUT) {
+            if(step % CONTROL_PERIOD == 0) {
+                double error = setpoint - drive.position;
+                if(std::abs(error) < 0.5 && std::abs(drive.velocity) < 1) {
+                    break;
+                }
+                compensator.update(battery * 1000, CONTROL_PERIOD);
+                int pd = static_cast<int>((KP * error) - (KD * drive.velocity));
+                command = compensator.compensate(std::max(-MAX_COMMAND, std::min(MAX_COMMAND, pd)));
+            }
+            battery = step_drive(drive, command, open_circuit_voltage);
+            time += PHYSICS_STEP;
+            step += 1;
+        }
+    }
+
+    compensator.update(battery * 1000, CONTROL_PERIOD);
+    min_headroom = compensator.get_stats().min_headroom;
+    return time;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("battery compensation\n");
+
+    errors += check_filter();
+    errors += check_scale();
+    errors += check_headroom();
+
+    const std::vector<double> batteries = {12.0, 12.2, 12.6, 13.0, 13.4};
+    std::printf("    open circuit     ");
+    for(double battery : batteries) {
+        std::printf("%8.1f", battery);
+    }
+    std::printf(" V\n");
+
+    double spreads[2];
+    for(bool compensate : {false, true}) {
+        std::vector<double> times;
+        std::vector<int> headrooms;
+        for(double battery : batteries) {
+            int min_headroom;
+            times.push_back(drive_path(battery, compensate, min_headroom));
+            headrooms.push_back(min_headroom);
+        }
+
+        double mean = 0;
+        for(double time : times) {
+            mean += time / times.size();
+        }
+        auto limits = std::minmax_element(times.begin(), times.end());
+        spreads[compensate] = (*limits.second - *limits.first) / mean;
+
+        std::printf("    %-16s ", compensate ? "compensated" : "uncompensated");
+        for(double time : times) {
+            std::printf("%8.3f", time);
+        }
+        std::printf(" s, spread %.1f%%\n", 100 * spreads[compensate]);
+        if(compensate) {
+            std::printf("    min headroom     ");
+            for(int headroom : headrooms) {
+                std::printf("%8d", headroom);
+            }
+            std::printf(" mv\n");
+        }
+    }
+    if(spreads[1] > ALLOWED_SPREAD || spreads[1] >= spreads[0]) {
+        std::printf("path times with compensation vary by %.1f%% across batteries\n", 100 * spreads[1]);
+        errors += 1;
+    }
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
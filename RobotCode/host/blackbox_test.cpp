@@ -0,0 +1,169 @@
+/**
+ * @file: ./RobotCode/host/blackbox_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * records with the black box writer running on a thread, then reads the
+ * file back and checks every block, every record, and the chain of index
+ * blocks
+ * also starts and stops enough recordings to go around the ring of
+ * numbered files
+ * files are written to bin/ instead of the sd card
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "objects/serial/BlackBox.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define RECORDS 10000  // enough blocks for a few index blocks
+
+
+std::vector<blackbox_block> read_blocks(const char* name)
+{
+    std::vector<blackbox_block> blocks;
+    std::FILE* file = std::fopen(name, "rb");
+    if(file == NULL) {
+        return blocks;
+    }
+    blackbox_block block;
+    while(std::fread(&block, 1, sizeof(block), file) == sizeof(block)) {
+        blocks.push_back(block);
+    }
+    std::fclose(file);
+    return blocks;
+}
+
+
+
+long file_size(const char* name)
+{
+    std::FILE* file = std::fopen(name, "rb");
+    if(file == NULL) {
+        return -1;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+    return size;
+}
+
+
+
+/**
+ * @return: int -> the number of problems found in the file
+ */
+int check_file(const char* name, int expected_records)
+{
+    std::vector<blackbox_block> blocks = read_blocks(name);
+    int errors = 0;
+    int records = 0;
+    for(int i = 0; i < blocks.size(); i++) {
+        if(BlackBox::compute_checksum(blocks.at(i)) != blocks.at(i).checksum || blocks.at(i).sequence != i) {
+            std::printf("block %d is corrupt or out of order\n", i);
+            errors += 1;
+        }
+        if(blocks.at(i).magic == BLACKBOX_DATA_MAGIC) {
+            records += blocks.at(i).count;
+        }
+    }
+    if(records != expected_records) {
+        std::printf("%d records in the file, %d were logged\n", records, expected_records);
+        errors += 1;
+    }
+    if(blocks.empty() || blocks.back().magic != BLACKBOX_END_MAGIC) {
+        std::printf("file does not end with an end block\n");
+        return errors + 1;
+    }
+
+    // walk the index from the end, every block but index and end blocks is covered once
+    std::vector<int> covered(blocks.size(), 0);
+    std::uint32_t index_block;
+    std::uint32_t num_index_blocks;
+    std::memcpy(&index_block, blocks.back().payload, 4);
+    std::memcpy(&num_index_blocks, blocks.back().payload + 4, 4);
+    int walked = 0;
+    while(index_block != BLACKBOX_NO_BLOCK && index_block < blocks.size() && walked <= num_index_blocks) {
+        const blackbox_block& index = blocks.at(index_block);
+        std::uint32_t first;
+        std::memcpy(&first, index.payload, 4);
+        for(int i = 0; i < index.count; i++) {
+            std::uint32_t time;
+            std::memcpy(&time, index.payload + 4 + 4 * i, 4);
+            if(first + i >= blocks.size() || blocks.at(first + i).time != time) {
+                errors += 1;
+            } else {
+                covered.at(first + i) += 1;
+            }
+        }
+        index_block = index.previous_index;
+        walked += 1;
+    }
+    if(walked != num_index_blocks) {
+        std::printf("walked %d index blocks, the end block says %d\n", walked, num_index_blocks);
+        errors += 1;
+    }
+    for(int i = 0; i < blocks.size(); i++) {
+        bool indexed = blocks.at(i).magic != BLACKBOX_INDEX_MAGIC && blocks.at(i).magic != BLACKBOX_END_MAGIC;
+        if(covered.at(i) != (indexed ? 1 : 0)) {
+            std::printf("block %d is in the index %d times\n", i, covered.at(i));
+            errors += 1;
+        }
+    }
+
+    std::printf("    %s: %d blocks, %d records, %d index blocks\n", name, (int)blocks.size(), records, walked);
+    return errors;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    char name[BLACKBOX_FILENAME_LENGTH];
+    for(int i = 0; i < BLACKBOX_MAX_FILES; i++) {
+        std::snprintf(name, sizeof(name), BLACKBOX_FILE_FORMAT, i);
+        std::remove(name);
+    }
+
+    host::run_tasks(true);
+    int channel = BlackBox::add_channel("position", {"x", "y", "theta"});
+
+    std::printf("black box\n");
+    BlackBox::start();
+    for(int i = 0; i < RECORDS; i++) {
+        while(!BlackBox::log(channel, {1.0f * i, 2, 3})) {  // dropped when every block is waiting to be written
+            std::this_thread::yield();
+        }
+    }
+    BlackBox::stop();
+    errors += check_file(BlackBox::get_filename(), RECORDS);
+
+    // go around the ring, the file after the newest is always the empty one
+    for(int i = 1; i < BLACKBOX_MAX_FILES + 5; i++) {
+        BlackBox::start();
+        BlackBox::log(channel, {1, 2, 3});
+        BlackBox::stop();
+
+        std::snprintf(name, sizeof(name), BLACKBOX_FILE_FORMAT, i % BLACKBOX_MAX_FILES);
+        std::string expected = name;
+        std::snprintf(name, sizeof(name), BLACKBOX_FILE_FORMAT, (i + 1) % BLACKBOX_MAX_FILES);
+        if(expected != BlackBox::get_filename() || file_size(name) > 0) {
+            std::printf("recording %d went to %s\n", i, BlackBox::get_filename());
+            errors += 1;
+        }
+    }
+    errors += check_file(BlackBox::get_filename(), 1);
+    host::stop_tasks();
+
+    std::printf("    problems found: %d\n", errors);
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
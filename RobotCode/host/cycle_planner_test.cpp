@@ -0,0 +1,239 @@
+/**
+ * @file: ./RobotCode/host/cycle_planner_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * checks CyclePlanner against a breadth first search over every indexer,
+ * tower, and goal arrangement and times queries
+ * the search works on lists of colors instead of the encoded stacks so that
+ * it does not share any code with the planner
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "objects/subsystems/CyclePlanner.hpp"
+
+
+
+#define BENCHMARK_ROUNDS 200
+
+
+typedef std::vector<ball_color> stack;  // colors from top to bottom
+typedef std::pair<stack, stack> cycle_state;  // indexer then tower
+
+
+
+/**
+ * @return: bool -> false if the action is not possible, state is unchanged
+ *
+ * same rules as the robot, balls enter the tower at the top and leave it at
+ * the bottom, the filter level is the second ball in the indexer
+ */
+bool apply(cycle_action action, cycle_state& state)
+{
+    stack& indexer = state.first;
+    stack& tower = state.second;
+    switch(action) {
+        case e_cycle_score: {
+            if(indexer.empty() || tower.size() == CYCLE_STACK_SIZE) {
+                return false;
+            }
+            tower.insert(tower.begin(), indexer.front());
+            indexer.erase(indexer.begin());
+            return true;
+        } case e_cycle_descore: {
+            if(tower.empty() || indexer.size() >= CYCLE_STACK_SIZE - 1) {  // has to reach the filter level to be seen
+                return false;
+            }
+            indexer.push_back(tower.back());
+            tower.pop_back();
+            return true;
+        } case e_cycle_filter: {
+            if(indexer.empty()) {
+                return false;
+            }
+            indexer.erase(indexer.begin() + (indexer.size() > 1 ? 1 : 0));
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+/**
+ * @return: int -> fewest actions to reach the goal tower, -1 if it can not be reached
+ */
+int search(const cycle_state& start, const stack& goal)
+{
+    std::map<cycle_state, int> distance;
+    std::deque<cycle_state> queue;
+    distance[start] = 0;
+    queue.push_back(start);
+    while(!queue.empty()) {
+        cycle_state state = queue.front();
+        queue.pop_front();
+        if(state.second == goal) {
+            return distance[state];
+        }
+        for(int action = e_cycle_score; action <= e_cycle_filter; action++) {
+            cycle_state next = state;
+            if(apply(static_cast<cycle_action>(action), next) && distance.count(next) == 0) {
+                distance[next] = distance[state] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+
+    return -1;
+}
+
+
+
+std::uint8_t encode(const stack& balls)
+{
+    std::array<ball_color, CYCLE_STACK_SIZE> colors;
+    colors.fill(e_no_ball);
+    std::copy(balls.begin(), balls.end(), colors.begin());
+    return CyclePlanner::encode_stack(colors);
+}
+
+
+
+std::vector<stack> all_stacks()
+{
+    std::vector<stack> stacks;
+    for(int length = 0; length <= CYCLE_STACK_SIZE; length++) {
+        for(int bits = 0; bits < (1 << length); bits++) {
+            stack balls;
+            for(int i = 0; i < length; i++) {
+                balls.push_back(((bits >> i) & 1) ? e_red_ball : e_blue_ball);
+            }
+            stacks.push_back(balls);
+        }
+    }
+    return stacks;
+}
+
+
+
+int main()
+{
+    std::vector<stack> stacks = all_stacks();
+    int checked = 0;
+    int wrong = 0;
+    int unreachable = 0;
+    int longest = 0;
+
+    // encoding
+    for(stack balls : stacks) {
+        std::uint8_t encoded = encode(balls);
+        std::array<ball_color, CYCLE_STACK_SIZE> decoded = CyclePlanner::decode_stack(encoded);
+        if(encoded >= CYCLE_NUM_STACKS || !std::equal(balls.begin(), balls.end(), decoded.begin())) {
+            std::printf("stack %d does not encode and decode to itself\n", encoded);
+            wrong += 1;
+        }
+    }
+    if(CyclePlanner::encode_stack({e_unknown_ball, e_no_ball, e_no_ball}) != CYCLE_INVALID_STACK) {
+        std::printf("unknown ball color was encoded\n");
+        wrong += 1;
+    }
+
+    // every step matches the model
+    for(stack indexer : stacks) {
+        for(stack tower : stacks) {
+            for(int action = e_cycle_score; action <= e_cycle_filter; action++) {
+                cycle_state state = {indexer, tower};
+                bool possible = apply(static_cast<cycle_action>(action), state);
+                std::uint8_t encoded_indexer = encode(indexer);
+                std::uint8_t encoded_tower = encode(tower);
+                bool planner_possible = CyclePlanner::apply_action(static_cast<cycle_action>(action), encoded_indexer, encoded_tower);
+                if(possible != planner_possible || encoded_indexer != encode(state.first) || encoded_tower != encode(state.second)) {
+                    std::printf("action %d from indexer %d tower %d does not match\n", action, encode(indexer), encode(tower));
+                    wrong += 1;
+                }
+            }
+        }
+    }
+
+    // every plan is as short as the search and reaches the goal
+    for(stack indexer : stacks) {
+        for(stack tower : stacks) {
+            for(stack goal : stacks) {
+                checked += 1;
+                int expected = search({indexer, tower}, goal);
+                cycle_plan plan = CyclePlanner::plan(encode(indexer), encode(tower), encode(goal));
+                if(plan.length != expected) {
+                    std::printf(
+                        "indexer %d tower %d goal %d: plan has %d steps, search found %d\n",
+                        encode(indexer), encode(tower), encode(goal), plan.length, expected
+                    );
+                    wrong += 1;
+                    continue;
+                }
+                if(expected < 0) {
+                    unreachable += 1;
+                    continue;
+                }
+                longest = std::max(longest, expected);
+
+                cycle_state state = {indexer, tower};
+                for(int i = 0; i < plan.length; i++) {
+                    if(!apply(plan.actions.at(i), state)) {
+                        break;
+                    }
+                }
+                if(state.second != goal) {
+                    std::printf("indexer %d tower %d goal %d: plan does not reach the goal\n", encode(indexer), encode(tower), encode(goal));
+                    wrong += 1;
+                }
+            }
+        }
+    }
+    if(CyclePlanner::plan(CYCLE_INVALID_STACK, 0, 0).length != -1) {
+        std::printf("invalid stack was planned for\n");
+        wrong += 1;
+    }
+
+    std::printf("cycle planner\n");
+    std::printf("    arrangements checked: %d, unreachable: %d, longest plan: %d\n", checked, unreachable, longest);
+    std::printf("    plans not matching the search: %d\n", wrong);
+
+    // lookup against searching for every query like cycle_test.py
+    volatile int sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int round = 0; round < BENCHMARK_ROUNDS; round++) {
+        for(int indexer = 0; indexer < CYCLE_NUM_STACKS; indexer++) {
+            for(int tower = 0; tower < CYCLE_NUM_STACKS; tower++) {
+                for(int goal = 0; goal < CYCLE_NUM_STACKS; goal++) {
+                    sink = sink + CyclePlanner::plan(indexer, tower, goal).length;
+                }
+            }
+        }
+    }
+    double plan_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    plan_time /= BENCHMARK_ROUNDS * checked;
+
+    start = std::chrono::steady_clock::now();
+    for(stack indexer : stacks) {
+        for(stack tower : stacks) {
+            for(stack goal : stacks) {
+                sink = sink + search({indexer, tower}, goal);
+            }
+        }
+    }
+    double search_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    search_time /= checked;
+
+    std::printf("    us per query: plan %.3f, search %.1f\n", plan_time, search_time);
+
+    std::printf("%s\n", wrong ? "FAILED" : "passed");
+    return wrong ? 1 : 0;
+}
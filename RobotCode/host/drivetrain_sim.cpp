@@ -0,0 +1,417 @@
+/**
+ * @file: ./RobotCode/host/drivetrain_sim.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: drivetrain_sim.hpp
+ *
+ * contains stand ins for Motor, Encoder, the imu, and PositionTracker that
+ * read from and write to the simulated drivetrain
+ * link with host_stubs.cpp and chassis.cpp instead of the real devices
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <tuple>
+
+#include "main.h"
+
+#include "Configuration.hpp"
+#include "objects/motors/Motor.hpp"
+#include "objects/position_tracking/PositionTracker.hpp"
+#include "objects/sensors/Encoder.hpp"
+#include "objects/sensors/Sensors.hpp"
+#include "drivetrain_sim.hpp"
+
+
+
+namespace
+{
+    std::recursive_mutex sim_lock;  // the chassis task and the test both read the drive
+    host::drivetrain_constants constants;
+    Motor* drive_motors[4] = {NULL, NULL, NULL, NULL};  // front left, front right, back left, back right
+
+    position pose;
+    position field_origin;
+    double side_velocity[2] = {0, 0};  // rpm, left and right
+    double tracking_ticks[2] = {0, 0};  // left and right
+    double yaw_rate = 0;  // deg/s
+    std::uint32_t last_step = 0;
+
+    /**
+     * @return: int -> 0 for a left drive motor, 1 for a right one, -1 if it is not in the drive
+     */
+    int side_of(const Motor* motor)
+    {
+        for(int i = 0; i < 4; i++) {
+            if(drive_motors[i] == motor) {
+                return i % 2;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @return: double -> the velocity in rpm a motor is asking its side for
+     */
+    double motor_target(motor_mode mode, int voltage_setpoint, int velocity_setpoint)
+    {
+        if(mode == e_voltage) {
+            return constants.free_speed * voltage_setpoint / 12000.0;
+        }
+        return velocity_setpoint;
+    }
+
+    // both motors on a side drive the same wheels, so the side goes at the average of what they ask for
+    double side_target(int side)
+    {
+        double target = 0;
+        int motors = 0;
+        for(int i = side; i < 4; i += 2) {
+            if(drive_motors[i] != NULL) {
+                target += drive_motors[i]->get_actual_voltage() * constants.free_speed / 12000.0;
+                motors += 1;
+            }
+        }
+        return motors ? target / motors : 0;
+    }
+
+    // the drive motors are in brake mode, so a side given 0 mV stops as fast as it can
+    bool side_braking(int side)
+    {
+        for(int i = side; i < 4; i += 2) {
+            if(drive_motors[i] != NULL && drive_motors[i]->get_actual_voltage() != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // steps the drive up to the current time 1ms at a time
+    void step_drive()
+    {
+        std::uint32_t now = pros::millis();
+        double dt = 0.001;
+        double ticks_per_inch = PositionTracker::to_encoder_ticks(1, constants.wheel_diameter);
+        while(last_step < now) {
+            double targets[2] = {side_target(0), side_target(1)};
+            if(targets[0] == 0 && targets[1] == 0 && side_velocity[0] == 0 && side_velocity[1] == 0) {
+                last_step = now;  // at rest, so skip the time the chassis task spent waiting
+                break;
+            }
+
+            for(int side = 0; side < 2; side++) {
+                double change = (targets[side] - side_velocity[side]) * dt / constants.time_constant;
+                if(side_braking(side)) {
+                    change = -side_velocity[side];
+                }
+                double limit = constants.max_acceleration * dt;
+                side_velocity[side] += std::clamp(change, -limit, limit);
+                if(targets[side] == 0 && std::abs(side_velocity[side]) < 0.01) {
+                    side_velocity[side] = 0;
+                }
+                tracking_ticks[side] += side_velocity[side] * constants.ticks_per_rpm * dt;
+            }
+
+            double left = side_velocity[0] * constants.ticks_per_rpm / ticks_per_inch;  // in/s
+            double right = side_velocity[1] * constants.ticks_per_rpm / ticks_per_inch;
+            double omega = (left - right) / constants.width;  // rad/s, clockwise
+            double velocity = (left + right) / 2;
+            pose.x_pos += velocity * std::sin(pose.theta + (omega * dt / 2)) * dt;
+            pose.y_pos += velocity * std::cos(pose.theta + (omega * dt / 2)) * dt;
+            pose.theta += omega * dt;
+            yaw_rate = omega * 180 / M_PI;
+            last_step += 1;
+        }
+    }
+}
+
+
+
+void host::set_drivetrain(Motor& front_left, Motor& front_right, Motor& back_left, Motor& back_right, drivetrain_constants new_constants)
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    drive_motors[0] = &front_left;
+    drive_motors[1] = &front_right;
+    drive_motors[2] = &back_left;
+    drive_motors[3] = &back_right;
+    constants = new_constants;
+    last_step = pros::millis();
+}
+
+void host::set_pose(position new_pose)
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    step_drive();
+    pose = new_pose;
+    side_velocity[0] = 0;
+    side_velocity[1] = 0;
+    yaw_rate = 0;
+}
+
+position host::get_pose()
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    step_drive();
+    return pose;
+}
+
+double host::get_yaw_rate()
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    step_drive();
+    return yaw_rate;
+}
+
+double host::get_drive_speed()
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    step_drive();
+    return std::max(std::abs(side_velocity[0]), std::abs(side_velocity[1]));
+}
+
+
+
+Motor::Motor(int port, pros::motor_gearset_e_t gearset, bool reversed)
+{
+    motor_port = port;
+    motor = NULL;
+    slew_enabled = false;
+    slew_rate = 0;
+    mode = e_voltage;
+    voltage_setpoint = 0;
+    velocity_setpoint = 0;
+}
+
+Motor::~Motor() { }
+
+void Motor::set_motor_mode(motor_mode new_mode)
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    step_drive();
+    mode = new_mode;
+}
+
+int Motor::set_voltage(int voltage)
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    step_drive();
+    voltage_setpoint = voltage;
+    return 1;
+}
+
+int Motor::move(int voltage)
+{
+    return set_voltage(voltage * 12000 / 127);
+}
+
+int Motor::move_velocity(int velocity)
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    step_drive();
+    velocity_setpoint = velocity;
+    return 1;
+}
+
+// the voltage the motor is asking for, the velocity it is asking for in velocity mode
+double Motor::get_actual_voltage()
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    return motor_target(mode, voltage_setpoint, velocity_setpoint) * 12000 / constants.free_speed;
+}
+
+double Motor::get_actual_velocity()
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    step_drive();
+    int side = side_of(this);
+    return side == -1 ? 0 : side_velocity[side];
+}
+
+int Motor::set_brake_mode(pros::motor_brake_mode_e_t brake_mode) { return 1; }
+pros::motor_brake_mode_e_t Motor::get_brake_mode() { return pros::E_MOTOR_BRAKE_BRAKE; }
+pros::motor_gearset_e_t Motor::get_gearset() { return pros::E_MOTOR_GEARSET_06; }
+int Motor::reverse_motor() { return 1; }
+int Motor::set_slew(int rate) { slew_rate = rate; return 1; }
+void Motor::enable_slew() { slew_enabled = true; }
+void Motor::disable_slew() { slew_enabled = false; }
+void Motor::enable_driver_control() { }
+void Motor::disable_driver_control() { }
+
+
+
+Encoder::Encoder(char upper_port, char lower_port, bool reverse)
+{
+    lock = ATOMIC_VAR_INIT(false);
+    encoder = NULL;
+    latest_uid = 0;
+    zero_positions[0] = 0;
+}
+
+Encoder::~Encoder() { }
+
+double Encoder::get_absolute_position(bool scaled)
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    step_drive();
+    return this == &Sensors::left_encoder ? tracking_ticks[0] : this == &Sensors::right_encoder ? tracking_ticks[1] : 0;
+}
+
+int Encoder::get_unique_id(bool zero)
+{
+    while ( lock.exchange( true ) ); //aquire lock
+    latest_uid += 1;
+    int id = latest_uid;
+    zero_positions[id] = 0;
+    lock.exchange( false ); //release lock
+
+    if(zero) {
+        reset(id);
+    }
+
+    return id;
+}
+
+double Encoder::get_position(int unique_id)
+{
+    while ( lock.exchange( true ) ); //aquire lock
+    double zero = zero_positions.count(unique_id) ? zero_positions.at(unique_id) : 0;
+    lock.exchange( false ); //release lock
+
+    return get_absolute_position(false) - zero;
+}
+
+int Encoder::reset(int unique_id)
+{
+    double position = get_absolute_position(false);
+    while ( lock.exchange( true ) ); //aquire lock
+    zero_positions[unique_id] = position;
+    lock.exchange( false ); //release lock
+
+    return 1;
+}
+
+void Encoder::forget_position(int unique_id)
+{
+    while ( lock.exchange( true ) ); //aquire lock
+    zero_positions.erase(unique_id);
+    lock.exchange( false ); //release lock
+}
+
+
+
+namespace Sensors
+{
+    Encoder right_encoder('C', 'D', false);
+    Encoder left_encoder('A', 'B', false);
+    pros::Imu imu{1};
+    std::atomic<bool> imu_is_calibrated(true);
+
+    std::tuple<double, double> get_average_encoders(int l_id, int r_id)
+    {
+        return {left_encoder.get_position(l_id), right_encoder.get_position(r_id)};
+    }
+}
+
+namespace pros
+{
+    std::int32_t Imu::reset() const { return 1; }
+    std::int32_t Imu::set_data_rate(std::uint32_t rate) const { return 1; }
+    double Imu::get_rotation() const { return PositionTracker::to_degrees(host::get_pose().theta); }
+    double Imu::get_heading() const { return std::fmod(std::fmod(get_rotation(), 360) + 360, 360); }
+    pros::c::quaternion_s_t Imu::get_quaternion() const { return {}; }
+    pros::c::euler_s_t Imu::get_euler() const { return {}; }
+    double Imu::get_pitch() const { return 0; }
+    double Imu::get_roll() const { return 0; }
+    double Imu::get_yaw() const { return get_rotation(); }
+    pros::c::imu_gyro_s_t Imu::get_gyro_rate() const { return {0, 0, host::get_yaw_rate()}; }
+    pros::c::imu_accel_s_t Imu::get_accel() const { return {}; }
+    pros::c::imu_status_e_t Imu::get_status() const { return static_cast<pros::c::imu_status_e_t>(0); }
+    bool Imu::is_calibrating() const { return false; }
+}
+
+
+
+PositionTracker::PositionTracker() { }
+PositionTracker::~PositionTracker() { }
+
+PositionTracker* PositionTracker::get_instance()
+{
+    static PositionTracker tracker;
+    return &tracker;
+}
+
+long double PositionTracker::to_inches(long double encoder_ticks, long double wheel_size)
+{
+    return wheel_size * M_PI * encoder_ticks / 360.0;
+}
+
+long double PositionTracker::to_encoder_ticks(long double inches, long double wheel_size)
+{
+    return inches / (wheel_size * M_PI) * 360;
+}
+
+long double PositionTracker::to_degrees(long double radians)
+{
+    return radians * (180 / M_PI);
+}
+
+long double PositionTracker::to_radians(long double degrees)
+{
+    return degrees * (M_PI / 180);
+}
+
+// the tracker keeps its heading on [-pi, pi]
+position PositionTracker::get_position()
+{
+    position robot = host::get_pose();
+    robot.theta = std::atan2(std::sin(robot.theta), std::cos(robot.theta));
+    return robot;
+}
+
+long double PositionTracker::get_heading_rad()
+{
+    return get_position().theta;
+}
+
+void PositionTracker::set_position(position robot_coordinates)
+{
+    host::set_pose(robot_coordinates);
+}
+
+void PositionTracker::set_field_origin(position origin)
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    ::field_origin = origin;
+}
+
+position PositionTracker::get_field_origin()
+{
+    std::lock_guard<std::recursive_mutex> guard(sim_lock);
+    return ::field_origin;
+}
+
+position PositionTracker::to_field_frame(position robot_coordinates)
+{
+    position origin = get_field_origin();
+    position field_coordinates;
+    field_coordinates.x_pos = origin.x_pos + (robot_coordinates.x_pos * std::cos(origin.theta)) + (robot_coordinates.y_pos * std::sin(origin.theta));
+    field_coordinates.y_pos = origin.y_pos - (robot_coordinates.x_pos * std::sin(origin.theta)) + (robot_coordinates.y_pos * std::cos(origin.theta));
+    field_coordinates.theta = robot_coordinates.theta + origin.theta;
+    return field_coordinates;
+}
+
+position PositionTracker::from_field_frame(position field_coordinates)
+{
+    position origin = get_field_origin();
+    double dx = field_coordinates.x_pos - origin.x_pos;
+    double dy = field_coordinates.y_pos - origin.y_pos;
+    position robot_coordinates;
+    robot_coordinates.x_pos = (dx * std::cos(origin.theta)) - (dy * std::sin(origin.theta));
+    robot_coordinates.y_pos = (dx * std::sin(origin.theta)) + (dy * std::cos(origin.theta));
+    robot_coordinates.theta = field_coordinates.theta - origin.theta;
+    return robot_coordinates;
+}
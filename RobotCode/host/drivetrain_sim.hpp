@@ -0,0 +1,74 @@
+/**
+ * @file: ./RobotCode/host/drivetrain_sim.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a simulated drivetrain so that chassis.cpp can be run by host
+ * tests against the motors, encoders, imu, and position tracker it uses on
+ * the robot
+ * each side of the drive follows the velocity its motors are given with a
+ * first order lag and an acceleration limit, and the robot moves with the
+ * difference between the sides
+ * a side given 0 mV stops at the acceleration limit since the drive motors
+ * are in brake mode
+ * the simulation is stepped by the simulated clock when anything is read or
+ * written, so it stays in time with the chassis task however fast that runs
+ * odometry is perfect, the position tracker reports where the robot really is
+ */
+
+#ifndef __DRIVETRAIN_SIM_HPP__
+#define __DRIVETRAIN_SIM_HPP__
+
+#include "objects/motors/Motor.hpp"
+#include "objects/position_tracking/PositionTracker.hpp"
+
+
+
+namespace host
+{
+    typedef struct {
+        double time_constant=0.05;  // s for a side to get 63% of the way to a new velocity
+        double max_acceleration=3000;  // rpm/s a side can change velocity by
+        double free_speed=600;  // rpm at 12000 mV
+        double ticks_per_rpm=3.6;  // tracking wheel ticks/s per motor rpm, the same as chassis_characterization
+        double wheel_diameter=3.25;  // in, of the tracking wheels
+        double width=16;  // in between the wheels
+    } drivetrain_constants;
+
+    /**
+     * @param: Motor& front_left -> the motor the chassis is given as its front left, the rest are the same
+     * @param: drivetrain_constants constants -> how the drive responds
+     * @return: None
+     *
+     * motors that are not part of the drive can still be made, they are not simulated
+     */
+    void set_drivetrain(Motor& front_left, Motor& front_right, Motor& back_left, Motor& back_right, drivetrain_constants constants);
+
+    /**
+     * @param: position pose -> where the robot is, theta of 0 faces +y and increases clockwise
+     * @return: None
+     *
+     * also stops the robot
+     */
+    void set_pose(position pose);
+
+    /**
+     * @return: position -> where the robot is now
+     */
+    position get_pose();
+
+    /**
+     * @return: double -> the yaw rate of the robot in deg/s, clockwise is positive
+     */
+    double get_yaw_rate();
+
+    /**
+     * @return: double -> the velocity in rpm of the faster side of the drive
+     */
+    double get_drive_speed();
+}
+
+
+
+#endif
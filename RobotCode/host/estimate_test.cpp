@@ -0,0 +1,125 @@
+/**
+ * @file: ./RobotCode/host/estimate_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * runs each kind of chassis command on the chassis task against the
+ * simulated drivetrain and compares how long the chassis predicted it would
+ * take with how long it took
+ * commands are given the default timeout, so an estimate that is too short
+ * also shows up as the command being cut off
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "objects/motion_planning/Trajectory.hpp"
+#include "objects/motors/Motor.hpp"
+#include "objects/sensors/Sensors.hpp"
+#include "objects/subsystems/chassis.hpp"
+#include "drivetrain_sim.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define ALLOWED_ERROR 0.25  // of the actual duration
+#define ALLOWED_MARGIN 150  // ms on top of that for loop timing
+
+
+typedef struct {
+    const char* name;
+    int predicted;  // ms
+    int actual;  // ms
+    int timeout;  // ms
+} command_result;
+
+
+
+/**
+ * @return: int -> the value after name in a log entry, -1 if it is not in the entry
+ */
+int log_field(const std::string& entry, const std::string& name)
+{
+    std::size_t start = entry.find(name + ": ");
+    if(start == std::string::npos) {
+        return -1;
+    }
+    return std::stoi(entry.substr(start + name.size() + 2));
+}
+
+
+
+/**
+ * @return: command_result -> the predicted and actual durations the chassis logged for the command
+ */
+command_result wait_for(Chassis& chassis, int uid, const char* name)
+{
+    while(!chassis.is_finished(uid)) {
+        std::this_thread::yield();  // the chassis task moves the clock
+    }
+    std::string entry = host::get_last_log();
+    command_result result = {name, log_field(entry, "Predicted_Time"), log_field(entry, "Actual_Time"), log_field(entry, "Timeout")};
+
+    while(host::get_drive_speed() > 0) {  // start the next command at rest
+        host::advance_time(10);
+    }
+    host::set_pose({0, 0, 0});
+
+    return result;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("chassis duration estimates\n");
+
+    host::run_tasks(true);
+    Motor front_left(1, pros::E_MOTOR_GEARSET_06, false);
+    Motor front_right(2, pros::E_MOTOR_GEARSET_06, true);
+    Motor back_left(3, pros::E_MOTOR_GEARSET_06, false);
+    Motor back_right(4, pros::E_MOTOR_GEARSET_06, true);
+    host::drivetrain_constants drive;
+    host::set_drivetrain(front_left, front_right, back_left, back_right, drive);
+    Chassis chassis(front_left, front_right, back_left, back_right, Sensors::left_encoder, Sensors::right_encoder, drive.width, 1, drive.wheel_diameter);
+    std::streambuf* console = std::cout.rdbuf(NULL);  // some commands print every loop
+
+    Trajectory trajectory;
+    trajectory_constraints constraints;
+    constraints.max_velocity = Chassis::rpm_to_inches_per_second(450);
+    constraints.track_width = drive.width;
+    trajectory.generate({{0, 0}, {12, 24}, {0, 48}}, constraints);
+
+    std::vector<command_result> results;
+    results.push_back(wait_for(chassis, chassis.pid_straight_drive(1000, 0, 450, INT32_MAX, true), "pid drive 1000 ticks"));
+    results.push_back(wait_for(chassis, chassis.pid_straight_drive(3000, 0, 300, INT32_MAX, true, true, 0.5), "pid drive 3000 ticks, slew 0.5"));
+    results.push_back(wait_for(chassis, chassis.okapi_pid_straight_drive(1500, 8000, INT32_MAX, true, 0), "okapi drive 1500 ticks"));
+    results.push_back(wait_for(chassis, chassis.profiled_straight_drive(1500, 300, INT32_MAX, true), "profiled drive 1500 ticks"));
+    results.push_back(wait_for(chassis, chassis.turn_right(45, 450, INT32_MAX, true), "pid turn 45 degrees"));
+    results.push_back(wait_for(chassis, chassis.turn_right(120, 300, INT32_MAX, true), "pid turn 120 degrees"));
+    chassis.set_turn_gains({4, 0.0001, 20, INT32_MAX, INT32_MAX});  // what the autons turn with
+    results.push_back(wait_for(chassis, chassis.turn_left(90, 200, INT32_MAX, true), "pid turn 90 degrees, auton gains"));
+    results.push_back(wait_for(chassis, chassis.profiled_turn(90, 300, 1, INT32_MAX, true), "profiled turn 90 degrees"));
+    results.push_back(wait_for(chassis, chassis.follow_trajectory(trajectory, 1, INT32_MAX, true), "trajectory 55 in"));
+
+    std::cout.rdbuf(console);
+    host::stop_tasks();
+
+    for(const command_result& result : results) {
+        std::printf("    %-34s predicted %5d ms, took %5d ms, timeout %5d ms\n", result.name, result.predicted, result.actual, result.timeout);
+        if(std::abs(result.predicted - result.actual) > (ALLOWED_ERROR * result.actual) + ALLOWED_MARGIN || result.actual >= result.timeout) {
+            std::printf("%s was not predicted well enough\n", result.name);
+            errors += 1;
+        }
+    }
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file: ./RobotCode/host/host_stubs.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: host_stubs.hpp
+ *
+ * contains stand ins for the pros functions and devices and the logger so
+ * robot code can be linked into host tests
+ * devices read as 0 unless a test sets their readings
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "main.h"
+
+#include "objects/serial/Logger.hpp"
+#include "host_stubs.hpp"
+
+
+
+namespace
+{
+    std::atomic<std::uint32_t> current_time(0);  // tasks advance the time from their own threads
+    int log_count = 0;
+    std::string last_log;
+    bool print_entries = false;
+
+    std::atomic<int> optical_hue(0);  // tests change the readings while tasks read them
+    std::atomic<int> optical_proximity(0);
+    std::atomic<int> distance_reading(0);
+
+    std::atomic<int> pace(0);  // us of real time per ms a delay outside a task moves the clock
+    std::atomic<bool> pace_tasks(false);  // if delays in tasks are paced too
+
+    bool start_tasks = false;
+    std::atomic<bool> stopping(false);
+    std::vector<std::thread> task_threads;
+    thread_local bool is_task = false;
+
+    struct task_stopped { };  // thrown out of a delay to end a task
+
+    // tasks only yield on a delay so the test thread keeps running
+    void yield_task(std::uint32_t milliseconds)
+    {
+        if(is_task) {
+            if(stopping) {
+                throw task_stopped();
+            }
+            if(pace_tasks && pace > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(pace * milliseconds));
+            } else {
+                std::this_thread::yield();
+            }
+        } else if(pace > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(pace * milliseconds));
+        }
+    }
+}
+
+
+
+void host::set_time(std::uint32_t time)
+{
+    current_time = time;
+}
+
+void host::advance_time(std::uint32_t milliseconds)
+{
+    current_time += milliseconds;
+}
+
+int host::get_log_count()
+{
+    return log_count;
+}
+
+std::string host::get_last_log()
+{
+    return last_log;
+}
+
+void host::print_logs(bool print)
+{
+    print_entries = print;
+}
+
+void host::set_optical(int hue, int proximity)
+{
+    optical_hue = hue;
+    optical_proximity = proximity;
+}
+
+void host::set_distance(int distance)
+{
+    distance_reading = distance;
+}
+
+void host::run_tasks(bool run)
+{
+    start_tasks = run;
+}
+
+void host::stop_tasks()
+{
+    stopping = true;
+    for(std::thread& thread : task_threads) {
+        thread.join();
+    }
+    task_threads.clear();
+    stopping = false;
+}
+
+void host::pace_time(int microseconds, bool in_tasks)
+{
+    pace = microseconds;
+    pace_tasks = in_tasks;
+}
+
+bool host::in_task()
+{
+    return is_task;
+}
+
+
+
+extern "C" {
+namespace pros
+{
+    namespace c
+    {
+        std::uint32_t millis()
+        {
+            return current_time;
+        }
+
+        void delay(const std::uint32_t milliseconds)
+        {
+            current_time += milliseconds;
+            yield_task(milliseconds);
+        }
+
+        void task_delay_until(std::uint32_t* const prev_time, const std::uint32_t delta)
+        {
+            *prev_time += delta;
+            if(current_time < *prev_time) {
+                current_time = *prev_time;
+            }
+            yield_task(delta);
+        }
+
+        task_t task_get_current()
+        {
+            return NULL;
+        }
+    }
+}
+}  // extern "C"
+
+namespace pros
+{
+    Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name)
+    {
+        if(start_tasks) {
+            task_threads.emplace_back([function, parameters]() {
+                is_task = true;
+                try {
+                    function(parameters);
+                } catch(task_stopped&) { }
+            });
+        }
+    }
+    Task::Task(task_fn_t function, void* parameters, const char* name) : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) { }
+    void Task::remove() { }
+    void Task::suspend() { }
+    void Task::resume() { }
+    void Task::delay(const std::uint32_t milliseconds)
+    {
+        current_time += milliseconds;
+        yield_task(milliseconds);
+    }
+    void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta)
+    {
+        *prev_time += delta;
+        if(current_time < *prev_time) {
+            current_time = *prev_time;
+        }
+        yield_task(delta);
+    }
+
+    Optical::Optical(const std::uint8_t port) : _port(port) { }
+    double Optical::get_hue() { return optical_hue; }
+    double Optical::get_saturation() { return 0; }
+    double Optical::get_brightness() { return 0; }
+    std::int32_t Optical::get_proximity() { return optical_proximity; }
+    std::int32_t Optical::set_led_pwm(uint8_t value) { return 1; }
+    std::int32_t Optical::get_led_pwm() { return 0; }
+    pros::c::optical_rgb_s_t Optical::get_rgb() { return {}; }
+    pros::c::optical_raw_s_t Optical::get_raw() { return {}; }
+    pros::c::optical_direction_e_t Optical::get_gesture() { return {}; }
+    pros::c::optical_gesture_s_t Optical::get_gesture_raw() { return {}; }
+    std::int32_t Optical::enable_gesture() { return 1; }
+    std::int32_t Optical::disable_gesture() { return 1; }
+    std::uint8_t Optical::get_port() { return _port; }
+
+    Distance::Distance(const std::uint8_t port) : _port(port) { }
+    std::int32_t Distance::get() { return distance_reading; }
+    std::int32_t Distance::get_confidence() { return 0; }
+    std::int32_t Distance::get_object_size() { return 0; }
+    double Distance::get_object_velocity() { return 0; }
+    std::uint8_t Distance::get_port() { return _port; }
+}
+
+
+
+Logger::Logger() { }
+Logger::~Logger() { }
+
+bool Logger::add(log_entry entry)
+{
+    log_count += 1;
+    last_log = entry.content;
+    if(print_entries) {
+        std::cout << entry.content << "\n";
+    }
+
+    return true;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file: ./RobotCode/host/host_stubs.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains the simulated clock and logger used when robot code is built for
+ * a computer by run_host_tests.sh
+ * pros::millis returns the simulated time and pros::delay advances it, tasks
+ * are not started unless a test asks for them so most code has to be stepped
+ * by the test
+ */
+
+#ifndef __HOST_STUBS_HPP__
+#define __HOST_STUBS_HPP__
+
+#include <cstdint>
+#include <string>
+
+
+
+namespace host
+{
+    void set_time(std::uint32_t time);
+    void advance_time(std::uint32_t milliseconds);
+
+    /**
+     * @return: int -> the number of entries given to Logger::add
+     */
+    int get_log_count();
+
+    /**
+     * @return: std::string -> the content of the last entry given to Logger::add
+     */
+    std::string get_last_log();
+
+    /**
+     * @param: bool print -> if log entries are also printed to stdout
+     * @return: None
+     */
+    void print_logs(bool print);
+
+    /**
+     * @param: int hue -> the hue every optical sensor reads
+     * @param: int proximity -> the proximity every optical sensor reads
+     * @return: None
+     */
+    void set_optical(int hue, int proximity);
+
+    /**
+     * @param: int distance -> the mm every distance sensor reads
+     * @return: None
+     */
+    void set_distance(int distance);
+
+    /**
+     * @param: bool run -> if a pros::Task made after this runs its function on a thread
+     * @return: None
+     *
+     * delays in a task only yield, so time moves as fast as the tasks loop
+     */
+    void run_tasks(bool run);
+
+    /**
+     * @return: None
+     *
+     * ends every running task at its next delay and waits for them
+     */
+    void stop_tasks();
+
+    /**
+     * @param: int microseconds -> real time a delay outside of a task sleeps for each ms it moves the clock
+     * @param: bool in_tasks -> if delays in tasks sleep the same way instead of only yielding
+     * @return: None
+     *
+     * gives tasks time to start and keep up with a test thread that moves
+     * the clock, 0 by default so tests run as fast as they can
+     * pacing tasks too keeps a task that moves the clock from getting ahead
+     * of a test thread that reacts to it
+     */
+    void pace_time(int microseconds, bool in_tasks=false);
+
+    /**
+     * @return: bool -> if the calling thread is a task started by pros::Task
+     */
+    bool in_task();
+}
+
+
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * @file: ./RobotCode/host/indexer_alloc_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * runs the indexer task on a thread and sends it staggered index commands the
+ * way driver control does while balls move past the sensors
+ * counts heap allocations made by the indexer task and by the thread sending
+ * commands, both should be 0 once the task is running
+ * motors are stubbed, the upper roller position moves with its voltage
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+#include "objects/motors/Motor.hpp"
+#include "objects/sensors/BallDetector.hpp"
+#include "objects/subsystems/Indexer.hpp"
+#include "objects/subsystems/intakes.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define WARM_UP_COMMANDS 100
+#define COMMANDS 4000
+#define COMMANDS_PER_PHASE 50  // commands between changes of the simulated sensors
+
+
+namespace
+{
+    std::atomic<long> task_allocations(0);
+    std::atomic<long> sender_allocations(0);
+    std::atomic<bool> counting(false);
+
+    Motor* upper_motor = NULL;
+    std::atomic<int> upper_voltage(0);
+    std::atomic<double> upper_position(0);
+}
+
+
+void* operator new(std::size_t size)
+{
+    if(counting) {
+        if(host::in_task()) {
+            task_allocations += 1;
+        } else {
+            sender_allocations += 1;
+        }
+    }
+    void* memory = std::malloc(size);
+    if(memory == NULL) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t size) noexcept
+{
+    std::free(memory);
+}
+
+
+
+Motor::Motor(int port, pros::motor_gearset_e_t gearset, bool reversed) { }
+Motor::~Motor() { }
+int Motor::set_brake_mode(pros::motor_brake_mode_e_t brake_mode) { return 1; }
+void Motor::set_motor_mode(motor_mode mode) { }
+void Motor::disable_slew() { }
+double Motor::get_actual_voltage() { return 0; }
+
+int Motor::set_voltage(int voltage)
+{
+    if(this == upper_motor) {
+        upper_voltage = voltage;
+    }
+    return 1;
+}
+
+// each read moves the roller as if it ran for one 5 ms loop at 1000 deg/s
+double Motor::get_encoder_position()
+{
+    if(this != upper_motor) {
+        return 0;
+    }
+    double position = upper_position + 5.0 * upper_voltage / 12000;
+    upper_position = position;
+    return position;
+}
+
+void Intakes::intake() { }
+void Intakes::stop() { }
+
+
+
+/**
+ * @param: int phase -> which part of a ball passing through to show the sensors
+ * @return: None
+ *
+ * a ball reaches the filter level, then the top, then leaves, every other
+ * ball is red so the auto commands filter it
+ */
+void set_sensors(int phase)
+{
+    int color_hue = (phase / 4) % 2 ? 8 : 215;
+    switch(phase % 4) {
+        case 1: {  // ball at the filter level
+            host::set_optical(color_hue, 255);
+            host::set_distance(200);
+            break;
+        } case 2: {  // ball at the top
+            host::set_optical(90, 60);
+            host::set_distance(30);
+            break;
+        } default: {  // empty
+            host::set_optical(90, 60);
+            host::set_distance(200);
+            break;
+        }
+    }
+}
+
+
+
+int main()
+{
+    host::run_tasks(true);
+    Motor upper(1, pros::E_MOTOR_GEARSET_06, false);
+    Motor lower(2, pros::E_MOTOR_GEARSET_06, false);
+    upper_motor = &upper;
+    BallDetector detector(3, 4, 245);
+    set_sensors(0);
+    Indexer indexer(upper, lower, detector, e_red_ball);
+
+    // the task allocates once when it registers itself
+    for(int i = 0; i < WARM_UP_COMMANDS; i++) {
+        indexer.staggered_index();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    int start_events = 0;
+    for(int type = e_ball_entered; type <= e_ball_ejected; type++) {
+        start_events += Indexer::get_event_count(static_cast<ball_event_type>(type));
+    }
+
+    counting = true;
+    for(int i = 0; i < COMMANDS; i++) {
+        if(i % COMMANDS_PER_PHASE == 0) {
+            set_sensors(i / COMMANDS_PER_PHASE);
+        }
+        if(i % 2) {
+            indexer.auto_staggered_index();
+        } else {
+            indexer.staggered_index();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    counting = false;
+    host::stop_tasks();
+
+    int events = -start_events;
+    for(int type = e_ball_entered; type <= e_ball_ejected; type++) {
+        events += Indexer::get_event_count(static_cast<ball_event_type>(type));
+    }
+    int logged = Indexer::log_ball_events();
+
+    std::printf("staggered index commands: %d\n", COMMANDS);
+    std::printf("    ball events: %d, logged afterwards: %d\n", events, logged);
+    std::printf("    allocations by the indexer task: %ld\n", task_allocations.load());
+    std::printf("    allocations sending commands: %ld\n", sender_allocations.load());
+
+    bool passed = task_allocations == 0 && sender_allocations == 0 && events > 0;
+    std::printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
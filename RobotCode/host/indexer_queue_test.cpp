@@ -0,0 +1,158 @@
+/**
+ * @file: ./RobotCode/host/indexer_queue_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * fills the indexer command queue before the indexer task is started and
+ * checks that only commands nobody waits on are dropped, that a send fails
+ * once the queue is full of waited on commands, and that every waited on
+ * command still reports as finished after the task runs them, even ones
+ * pushed out of the finished list before anyone collected them
+ * motors are stubbed, fix_ball is the only command that runs the upper
+ * roller backwards so the number of those that ran can be counted
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "objects/motors/Motor.hpp"
+#include "objects/sensors/BallDetector.hpp"
+#include "objects/subsystems/Indexer.hpp"
+#include "objects/subsystems/intakes.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define EXTRA_COMMANDS 4  // fix_ball commands sent once the task is running, pushes the first uids out of the finished list
+
+
+namespace
+{
+    Motor* upper_motor = NULL;
+    std::atomic<int> upper_voltage(0);
+    std::atomic<int> fix_balls_run(0);
+}
+
+
+Motor::Motor(int port, pros::motor_gearset_e_t gearset, bool reversed) { }
+Motor::~Motor() { }
+int Motor::set_brake_mode(pros::motor_brake_mode_e_t brake_mode) { return 1; }
+void Motor::set_motor_mode(motor_mode mode) { }
+void Motor::disable_slew() { }
+double Motor::get_actual_voltage() { return 0; }
+double Motor::get_encoder_position() { return 0; }
+
+int Motor::set_voltage(int voltage)
+{
+    if(this == upper_motor) {
+        if(voltage == -12000 && upper_voltage != -12000) {
+            fix_balls_run += 1;
+        }
+        upper_voltage = voltage;
+    }
+    return 1;
+}
+
+void Intakes::intake() { }
+void Intakes::stop() { }
+
+
+
+/**
+ * @return: int -> the uid of the command, the clock is moved so every command gets its own uid
+ */
+int send(Indexer& indexer, bool waited_on, bool run_lower=true)
+{
+    host::advance_time(1);
+    if(waited_on) {
+        return indexer.fix_ball(true);
+    }
+    indexer.index(run_lower);
+    return 0;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("indexer command queue\n");
+
+    Motor upper(1, pros::E_MOTOR_GEARSET_06, false);
+    Motor lower(2, pros::E_MOTOR_GEARSET_06, false);
+    upper_motor = &upper;
+    BallDetector detector(3, 4, 245);
+    host::set_optical(90, 60);
+    host::set_distance(200);
+    Indexer* indexer = new Indexer(upper, lower, detector, e_red_ball);  // tasks are not run so the queue fills
+
+    // half waited on, half sent every loop by driver control
+    std::vector<int> uids;
+    for(int i = 0; i < INDEXER_COMMAND_QUEUE_SIZE; i++) {
+        if(i % 2) {
+            uids.push_back(send(*indexer, true));
+        } else {
+            send(*indexer, false, i % 4 == 0);  // alternate so they are not combined
+        }
+    }
+
+    // a full queue makes room by dropping commands nobody waits on
+    host::advance_time(1);
+    indexer->run_upper_roller();
+    while(uids.size() < INDEXER_COMMAND_QUEUE_SIZE) {
+        int uid = send(*indexer, true);
+        if(uid == -1) {
+            std::printf("fix_ball was not sent with %d waited on commands queued\n", (int)uids.size());
+            errors += 1;
+            break;
+        }
+        uids.push_back(uid);
+    }
+    for(int uid : uids) {
+        if(indexer->is_finished(uid)) {
+            std::printf("waited on command %d was dropped from the queue\n", uid);
+            errors += 1;
+        }
+    }
+    std::printf("    %d waited on commands queued after dropping the rest\n", (int)uids.size());
+
+    // nothing can be dropped, so the send fails
+    int log_count = host::get_log_count();
+    if(send(*indexer, true) != -1 || host::get_log_count() != log_count + 1) {
+        std::printf("a send to a queue full of waited on commands did not fail\n");
+        errors += 1;
+    }
+    indexer->wait_until_finished(-1);  // has to return since there is nothing to wait on
+    std::printf("    send to a full queue returned -1\n");
+
+    // run the queue
+    delete indexer;
+    host::run_tasks(true);
+    indexer = new Indexer(upper, lower, detector, e_red_ball);
+    for(int i = 0; i < EXTRA_COMMANDS; i++) {
+        int uid = send(*indexer, true);
+        while(uid == -1) {  // retry until the task makes room without collecting anything
+            std::this_thread::yield();
+            uid = send(*indexer, true);
+        }
+        uids.push_back(uid);
+    }
+
+    // collecting the newest uid last leaves more finished uids than the list holds
+    indexer->wait_until_finished(uids.back());
+    for(int uid : uids) {
+        indexer->wait_until_finished(uid);
+    }
+    host::stop_tasks();
+
+    std::printf("    fix_ball commands run: %d of %d\n", fix_balls_run.load(), (int)uids.size());
+    if(fix_balls_run != uids.size()) {
+        errors += 1;
+    }
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
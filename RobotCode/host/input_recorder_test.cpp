@@ -0,0 +1,150 @@
+/**
+ * @file: ./RobotCode/host/input_recorder_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * records a minute of synthetic driving with InputRecorder, then replays it
+ * and checks every tick comes back the same
+ * the driving is stick ramps with +/-1 of jitter and buttons that toggle
+ * every so often, the snapshots are made by the test so no controller is read
+ * reports the size of the recording against writing the master buttons and
+ * axes every tick, and the time InputRecorder::record takes per tick
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "objects/controller/InputRecorder.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define RECORDING_FILE "bin/driver_recording.bin"
+#define TICK_PERIOD 5  // ms, driver control loop
+#define TICKS 12000  // a minute of driver control
+#define RAW_BYTES_PER_TICK 6  // master buttons and the four master axes
+#define KEYFRAME_BYTES 7  // flag and three int16
+
+
+
+/**
+ * @return: std::vector<controller_snapshot> -> a snapshot for every tick of driving
+ */
+std::vector<controller_snapshot> make_driving()
+{
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<int> jitter(-1, 1);
+    std::vector<controller_snapshot> snapshots;
+    controller_snapshot snapshot = {};
+    snapshot.connected[0] = true;
+
+    for(int tick = 0; tick < TICKS; tick++) {
+        // the sticks ramp between full forward and full reverse over 4 s, out of phase with each other
+        int left = ((tick % 800) < 400 ? (tick % 400) : 400 - (tick % 400)) * 254 / 400 - 127;
+        int right = (((tick + 200) % 800) < 400 ? ((tick + 200) % 400) : 400 - ((tick + 200) % 400)) * 254 / 400 - 127;
+        snapshot.analog[0][pros::E_CONTROLLER_ANALOG_LEFT_Y] = std::max(-127, std::min(127, left + jitter(generator)));
+        snapshot.analog[0][pros::E_CONTROLLER_ANALOG_RIGHT_Y] = std::max(-127, std::min(127, right + jitter(generator)));
+        if(tick % 150 == 0) {  // intake
+            snapshot.buttons[0] ^= button_mask(pros::E_CONTROLLER_DIGITAL_R1);
+        }
+        if(tick % 230 == 0) {  // indexer
+            snapshot.buttons[0] ^= button_mask(pros::E_CONTROLLER_DIGITAL_L1);
+        }
+        snapshot.time = tick * TICK_PERIOD;
+        snapshots.push_back(snapshot);
+    }
+
+    return snapshots;
+}
+
+
+
+/**
+ * @return: long -> the size of the file in bytes, -1 if it can not be opened
+ */
+long file_size(const char* filename)
+{
+    std::FILE* file = std::fopen(filename, "rb");
+    if(file == NULL) {
+        return -1;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+    return size;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("input recorder\n");
+
+    std::vector<controller_snapshot> snapshots = make_driving();
+    host::run_tasks(true);  // the writer task saves full blocks
+
+    if(!InputRecorder::start_recording(RECORDING_FILE)) {
+        std::printf("could not open %s\n", RECORDING_FILE);
+        return 1;
+    }
+    std::chrono::nanoseconds record_time(0);
+    for(const controller_snapshot& snapshot : snapshots) {
+        host::advance_time(TICK_PERIOD);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        InputRecorder::record(snapshot);
+        record_time += std::chrono::steady_clock::now() - start;
+        std::this_thread::sleep_for(std::chrono::microseconds(20));  // gives the writer task time like the rest of the loop would
+    }
+    InputRecorder::stop_recording();
+    input_recorder_stats stats = InputRecorder::get_stats();
+
+    // the writer task closes the file after stop_recording returns
+    for(int i = 0; i < 1000 && file_size(RECORDING_FILE) != stats.bytes + 8; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    host::stop_tasks();
+    long size = file_size(RECORDING_FILE);
+
+    double minutes = TICKS * TICK_PERIOD / 60000.0;
+    std::printf("    ticks: %d, keyframes: %d, dropped blocks: %d\n", stats.ticks, stats.keyframes, stats.dropped_blocks);
+    std::printf(
+        "    file size: %.1f KB per minute, %.1f KB of it keyframes, raw master inputs: %.1f KB per minute\n",
+        size / minutes / 1000, stats.keyframes * KEYFRAME_BYTES / minutes / 1000, TICKS * RAW_BYTES_PER_TICK / minutes / 1000
+    );
+    std::printf("    record: %.1f ns per tick\n", (double)record_time.count() / TICKS);
+    if(stats.ticks != TICKS || stats.dropped_blocks != 0 || size != stats.bytes + 8 || size >= TICKS * RAW_BYTES_PER_TICK) {
+        std::printf("recording is incomplete or larger than the raw inputs\n");
+        errors += 1;
+    }
+
+    if(!InputRecorder::start_replay(RECORDING_FILE)) {
+        std::printf("could not replay %s\n", RECORDING_FILE);
+        return 1;
+    }
+    int mismatched = 0;
+    int replayed = 0;
+    controller_snapshot snapshot = {};
+    while(replayed < TICKS && InputRecorder::replay(snapshot)) {
+        const controller_snapshot& recorded = snapshots.at(replayed);
+        bool same = snapshot.buttons[0] == recorded.buttons[0] && snapshot.buttons[1] == recorded.buttons[1];
+        for(int channel = 0; channel < NUM_ANALOG_CHANNELS; channel++) {
+            same = same && snapshot.analog[0][channel] == recorded.analog[0][channel] && snapshot.analog[1][channel] == recorded.analog[1][channel];
+        }
+        mismatched += same ? 0 : 1;
+        replayed += 1;
+    }
+    InputRecorder::stop_replay();
+
+    std::printf("    replayed %d of %d ticks, %d different from the recording\n", replayed, TICKS, mismatched);
+    if(replayed != TICKS || mismatched != 0) {
+        errors += 1;
+    }
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
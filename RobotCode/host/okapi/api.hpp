@@ -0,0 +1,70 @@
+/**
+ * @file: ./RobotCode/host/okapi/api.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * stands in for the parts of okapilib the robot code uses, okapilib is only
+ * built for the brain
+ * run_host_tests.sh puts this directory before ../include so this is found
+ * instead of the real header
+ */
+
+#ifndef __HOST_OKAPI_API_HPP__
+#define __HOST_OKAPI_API_HPP__
+
+#include <algorithm>
+
+
+
+namespace okapi
+{
+    /**
+     * position pid with its output bounded to [-1, 1] like okapi's, the
+     * integral and derivative are per step instead of per second since the
+     * robot code only uses kP
+     */
+    class IterativePosPIDController
+    {
+        private:
+            double kP;
+            double kI;
+            double kD;
+            double target = 0;
+            double integral = 0;
+            double prev_error = 0;
+            bool first_step = true;
+
+        public:
+            IterativePosPIDController(double kP, double kI, double kD) : kP(kP), kI(kI), kD(kD) { }
+
+            void setTarget(double new_target)
+            {
+                target = new_target;
+            }
+
+            double step(double reading)
+            {
+                double error = target - reading;
+                integral += error;
+                double derivative = first_step ? 0 : error - prev_error;
+                prev_error = error;
+                first_step = false;
+
+                return std::clamp((kP * error) + (kI * integral) + (kD * derivative), -1.0, 1.0);
+            }
+    };
+
+    class IterativeControllerFactory
+    {
+        public:
+            static IterativePosPIDController posPID(double kP, double kI, double kD)
+            {
+                return IterativePosPIDController(kP, kI, kD);
+            }
+    };
+}
+
+
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file: ./RobotCode/host/path_planner_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * plans between random points on the field and checks that every path is
+ * found and stays clear of the towers, and times plan and plan_trajectory
+ * the points are in the frame of the field, so some of them are inside a
+ * tower or against a wall, which the planner has to get out of
+ * also moves a trajectory into a turned frame and back the way
+ * Chassis::drive_to_point_planned does
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "objects/motion_planning/FieldModel.hpp"
+#include "objects/motion_planning/PathPlanner.hpp"
+#include "objects/motion_planning/Trajectory.hpp"
+
+
+
+#define PAIRS 2000
+#define SEED 2
+#define ROBOT_RADIUS 9  // same as CHASSIS_PLANNING_RADIUS
+#define TRACK_WIDTH 16  // same as the chassis
+#define MAX_CORNER_STEP (1.5 * M_SQRT2 * FIELD_RESOLUTION)  // in from anywhere in a cell to the center of a diagonal neighbor
+
+
+/**
+ * @return: double -> the value at the fraction of the sorted times
+ */
+double percentile(std::vector<double> times, double fraction)
+{
+    std::sort(times.begin(), times.end());
+    return times.at(std::min<int>(times.size() - 1, times.size() * fraction));
+}
+
+
+
+/**
+ * @return: int -> the number of samples that did not come back to where they started
+ */
+int check_transform(const Trajectory& trajectory)
+{
+    Trajectory moved = trajectory;
+    double x = 30;
+    double y = -12;
+    double theta = 1.2;
+    moved.transform(x, y, theta);
+
+    // the origin of the turned frame in the first one, the same as PositionTracker::from_field_frame({0, 0, 0})
+    double back_x = -x * std::cos(theta) + y * std::sin(theta);
+    double back_y = -x * std::sin(theta) - y * std::cos(theta);
+    moved.transform(back_x, back_y, -theta);
+
+    int errors = 0;
+    for(int i = 0; i < trajectory.size(); i++) {
+        const trajectory_sample& a = trajectory.data()[i];
+        const trajectory_sample& b = moved.data()[i];
+        if(std::abs(a.x - b.x) > 1e-3 || std::abs(a.y - b.y) > 1e-3 || std::abs(std::remainder(a.theta - b.theta, 2 * M_PI)) > 1e-4 || a.velocity != b.velocity) {
+            errors += 1;
+        }
+    }
+    return errors;
+}
+
+
+
+int main()
+{
+    auto start = std::chrono::steady_clock::now();
+    FieldModel field;
+    field.build(ROBOT_RADIUS);
+    double build_time = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    PathPlanner planner(field);
+
+    std::mt19937 generator(SEED);
+    std::uniform_real_distribution<double> coordinate(0.5, FIELD_WIDTH - 0.5);
+    std::vector<double> plan_times;
+    std::vector<double> trajectory_times;
+    int failed = 0;
+    int blocked_segments = 0;
+    int clipped_corners = 0;
+    int trajectories_failed = 0;
+    int transform_errors = 0;
+    long nodes = 0;
+    double waypoints = 0;
+
+    for(int i = 0; i < PAIRS; i++) {
+        double x0 = coordinate(generator);
+        double y0 = coordinate(generator);
+        double x1 = coordinate(generator);
+        double y1 = coordinate(generator);
+
+        std::vector<spline_point> path;
+        start = std::chrono::steady_clock::now();
+        bool found = planner.plan(x0, y0, x1, y1, path);
+        plan_times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        if(!found) {
+            std::printf("no path from (%.1f, %.1f) to (%.1f, %.1f)\n", x0, y0, x1, y1);
+            failed += 1;
+            continue;
+        }
+        nodes += planner.get_nodes_expanded();
+        waypoints += path.size();
+
+        // the first and last segments are allowed to leave a blocked start
+        // or goal, or to clip a corner on the way to the next cell
+        for(int j = 1; j < path.size(); j++) {
+            const spline_point& a = path.at(j - 1);
+            const spline_point& b = path.at(j);
+            if(field.line_is_free(a.x, a.y, b.x, b.y)) {
+                continue;
+            }
+            bool escape = (j == 1 && !field.is_free(x0, y0)) || (j == path.size() - 1 && !field.is_free(x1, y1));
+            bool next_cell = (j == 1 || j == path.size() - 1) && std::hypot(b.x - a.x, b.y - a.y) < MAX_CORNER_STEP;
+            if(escape) {
+                continue;
+            } else if(next_cell) {
+                clipped_corners += 1;
+            } else {
+                std::printf("segment (%.1f, %.1f) to (%.1f, %.1f) is blocked\n", a.x, a.y, b.x, b.y);
+                blocked_segments += 1;
+            }
+        }
+
+        Trajectory trajectory;
+        trajectory_constraints constraints;
+        constraints.track_width = TRACK_WIDTH;
+        start = std::chrono::steady_clock::now();
+        bool generated = planner.plan_trajectory(x0, y0, x1, y1, constraints, trajectory);
+        trajectory_times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        if(!generated) {
+            std::printf("no trajectory clear of the towers from (%.1f, %.1f) to (%.1f, %.1f)\n", x0, y0, x1, y1);
+            trajectories_failed += 1;
+        } else if(i % 100 == 0) {
+            transform_errors += check_transform(trajectory);
+        }
+    }
+
+    int planned = PAIRS - failed;
+    std::printf("path planner\n");
+    std::printf("    field model built in %.0f us\n", build_time);
+    std::printf("    pairs: %d, no path: %d, blocked segments: %d, no trajectory: %d\n", PAIRS, failed, blocked_segments, trajectories_failed);
+    std::printf("    first or last steps clipping a corner: %d\n", clipped_corners);
+    std::printf("    average cells expanded: %ld, average waypoints: %.1f\n", planned ? nodes / planned : 0, planned ? waypoints / planned : 0);
+    std::printf("    us to plan: p50 %.0f, p99 %.0f\n", percentile(plan_times, 0.5), percentile(plan_times, 0.99));
+    std::printf("    us to plan a trajectory: p50 %.0f, p99 %.0f\n", percentile(trajectory_times, 0.5), percentile(trajectory_times, 0.99));
+    std::printf("    samples not moved back by the inverse transform: %d\n", transform_errors);
+
+    int errors = failed + blocked_segments + trajectories_failed + transform_errors;
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file: ./RobotCode/host/planned_drive_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * queues as many planned drives as Chassis keeps trajectories for on the
+ * chassis task against the simulated drivetrain and checks that one more is
+ * refused instead of overwriting a trajectory that is still being followed,
+ * that each queued drive is planned from where the one before it ends, and
+ * that a planned drive queued behind a command that is not planned is refused
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "objects/motors/Motor.hpp"
+#include "objects/position_tracking/PositionTracker.hpp"
+#include "objects/sensors/Sensors.hpp"
+#include "objects/subsystems/chassis.hpp"
+#include "drivetrain_sim.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define PACE 50  // us of real time per simulated ms so the first drive is still running while the rest are queued
+#define ALLOWED_ERROR 3  // in from the goal the robot can stop
+
+
+typedef struct {
+    double x;
+    double y;
+} goal;
+
+
+
+/**
+ * @return: double -> inches from the robot to the point
+ */
+double distance_to(goal point)
+{
+    position pose = host::get_pose();
+    return std::hypot(pose.x_pos - point.x, pose.y_pos - point.y);
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("planned drives\n");
+
+    host::run_tasks(true);
+    host::pace_time(PACE, true);
+    Motor front_left(1, pros::E_MOTOR_GEARSET_06, false);
+    Motor front_right(2, pros::E_MOTOR_GEARSET_06, true);
+    Motor back_left(3, pros::E_MOTOR_GEARSET_06, false);
+    Motor back_right(4, pros::E_MOTOR_GEARSET_06, true);
+    host::drivetrain_constants drive;
+    host::set_drivetrain(front_left, front_right, back_left, back_right, drive);
+    Chassis chassis(front_left, front_right, back_left, back_right, Sensors::left_encoder, Sensors::right_encoder, drive.width, 1, drive.wheel_diameter);
+    PositionTracker::get_instance()->set_field_origin({36, 36, 0});  // the robot starts a tile in from the corner
+    std::streambuf* console = std::cout.rdbuf(NULL);  // the turns print every loop
+
+    // a loop around the center tower, each drive starts where the last one ends
+    std::vector<goal> goals = {{0, 72}, {72, 72}, {72, 0}, {36, 0}};
+    std::vector<int> uids;
+    for(const goal& point : goals) {
+        uids.push_back(chassis.drive_to_point_planned(point.x, point.y, 300, INT32_MAX, true));
+    }
+    int log_count = host::get_log_count();
+    int extra = chassis.drive_to_point_planned(0, 72, 300, INT32_MAX, true);
+    std::string refused = host::get_last_log();
+    bool logged = host::get_log_count() == log_count + 1;
+
+    for(int uid : uids) {
+        if(uid != -1) {
+            chassis.wait_until_finished(uid);
+        }
+    }
+    double loop_error = distance_to(goals.back());
+
+    // drives can be queued again once the ones using the trajectories are done
+    int after = chassis.drive_to_point_planned(0, 36, 300, INT32_MAX, false);
+    double after_error = distance_to({0, 36});
+
+    // where a drive that is not planned leaves the robot is not known
+    int unplanned = chassis.okapi_pid_straight_drive(1000, 11000, INT32_MAX, true);
+    int behind = chassis.drive_to_point_planned(36, 36, 300, INT32_MAX, true);
+    std::string behind_log = host::get_last_log();
+    chassis.wait_until_finished(unplanned);
+
+    std::cout.rdbuf(console);
+    host::stop_tasks();
+
+    std::printf("    queued: %d %d %d %d, one more: %d\n", uids.at(0) != -1, uids.at(1) != -1, uids.at(2) != -1, uids.at(3) != -1, extra);
+    if(extra != -1 || !logged || refused.find("planned drives queued") == std::string::npos) {
+        std::printf("a planned drive was queued over a trajectory that was still in use\n");
+        errors += 1;
+    }
+    for(int uid : uids) {
+        errors += uid == -1 ? 1 : 0;
+    }
+
+    std::printf("    stopped %.2f in from the end of the queued loop, %.2f in from a drive queued after it\n", loop_error, after_error);
+    if(loop_error > ALLOWED_ERROR || after == -1 || after_error > ALLOWED_ERROR) {
+        std::printf("queued planned drives were not planned from where the one before ends\n");
+        errors += 1;
+    }
+
+    std::printf("    planned drive behind an unplanned one: %d\n", behind);
+    if(behind != -1 || behind_log.find("not planned") == std::string::npos) {
+        errors += 1;
+    }
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,50 @@
+#!/bin/bash
+# builds the tests and benchmarks in this directory against the robot code
+# with the computer's compiler and runs them
+# usage: ./run_host_tests.sh [name ...] to only run some of them
+# exits with the number of programs that failed to build or run
+
+cd "$(dirname "$0")"
+CXX=${CXX:-g++}
+FLAGS="-std=gnu++17 -O2 -pthread -DHOST_BUILD -I. -I../include -I../src"  # . first so okapi/api.hpp here is used
+SRC=../src/objects
+# chassis.cpp and what it needs, run against the simulated drivetrain
+CHASSIS="drivetrain_sim.cpp $SRC/subsystems/chassis.cpp $SRC/motion_planning/FieldModel.cpp $SRC/motion_planning/PathPlanner.cpp $SRC/motion_planning/Trajectory.cpp $SRC/diagnostics/TaskStats.cpp $SRC/diagnostics/AllocationTracker.cpp $SRC/diagnostics/Clock.cpp $SRC/diagnostics/Telemetry.cpp ../src/Configuration.cpp ../src/ConfigurationJson.cpp"
+mkdir -p bin
+
+all="ball_tracker_test indexer_alloc_test indexer_queue_test cycle_planner_test blackbox_test ui_thread_test screen_manager_test path_planner_test wall_relocalizer_test turn_test estimate_test input_recorder_test startup_graph_test task_stats_test action_test trajectory_test planned_drive_test battery_compensator_test"
+declare -A sources
+sources[ball_tracker_test]="$SRC/subsystems/BallTracker.cpp $SRC/sensors/BallDetector.cpp $SRC/diagnostics/AllocationTracker.cpp"
+sources[indexer_alloc_test]="$SRC/subsystems/Indexer.cpp $SRC/subsystems/BallTracker.cpp $SRC/subsystems/CyclePlanner.cpp $SRC/sensors/BallDetector.cpp $SRC/diagnostics/AllocationTracker.cpp $SRC/diagnostics/TaskStats.cpp $SRC/diagnostics/Clock.cpp"
+sources[indexer_queue_test]="${sources[indexer_alloc_test]}"
+sources[battery_compensator_test]="$SRC/motors/BatteryCompensator.cpp"
+sources[cycle_planner_test]="$SRC/subsystems/CyclePlanner.cpp"
+sources[blackbox_test]="$SRC/serial/BlackBox.cpp"
+sources[path_planner_test]="$SRC/motion_planning/FieldModel.cpp $SRC/motion_planning/PathPlanner.cpp $SRC/motion_planning/Trajectory.cpp"
+sources[trajectory_test]="$SRC/motion_planning/Trajectory.cpp"
+sources[wall_relocalizer_test]="$SRC/position_tracking/WallRelocalizer.cpp $SRC/diagnostics/Clock.cpp"
+sources[screen_manager_test]="$SRC/lcdCode/ScreenManager.cpp"
+sources[turn_test]="$CHASSIS"
+sources[estimate_test]="$CHASSIS"
+sources[planned_drive_test]="$CHASSIS"
+sources[action_test]="$CHASSIS $SRC/actions/RobotActions.cpp"
+sources[input_recorder_test]="$SRC/controller/InputRecorder.cpp drivetrain_sim.cpp"
+sources[startup_graph_test]="$SRC/startup/StartupGraph.cpp"
+sources[task_stats_test]="$SRC/diagnostics/TaskStats.cpp $SRC/diagnostics/AllocationTracker.cpp $SRC/diagnostics/Clock.cpp"
+sources[ui_thread_test]="$SRC/lcdCode/UIThread.cpp $SRC/diagnostics/TaskStats.cpp $SRC/diagnostics/AllocationTracker.cpp $SRC/diagnostics/Clock.cpp"
+
+declare -A flags  # extra flags for one program
+flags[blackbox_test]='-DBLACKBOX_FILE_FORMAT="bin/bbox%02d.bin"'
+
+failures=0
+names=${@:-$all}
+for name in $names; do
+    echo "== $name"
+    if ! $CXX $FLAGS ${flags[$name]} -o bin/$name $name.cpp host_stubs.cpp ${sources[$name]}; then
+        failures=$((failures + 1))
+    elif ! ./bin/$name; then
+        failures=$((failures + 1))
+    fi
+done
+
+exit $failures
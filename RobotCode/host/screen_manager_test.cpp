@@ -0,0 +1,173 @@
+/**
+ * @file: ./RobotCode/host/screen_manager_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * opens debugger tabs in a random order through ScreenManager the way
+ * debug() does and compares the lvgl objects alive against making every
+ * tab up front like debug() used to
+ * screens are stand ins that take one block of a simulated kernel heap
+ * per lvgl object their constructor makes, counted from the lv_*_create
+ * calls in each screen, widgets made in a loop are counted once
+ * also checks get_report against the cache and that a low heap frees
+ * cached screens
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "objects/lcdCode/ScreenManager.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define OBJECT_BYTES 100  // simulated heap per lvgl object
+#define START_HEAP (1024 * 1024)
+#define TAB_OPENS 1000
+#define NUM_TABS 10
+
+
+namespace
+{
+    int free_heap = START_HEAP;
+    int live_objects = 0;
+    int peak_objects = 0;
+}
+
+// ScreenManager reads the free kernel heap from freertos
+extern "C" std::size_t xPortGetFreeHeapSize(void)
+{
+    return free_heap;
+}
+
+
+template <int OBJECTS>
+class TestScreen
+{
+    public:
+        TestScreen() {
+            free_heap -= OBJECTS * OBJECT_BYTES;
+            live_objects += OBJECTS;
+            peak_objects = std::max(peak_objects, live_objects);
+        }
+
+        ~TestScreen() {
+            free_heap += OBJECTS * OBJECT_BYTES;
+            live_objects -= OBJECTS;
+        }
+};
+
+typedef TestScreen<5> TitleScreen;
+typedef TestScreen<19> MotorsDebug;
+typedef TestScreen<5> SensorsDebug;
+typedef TestScreen<23> ControllerDebug;
+typedef TestScreen<6> BatteryDebug;
+typedef TestScreen<6> FieldControlDebug;
+typedef TestScreen<6> Wiring;
+typedef TestScreen<28> InternalMotorDebug;
+typedef TestScreen<8> MemoryDebug;
+typedef TestScreen<9> TasksDebug;
+typedef TestScreen<7> ChartsDebug;
+
+
+
+/**
+ * same ids and names as debug()
+ */
+void open_tab(ScreenManager& screens, int option)
+{
+    switch(option) {
+        case 1: screens.get<MotorsDebug>(1, "Motors"); break;
+        case 2: screens.get<SensorsDebug>(2, "Sensors"); break;
+        case 3: screens.get<ControllerDebug>(3, "Controller"); break;
+        case 4: screens.get<BatteryDebug>(4, "Battery"); break;
+        case 5: screens.get<FieldControlDebug>(5, "Field Control"); break;
+        case 6: screens.get<Wiring>(6, "Wiring"); break;
+        case 7: screens.get<InternalMotorDebug>(7, "Internal Motor PID"); break;
+        case 8: screens.get<MemoryDebug>(8, "Memory"); break;
+        case 9: screens.get<TasksDebug>(9, "Tasks"); break;
+        case 10: screens.get<ChartsDebug>(10, "Charts"); break;
+    }
+}
+
+
+
+int count_screens(const std::string& report)
+{
+    return std::count(report.begin(), report.end(), ';');
+}
+
+
+
+int main()
+{
+    int errors = 0;
+
+    // every tab made before the title screen is shown
+    {
+        TitleScreen title;
+        ScreenManager screens(NUM_TABS);
+        for(int option = 1; option <= NUM_TABS; option++) {
+            open_tab(screens, option);
+        }
+    }
+    int before_objects = peak_objects;
+
+    // tabs made when they are opened
+    peak_objects = 0;
+    int startup_objects;
+    int most_cached = 0;
+    std::string report;
+    {
+        TitleScreen title;
+        ScreenManager screens;
+        startup_objects = live_objects;
+
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> tab(1, NUM_TABS);
+        for(int i = 0; i < TAB_OPENS; i++) {
+            open_tab(screens, tab(rng));
+            report = screens.get_report();
+            most_cached = std::max(most_cached, count_screens(report));
+        }
+
+        // the report lists what is cached and its heap
+        int cached_objects = live_objects - startup_objects;
+        int reported_bytes = 0;
+        for(std::size_t start = 0, end; (end = report.find(';', start)) != std::string::npos; start = end + 1) {
+            reported_bytes += std::stoi(report.substr(report.find(',', start) + 1, end));
+        }
+        std::string expected_end = "free," + std::to_string(free_heap) + ",min free," + std::to_string(ScreenManager::get_min_free_heap());
+        if(reported_bytes != cached_objects * OBJECT_BYTES || report.compare(report.size() - expected_end.size(), std::string::npos, expected_end) != 0) {
+            std::printf("report does not match the cache: %s\n", report.c_str());
+            errors += 1;
+        }
+
+        // low heap leaves only the screen that was asked for
+        screens.clear();
+        open_tab(screens, 1);
+        open_tab(screens, 2);
+        free_heap = SCREEN_MIN_FREE_HEAP + OBJECT_BYTES;  // both cached tabs have to be freed to get back above it
+        open_tab(screens, 3);
+        if(count_screens(screens.get_report()) != 1) {
+            std::printf("screens were kept with the heap low: %s\n", screens.get_report().c_str());
+            errors += 1;
+        }
+    }
+    if(most_cached > SCREEN_CACHE_SIZE || live_objects != 0) {
+        std::printf("%d screens cached, %d objects left after the debugger closed\n", most_cached, live_objects);
+        errors += 1;
+    }
+
+    std::printf("screen manager\n");
+    std::printf("    lvgl objects when the title screen is shown: all tabs up front %d, cached %d\n", before_objects, startup_objects);
+    std::printf("    most lvgl objects alive over %d tab opens: all tabs up front %d, cached %d\n", TAB_OPENS, before_objects, peak_objects);
+    std::printf("    last report: %s\n", report.c_str());
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
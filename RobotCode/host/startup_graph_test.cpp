@@ -0,0 +1,223 @@
+/**
+ * @file: ./RobotCode/host/startup_graph_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * runs the startup stages initialize() uses against simulated devices that
+ * take as long as the real ones to respond
+ * checks that every stage starts after the stages it depends on, that
+ * independent stages run in parallel, that optional stages that hang are
+ * timed out without holding up startup, and that startup finishes degraded
+ * with only the dependents of a failed required stage skipped
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "objects/startup/StartupGraph.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define PACE 20  // us of real time per simulated ms so stage tasks start before the clock moves on
+#define ALLOWED_OVERHEAD 50  // ms past the slowest chain of stages that run() can take
+#define IMU_TIMEOUT 3500  // ms, the same as initialize()
+#define SENSORS_TIMEOUT 500  // ms, the same as initialize()
+
+
+typedef struct {
+    int latency;  // ms the device takes to respond
+    bool result;  // what the stage returns
+} device;
+
+typedef struct {
+    int start = -1;  // ms, -1 if the stage never ran
+    int end = -1;  // ms, -1 if it has not returned
+} stage_times;
+
+
+namespace
+{
+    std::mutex times_lock;
+    std::map<std::string, stage_times> times;
+}
+
+
+
+/**
+ * @return: std::function<bool()> -> a stage that waits on a device for its latency
+ *
+ * waits on the clock without delaying so it takes as long as the device
+ * no matter how many stages are running at once
+ */
+std::function<bool()> simulate(const std::string& name, device simulated)
+{
+    return [name, simulated]() {
+        int start = pros::millis();
+        {
+            std::lock_guard<std::mutex> guard(times_lock);
+            times[name].start = start;
+        }
+        while(pros::millis() < start + simulated.latency) {
+            std::this_thread::yield();
+        }
+        std::lock_guard<std::mutex> guard(times_lock);
+        times[name].end = pros::millis();
+        return simulated.result;
+    };
+}
+
+
+
+/**
+ * @return: None
+ *
+ * adds the same stages and dependencies as initialize(), ids is filled with the id of each stage
+ */
+void add_stages(StartupGraph& startup, std::map<std::string, device> devices, std::map<std::string, int>& ids)
+{
+    times.clear();
+    ids["motors"] = startup.add_stage("motors", simulate("motors", devices["motors"]));
+    ids["config"] = startup.add_stage("config", simulate("config", devices["config"]), {ids["motors"]}, STARTUP_NO_TIMEOUT, false);
+    ids["blackbox"] = startup.add_stage("blackbox", simulate("blackbox", devices["blackbox"]), {ids["config"]}, STARTUP_NO_TIMEOUT, false);
+    ids["imu"] = startup.add_stage("imu", simulate("imu", devices["imu"]), {}, IMU_TIMEOUT, false);
+    ids["sensors"] = startup.add_stage("sensors", simulate("sensors", devices["sensors"]), {ids["config"]}, SENSORS_TIMEOUT, false);
+    ids["lcd"] = startup.add_stage("lcd", simulate("lcd", devices["lcd"]));
+    ids["auton"] = startup.add_stage("auton", simulate("auton", devices["auton"]), {ids["config"], ids["lcd"]});
+}
+
+
+
+/**
+ * @return: int -> the number of stages that started before a stage they depend on returned
+ */
+int check_order(const std::map<std::string, std::vector<std::string>>& dependencies)
+{
+    int errors = 0;
+    for(const auto& stage : dependencies) {
+        for(const std::string& dependency : stage.second) {
+            stage_times before = times[dependency];
+            stage_times after = times[stage.first];
+            if(after.start != -1 && (before.end == -1 || after.start < before.end)) {
+                std::printf("%s started at %d ms before %s returned at %d ms\n", stage.first.c_str(), after.start, dependency.c_str(), before.end);
+                errors += 1;
+            }
+        }
+    }
+    return errors;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("startup graph\n");
+
+    host::run_tasks(true);
+    host::pace_time(PACE);
+    const std::map<std::string, std::vector<std::string>> dependencies = {
+        {"config", {"motors"}}, {"blackbox", {"config"}}, {"sensors", {"config"}}, {"auton", {"config", "lcd"}}
+    };
+
+    // every device responds, the imu and the auton selection are the slow ones
+    {
+        StartupGraph startup;
+        std::map<std::string, int> ids;
+        add_stages(startup, {
+            {"motors", {20, true}}, {"config", {150, true}}, {"blackbox", {40, true}}, {"imu", {2100, true}},
+            {"sensors", {60, true}}, {"lcd", {1600, true}}, {"auton", {30, true}}
+        }, ids);
+        host::set_time(0);
+        bool healthy = startup.run();
+        int slowest = std::max(2100, 1600 + 30);  // imu alone, or selecting an auton then planning it
+
+        std::printf("    healthy startup: %d ms, slowest chain of stages: %d ms\n", startup.get_total_time(), slowest);
+        errors += check_order(dependencies);
+        if(!healthy || startup.is_degraded() || startup.get_total_time() > slowest + ALLOWED_OVERHEAD || startup.get_total_time() < slowest) {
+            std::printf("healthy startup did not finish in parallel without being degraded\n");
+            errors += 1;
+        }
+        if(times["imu"].start > ALLOWED_OVERHEAD || times["lcd"].start > ALLOWED_OVERHEAD) {
+            std::printf("stages with no dependencies did not start right away\n");
+            errors += 1;
+        }
+    }
+
+    // no sd card, no imu, and a sensor that never answers, all optional
+    {
+        StartupGraph startup;
+        std::map<std::string, int> ids;
+        add_stages(startup, {
+            {"motors", {20, true}}, {"config", {5, false}}, {"blackbox", {5, false}}, {"imu", {IMU_TIMEOUT * 2, true}},
+            {"sensors", {SENSORS_TIMEOUT * 4, true}}, {"lcd", {1600, true}}, {"auton", {30, true}}
+        }, ids);
+        host::set_time(0);
+        bool healthy = startup.run();
+        int total = startup.get_total_time();
+
+        std::printf("    startup without an sd card, imu, or sensors: %d ms\n", total);
+        errors += check_order(dependencies);
+        if(healthy || !startup.is_degraded()) {
+            std::printf("startup with failed stages was not degraded\n");
+            errors += 1;
+        }
+        if(total < IMU_TIMEOUT || total > IMU_TIMEOUT + ALLOWED_OVERHEAD) {
+            std::printf("startup waited %d ms instead of timing out the imu at %d ms\n", total, IMU_TIMEOUT);
+            errors += 1;
+        }
+        if(times["imu"].end != -1 || times["sensors"].end < SENSORS_TIMEOUT * 4 || startup.succeeded(ids["sensors"])) {  // sensors returns true after it timed out
+            std::printf("hung stages were not timed out\n");
+            errors += 1;
+        }
+        if(times["blackbox"].start == -1 || times["sensors"].start == -1 || !startup.succeeded(ids["auton"])) {
+            std::printf("stages depending on the optional config stage did not run\n");
+            errors += 1;
+        }
+
+        // timed out stages keep running, when they return they still count as failed
+        host::advance_time(IMU_TIMEOUT * 2);
+        while(times["imu"].end == -1 || times["sensors"].end == -1) {
+            std::this_thread::yield();
+        }
+        if(startup.succeeded(ids["imu"]) || startup.succeeded(ids["sensors"])) {
+            std::printf("a timed out stage was marked done when it returned\n");
+            errors += 1;
+        }
+        std::printf("    imu and sensors timed out and stayed failed after returning\n");
+    }
+
+    // a required stage fails, only the stages that depend on it are skipped
+    {
+        StartupGraph startup;
+        std::map<std::string, int> ids;
+        add_stages(startup, {
+            {"motors", {20, true}}, {"config", {150, true}}, {"blackbox", {40, true}}, {"imu", {2100, true}},
+            {"sensors", {60, true}}, {"lcd", {1600, false}}, {"auton", {30, true}}
+        }, ids);
+        host::set_time(0);
+        bool healthy = startup.run();
+
+        bool skipped = times["auton"].start == -1;
+        bool ran = true;
+        for(const std::string& name : {"motors", "config", "blackbox", "imu", "sensors"}) {
+            ran = ran && startup.succeeded(ids[name]);
+        }
+        std::printf("    auton selection failed: planning %s, other stages %s\n", skipped ? "skipped" : "ran", ran ? "ran" : "did not all run");
+        if(healthy || !skipped || !ran) {
+            errors += 1;
+        }
+    }
+
+    host::stop_tasks();
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file: ./RobotCode/host/task_stats_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * registers threads that run on stacks placed in the middle of a buffer
+ * with TaskStats, giving it the real stack depth, more than the real depth,
+ * and less than it
+ * checks that painting never writes a byte outside the stack, starts at the
+ * real bottom when the depth reaches past it, and that the stack use
+ * reported for a thread covers what it used after registering
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <pthread.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "objects/diagnostics/TaskStats.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define STACK_SIZE 65536  // bytes of each thread stack
+#define GUARD_SIZE 4096  // bytes on either side of the stack that must not be written
+#define FILL 0x5A  // what the buffer starts as, different from the pattern
+#define USED_BYTES 8192  // bytes each thread uses after registering
+
+
+typedef struct {
+    const char* name;
+    int stack_depth;  // words given to register_current_task
+    std::atomic<bool> registered{false};
+    std::atomic<bool> release{false};
+} stack_case;
+
+
+namespace
+{
+    alignas(4096) unsigned char buffer[GUARD_SIZE + STACK_SIZE + GUARD_SIZE];
+}
+
+
+
+/**
+ * @return: int -> the sum of the bytes used, so the array is not optimized out
+ */
+__attribute__((noinline)) int use_stack(int bytes)
+{
+    volatile unsigned char used[USED_BYTES];
+    for(int i = 0; i < bytes && i < USED_BYTES; i++) {
+        used[i] = i;
+    }
+    return used[0] + used[bytes - 1];
+}
+
+
+
+void* run_case(void* args)
+{
+    stack_case* test = static_cast<stack_case*>(args);
+    TaskStats::register_current_task(test->name, 0, test->stack_depth);
+    use_stack(USED_BYTES);
+    test->registered = true;
+    while(!test->release) {  // stays alive so its stack use is reported
+        std::this_thread::yield();
+    }
+    return NULL;
+}
+
+
+
+/**
+ * @return: task_report -> the report for the task, the name is empty if it is not found
+ */
+task_report find_report(const char* name)
+{
+    for(const task_report& report : TaskStats::get_reports()) {
+        if(report.name == name) {
+            return report;
+        }
+    }
+    return task_report();
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("task stats stack painting\n");
+
+    unsigned char* stack = buffer + GUARD_SIZE;
+    const std::uint32_t pattern = TASK_STATS_STACK_PATTERN;
+    stack_case cases[3];
+    cases[0].name = "real depth";
+    cases[0].stack_depth = STACK_SIZE / TASK_STATS_WORD_SIZE;
+    cases[1].name = "twice the depth";
+    cases[1].stack_depth = 2 * STACK_SIZE / TASK_STATS_WORD_SIZE;
+    cases[2].name = "quarter of the depth";
+    cases[2].stack_depth = STACK_SIZE / TASK_STATS_WORD_SIZE / 4;
+
+    for(stack_case& test : cases) {
+        std::memset(buffer, FILL, sizeof(buffer));
+
+        pthread_attr_t attributes;
+        pthread_attr_init(&attributes);
+        pthread_attr_setstack(&attributes, stack, STACK_SIZE);
+        pthread_t thread;
+        if(pthread_create(&thread, &attributes, run_case, &test) != 0) {
+            std::printf("could not start a thread on the buffer\n");
+            return 1;
+        }
+        pthread_attr_destroy(&attributes);
+        while(!test.registered) {
+            std::this_thread::yield();
+        }
+        task_report report = find_report(test.name);
+        test.release = true;
+        pthread_join(thread, NULL);
+
+        int written = 0;
+        for(int i = 0; i < GUARD_SIZE; i++) {
+            written += buffer[i] != FILL ? 1 : 0;
+            written += buffer[GUARD_SIZE + STACK_SIZE + i] != FILL ? 1 : 0;
+        }
+
+        // the lowest painted word, painting has to reach the real bottom only if the depth does
+        int lowest = -1;
+        for(int offset = 0; offset < STACK_SIZE && lowest == -1; offset += TASK_STATS_WORD_SIZE) {
+            lowest = std::memcmp(stack + offset, &pattern, sizeof(pattern)) == 0 ? offset : -1;
+        }
+        bool reaches_bottom = test.stack_depth * TASK_STATS_WORD_SIZE >= STACK_SIZE;
+
+        std::printf(
+            "    %-20s  bytes written outside the stack: %d, painted from %d bytes above the bottom, used %d of %d bytes\n",
+            test.name, written, lowest, report.stack_used, report.stack_size
+        );
+        if(written != 0) {
+            errors += 1;
+        }
+        if(lowest == -1 || (reaches_bottom && lowest != 0) || (!reaches_bottom && lowest == 0)) {
+            std::printf("%s: painting did not start at the right place\n", test.name);
+            errors += 1;
+        }
+        // the frame of register_current_task overlaps the start of what was used
+        if(report.name != test.name || report.stack_used < USED_BYTES - TASK_STATS_TOP_MARGIN || report.stack_used > report.stack_size) {
+            std::printf("%s: stack use was not reported\n", test.name);
+            errors += 1;
+        }
+    }
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file: ./RobotCode/host/trajectory_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * generates trajectories through straight, curved, tight, and reversed paths
+ * and checks that every sample keeps to the velocity, acceleration,
+ * centripetal, and track width limits, that time only goes forward, that the
+ * ends are at the first and last waypoints with the velocities they were
+ * given, and that sampling between samples moves smoothly
+ * then times generating random paths across the field and reports the time
+ * per meter of path and the memory each trajectory takes
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "objects/motion_planning/Trajectory.hpp"
+
+
+
+#define TOLERANCE 1e-3  // of a limit, samples are stored as floats
+#define POSITION_TOLERANCE 1e-3  // in
+#define SAMPLE_STEP 0.005  // s between calls to sample
+#define BENCHMARK_PATHS 500
+#define FIELD_SIZE 144  // in
+#define INCHES_PER_METER 39.37
+#define SEED 3
+
+
+typedef struct {
+    const char* name;
+    std::vector<spline_point> points;
+    trajectory_constraints constraints;
+} trajectory_case;
+
+
+
+/**
+ * @return: bool -> if two samples are at the same place with the same velocity
+ */
+bool same_sample(const trajectory_sample& a, const trajectory_sample& b)
+{
+    return std::abs(a.x - b.x) < POSITION_TOLERANCE && std::abs(a.y - b.y) < POSITION_TOLERANCE && std::abs(a.velocity - b.velocity) < POSITION_TOLERANCE;
+}
+
+
+
+/**
+ * @return: int -> the number of ways the trajectory breaks its constraints
+ */
+int check_limits(const trajectory_case& test, const Trajectory& trajectory)
+{
+    int errors = 0;
+    const trajectory_constraints& limits = test.constraints;
+    const trajectory_sample* samples = trajectory.data();
+    int direction = limits.reversed ? -1 : 1;
+
+    const trajectory_sample& first = samples[0];
+    const trajectory_sample& last = samples[trajectory.size() - 1];
+    if(
+        std::abs(first.x - test.points.front().x) > POSITION_TOLERANCE || std::abs(first.y - test.points.front().y) > POSITION_TOLERANCE
+        || std::abs(last.x - test.points.back().x) > POSITION_TOLERANCE || std::abs(last.y - test.points.back().y) > POSITION_TOLERANCE
+        || std::abs(first.velocity - (direction * limits.start_velocity)) > POSITION_TOLERANCE
+        || std::abs(last.velocity - (direction * limits.end_velocity)) > POSITION_TOLERANCE
+        || first.time != 0
+    ) {
+        std::printf("%s: endpoints are wrong\n", test.name);
+        errors += 1;
+    }
+
+    for(int i = 0; i < trajectory.size(); i++) {
+        const trajectory_sample& point = samples[i];
+        double speed = std::abs(point.velocity);
+        double curvature = std::abs(point.curvature);
+        bool broken = (
+            point.velocity * direction < 0
+            || speed > limits.max_velocity * (1 + TOLERANCE)
+            || speed * speed * curvature > limits.max_centripetal_acceleration * (1 + TOLERANCE)
+            || speed * (1 + (curvature * limits.track_width / 2)) > limits.max_velocity * (1 + TOLERANCE)
+            || point.theta > M_PI || point.theta < -M_PI
+        );
+        if(i > 0) {
+            const trajectory_sample& previous = samples[i - 1];
+            double dt = point.time - previous.time;
+            broken = broken || dt <= 0 || std::abs(point.velocity - previous.velocity) / dt > limits.max_acceleration * (1 + TOLERANCE);
+        }
+        if(broken) {
+            std::printf("%s: sample %d at %.3f s breaks a limit, velocity %.2f, curvature %.4f\n", test.name, i, point.time, point.velocity, point.curvature);
+            errors += 1;
+            break;
+        }
+    }
+
+    return errors;
+}
+
+
+
+/**
+ * @return: int -> the number of ways sampling the trajectory is wrong
+ */
+int check_sampling(const trajectory_case& test, const Trajectory& trajectory)
+{
+    int errors = 0;
+    double duration = trajectory.get_duration();
+    const trajectory_sample& first = trajectory.data()[0];
+    const trajectory_sample& last = trajectory.data()[trajectory.size() - 1];
+    if(!same_sample(trajectory.sample(0), first) || !same_sample(trajectory.sample(duration), last) || !same_sample(trajectory.sample(duration + 1), last)) {
+        std::printf("%s: sampling at the ends does not give the ends\n", test.name);
+        errors += 1;
+    }
+
+    // between samples it can not move faster than the max velocity or jump
+    trajectory_sample previous = trajectory.sample(0);
+    for(double t = SAMPLE_STEP; t < duration + SAMPLE_STEP; t += SAMPLE_STEP) {
+        trajectory_sample point = trajectory.sample(t);
+        double moved = std::hypot(point.x - previous.x, point.y - previous.y);
+        if(moved > test.constraints.max_velocity * SAMPLE_STEP * (1 + TOLERANCE) + POSITION_TOLERANCE || std::abs(point.velocity) > test.constraints.max_velocity * (1 + TOLERANCE)) {
+            std::printf("%s: sample at %.3f s moved %.3f in from the last one\n", test.name, t, moved);
+            errors += 1;
+            break;
+        }
+        previous = point;
+    }
+
+    return errors;
+}
+
+
+
+/**
+ * @return: int -> the number of headings outside [-pi, pi] after moving the trajectory into turned frames
+ */
+int check_transform(const Trajectory& trajectory)
+{
+    int errors = 0;
+    for(double theta : {3.0, -3.0, 7.0}) {
+        Trajectory moved = trajectory;
+        moved.transform(10, -5, theta);
+        for(int i = 0; i < moved.size(); i++) {
+            double heading = moved.data()[i].theta;
+            double expected = trajectory.data()[i].theta + theta;
+            if(heading > M_PI || heading < -M_PI || std::abs(std::remainder(heading - expected, 2 * M_PI)) > TOLERANCE) {
+                errors += 1;
+                break;
+            }
+        }
+    }
+    return errors;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("trajectories\n");
+
+    std::vector<trajectory_case> cases;
+    trajectory_constraints constraints;
+    cases.push_back({"straight", {{0, 0}, {0, 48}}, constraints});
+    constraints.track_width = 16;
+    cases.push_back({"s curve", {{0, 0}, {24, 24}, {0, 48}, {24, 72}}, constraints});
+    constraints.max_centripetal_acceleration = 20;
+    cases.push_back({"tight curve", {{0, 0}, {12, 12}, {0, 24}, {-12, 12}}, constraints});
+    constraints.reversed = true;
+    constraints.start_velocity = 10;
+    constraints.end_velocity = 5;
+    cases.push_back({"reversed, moving at the ends", {{0, 0}, {-10, -30}, {-40, -40}}, constraints});
+    constraints = trajectory_constraints();
+    spline_point turned = {24, 24, M_PI, true};
+    cases.push_back({"fixed heading", {{0, 0}, turned, {48, 0}}, constraints});
+
+    for(const trajectory_case& test : cases) {
+        Trajectory trajectory;
+        if(!trajectory.generate(test.points, test.constraints)) {
+            std::printf("%s: could not be generated\n", test.name);
+            errors += 1;
+            continue;
+        }
+        int case_errors = check_limits(test, trajectory) + check_sampling(test, trajectory) + check_transform(trajectory);
+        std::printf("    %-30s %5.1f in, %.3f s, %d samples\n", test.name, trajectory.get_length(), trajectory.get_duration(), trajectory.size());
+        errors += case_errors;
+    }
+
+    // a straight line has a trapezoidal profile, 40 in/s reached after 0.667 s
+    Trajectory straight;
+    straight.generate(cases.front().points, cases.front().constraints);
+    double expected = (2 * 40.0 / 60) + ((48 - (40.0 * 40 / 60)) / 40);
+    if(std::abs(straight.get_duration() - expected) > 0.02 * expected) {
+        std::printf("straight trajectory takes %.3f s instead of %.3f s\n", straight.get_duration(), expected);
+        errors += 1;
+    }
+
+    Trajectory empty;
+    if(empty.generate({{0, 0}, {0, 0}}, trajectory_constraints()) || empty.size() != 0) {
+        std::printf("a trajectory with one distinct point was generated\n");
+        errors += 1;
+    }
+    std::printf("    limits, time, endpoints, sampling, and turned headings checked\n");
+
+    // random paths of 3 to 8 waypoints across the field
+    std::mt19937 generator(SEED);
+    std::uniform_real_distribution<double> coordinate(0, FIELD_SIZE);
+    std::uniform_int_distribution<int> num_points(3, 8);
+    constraints = trajectory_constraints();
+    constraints.track_width = 16;
+    double total_time = 0;
+    double total_length = 0;
+    double total_memory = 0;
+    int generated = 0;
+    for(int i = 0; i < BENCHMARK_PATHS; i++) {
+        std::vector<spline_point> points(num_points(generator));
+        for(spline_point& point : points) {
+            point.x = coordinate(generator);
+            point.y = coordinate(generator);
+        }
+
+        Trajectory trajectory;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool success = trajectory.generate(points, constraints);
+        total_time += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if(success) {
+            total_length += trajectory.get_length() / INCHES_PER_METER;
+            total_memory += trajectory.get_memory_usage();
+            generated += 1;
+        }
+    }
+    double meters = std::max(total_length, 1e-9);
+    std::printf(
+        "    %d of %d random paths, %.1f m average: %.1f us per meter, %.0f bytes per trajectory, %.0f bytes per meter\n",
+        generated, BENCHMARK_PATHS, total_length / std::max(generated, 1), total_time / meters,
+        total_memory / std::max(generated, 1), total_memory / meters
+    );
+    if(generated != BENCHMARK_PATHS) {
+        errors += 1;
+    }
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+/**
+ * @file: ./RobotCode/host/turn_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * checks the trapezoidal profile profiled turns follow, then runs
+ * Chassis::t_profiled_turn and Chassis::t_turn on the chassis task against
+ * the simulated drivetrain and compares how long they take to settle
+ * the rpm to yaw rate gain and the lag of the drive are randomized for every
+ * turn to stand in for battery and carpet differences
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "objects/motors/Motor.hpp"
+#include "objects/sensors/Sensors.hpp"
+#include "objects/subsystems/chassis.hpp"
+#include "drivetrain_sim.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define TRIALS 20  // turns of each angle with each controller
+#define MAX_VELOCITY 300  // rpm, the same as the python model this replaces
+#define TOLERANCE 1  // degrees
+#define PROFILE_STEP 0.0005  // s between samples when checking profiles
+#define SETTLE_TIME 300  // ms, profiled_turn_constants.settle_time
+#define PID_TIMEOUT 4000  // ms, t_turn is given the longest timeout autons used so it is timed by when it settles
+
+
+typedef struct {
+    int time;  // ms the command ran for
+    int predicted;  // ms
+    double error;  // degrees from the setpoint once stopped
+} turn_result;
+
+
+
+/**
+ * @return: int -> the number of ways the profile is wrong
+ *
+ * checks that the profile starts and ends at rest, reaches the distance at
+ * the duration trapezoidal_profile_duration gives, and keeps to its limits
+ */
+int check_profile(double distance, double max_velocity, double max_acceleration)
+{
+    int errors = 0;
+    double duration = trapezoidal_profile_duration(distance, max_velocity, max_acceleration);
+    profile_point start = sample_trapezoidal_profile(distance, max_velocity, max_acceleration, 0);
+    profile_point end = sample_trapezoidal_profile(distance, max_velocity, max_acceleration, duration);
+    profile_point after = sample_trapezoidal_profile(distance, max_velocity, max_acceleration, duration + 1);
+    if(start.position != 0 || start.velocity != 0 || std::abs(end.position - distance) > 1e-6 || std::abs(end.velocity) > 1e-6 || after.position != distance || after.velocity != 0) {
+        std::printf("profile of %.1f at %.0f/s: endpoints are wrong\n", distance, max_velocity);
+        errors += 1;
+    }
+
+    // a triangular profile has to be as short as accelerating for half and deccelerating for half
+    double t_accel = max_velocity / max_acceleration;
+    double expected = 2 * std::sqrt(std::abs(distance) / max_acceleration);
+    if(max_acceleration * t_accel * t_accel < std::abs(distance)) {
+        expected = (2 * t_accel) + ((std::abs(distance) - (max_acceleration * t_accel * t_accel)) / max_velocity);
+    }
+    if(std::abs(duration - expected) > 1e-9) {
+        std::printf("profile of %.1f at %.0f/s: lasts %.4f s instead of %.4f s\n", distance, max_velocity, duration, expected);
+        errors += 1;
+    }
+
+    profile_point previous = start;
+    int direction = distance < 0 ? -1 : 1;
+    for(double t = PROFILE_STEP; t < duration + PROFILE_STEP; t += PROFILE_STEP) {
+        profile_point point = sample_trapezoidal_profile(distance, max_velocity, max_acceleration, t);
+        double moved = (point.position - previous.position) * direction;
+        double average_velocity = (point.velocity + previous.velocity) * PROFILE_STEP / 2;
+        if(
+            std::abs(point.velocity) > max_velocity + 1e-9
+            || std::abs(point.acceleration) > max_acceleration + 1e-9
+            || moved < -1e-9
+            || std::abs(point.position - previous.position - average_velocity) > max_acceleration * PROFILE_STEP * PROFILE_STEP
+        ) {
+            std::printf("profile of %.1f at %.0f/s: breaks its limits at %.4f s\n", distance, max_velocity, t);
+            errors += 1;
+            break;
+        }
+        previous = point;
+    }
+
+    return errors;
+}
+
+
+
+/**
+ * @return: int -> the value after name in a log entry, -1 if it is not in the entry
+ */
+int log_field(const std::string& entry, const std::string& name)
+{
+    std::size_t start = entry.find(name + ": ");
+    if(start == std::string::npos) {
+        return -1;
+    }
+    return std::stoi(entry.substr(start + name.size() + 2));
+}
+
+
+
+/**
+ * @return: turn_result -> how long the turn took according to the chassis and where it stopped
+ */
+turn_result run_turn(Chassis& chassis, bool profiled, double degrees)
+{
+    host::set_pose({0, 0, 0});
+    int uid = profiled ? chassis.profiled_turn(degrees, MAX_VELOCITY, TOLERANCE, INT32_MAX, true) : chassis.turn_right(degrees, MAX_VELOCITY, PID_TIMEOUT, true);
+    while(!chassis.is_finished(uid)) {
+        std::this_thread::yield();  // the chassis task moves the clock
+    }
+    while(host::get_drive_speed() > 0) {  // let the robot come to rest where the command left it
+        host::advance_time(10);
+    }
+
+    std::string entry = host::get_last_log();
+    double heading = PositionTracker::to_degrees(host::get_pose().theta);
+    return {log_field(entry, "Actual_Time"), log_field(entry, "Predicted_Time"), degrees - heading};
+}
+
+
+
+void summarize(const char* name, std::vector<turn_result> results)
+{
+    std::sort(results.begin(), results.end(), [](const turn_result& a, const turn_result& b) { return a.time < b.time; });
+    double mean = 0;
+    double mean_error = 0;
+    for(const turn_result& result : results) {
+        mean += result.time / (double)results.size();
+        mean_error += std::abs(result.error) / results.size();
+    }
+    std::printf(
+        "    %10s  mean: %7.1f  p50: %5d  p90: %5d  max: %5d  mean |error|: %.2f\n",
+        name, mean, results.at(results.size() / 2).time, results.at(results.size() * 9 / 10).time, results.back().time, mean_error
+    );
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("turns\n");
+
+    for(double distance : {45.0, 90.0, -180.0, 600.0, 0.5}) {
+        for(double max_velocity : {100.0, 300.0}) {
+            errors += check_profile(distance, max_velocity, 900);
+        }
+    }
+    std::printf("    profile endpoints, durations, and limits checked\n");
+
+    host::run_tasks(true);
+    Motor front_left(1, pros::E_MOTOR_GEARSET_06, false);
+    Motor front_right(2, pros::E_MOTOR_GEARSET_06, true);
+    Motor back_left(3, pros::E_MOTOR_GEARSET_06, false);
+    Motor back_right(4, pros::E_MOTOR_GEARSET_06, true);
+    host::drivetrain_constants drive;
+    host::set_drivetrain(front_left, front_right, back_left, back_right, drive);
+    Chassis chassis(front_left, front_right, back_left, back_right, Sensors::left_encoder, Sensors::right_encoder, drive.width, 1, drive.wheel_diameter);
+
+    std::streambuf* console = std::cout.rdbuf(NULL);  // t_turn prints every loop
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> kV(1.2, 1.55);  // true rpm per deg/s, chassis.hpp assumes 1.37
+    std::uniform_real_distribution<double> time_constant(0.04, 0.08);
+
+    for(double degrees : {45.0, 90.0, 135.0, 180.0}) {
+        std::vector<turn_result> pid_results;
+        std::vector<turn_result> profiled_results;
+        for(int i = 0; i < TRIALS; i++) {
+            drive.width = 16 * kV(generator) / 1.368;  // 1.368 rpm per deg/s with a 16 in wide drive
+            drive.time_constant = time_constant(generator);
+            host::set_drivetrain(front_left, front_right, back_left, back_right, drive);
+            pid_results.push_back(run_turn(chassis, false, degrees));
+            profiled_results.push_back(run_turn(chassis, true, degrees));
+        }
+
+        std::printf("    turn of %.0f degrees, predicted profile time: %d ms\n", degrees, Chassis::predict_profiled_turn_time(degrees, MAX_VELOCITY));
+        summarize("t_turn", pid_results);
+        summarize("profiled", profiled_results);
+
+        // profiled turns have to stop in tolerance within the settle time past the
+        // profile, and should not be slower than the pid turn they replace
+        for(const turn_result& result : profiled_results) {
+            if(std::abs(result.error) > TOLERANCE || result.time > result.predicted + SETTLE_TIME) {
+                std::printf("profiled turn of %.0f degrees took %d ms and stopped %.2f degrees off\n", degrees, result.time, result.error);
+                errors += 1;
+            }
+        }
+        std::sort(pid_results.begin(), pid_results.end(), [](const turn_result& a, const turn_result& b) { return a.time < b.time; });
+        std::sort(profiled_results.begin(), profiled_results.end(), [](const turn_result& a, const turn_result& b) { return a.time < b.time; });
+        if(profiled_results.at(TRIALS * 9 / 10).time > pid_results.at(TRIALS * 9 / 10).time) {
+            std::printf("profiled turns of %.0f degrees settle slower than t_turn\n", degrees);
+            errors += 1;
+        }
+    }
+
+    std::cout.rdbuf(console);
+    host::stop_tasks();
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file: ./RobotCode/host/ui_thread_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * runs the ui thread on a thread with a screen that marks when it is using
+ * lvgl, then switches modes the way main.cpp does
+ * checks that showing the same screen again reloads it and that nothing
+ * else uses lvgl while the ui thread is drawing once clear_screen returns
+ * the old path of building the autonomous screen without clearing is also
+ * run to show how often it overlapped a frame
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "objects/lcdCode/UIThread.hpp"
+#include "host_stubs.hpp"
+
+
+
+#define MODE_CHANGES 50
+#define FRAME_TIME 300  // us each update takes
+#define BUILD_TIME 2000  // us the disabled screen takes to build
+#define CLEAR_TIMEOUT 1000000  // host time only moves when tasks delay so it can not time out the wait
+
+
+class TestScreen : public UIScreen
+{
+    public:
+        std::atomic<int> loads;
+        std::atomic<int> updates;
+        std::atomic<bool> drawing;
+
+        TestScreen() : loads(0), updates(0), drawing(false) { }
+
+        void load() override {
+            loads += 1;
+        }
+
+        void update() override {
+            drawing = true;
+            std::this_thread::sleep_for(std::chrono::microseconds(FRAME_TIME));
+            drawing = false;
+            updates += 1;
+        }
+};
+
+
+
+/**
+ * @return: bool -> false if the ui thread did not update the screen in time
+ */
+bool wait_for_updates(TestScreen& screen, int count)
+{
+    int start = screen.updates;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while(screen.updates - start < count) {
+        if(std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+
+
+/**
+ * @return: bool -> if the screen was drawing at any time while the
+ *                  disabled screen was being built
+ */
+bool build_disabled_screen(TestScreen& screen)
+{
+    bool overlapped = false;
+    auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(BUILD_TIME);
+    while(std::chrono::steady_clock::now() < end) {
+        overlapped = overlapped || screen.drawing;
+    }
+    return overlapped;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    host::run_tasks(true);
+    static TestScreen screen;
+    UIThread* ui = UIThread::get_instance();
+    ui->set_frame_period(1);
+    ui->start_thread();
+
+    // the same screen after the robot was disabled
+    ui->set_screen(&screen);
+    errors += wait_for_updates(screen, 2) ? 0 : 1;
+    ui->set_screen(&screen);
+    errors += wait_for_updates(screen, 2) ? 0 : 1;
+    int loads = screen.loads;
+
+    // disabled() building its screen while the driver screen is still shown
+    int old_overlaps = 0;
+    int new_overlaps = 0;
+    int timeouts = 0;
+    for(int i = 0; i < MODE_CHANGES; i++) {
+        ui->set_screen(&screen);
+        errors += wait_for_updates(screen, 1) ? 0 : 1;
+        old_overlaps += build_disabled_screen(screen) ? 1 : 0;
+
+        errors += wait_for_updates(screen, 1) ? 0 : 1;
+        timeouts += ui->clear_screen(CLEAR_TIMEOUT) ? 0 : 1;
+        new_overlaps += build_disabled_screen(screen) ? 1 : 0;
+    }
+    host::stop_tasks();
+
+    std::printf("ui thread\n");
+    std::printf("    loads after showing the same screen twice: %d\n", loads);
+    std::printf("    disabled screens built while a frame was drawing out of %d: without clear_screen %d, with clear_screen %d\n", MODE_CHANGES, old_overlaps, new_overlaps);
+    errors += loads != 2 || new_overlaps != 0 || timeouts != 0 ? 1 : 0;
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file: ./RobotCode/host/wall_relocalizer_test.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * simulates a skills run of straight legs along the field axes with
+ * odometry that drifts and a wall distance sensor that is noisy and is
+ * sometimes blocked, and compares the error with and without relocalization
+ * also checks how long it takes to pull a known error back in once the
+ * robot is square to a wall
+ * the sensor is mounted the same as it is on the robot
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "Configuration.hpp"
+#include "objects/position_tracking/WallRelocalizer.hpp"
+#include "objects/motion_planning/FieldModel.hpp"
+
+
+
+#define RUNS 50
+#define RUN_LENGTH 60000  // ms, a skills run
+#define TICK 5  // ms, the same as the odometry task
+#define SPEED 30  // in/s
+#define SCALE_ERROR 1.02  // odometry reads 2% more than was driven
+#define SLIP 0.01  // in of sideways slip per inch driven, standard deviation
+#define TURN_SLIP 0.003  // in of slip per tick while turning
+#define HEADING_DRIFT (M_PI / 180 / 60000)  // rad per ms, a degree per minute
+#define BLOCKED_READINGS 0.05  // something between the sensor and the wall
+#define LATENCY_ERROR 3  // in
+#define LATENCY_LIMIT 2000  // ms to get within 0.5 in of the truth
+
+
+typedef struct {
+    double final_error;
+    double worst_error;
+    double rms_error;
+    double mean_compute;  // us, the max in the stats also has the times the host was busy with something else
+    relocalization_stats stats;
+} run_result;
+
+
+
+distance_sensor_mount get_mount()
+{
+    return {WALL_DISTANCE_FORWARD, WALL_DISTANCE_LEFT, WALL_DISTANCE_ANGLE};
+}
+
+
+
+/**
+ * @return: double -> what the sensor would read from the true position with no noise
+ */
+double true_reading(const position& truth)
+{
+    WallRelocalizer oracle;
+    oracle.configure(get_mount(), relocalization_constants());
+    position pose = truth;
+    return oracle.update(pose, 1e9, 1).expected;  // a reading this far is never used
+}
+
+
+
+run_result simulate(int seed, bool relocalize, double noise_scale)
+{
+    std::mt19937 generator(seed);
+    std::normal_distribution<double> normal(0, 1);
+    std::uniform_real_distribution<double> uniform(0, 1);
+    relocalization_constants constants;
+    WallRelocalizer relocalizer;
+    relocalizer.configure(get_mount(), constants);
+
+    position truth;
+    truth.x_pos = 24;
+    truth.y_pos = 24;
+    position odometry = truth;
+    double heading_error = 0;
+    double error = 0;
+    double worst = 0;
+    double squared = 0;
+    int samples = 0;
+    int time = 0;
+    double compute = 0;
+    int updates = 0;
+
+    while(time < RUN_LENGTH) {
+        // a leg along one of the axes that stays off the walls, driven backwards half the time
+        double heading = (generator() % 4) * M_PI / 2;
+        double length = 12 + (36 * uniform(generator));
+        double end_x = truth.x_pos + (length * std::sin(heading));
+        double end_y = truth.y_pos + (length * std::cos(heading));
+        if(end_x < 18 || end_x > FIELD_WIDTH - 18 || end_y < 18 || end_y > FIELD_WIDTH - 18) {
+            continue;
+        }
+        bool reversed = uniform(generator) < 0.5;
+        double facing = reversed ? heading + M_PI : heading;
+        double turn = std::atan2(std::sin(facing - truth.theta), std::cos(facing - truth.theta));
+        int turn_ticks = 60 + (std::abs(turn) * 80);
+        int drive_ticks = length / (SPEED * TICK / 1000.0);
+
+        for(int tick = 0; tick < turn_ticks + drive_ticks && time < RUN_LENGTH; tick++) {
+            time += TICK;
+            heading_error += HEADING_DRIFT * TICK;
+            double driven = 0;
+            if(tick < turn_ticks) {
+                truth.theta += turn / turn_ticks;
+            } else {
+                driven = (reversed ? -length : length) / drive_ticks;
+            }
+            truth.x_pos += driven * std::sin(truth.theta);
+            truth.y_pos += driven * std::cos(truth.theta);
+
+            odometry.theta = truth.theta + heading_error;
+            double measured = driven * SCALE_ERROR;
+            double slip = (SLIP * std::abs(driven) * normal(generator)) + (tick < turn_ticks ? TURN_SLIP * normal(generator) : 0);
+            odometry.x_pos += (measured * std::sin(odometry.theta)) + (slip * std::cos(odometry.theta));
+            odometry.y_pos += (measured * std::cos(odometry.theta)) - (slip * std::sin(odometry.theta));
+
+            if(relocalize) {
+                relocalizer.predict(std::abs(measured));
+                if(time % WALL_RELOCALIZATION_PERIOD == 0) {
+                    double reading = true_reading(truth);
+                    reading += noise_scale * (constants.sensor_noise + (constants.sensor_noise_scale * reading)) * normal(generator) / 2;
+                    if(uniform(generator) < BLOCKED_READINGS) {
+                        reading /= 2;
+                    }
+                    relocalizer.update(odometry, reading, time);
+                    compute += relocalizer.get_stats().last_compute;
+                    updates += 1;
+                }
+            }
+
+            error = std::hypot(odometry.x_pos - truth.x_pos, odometry.y_pos - truth.y_pos);
+            worst = std::max(worst, error);
+            squared += error * error;
+            samples += 1;
+        }
+    }
+
+    return {error, worst, std::sqrt(squared / samples), updates ? compute / updates : 0, relocalizer.get_stats()};
+}
+
+
+
+/**
+ * @return: int -> ms until a LATENCY_ERROR in error is within 0.5 in, -1 if it never is
+ *
+ * the robot has driven 200 in since it was last corrected and is square
+ * to the left wall
+ */
+int correction_time(int& first_latency)
+{
+    std::mt19937 generator(9);
+    std::normal_distribution<double> normal(0, 1);
+    relocalization_constants constants;
+    WallRelocalizer relocalizer;
+    relocalizer.configure(get_mount(), constants);
+    relocalizer.predict(200);
+
+    position truth;
+    truth.x_pos = 33;
+    truth.y_pos = 72;
+    truth.theta = M_PI / 2;
+    position odometry = truth;
+    odometry.x_pos -= LATENCY_ERROR;
+
+    int time = 0;
+    while(std::abs(odometry.x_pos - truth.x_pos) > 0.5) {
+        if(time > LATENCY_LIMIT) {
+            return -1;
+        }
+        time += WALL_RELOCALIZATION_PERIOD;
+        double reading = true_reading(truth);
+        reading += (constants.sensor_noise + (constants.sensor_noise_scale * reading)) * normal(generator) / 2;
+        relocalizer.update(odometry, reading, time);
+    }
+    first_latency = relocalizer.get_stats().last_latency;
+
+    return time;
+}
+
+
+
+int main()
+{
+    int errors = 0;
+    std::printf("wall relocalizer\n");
+    std::printf("    mount: %.1f in forward, %.1f in left, facing %.0f degrees\n", (double)WALL_DISTANCE_FORWARD, (double)WALL_DISTANCE_LEFT, WALL_DISTANCE_ANGLE * 180 / M_PI);
+
+    for(double noise_scale : {1.0, 2.0}) {
+        run_result totals[2];
+        for(int relocalize = 0; relocalize < 2; relocalize++) {
+            totals[relocalize] = {0, 0, 0, 0, {0, 0, -1, 0, 0, 0}};
+            for(int seed = 0; seed < RUNS; seed++) {
+                run_result result = simulate(seed, relocalize, noise_scale);
+                totals[relocalize].final_error += result.final_error / RUNS;
+                totals[relocalize].rms_error += result.rms_error / RUNS;
+                totals[relocalize].mean_compute += result.mean_compute / RUNS;
+                totals[relocalize].worst_error = std::max(totals[relocalize].worst_error, result.worst_error);
+                totals[relocalize].stats.accepted += result.stats.accepted;
+                totals[relocalize].stats.rejected += result.stats.rejected;
+                totals[relocalize].stats.max_compute = std::max(totals[relocalize].stats.max_compute, result.stats.max_compute);
+            }
+        }
+        std::printf(
+            "    noise x%.0f, odometry only: final %.2f in, rms %.2f in, worst %.2f in\n",
+            noise_scale, totals[0].final_error, totals[0].rms_error, totals[0].worst_error
+        );
+        std::printf(
+            "    noise x%.0f, relocalized: final %.2f in, rms %.2f in, worst %.2f in, %d accepted and %d rejected per run\n",
+            noise_scale, totals[1].final_error, totals[1].rms_error, totals[1].worst_error,
+            totals[1].stats.accepted / RUNS, totals[1].stats.rejected / RUNS
+        );
+        std::printf("    us per update: mean %.2f, max %u\n", totals[1].mean_compute, totals[1].stats.max_compute);
+        if(totals[1].rms_error >= totals[0].rms_error || totals[1].stats.accepted == 0) {
+            std::printf("relocalization did not reduce the error\n");
+            errors += 1;
+        }
+    }
+
+    int first_latency = -1;
+    int time = correction_time(first_latency);
+    if(time < 0) {
+        std::printf("a %d in error was not corrected in %d ms\n", LATENCY_ERROR, LATENCY_LIMIT);
+        errors += 1;
+    } else {
+        std::printf(
+            "    %d in error within 0.5 in after %d ms (%d readings), first correction latency %d ms\n",
+            LATENCY_ERROR, time, time / WALL_RELOCALIZATION_PERIOD, first_latency
+        );
+    }
+
+    std::printf("%s\n", errors ? "FAILED" : "passed");
+    return errors ? 1 : 0;
+}
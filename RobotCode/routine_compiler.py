@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Created on Mon Oct 19 14:03:27 2026
+
+@author: aiden
+
+converts a text autonomous routine to the binary routine read by
+Routine::load, the layout has to match routine_header and routine_command
+in src/objects/actions/Routine.hpp
+
+the robot looks for /usd/auton<N>.rtn where N is the selected autonomous
+
+one command per line, # starts a comment, key=value options can go in any
+order after the arguments and async starts the command without waiting
+a path is followed as one trajectory through its points, starting from
+wherever the robot is once the chassis commands before it have finished
+    name skills_sd
+    position 0 0 0
+    drive -770 voltage=6000 heading=0 timeout=2500 async
+    profiled_drive 1200 velocity=300
+    indexer run_upper
+    wait_chassis
+    turn_right 43 velocity=300 timeout=2500
+    drive_to_point 10 20 direction=1 velocity=400
+    turn_to_point 0 0 velocity=300
+    turn_to_angle 90
+    path velocity=400 timeout=3000
+        10 20
+        30 40
+    end
+    indexer increment
+    intakes intake
+    wait_ball_top timeout=1000
+    delay 700
+
+--simulator reads the self.robot commands from an AutonSimulator
+autonomous.py instead of a text routine
+
+usage: python3 routine_compiler.py [--simulator] routine.txt auton3.rtn
+"""
+
+import re
+import struct
+import sys
+
+MAGIC = 0x4E545256
+VERSION = 2
+MAX_COMMANDS = 512
+FLAG_ASYNC = 0x01
+
+HEADER = "<IHH20sI"
+COMMAND = "<BBH4f"
+
+OPCODES = {
+    "delay": 0,
+    "position": 1,
+    "drive": 2,
+    "turn_right": 3,
+    "turn_left": 4,
+    "turn_to_angle": 5,
+    "drive_to_point": 6,
+    "turn_to_point": 7,
+    "path": 8,
+    "waypoint": 9,
+    "wait_chassis": 10,
+    "indexer": 11,
+    "intakes": 12,
+    "wait_ball_top": 13,
+    "profiled_drive": 14
+}
+
+INDEXER_MODES = [
+    "stop", "index", "index_no_backboard", "increment", "auto_increment",
+    "run_upper", "run_upper_reverse", "run_lower_reverse"
+]
+
+INTAKE_MODES = ["stop", "intake", "rocket_outward", "hold_outward"]
+
+# positional arguments then options with their defaults, in the order of args in the file
+ARGUMENTS = {
+    "delay": (["ms"], []),
+    "position": (["x", "y", "theta"], []),
+    "drive": (["ticks"], [("voltage", 11000), ("heading", 5000)]),
+    "profiled_drive": (["ticks"], [("velocity", 450)]),
+    "turn_right": (["degrees"], [("velocity", 450)]),
+    "turn_left": (["degrees"], [("velocity", 450)]),
+    "turn_to_angle": (["degrees"], [("velocity", 450)]),
+    "drive_to_point": (["x", "y"], [("direction", 0), ("velocity", 450)]),
+    "turn_to_point": (["x", "y"], [("velocity", 450)]),
+    "wait_chassis": ([], []),
+    "wait_ball_top": ([], [])
+}
+
+# AutonSimulator robot methods and what they become
+SIMULATOR_COMMANDS = {
+    "forward": lambda args: "drive " + args[0],
+    "backward": lambda args: "drive -" + args[0],
+    "turnLeft": lambda args: "turn_left " + args[0],
+    "turnRight": lambda args: "turn_right " + args[0],
+    "drive_to_point": lambda args: "drive_to_point {} {}".format(args[0], args[1]) + (" direction=" + args[2] if len(args) > 2 else ""),
+    "intakeStart": lambda args: "intakes intake",
+    "outakeStart": lambda args: "intakes rocket_outward",
+    "intakeEnd": lambda args: "intakes stop"
+}
+
+
+class RoutineError(Exception):
+    pass
+
+
+def command(opcode, args=(), flags=0, timeout=0):
+    args = list(args) + [0] * (4 - len(args))
+    if not 0 <= timeout <= 0xFFFF:
+        raise RoutineError("timeout must be from 0 to 65535 ms")
+    return struct.pack(COMMAND, OPCODES[opcode], flags, timeout, *args)
+
+
+def parse_line(words):
+    """
+    splits words into positional arguments, key=value options and flags
+    """
+    positional = [word for word in words if "=" not in word and word != "async"]
+    options = dict(word.split("=", 1) for word in words if "=" in word)
+    flags = FLAG_ASYNC if "async" in words else 0
+    timeout = int(options.pop("timeout", 0))
+    return positional, options, flags, timeout
+
+
+def compile_routine(lines):
+    name = ""
+    commands = []
+    path = None  # [velocity, flags, timeout, waypoints] while inside a path block
+
+    for number, line in enumerate(lines, 1):
+        words = line.split("#")[0].split()
+        if not words:
+            continue
+
+        try:
+            opcode, words = words[0], words[1:]
+            positional, options, flags, timeout = parse_line(words)
+
+            if path is not None:
+                if opcode == "end":
+                    # the path is one trajectory so its flags and timeout go on the path
+                    commands.append(command("path", [len(path[3]), path[0]], path[1], path[2]))
+                    commands += [command("waypoint", point) for point in path[3]]
+                    path = None
+                else:
+                    path[3].append([float(opcode), float(positional[0])])
+            elif opcode == "name":
+                name = positional[0]
+            elif opcode == "path":
+                path = [float(options.pop("velocity", 450)), flags, timeout, []]
+            elif opcode == "indexer":
+                commands.append(command(opcode, [INDEXER_MODES.index(positional[0])]))
+            elif opcode == "intakes":
+                commands.append(command(opcode, [INTAKE_MODES.index(positional[0])]))
+            elif opcode in ARGUMENTS:
+                names, defaults = ARGUMENTS[opcode]
+                if len(positional) != len(names):
+                    raise RoutineError("{} takes {}".format(opcode, " ".join(names) or "no arguments"))
+                args = [float(value) for value in positional]
+                args += [float(options.pop(key, default)) for key, default in defaults]
+                if options:
+                    raise RoutineError("unknown option " + next(iter(options)))
+                commands.append(command(opcode, args, flags, timeout))
+            else:
+                raise RoutineError("unknown command " + opcode)
+        except (IndexError, ValueError, RoutineError) as e:
+            raise RoutineError("line {}: {}".format(number, e))
+
+    if path is not None:
+        raise RoutineError("path is missing its end")
+    if len(commands) > MAX_COMMANDS:
+        raise RoutineError("routine has more than {} commands".format(MAX_COMMANDS))
+
+    body = b"".join(commands)
+    header = struct.pack(HEADER, MAGIC, VERSION, len(commands), name.encode()[:19], sum(body) & 0xFFFFFFFF)
+
+    return header + body
+
+
+def from_simulator(lines):
+    """
+    converts the self.robot calls in an AutonSimulator autonomous.py to routine lines
+    """
+    routine = []
+    for line in lines:
+        match = re.match(r"\s*self\.robot\.(\w+)\((.*)\)", line)
+        if match and match.group(1) in SIMULATOR_COMMANDS:
+            args = [arg.strip() for arg in match.group(2).split(",") if arg.strip()]
+            routine.append(SIMULATOR_COMMANDS[match.group(1)](args))
+
+    return routine
+
+
+if __name__ == "__main__":
+    args = [arg for arg in sys.argv[1:] if arg != "--simulator"]
+    in_file = args[0] if len(args) > 0 else "routine.txt"
+    out_file = args[1] if len(args) > 1 else "routine.rtn"
+
+    with open(in_file) as f:
+        lines = f.readlines()
+    if "--simulator" in sys.argv:
+        lines = from_simulator(lines)
+
+    try:
+        image = compile_routine(lines)
+    except RoutineError as e:
+        sys.exit(in_file + ": " + str(e))
+
+    with open(out_file, "wb") as f:
+        f.write(image)
+
+    print("wrote", len(image), "bytes to", out_file)
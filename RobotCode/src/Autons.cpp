@@ -9,14 +9,24 @@
  * contains implementation for autonomous options
  */
 
+#include <cstdio>
 #include <unordered_map>
 
 #include "main.h"
 
 #include "Autons.hpp"
+#include "Configuration.hpp"
+#include "DriverControl.hpp"
+#include "objects/actions/Action.hpp"
+#include "objects/actions/RobotActions.hpp"
+#include "objects/actions/Routine.hpp"
+#include "objects/controller/InputRecorder.hpp"
+#include "objects/diagnostics/CommandLatency.hpp"
 #include "objects/motors/Motors.hpp"
 #include "objects/motors/MotorThread.hpp"
 #include "objects/position_tracking/PositionTracker.hpp"
+#include "objects/position_tracking/WallRelocalizer.hpp"
+#include "objects/serial/Logger.hpp"
 #include "objects/subsystems/chassis.hpp"
 #include "objects/subsystems/Indexer.hpp"
 #include "objects/subsystems/intakes.hpp"
@@ -24,10 +34,14 @@
 
 
 int Autons::selected_number = 1;
+autonConfig Autons::options;
+Routine Autons::planned_routine;
+int Autons::planned_number = 0;
+driver_control_args Autons::replay_control;
 
 Autons::Autons( )
 {
-    debug_auton_num = 17;
+    debug_auton_num = 19;
     driver_control_num = 1;
 }
 
@@ -45,6 +59,11 @@ int Autons::get_autonomous_number() {
     return selected_number;
 }
 
+void Autons::set_start_position(int auton_number) {
+    PositionTracker::set_position({0, 0, 0});
+    PositionTracker::set_field_origin(AUTONOMOUS_START_POSITIONS.at(auton_number));
+}
+
 /**
  * deploys by outtaking and running top roller
  */
@@ -85,36 +104,22 @@ void Autons::skills() {
     tracker->start_thread();
     tracker->enable_imu();
     tracker->set_log_level(0);
-    tracker->set_position({0, 0, 0});    
+    set_start_position(selected_number);
+    tracker->get_relocalizer()->configure({WALL_DISTANCE_FORWARD, WALL_DISTANCE_LEFT, WALL_DISTANCE_ANGLE}, relocalization_constants());
+    tracker->enable_relocalization();
     chassis.set_turn_gains({4, 0.0001, 20, INT32_MAX, INT32_MAX});
     
     // tower 1
-    int uid = chassis.okapi_pid_straight_drive(-770, 6000, 2500, true, 0);
-    indexer.run_upper_roller();
-    while(!chassis.is_finished(uid)) {
-        pros::delay(5);
-    }
-    
-    uid = chassis.turn_right(43, 300, 2500, true);
-    while(!chassis.is_finished(uid)) {
-        indexer.increment();
-        pros::delay(5);
-    }
-    indexer.stop();
-    
-    uid = chassis.okapi_pid_straight_drive(1100, 6000, 3000, true, 2200);   // pick up next ball
-    while(!chassis.is_finished(uid)) {
-        indexer.increment();
-        pros::delay(5);
-    }
-    indexer.stop();
+    run(all(drive(chassis, -770, 6000, 2500, 0), do_now([&]{ indexer.run_upper_roller(); })));
+    run(race(turn_right(chassis, 43, 300, 2500), increment(indexer)));
+    run(race(drive(chassis, 1100, 6000, 3000, 2200), increment(indexer)));   // pick up next ball
     
     // score first tower
     indexer.index();  // score first two
     pros::delay(700);
     indexer.stop();
     
-    uid = chassis.okapi_pid_straight_drive(-1200, 6000, 2000, false, 0);
+    chassis.okapi_pid_straight_drive(-1200, 6000, 2000, false, 0);
 
     chassis.turn_to_angle(93, 300, 3000, false);
     chassis.okapi_pid_straight_drive(-6000, 6000, 10000, false, 1000);
@@ -122,56 +127,24 @@ void Autons::skills() {
     
     chassis.turn_right(93, 200, 4000, false);
     
-    uid = chassis.okapi_pid_straight_drive(3500, 5000, 6500, true, 0);   // pick up next ball
-    while(!chassis.is_finished(uid)) {
-        indexer.increment();
-        intakes.intake();
-        pros::delay(5);
-    }
-    indexer.stop();
-    intakes.stop();
-    
-    uid = chassis.turn_right(45, 300, 2500, true);
-    while(!chassis.is_finished(uid)) {
-        indexer.increment();
-        pros::delay(5);
-    }
-    indexer.stop();
-    
-    uid = chassis.okapi_pid_straight_drive(1000, 6000, 3000, true, 2200);   // pick up next ball
-    while(!chassis.is_finished(uid)) {
-        indexer.increment();
-        pros::delay(5);
-    }
-    indexer.stop();
+    run(race(drive(chassis, 3500, 5000, 6500, 0), increment(indexer), intake(intakes)));   // pick up next ball
+    run(race(turn_right(chassis, 45, 300, 2500), increment(indexer)));
+    run(race(drive(chassis, 1000, 6000, 3000, 2200), increment(indexer)));   // pick up next ball
     
     indexer.index();  // score first two
     pros::delay(700);
     indexer.stop();
     
     
-    uid = chassis.okapi_pid_straight_drive(-700, 6000, 2000, false, 0);
+    chassis.okapi_pid_straight_drive(-700, 6000, 2000, false, 0);
 
     chassis.turn_left(42, 300, 2500, false);
     chassis.okapi_pid_straight_drive(-1050, 6000, 3000, false, 0);
     chassis.turn_left(90, 300, 2500, false);
     chassis.okapi_pid_straight_drive(-2000, 6000, 3000, false, 0);
     
-    uid = chassis.okapi_pid_straight_drive(2800, 5000, 7000, true, 0);   // pick up next ball
-    while(!chassis.is_finished(uid)) {
-        indexer.increment();
-        intakes.intake();
-        pros::delay(5);
-    }
-    indexer.stop();
-    intakes.stop();
-    for(int i = 0; i < 100; i++) {
-        indexer.increment();
-        intakes.intake();
-        pros::delay(10);
-    }
-    indexer.stop();
-    intakes.stop();
+    run(race(drive(chassis, 2800, 5000, 7000, 0), increment(indexer), intake(intakes)));   // pick up next ball
+    run(race(wait_for(1000), increment(indexer), intake(intakes)));
     
     chassis.turn_left(90, 300, 2500, false);
     intakes.rocket_outward();
@@ -344,7 +317,7 @@ void Autons::skills_old() {
     tracker->start_thread();
     tracker->enable_imu();
     tracker->set_log_level(0);
-    tracker->set_position({0, 0, 0});
+    set_start_position(selected_number);
     chassis.set_turn_gains({4, 0.0001, 20, INT32_MAX, INT32_MAX});  // this was written with slow turns in mind
     
 }
@@ -360,7 +333,7 @@ void Autons::one_tower_auton(std::string filter_color, int turn_direction) {
     tracker->start_thread();
     tracker->enable_imu();
     tracker->set_log_level(0);
-    tracker->set_position({0, 0, 0});  
+    set_start_position(selected_number);
     chassis.set_turn_gains({4, 0.0001, 20, INT32_MAX, INT32_MAX});    
     
     indexer.run_upper_roller();
@@ -439,7 +412,7 @@ void Autons::two_tower_auton(std::string filter_color, int turn_direction) {
     tracker->start_thread();
     tracker->enable_imu();
     tracker->set_log_level(0);
-    tracker->set_position({0, 0, 0});    
+    set_start_position(selected_number);
     chassis.set_turn_gains({4, 0.0001, 20, INT32_MAX, INT32_MAX});
     
     // tower 1
@@ -524,7 +497,7 @@ void Autons::two_tower_new_auton(std::string filter_color, int turn_direction) {
     tracker->start_thread();
     tracker->enable_imu();
     tracker->set_log_level(0);
-    tracker->set_position({0, 0, 0});    
+    set_start_position(selected_number);
     chassis.set_turn_gains({4, 0.0001, 20, INT32_MAX, INT32_MAX});
     
     // tower 1
@@ -564,7 +537,7 @@ void Autons::two_tower_new_auton(std::string filter_color, int turn_direction) {
     
     
     for(int i=0; i < 130; i++) {  // index for 1000ms or until middle ball is bad color
-        if(indexer.get_state().middle_color == filter_color) {
+        if(indexer.get_state().middle_color() == Indexer::parse_color(filter_color)) {
             break;
         }
         pros::delay(10);
@@ -594,7 +567,7 @@ void Autons::two_tower_new_auton(std::string filter_color, int turn_direction) {
     intakes.intake();
     indexer.index();
     int start = pros::millis();
-    while(indexer.get_state().middle_color != filter_color) {
+    while(indexer.get_state().middle_color() != Indexer::parse_color(filter_color)) {
         if(pros::millis() > start + 1000) {  // timeout
             break;
         }
@@ -678,7 +651,126 @@ void Autons::red_two_tower_new_right() {
 }
 
 
+void Autons::replay_driver(bool correct_with_odometry) {
+    stop_replay_driver();  // one can be left over from an autonomous that was ended early
+    if(!options.use_previous_macros || !InputRecorder::start_replay(INPUT_RECORDING_FILE, correct_with_odometry)) {
+        return;
+    }
+    
+    replay_control.stop = false;
+    replay_control.finished = false;
+    replay_control.until_replay_ends = true;
+    pros::Task driver_control_task (driver_control,
+                                    (void*)&replay_control,
+                                    TASK_PRIORITY_DEFAULT,
+                                    TASK_STACK_DEPTH_DEFAULT,
+                                    "DriverControlTask");
+    
+    while(!replay_control.finished) {  // driver control stops the drive when the recording ends
+        pros::delay(10);
+    }
+}
+
+
+void Autons::stop_replay_driver() {
+    replay_control.stop = true;
+    InputRecorder::stop_replay();
+    while(!replay_control.finished) {
+        pros::delay(5);
+    }
+}
+
+
+
+bool Autons::plan_autonomous() {
+    if(planned_number == selected_number) {
+        return true;
+    }
+    
+    Chassis::clear_plan();
+    planned_number = 0;
+    
+    char filename[32];
+    std::snprintf(filename, sizeof(filename), ROUTINE_FILE_FORMAT, selected_number);
+    if(!planned_routine.load(filename)) {
+        return false;
+    }
+    
+    int start_time = pros::millis();
+    int planned = RoutineAction::plan_routine(planned_routine);
+    planned_number = selected_number;
+    
+    Logger logger;
+    log_entry entry;
+    entry.content = (
+        "[INFO] " + std::string("Routine Plan")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Name: " + planned_routine.get_name()
+        + ", Chassis_Commands: " + std::to_string(planned)
+        + ", Plan_Time: " + std::to_string(pros::millis() - start_time)
+    );
+    entry.stream = "clog";
+    logger.add(entry);
+    
+    return true;
+}
+
+
+
+bool Autons::run_routine(int auton_number) {
+    // the routine is normally loaded and planned while disabled
+    if(planned_number != auton_number) {
+        char filename[32];
+        std::snprintf(filename, sizeof(filename), ROUTINE_FILE_FORMAT, auton_number);
+        Chassis::clear_plan();
+        planned_number = 0;
+        if(!planned_routine.load(filename)) {
+            return false;
+        }
+    }
+    const Routine& routine = planned_routine;
+    
+    Chassis chassis( Motors::front_left, Motors::front_right, Motors::back_left, Motors::back_right, Sensors::left_encoder, Sensors::right_encoder, 16, 3/5);
+    Indexer indexer(Motors::upper_indexer, Motors::lower_indexer, Sensors::ball_detector, AUTONOMOUS_COLORS.at(auton_number));
+    Intakes intakes(Motors::left_intake, Motors::right_intake);
+    PositionTracker* tracker = PositionTracker::get_instance();
+    tracker->start_thread();
+    tracker->enable_imu();
+    tracker->set_log_level(0);
+    set_start_position(auton_number);
+    chassis.set_turn_gains({4, 0.0001, 20, INT32_MAX, INT32_MAX});
+    
+    RoutineAction action(routine, chassis, indexer, intakes);
+    int duration = run(action);
+    
+    // the plan has been used up, it is made again the next time the robot is disabled
+    Chassis::clear_plan();
+    planned_number = 0;
+    
+    Logger logger;
+    log_entry entry;
+    entry.content = (
+        "[INFO] " + std::string("Routine")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Name: " + routine.get_name()
+        + ", Commands: " + std::to_string(routine.size())
+        + ", Duration: " + std::to_string(duration)
+    );
+    entry.stream = "clog";
+    logger.add(entry);
+    
+    return true;
+}
+
+
+
 void Autons::run_autonomous() {
+    CommandLatency::start(&Motors::front_left);  // every chassis command moves this motor
+    
+    if(!options.use_hardcoded && run_routine(selected_number)) {
+        return;
+    }
+    
     switch(selected_number) {
         case 1:
            break;
@@ -744,5 +836,13 @@ void Autons::run_autonomous() {
             red_two_tower_new_right();
             break;
             
+        case 17:
+            replay_driver(false);
+            break;
+            
+        case 18:
+            replay_driver(true);
+            break;
+            
     }
 }
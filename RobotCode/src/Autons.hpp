@@ -11,10 +11,15 @@
 #ifndef __AUTONS_HPP__
 #define __AUTONS_HPP__
 
+#include <cmath>
 #include <unordered_map>
 
 #include "main.h"
 
+#include "DriverControl.hpp"
+#include "objects/actions/Routine.hpp"
+#include "objects/position_tracking/PositionTracker.hpp"
+
 
 typedef struct
 {
@@ -38,16 +43,32 @@ typedef struct
 class Autons
 {
     private:
+        static Routine planned_routine;
+        static int planned_number;  // the autonomous the routine and chassis plan are for, 0 if none
+        static driver_control_args replay_control;  // static so it outlives the autonomous task if that is ended first
+        
         void one_tower_auton(std::string filter_color, int turn_direction);
         void two_tower_auton(std::string filter_color, int turn_direction);
         void two_tower_new_auton(std::string filter_color, int turn_direction);
         
+        /**
+         * @param: int auton_number -> the autonomous that is starting
+         * @return: None
+         *
+         * @see: PositionTracker::set_field_origin
+         *
+         * sets the position to {0, 0, 0}, which autonomous are written from,
+         * and the field origin to where the autonomous starts on the field
+         */
+        void set_start_position(int auton_number);
+        
 
     public:
         Autons();
         ~Autons();
 
         static int selected_number;
+        static autonConfig options;  // set by the options screen
         int debug_auton_num;       //change if more autons are added
                                    //debugger should be last option
         int driver_control_num;
@@ -69,7 +90,9 @@ class Autons
             {14, "blue two tower mid right"},
             {15, "red two tower mid left"},
             {16, "red two tower mid right"},
-            {17, "Debugger"}
+            {17, "replay driver"},
+            {18, "replay driver odom"},
+            {19, "Debugger"}
         };
         const std::unordered_map <int, const char*> AUTONOMOUS_DESCRIPTIONS = {   //used to find color of auton
             {1, "goes directly to\ndriver control"},                               //selected to keep background the same
@@ -88,7 +111,9 @@ class Autons
             {14, "Caps two towers for blue (new), \nfirst turn is left"},
             {15, "Caps two towers for red (new), \nfirst turn is right"},
             {16, "Caps two towers for red (new), \nfirst turn is left"},
-            {17, "opens debugger"}
+            {17, "replays the last recorded\ndriver control"},
+            {18, "replays the last recorded\ndriver control corrected\nwith odometry"},
+            {19, "opens debugger"}
         };
         const std::unordered_map <int, std::string> AUTONOMOUS_COLORS = {
             {1, "none"},                     //used to find color of auton
@@ -107,7 +132,34 @@ class Autons
             {14, "blue"},
             {15, "red"},
             {16, "red"},
-            {17, "none"}
+            {17, "none"},
+            {18, "none"},
+            {19, "none"}
+        };
+
+        // where the tracking center is on the field at the start, in the frame of FieldModel
+        // red is along y = 0 and blue along y = FIELD_WIDTH, left and right are seen from the alliance station
+        // autonomous that are not tied to a side start in the middle of the red wall
+        const std::unordered_map <int, position> AUTONOMOUS_START_POSITIONS = {
+            {1, {72, 9, 0}},
+            {2, {72, 9, 0}},
+            {3, {36, 18, 0}},                  //backs up before the first tower
+            {4, {36, 18, 0}},
+            {5, {108, 135, M_PI}},
+            {6, {36, 135, M_PI}},
+            {7, {36, 9, 0}},
+            {8, {108, 9, 0}},
+            {9, {108, 135, M_PI}},
+            {10, {36, 135, M_PI}},
+            {11, {36, 9, 0}},
+            {12, {108, 9, 0}},
+            {13, {108, 135, M_PI}},
+            {14, {36, 135, M_PI}},
+            {15, {36, 9, 0}},
+            {16, {108, 9, 0}},
+            {17, {72, 9, 0}},
+            {18, {72, 9, 0}},
+            {19, {72, 9, 0}}
         };
 
         void set_autonomous_number(int n);
@@ -162,7 +214,55 @@ class Autons
         void blue_north();
         void blue_north_2();
         void red_north();
+        
+        /**
+         * @param: bool correct_with_odometry -> if the drive should be steered back onto the recorded path
+         * @return: None
+         *
+         * @see: InputRecorder.hpp
+         *
+         * runs driver control with the inputs recorded on the sd card
+         * until the recording ends
+         */
+        void replay_driver(bool correct_with_odometry);
+        
+        /**
+         * @return: None
+         *
+         * ends driver control started by replay_driver and waits for it to
+         * return, autonomous can be ended before the recording is so this is
+         * called before anything else drives the robot
+         */
+        static void stop_replay_driver();
+        
+        /**
+         * @param: int auton_number -> the autonomous to look for a routine file for
+         * @return: bool -> false if there is no valid routine file for the autonomous
+         *
+         * @see: ./objects/actions/Routine.hpp
+         *
+         * runs /usd/auton<auton_number>.rtn if it exists so that an
+         * autonomous can be changed without a rebuild
+         */
+        bool run_routine(int auton_number);
+        
+        /**
+         * @return: bool -> false if the selected autonomous has no routine file
+         *
+         * @see: RoutineAction::plan_routine
+         *
+         * loads the routine file for the selected autonomous and plans its chassis
+         * commands so that nothing is read or computed when autonomous starts
+         * call while disabled, does nothing if the selection is already planned
+         */
+        bool plan_autonomous();
 
+        /**
+         * @return: None
+         *
+         * runs the routine file for the selected autonomous if there is one and
+         * hard coded autons are not forced, otherwise runs the compiled autonomous
+         */
         void run_autonomous();
 };
 
@@ -9,16 +9,21 @@
  * contains implementation for configuration class
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
 #include <vector>
-#include <fstream>
 
 #include "main.h"
 
-#include "../lib/json.hpp"
 #include "Configuration.hpp"
 
 
 Configuration *Configuration::config_obj = NULL;
+std::atomic<bool> Configuration::lock = ATOMIC_VAR_INIT(false);
 
 
 Configuration::Configuration( )
@@ -134,135 +139,326 @@ Configuration* Configuration::get_instance()
 
 
 /**
- * reads json file into memory in the form of a json object supported by
- * a library
- * parses json array to get pid constants and setpoints by looking at the size
- * sets other variables by looking at their value
+ * tries the binary image first since it is one read with no parsing
+ * if there is no valid image the json file is parsed and converted so
+ * that later startups can skip it
  */
 int Configuration::init()
 {
-    std::ifstream input("/usd/config.json"); //open file with library
-    if ( input.fail() )
+    config_image image;
+    if ( read_image(CONFIG_IMAGE_FILE, image) )
+    {
+        return apply_image(image);
+    }
+
+    image = to_image();
+    if ( !parse_json(CONFIG_JSON_FILE, image) )
     {
         std::cerr << "[ERROR], " << pros::millis() << ", configuration file could not be opened\n";
         return 0;
     }
-    nlohmann::json contents;
-    input >> contents;
+
+    if ( !apply_image(image) )
+    {
+        std::cerr << "[ERROR], " << pros::millis() << ", configuration file has invalid values\n";
+        return 0;
+    }
+
+    if ( !write_image(CONFIG_IMAGE_FILE) )
+    {
+        std::cerr << "[ERROR], " << pros::millis() << ", configuration image could not be written\n";
+    }
+
+    return 1;
+}
 
 
-    std::vector<double> constants1;  //read pid constants for different systems
-    std::vector<double> constants2;
 
-    for ( int i1 = 0; i1 < 4; i1++)
+/**
+ * reads the whole image with one call and rejects it if anything about
+ * it does not match, a short read means the file is from a different layout
+ */
+int Configuration::read_image(const char* filename, config_image& image)
+{
+    std::FILE* file = std::fopen(filename, "rb");
+    if ( file == NULL )
     {
-        double value1 = contents["internal_motor_pid"][i1];
-        double value2 = contents["lift_pid"][i1];
+        return 0;
+    }
+
+    std::size_t read = std::fread(&image, 1, sizeof(config_image), file);
+    std::fclose(file);
 
-        std::cout << value1 << "\n";
-        constants1.push_back(value1);
-        constants2.push_back(value2);
+    return read == sizeof(config_image) && validate_image(image);
+}
+
+
+
+bool Configuration::validate_image(const config_image& image)
+{
+    return (
+        image.magic == CONFIG_IMAGE_MAGIC
+        && image.version == CONFIG_IMAGE_VERSION
+        && image.size == sizeof(config_image)
+        && image.num_lift_setpoints <= CONFIG_MAX_SETPOINTS
+        && image.num_tilter_setpoints <= CONFIG_MAX_SETPOINTS
+        && image.num_intake_speeds <= CONFIG_MAX_SETPOINTS
+        && image.checksum == compute_checksum(image)
+    );
+}
+
+
+
+std::uint32_t Configuration::compute_checksum(const config_image& image)
+{
+    const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(&image);
+    std::uint32_t checksum = 0;
+    for ( int i = 0; i < offsetof(config_image, checksum); i++ )
+    {
+        checksum += bytes[i];
     }
 
-    internal_motor_pid.kP = constants1.at(0);
-    internal_motor_pid.kI = constants1.at(1);
-    internal_motor_pid.kD = constants1.at(2);
-    internal_motor_pid.I_max = constants1.at(3);
+    return checksum;
+}
+
+
+
+int Configuration::write_image(const char* filename)
+{
+    config_image image = to_image();
+
+    std::FILE* file = std::fopen(filename, "wb");
+    if ( file == NULL )
+    {
+        return 0;
+    }
 
-    lift_pid.kP = constants2.at(0);
-    lift_pid.kI = constants2.at(1);
-    lift_pid.kD = constants2.at(2);
-    lift_pid.I_max = constants2.at(3);
+    std::size_t written = std::fwrite(&image, 1, sizeof(config_image), file);
+    std::fclose(file);
 
+    return written == sizeof(config_image);
+}
 
 
 
-    front_right_port = contents["front_right_port"];  //read motor port definitions
-    back_left_port = contents["back_left_port"];
-    front_left_port = contents["front_left_port"];
-    back_right_port = contents["back_right_port"];
-    left_intake_port = contents["left_intake_port"];
-    right_intake_port = contents["right_intake_port"];
-    upper_indexer_port = contents["upper_indexer_port"];
-    lower_indexer_port = contents["lower_indexer_port"];
+/**
+ * packs the current values into an image, vectors longer than the image
+ * allows are cut off
+ */
+config_image Configuration::to_image()
+{
+    config_image image = {};
+    image.magic = CONFIG_IMAGE_MAGIC;
+    image.version = CONFIG_IMAGE_VERSION;
+    image.size = sizeof(config_image);
 
-    front_right_reversed = contents["front_right_reversed"] == 1 ? true : false; //read motor port reversals
-    back_left_reversed = contents["back_left_reversed"] == 1 ? true : false;
-    front_left_reversed = contents["front_left_reversed"] == 1 ? true : false;
-    back_right_reversed = contents["back_right_reversed"] == 1 ? true : false;
-    left_intake_reversed = contents["left_intake_reversed"] == 1 ? true : false;
-    right_intake_reversed = contents["right_intake_reversed"] == 1 ? true : false;
-    upper_indexer_reversed = contents["upper_indexer_reversed"] == 1 ? true : false;
-    lower_indexer_reversed = contents["lower_indexer_reversed"] == 1 ? true : false;
+    while ( lock.exchange( true ) ); //aquire lock
 
-    filter_threshold = contents["filter_threshold"];
+    const pid* pids[3] = {&internal_motor_pid, &lift_pid, &chassis_pid};
+    double* image_pids[3] = {image.internal_motor_pid, image.lift_pid, image.chassis_pid};
+    for ( int i = 0; i < 3; i++ )
+    {
+        image_pids[i][0] = pids[i]->kP;
+        image_pids[i][1] = pids[i]->kI;
+        image_pids[i][2] = pids[i]->kD;
+        image_pids[i][3] = pids[i]->I_max;
+    }
 
-    lift_setpoints.clear();
-    for ( int i2 = 0; i2 < contents["lift_setpoints"].size(); i2++)
+    const int* ports[CONFIG_NUM_MOTORS] = {
+        &front_right_port, &back_left_port, &front_left_port, &back_right_port,
+        &left_intake_port, &right_intake_port, &upper_indexer_port, &lower_indexer_port
+    };
+    const bool* reversed[CONFIG_NUM_MOTORS] = {
+        &front_right_reversed, &back_left_reversed, &front_left_reversed, &back_right_reversed,
+        &left_intake_reversed, &right_intake_reversed, &upper_indexer_reversed, &lower_indexer_reversed
+    };
+    for ( int i = 0; i < CONFIG_NUM_MOTORS; i++ )
     {
-        lift_setpoints.push_back(contents["lift_setpoints"][i2]);
+        image.ports[i] = *ports[i];
+        image.reversed[i] = *reversed[i];
+    }
+
+    image.num_lift_setpoints = std::min<int>(lift_setpoints.size(), CONFIG_MAX_SETPOINTS);
+    image.num_tilter_setpoints = std::min<int>(tilter_setpoints.size(), CONFIG_MAX_SETPOINTS);
+    image.num_intake_speeds = std::min<int>(intake_speeds.size(), CONFIG_MAX_SETPOINTS);
+    std::copy(lift_setpoints.begin(), lift_setpoints.begin() + image.num_lift_setpoints, image.lift_setpoints);
+    std::copy(tilter_setpoints.begin(), tilter_setpoints.begin() + image.num_tilter_setpoints, image.tilter_setpoints);
+    std::copy(intake_speeds.begin(), intake_speeds.begin() + image.num_intake_speeds, image.intake_speeds);
+
+    image.filter_threshold = filter_threshold;
+    filter_color.copy(image.filter_color, sizeof(image.filter_color) - 1);
+
+    lock.exchange( false ); //release lock
 
+    image.checksum = compute_checksum(image);
+    return image;
+}
+
+
+
+/**
+ * validates first so that a bad image changes nothing, then copies every
+ * value while holding the lock
+ */
+int Configuration::apply_image(const config_image& image)
+{
+    if ( !validate_image(image) )
+    {
+        return 0;
     }
 
-    intake_speeds.clear();
-    for ( int i3 = 0; i3 < contents["intake_speeds"].size(); i3++)
+    // build the vectors before taking the lock so nothing allocates while it is held
+    std::vector<int> new_lift_setpoints(image.lift_setpoints, image.lift_setpoints + image.num_lift_setpoints);
+    std::vector<int> new_tilter_setpoints(image.tilter_setpoints, image.tilter_setpoints + image.num_tilter_setpoints);
+    std::vector<int> new_intake_speeds(image.intake_speeds, image.intake_speeds + image.num_intake_speeds);
+    std::string new_filter_color(image.filter_color, strnlen(image.filter_color, sizeof(image.filter_color)));
+
+    while ( lock.exchange( true ) ); //aquire lock
+
+    pid* pids[3] = {&internal_motor_pid, &lift_pid, &chassis_pid};
+    const double* image_pids[3] = {image.internal_motor_pid, image.lift_pid, image.chassis_pid};
+    for ( int i = 0; i < 3; i++ )
     {
-        intake_speeds.push_back(contents["intake_speeds"][i3]);
+        pids[i]->kP = image_pids[i][0];
+        pids[i]->kI = image_pids[i][1];
+        pids[i]->kD = image_pids[i][2];
+        pids[i]->I_max = image_pids[i][3];
+    }
 
+    int* ports[CONFIG_NUM_MOTORS] = {
+        &front_right_port, &back_left_port, &front_left_port, &back_right_port,
+        &left_intake_port, &right_intake_port, &upper_indexer_port, &lower_indexer_port
+    };
+    bool* reversed[CONFIG_NUM_MOTORS] = {
+        &front_right_reversed, &back_left_reversed, &front_left_reversed, &back_right_reversed,
+        &left_intake_reversed, &right_intake_reversed, &upper_indexer_reversed, &lower_indexer_reversed
+    };
+    for ( int i = 0; i < CONFIG_NUM_MOTORS; i++ )
+    {
+        *ports[i] = image.ports[i];
+        *reversed[i] = image.reversed[i];
     }
 
+    lift_setpoints.swap(new_lift_setpoints);
+    tilter_setpoints.swap(new_tilter_setpoints);
+    intake_speeds.swap(new_intake_speeds);
+    filter_threshold = image.filter_threshold;
+    filter_color.swap(new_filter_color);
+
+    lock.exchange( false ); //release lock
+
     return 1;
 }
 
 
 
+/**
+ * colors fit in the short string buffer so copying them under the lock
+ * does not allocate
+ */
+std::string Configuration::get_filter_color()
+{
+    while ( lock.exchange( true ) ); //aquire lock
+    std::string color = filter_color;
+    lock.exchange( false ); //release lock
+
+    return color;
+}
+
+
+
+void Configuration::set_filter_color(const std::string& color)
+{
+    std::string new_color = color;  // copied before the lock in case it is long enough to allocate
+    while ( lock.exchange( true ) ); //aquire lock
+    filter_color.swap(new_color);
+    lock.exchange( false ); //release lock
+}
+
+
+
+/**
+ * json files are parsed into a copy of the current values so that keys
+ * missing from the file keep their value
+ */
+int Configuration::reload(const char* filename)
+{
+    config_image image;
+    std::string name = filename;
+    if ( name.size() >= 5 && name.compare(name.size() - 5, 5, ".json") == 0 )
+    {
+        image = to_image();
+        if ( !parse_json(filename, image) )
+        {
+            return 0;
+        }
+    }
+    else if ( !read_image(filename, image) )
+    {
+        return 0;
+    }
+
+    return apply_image(image);
+}
+
+
+
 
 /**
  * prints all the variables and what they are so that they can be debugged
  * makes use of internal pid print function
+ * prints from one locked copy so a reload can not change the values part way
+ * through, lists can be empty since an image may have no setpoints
  */
 void Configuration::print_config_options()
 {
+    config_image image = to_image();
+    pid drive_pid;
+    drive_pid.kP = image.internal_motor_pid[0];
+    drive_pid.kI = image.internal_motor_pid[1];
+    drive_pid.kD = image.internal_motor_pid[2];
+    drive_pid.I_max = image.internal_motor_pid[3];
+    pid image_lift_pid;
+    image_lift_pid.kP = image.lift_pid[0];
+    image_lift_pid.kI = image.lift_pid[1];
+    image_lift_pid.kD = image.lift_pid[2];
+    image_lift_pid.I_max = image.lift_pid[3];
+
     std::cout << "drive PID constants\n";
-    internal_motor_pid.print();
+    drive_pid.print();
     std::cout << "lift PID constants\n";
-    lift_pid.print();
+    image_lift_pid.print();
 
     std::cout << "\n";
 
-    std::cout << "front_right_port: " << front_right_port << "\n";
-    std::cout << "back_left_port: " << back_left_port << "\n";
-    std::cout << "front_left_port: " << front_left_port << "\n";
-    std::cout << "back_right_port: " << back_right_port << "\n";
-    std::cout << "left_intake_port: " << left_intake_port << "\n";
-    std::cout << "right_intake_port: " << right_intake_port << "\n";
-    std::cout << "upper_indexer_port: " << upper_indexer_port << "\n";
-    std::cout << "lower_indexer_port: " << lower_indexer_port << "\n";
-
-    std::cout << "front_right_reversed: " << front_right_reversed << "\n";
-    std::cout << "back_left_reversed: " << back_left_reversed << "\n";
-    std::cout << "front_left_reversed: " << front_left_reversed << "\n";
-    std::cout << "back_right_reversed: " << back_right_reversed << "\n";
-    std::cout << "left_intake_reversed: " << left_intake_reversed << "\n";
-    std::cout << "right_intake_reversed: " << right_intake_reversed << "\n";
-    std::cout << "upper_indexer_reversed: " << upper_indexer_reversed << "\n";
-    std::cout << "lower_indexer_reversed: " << lower_indexer_reversed << "\n";
+    const char* motor_names[CONFIG_NUM_MOTORS] = {
+        "front_right", "back_left", "front_left", "back_right",
+        "left_intake", "right_intake", "upper_indexer", "lower_indexer"
+    };
+    for ( int i = 0; i < CONFIG_NUM_MOTORS; i++ )
+    {
+        std::cout << motor_names[i] << "_port: " << (int)image.ports[i] << "\n";
+    }
+    for ( int i = 0; i < CONFIG_NUM_MOTORS; i++ )
+    {
+        std::cout << motor_names[i] << "_reversed: " << (bool)image.reversed[i] << "\n";
+    }
 
-    std::cout << "\nfilter threshold: " << filter_threshold << "\n";
+    std::cout << "\nfilter threshold: " << image.filter_threshold << "\n";
 
 
     std::cout << "\nlift_setpoints: ";
-    for ( int i = 0; i < lift_setpoints.size() - 1; i++ )
+    for ( int i = 0; i < image.num_lift_setpoints; i++ )
     {
-        std::cout << lift_setpoints.at(i) << ", ";
+        std::cout << (i > 0 ? ", " : "") << image.lift_setpoints[i];
     }
-    std::cout << lift_setpoints.at(lift_setpoints.size() - 1) << "\n";
+    std::cout << "\n";
 
 
     std::cout << "\nintake_speeds: ";
-    for ( int i = 0; i < intake_speeds.size() - 1; i++ )
+    for ( int i = 0; i < image.num_intake_speeds; i++ )
     {
-        std::cout << intake_speeds.at(i) << ", ";
+        std::cout << (i > 0 ? ", " : "") << image.intake_speeds[i];
     }
-    std::cout << intake_speeds.at(intake_speeds.size() - 1) << "\n";
+    std::cout << "\n";
 }
@@ -11,13 +11,15 @@
 #ifndef __CONFIGURATION_HPP__
 #define __CONFIGURATION_HPP__
 
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "main.h"
 
-#include "../lib/json.hpp"
-
 
 #define LEFT_ENC_TOP_PORT        'G'
 #define LEFT_ENC_BOTTOM_PORT     'H'
@@ -33,9 +35,20 @@
 
 #define OPTICAL_PORT              5
 #define DISTANCE_PORT            20
+#define WALL_DISTANCE_PORT       14  // faces a field wall, see WallRelocalizer.hpp
+#define WALL_DISTANCE_FORWARD    -7  // in from the tracking center, it is on the back of the robot
+#define WALL_DISTANCE_LEFT        0  // in from the tracking center
+#define WALL_DISTANCE_ANGLE      M_PI  // rad clockwise from the front of the robot, it faces backwards
 #define IMU_PORT                 10
 #define EXPANDER_PORT             4
 
+#define CONFIG_JSON_FILE         "/usd/config.json"
+#define CONFIG_IMAGE_FILE        "/usd/config.bin"
+#define CONFIG_IMAGE_MAGIC       0x47464356  // "VCFG" when read little endian
+#define CONFIG_IMAGE_VERSION     1
+#define CONFIG_NUM_MOTORS        8
+#define CONFIG_MAX_SETPOINTS     8
+
 
 typedef struct
 {
@@ -54,7 +67,41 @@ typedef struct
 
 
 /**
- * @see: ../lib/json.hpp
+ * binary form of the configuration, written by config_compiler.py on the host
+ * or by Configuration::init the first time config.json is read on the robot
+ * all values are little endian and naturally aligned so there is no padding,
+ * the layout must match config_compiler.py
+ * motors are ordered front right, back left, front left, back right,
+ * left intake, right intake, upper indexer, lower indexer
+ */
+typedef struct
+{
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t size;  // sizeof(config_image) when it was written
+    double internal_motor_pid[4];  // kP, kI, kD, I_max
+    double lift_pid[4];
+    double chassis_pid[4];
+    std::int8_t ports[CONFIG_NUM_MOTORS];
+    std::uint8_t reversed[CONFIG_NUM_MOTORS];
+    std::uint8_t num_lift_setpoints;
+    std::uint8_t num_tilter_setpoints;
+    std::uint8_t num_intake_speeds;
+    std::uint8_t reserved;
+    std::int16_t lift_setpoints[CONFIG_MAX_SETPOINTS];
+    std::int16_t tilter_setpoints[CONFIG_MAX_SETPOINTS];
+    std::int16_t intake_speeds[CONFIG_MAX_SETPOINTS];
+    std::int32_t filter_threshold;
+    char filter_color[12];
+    std::uint32_t checksum;  // sum of every byte before the checksum
+} config_image;
+
+static_assert(sizeof(config_image) == 192, "config_image layout changed, update config_compiler.py");
+
+
+
+/**
+ * @see: ConfigurationJson.cpp
  *
  * Singleton class
  * contains class to read data from config file on sd card for better runtime config
@@ -66,6 +113,20 @@ class Configuration
     private:
         Configuration();
         static Configuration *config_obj;
+        static std::atomic<bool> lock;
+
+        std::string filter_color;  // color to remove, only read through get_filter_color because a reload can swap it
+
+        /**
+         * @param: const char* filename -> the json file to read
+         * @param: config_image& image -> filled with the values in the file, starts as the current values
+         * @return: int -> 1 if the file was parsed, 0 if it could not be read
+         *
+         * @see: ConfigurationJson.cpp
+         *
+         * the only place json.hpp is used so it is only compiled once
+         */
+        static int parse_json(const char* filename, config_image& image);
 
     public:
         ~Configuration();
@@ -78,6 +139,7 @@ class Configuration
          */
         static Configuration* get_instance();
 
+        // written under the lock by apply_image, read them through to_image once tasks are running
         pid internal_motor_pid;
         pid lift_pid;
         pid chassis_pid;
@@ -105,18 +167,78 @@ class Configuration
         std::vector<int> intake_speeds;
 
         int filter_threshold;
-        std::string filter_color;  // color to remove
+
+        /**
+         * @return: std::string -> a copy of the color to remove taken under the lock
+         */
+        std::string get_filter_color();
+
+        /**
+         * @param: const std::string& color -> "red", "blue", or "none"
+         * @return: None
+         */
+        void set_filter_color(const std::string& color);
 
 
         /**
          * @return: int -> 1 if file was successfully read, 0 if no changes were made
          *
-         * @see: ../lib/json.hpp
-         *
-         * parses json file looking for data to set variables to
+         * reads config.bin in one read, falls back to parsing config.json and
+         * then writes config.bin so the next startup does not parse json
          */
         int init();
 
+        /**
+         * @param: const char* filename -> the file to read the image from
+         * @param: config_image& image -> filled with the image
+         * @return: int -> 1 if a valid image was read, 0 otherwise
+         */
+        static int read_image(const char* filename, config_image& image);
+
+        /**
+         * @param: const config_image& image -> the image to check
+         * @return: bool -> true if the magic, version, size, counts, and checksum are all correct
+         */
+        static bool validate_image(const config_image& image);
+        static std::uint32_t compute_checksum(const config_image& image);
+
+        /**
+         * @param: const char* filename -> the file to write to
+         * @return: int -> 1 if the image was written, 0 otherwise
+         */
+        int write_image(const char* filename);
+
+        /**
+         * @return: config_image -> the current values packed into an image with a valid checksum
+         *
+         * copied under the lock so it is a consistent snapshot even while a
+         * reload is running
+         */
+        config_image to_image();
+
+        /**
+         * @param: const config_image& image -> the values to use
+         * @return: int -> 1 if the image was applied, 0 if it was invalid and nothing changed
+         *
+         * every value is swapped under one lock, so to_image and
+         * get_filter_color never return half of an old configuration and half
+         * of a new one
+         * the public members are not locked, other tasks read through
+         * to_image instead, and motors only change in Motors::apply_configuration
+         */
+        int apply_image(const config_image& image);
+
+        /**
+         * @param: const char* filename -> the file to reload from, config.json is parsed if it ends in .json
+         * @return: int -> 1 if the configuration changed, 0 otherwise
+         *
+         * @see: Motors::apply_configuration
+         *
+         * used by the server to change gains and ports without restarting
+         * the program, motors have to be updated afterwards
+         */
+        int reload(const char* filename=CONFIG_IMAGE_FILE);
+
 
         /**
          * @return: None
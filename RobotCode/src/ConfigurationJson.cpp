@@ -0,0 +1,122 @@
+/**
+ * @file: ./RobotCode/src/ConfigurationJson.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: Configuration.hpp
+ *
+ * contains the json reader for the configuration, kept separate so that
+ * json.hpp is only compiled here and is only run when there is no config.bin
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+#include "main.h"
+
+#include "../lib/json.hpp"
+#include "Configuration.hpp"
+
+
+
+/**
+ * keys that are missing or the wrong type are skipped so the image keeps
+ * the value it was passed in with
+ */
+static void read_pid(const nlohmann::json& contents, const char* key, double* pid_constants)
+{
+    if ( !contents.contains(key) || !contents[key].is_array() || contents[key].size() < 4 )
+    {
+        return;
+    }
+
+    for ( int i = 0; i < 4; i++ )
+    {
+        if ( contents[key][i].is_number() )
+        {
+            pid_constants[i] = contents[key][i];
+        }
+    }
+}
+
+
+
+static void read_list(const nlohmann::json& contents, const char* key, std::int16_t* values, std::uint8_t& count)
+{
+    if ( !contents.contains(key) || !contents[key].is_array() )
+    {
+        return;
+    }
+
+    count = 0;
+    for ( int i = 0; i < contents[key].size() && count < CONFIG_MAX_SETPOINTS; i++ )
+    {
+        if ( contents[key][i].is_number() )
+        {
+            values[count] = contents[key][i];
+            count += 1;
+        }
+    }
+}
+
+
+
+int Configuration::parse_json(const char* filename, config_image& image)
+{
+    std::ifstream input(filename);
+    if ( input.fail() )
+    {
+        return 0;
+    }
+
+    nlohmann::json contents = nlohmann::json::parse(input, nullptr, false);  // no exceptions, returns discarded on error
+    if ( contents.is_discarded() || !contents.is_object() )
+    {
+        return 0;
+    }
+
+    read_pid(contents, "internal_motor_pid", image.internal_motor_pid);
+    read_pid(contents, "lift_pid", image.lift_pid);
+    read_pid(contents, "chassis_pid", image.chassis_pid);
+
+    // same order as config_image
+    const char* motors[CONFIG_NUM_MOTORS] = {
+        "front_right", "back_left", "front_left", "back_right",
+        "left_intake", "right_intake", "upper_indexer", "lower_indexer"
+    };
+    for ( int i = 0; i < CONFIG_NUM_MOTORS; i++ )
+    {
+        std::string port_key = std::string(motors[i]) + "_port";
+        std::string reversed_key = std::string(motors[i]) + "_reversed";
+        if ( contents.contains(port_key) && contents[port_key].is_number_integer() )
+        {
+            image.ports[i] = contents[port_key].get<int>();
+        }
+        if ( contents.contains(reversed_key) && contents[reversed_key].is_number() )
+        {
+            image.reversed[i] = contents[reversed_key] == 1 ? 1 : 0;
+        }
+    }
+
+    read_list(contents, "lift_setpoints", image.lift_setpoints, image.num_lift_setpoints);
+    read_list(contents, "tilter_setpoints", image.tilter_setpoints, image.num_tilter_setpoints);
+    read_list(contents, "intake_speeds", image.intake_speeds, image.num_intake_speeds);
+
+    if ( contents.contains("filter_threshold") && contents["filter_threshold"].is_number() )
+    {
+        image.filter_threshold = contents["filter_threshold"];
+    }
+
+    if ( contents.contains("filter_color") && contents["filter_color"].is_string() )
+    {
+        std::string color = contents["filter_color"];
+        std::fill(image.filter_color, image.filter_color + sizeof(image.filter_color), 0);
+        color.copy(image.filter_color, sizeof(image.filter_color) - 1);
+    }
+
+    image.checksum = compute_checksum(image);
+
+    return 1;
+}
@@ -18,34 +18,40 @@
 #include "objects/subsystems/Indexer.hpp"
 #include "objects/subsystems/intakes.hpp"
 #include "objects/controller/controller.hpp"
+#include "objects/controller/InputRecorder.hpp"
+#include "objects/diagnostics/TaskStats.hpp"
 #include "objects/motors/Motors.hpp"
 #include "objects/sensors/Sensors.hpp"
 #include "Configuration.hpp"
 #include "DriverControl.hpp"
-#include "Configuration.hpp"
+#include "Autons.hpp"
 
 
 
 /**
  * uses if statements to control motor based on controller settings
+ * returns when args says to stop, so everything it made is destroyed before
+ * driver_control marks it finished
  */
-void driver_control(void*)
+static void run_driver_control(driver_control_args* args)
 {
+    int stats_id = TaskStats::register_current_task("DriverControlTask", 5, TASK_STACK_DEPTH_DEFAULT);
     Configuration *config = Configuration::get_instance();
     Autons autons;
     if(autons.AUTONOMOUS_COLORS.at(autons.selected_number) == "blue") {
-        config->filter_color = "red";
+        config->set_filter_color("red");
     } else if(autons.AUTONOMOUS_COLORS.at(autons.selected_number) == "red") {
-        config->filter_color = "blue";
+        config->set_filter_color("blue");
     } else {
-        config->filter_color = "none";
+        config->set_filter_color("none");
     }
-    // config->filter_color = "blue";  // uncomment if uploading for skills
+    // config->set_filter_color("blue");  // uncomment if uploading for skills
+    std::string filter_color = config->get_filter_color();  // local copy so the loop does not take the config lock
 
     Controller controllers;
 
     Chassis chassis(Motors::front_left, Motors::front_right, Motors::back_left, Motors::back_right, Sensors::left_encoder, Sensors::right_encoder, 16, 3/5);
-    Indexer indexer(Motors::upper_indexer, Motors::lower_indexer, Sensors::ball_detector, config->filter_color);
+    Indexer indexer(Motors::upper_indexer, Motors::lower_indexer, Sensors::ball_detector, filter_color);
     Intakes intakes(Motors::left_intake, Motors::right_intake);
     intakes.stop();  // help pid loop not be wierd when starting the task
     
@@ -59,10 +65,18 @@ void driver_control(void*)
     bool run_lower_indexer = true;
     int lower_indexer_start_time = 0;
 
-    controllers.master.print(0, 0, "Auto Filter %s     ", config->filter_color);
+    controllers.master.print(0, 0, "Auto Filter %s     ", filter_color.c_str());
+
+    if(Autons::options.record && !InputRecorder::is_replaying()) {
+        InputRecorder::start_recording(INPUT_RECORDING_FILE, 15000);  // long enough to be replayed as an autonomous
+    }
 
-    while ( true ) {
-        controllers.update_button_history();
+    while ( args == NULL || !args->stop ) {
+        TaskStats::loop_tick(stats_id);
+        controllers.update_snapshot();
+        if(args != NULL && args->until_replay_ends && !InputRecorder::is_replaying()) {  // snapshot is from the controllers now
+            break;
+        }
 
     // section for front roller intake movement
         if(controllers.btn_is_pressing(pros::E_CONTROLLER_DIGITAL_R1)) {  // define velocity for main intake
@@ -99,7 +113,7 @@ void driver_control(void*)
         } else if(controllers.btn_is_pressing(pros::E_CONTROLLER_DIGITAL_L2)) {
             indexer.reset_command_queue();
             indexer.index();
-        } else if(controllers.master.get_digital_new_press(pros::E_CONTROLLER_DIGITAL_LEFT)) {
+        } else if(controllers.btn_get_start_press(pros::E_CONTROLLER_DIGITAL_LEFT)) {
             indexer.fix_ball(true);
         } else if(controllers.btn_is_pressing(pros::E_CONTROLLER_DIGITAL_X)) {
             indexer.index_no_backboard();
@@ -112,43 +126,42 @@ void driver_control(void*)
         if(controllers.btn_get_release(pros::E_CONTROLLER_DIGITAL_B)) {
             auto_filter = !auto_filter;
             if(auto_filter) {  // give different message if not auto filtering
-                controllers.master.print(0, 0, "Auto Filter %s     ", config->filter_color);
+                controllers.master.print(0, 0, "Auto Filter %s     ", filter_color.c_str());
             } else {
-                controllers.master.print(0, 0, "Man Filter %s     ", config->filter_color);
+                controllers.master.print(0, 0, "Man Filter %s     ", filter_color.c_str());
             }
         }
 
     // section for setting filter color
         if(controllers.btn_get_release(pros::E_CONTROLLER_DIGITAL_A)) {  // cycle filter colors
-            if(config->filter_color == "red") {
-                config->filter_color = "blue";
-            } else if(config->filter_color == "blue") {
-                config->filter_color = "none";
-            } else if(config->filter_color == "none") {
-                config->filter_color = "red";
+            if(filter_color == "red") {
+                filter_color = "blue";
+            } else if(filter_color == "blue") {
+                filter_color = "none";
+            } else if(filter_color == "none") {
+                filter_color = "red";
             }
+            config->set_filter_color(filter_color);
             
             if(auto_filter) {  // give different message if not auto filtering
-                controllers.master.print(0, 0, "Auto Filter %s     ", config->filter_color);
+                controllers.master.print(0, 0, "Auto Filter %s     ", filter_color.c_str());
             } else {
-                controllers.master.print(0, 0, "Man Filter %s     ", config->filter_color);
+                controllers.master.print(0, 0, "Man Filter %s     ", filter_color.c_str());
             }
-            std::cout << "filtering " << config->filter_color << "\n";
-            indexer.update_filter_color(config->filter_color);
+            std::cout << "filtering " << filter_color << "\n";
+            indexer.update_filter_color(filter_color);
         }
 
 
     // section for chassis movement
-        if(std::abs(controllers.master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y)) < 5) {   // define deadzone for left analog input on the y axis
+        left_analog_y = controllers.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
+        if(std::abs(left_analog_y) < 5) {   // define deadzone for left analog input on the y axis
             left_analog_y = 0;
-        } else {
-            left_analog_y = controllers.master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
         }
 
-        if(std::abs(controllers.master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y)) < 5) {   // define deadzone for right analog input on the y axis
+        right_analog_y = controllers.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
+        if(std::abs(right_analog_y) < 5) {   // define deadzone for right analog input on the y axis
             right_analog_y = 0;
-        } else {
-            right_analog_y = controllers.master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
         }
 
         // float corrected_speed = ( .000043326431866017 * std::pow( leftDriveSpeed, 3 ) ) + ( 0.29594689028631 * leftDriveSpeed);
@@ -160,7 +173,7 @@ void driver_control(void*)
         Motors::back_right.user_move(right_analog_y);
 
 
-        if ( controllers.master.get_digital(pros::E_CONTROLLER_DIGITAL_DOWN) ) {
+        if ( controllers.btn_is_pressing(pros::E_CONTROLLER_DIGITAL_DOWN) ) {
             Autons auton;
             auton.deploy();
         }
@@ -173,4 +186,22 @@ void driver_control(void*)
         pros::delay(5);
 
     }
+    
+    Motors::front_left.user_move(0);
+    Motors::back_left.user_move(0);
+    Motors::front_right.user_move(0);
+    Motors::back_right.user_move(0);
+    indexer.stop();
+    intakes.stop();
+}
+
+
+
+void driver_control(void* args)
+{
+    driver_control_args* control_args = static_cast<driver_control_args*>(args);
+    run_driver_control(control_args);
+    if(control_args != NULL) {
+        control_args->finished = true;
+    }
 }
@@ -11,6 +11,7 @@
 #ifndef __DRIVERCONTROL_HPP__
 #define __DRIVERCONTROL_HPP__
 
+#include <atomic>
 #include <cstdlib>
 
 #include "../include/main.h"
@@ -23,7 +24,18 @@
 
 
 /**
- * @param: void* -> not used
+ * lets another task end driver control instead of removing its task, which
+ * could leave the controller, indexer, or logger locks held
+ */
+typedef struct {
+    std::atomic<bool> stop{false};  // set to end the loop at its next tick
+    std::atomic<bool> finished{true};  // set once driver control has returned and released what it used
+    bool until_replay_ends=false;  // ends the loop when InputRecorder stops replaying so live inputs are never driven on
+} driver_control_args;
+
+
+/**
+ * @param: void* args -> a driver_control_args* to end the loop with, NULL to run until the task is removed
  * @return: None
  *
  * @see: Motors.hpp
@@ -31,9 +43,10 @@
  *
  * meant to be run on task
  * function cycles through and allows user to controll robot
+ * the drive, indexer, and intakes are stopped when the loop ends
  *
  */
-void driver_control(void*);
+void driver_control(void* args);
 
 
 #endif
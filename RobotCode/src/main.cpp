@@ -1,4 +1,5 @@
 #include <csignal>
+#include <cstring>
 
 #include "main.h"
 
@@ -6,19 +7,24 @@
 #include "Configuration.hpp"
 #include "DriverControl.hpp"
 #include "objects/controller/controller.hpp"
+#include "objects/diagnostics/TaskStats.hpp"
 #include "objects/lcdCode/DriverControl/AutonomousLCD.hpp"
 #include "objects/lcdCode/DriverControl/DriverControlLCD.hpp"
 #include "objects/lcdCode/gui.hpp"
 #include "objects/lcdCode/TemporaryScreen.hpp"
+#include "objects/lcdCode/UIThread.hpp"
 #include "objects/motors/Motors.hpp"
 #include "objects/motors/MotorThread.hpp"
 #include "objects/position_tracking/PositionTracker.hpp"
+#include "objects/serial/BlackBox.hpp"
 #include "objects/serial/Logger.hpp"
 #include "objects/serial/Server.hpp"
 #include "objects/subsystems/chassis.hpp"
 #include "objects/subsystems/Indexer.hpp"
 #include "objects/subsystems/intakes.hpp"
 #include "objects/sensors/RGBLed.hpp"
+#include "objects/sensors/Sensors.hpp"
+#include "objects/startup/StartupGraph.hpp"
 
 
 /**
@@ -30,21 +36,58 @@
  void initialize()
  {
     pros::c::serctl(SERCTL_ACTIVATE, 0);  // I think this enables stdin (necessary to start server)
+    TaskStats::start();  // before any task registers so their cpu use is counted from the start
 
-    Motors::register_motors();
-    MotorThread::get_instance()->start_thread();
-
-    pros::delay(100); //wait for terminal to start and lvgl
+    // stages run in parallel as soon as the stages they depend on are finished
+    // static because a stage that times out keeps running after initialize returns
+    static StartupGraph startup;
     Configuration* config = Configuration::get_instance();
-    config->init();
-    config->print_config_options();
-
-    int final_auton_choice = chooseAuton();
-    Autons auton;
-    config->filter_color = auton.AUTONOMOUS_COLORS.at(final_auton_choice);
-    auton.set_autonomous_number(final_auton_choice);
-
-    Sensors::calibrate_imu();
+    static int final_auton_choice = 0;
+
+    int motors_stage = startup.add_stage("motors", [](){
+        Motors::register_motors();
+        MotorThread::get_instance()->start_thread();
+        return true;
+    });
+
+    int config_stage = startup.add_stage("config", [config](){
+        int success = config->init();  // defaults are kept if the sd card can not be read
+        Motors::apply_configuration();  // motors are constructed before the sd card is read
+        config->print_config_options();
+        return success == 1;
+    }, {motors_stage}, STARTUP_NO_TIMEOUT, false);
+
+    startup.add_stage("blackbox", [](){
+        return BlackBox::start();  // keeps telemetry when the robot is not tethered
+    }, {config_stage}, STARTUP_NO_TIMEOUT, false);
+
+    startup.add_stage("imu", [](){
+        return Sensors::calibrate_imu(3000);
+    }, {}, 3500, false);
+
+    startup.add_stage("sensors", [](){
+        Sensors::ball_detector.start_sampling();
+        return Sensors::probe_devices() == 0;
+    }, {config_stage}, 500, false);
+
+    int lcd_stage = startup.add_stage("lcd", [](){
+        pros::delay(100); //wait for terminal to start and lvgl
+        final_auton_choice = chooseAuton();
+        return true;
+    });
+
+    startup.add_stage("auton", [config](){
+        Autons auton;
+        config->set_filter_color(auton.AUTONOMOUS_COLORS.at(final_auton_choice));  // after config so it is not overwritten
+        auton.set_autonomous_number(final_auton_choice);
+        auton.plan_autonomous();  // so autonomous does not read or compute its routine when it is enabled
+        return true;
+    }, {config_stage, lcd_stage});
+
+    if(!startup.run()) {
+        std::cerr << "[ERROR], " << pros::millis() << ", startup is degraded, check the boot time breakdown\n";
+    }
+    startup.log_breakdown();
     
     
     // std::cout << OptionsScreen::cnfg.use_hardcoded << '\n';
@@ -66,9 +109,15 @@
  * the robot is enabled, this task will exit.
  */
 void disabled() {
+    Autons::stop_replay_driver();  // the autonomous task was ended without it
+    MotorThread::get_instance()->disable_battery_compensation();  // autonomous turns it on, it is only meant to run during autonomous
+    Motors::apply_configuration();  // in case the configuration was reloaded while enabled
+    BlackBox::stop();  // writes the index so the recording of the last mode is complete, the robot is often turned off next
+    UIThread::get_instance()->clear_screen();  // the driver screen is still being drawn after opcontrol is stopped
     AutonomousLCD auton_lcd;
     Autons auton;
     auton_lcd.update_labels(auton.get_autonomous_number());
+    auton.plan_autonomous();  // the plan is used up each time autonomous runs
 }
 
 
@@ -98,6 +147,10 @@ void competition_initialize() {}
  * from where it left off.
  */
 void autonomous() {
+    if(!BlackBox::is_running()) {  // each mode after the robot was disabled gets its own recording
+        BlackBox::start();
+    }
+    MotorThread::get_instance()->enable_battery_compensation();  // so routines take the same time on any battery
     Autons auton;
     auton.run_autonomous();
 }
@@ -108,11 +161,11 @@ void autonomous() {
      Logger logger;
      Chassis chassis( Motors::front_left, Motors::front_right, Motors::back_left, Motors::back_right, Sensors::left_encoder, Sensors::right_encoder, 16, 3/5);
      
-     Configuration* config = Configuration::get_instance();
-     double kP = config->chassis_pid.kP;
-     double kI = config->chassis_pid.kI;
-     double kD = config->chassis_pid.kD;
-     double I_max = config->chassis_pid.I_max;
+     config_image config = Configuration::get_instance()->to_image();
+     double kP = config.chassis_pid[0];
+     double kI = config.chassis_pid[1];
+     double kD = config.chassis_pid[2];
+     double I_max = config.chassis_pid[3];
      
      int l_id = Sensors::left_encoder.get_unique_id();
      int r_id = Sensors::right_encoder.get_unique_id();
@@ -189,6 +242,11 @@ void autonomous() {
  * task, not resume it from where it left off.
  */
 void opcontrol() {
+    if(!BlackBox::is_running()) {  // each mode after the robot was disabled gets its own recording
+        BlackBox::start();
+    }
+    MotorThread::get_instance()->disable_battery_compensation();
+    Autons::stop_replay_driver();  // autonomous can be ended before the recording it was replaying
      // pros::ADIAnalogIn l1 (1);
      // pros::ADIAnalogIn l2 (2);
      // pros::ADIAnalogIn l3 (3);
@@ -264,6 +322,7 @@ void opcontrol() {
 
     pros::delay(100);
 
+    UIThread::get_instance()->clear_screen();
     lv_scr_load(tempScreen::temp_screen);
 
 
@@ -300,7 +359,9 @@ void opcontrol() {
     // tracker->start_thread();
     // std::cout << pros::Task::get_count() << "\n";
     // Chassis chassis(Motors::front_left, Motors::front_right, Motors::back_left, Motors::back_right, Sensors::left_encoder, Sensors::right_encoder, Sensors::imu, 12.75, 5/3, 3.25);
-    DriverControlLCD lcd;
+    static DriverControlLCD lcd;  // static because the ui thread keeps using it if this task is deleted
+    UIThread::get_instance()->set_screen(&lcd);
+    UIThread::get_instance()->start_thread();
     // lcd.update_labels();
     // chassis.generate_profiles();
     
@@ -492,10 +553,11 @@ void opcontrol() {
         // 
         // std::cout << "delta theta: " << delta_theta << "  |  new angle: " << prev_angle << "\n";
         // std::cout << tracker->get_position().x_pos << " " << tracker->get_position().y_pos << " " << tracker->to_degrees(tracker->get_position().theta) << "\n";
-        lcd.update_labels();
         // server.handle_requests(50);
         // std::cout << "handling requests\n";
         // logger.dump();
+        
+        Indexer::log_ball_events();  // the indexer task only records events so driver control does not build log strings
 
         pros::delay(20);
     }
@@ -0,0 +1,419 @@
+/**
+ * @file: ./RobotCode/src/objects/actions/Action.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains combinators for running robot actions at the same time from
+ * one task, such as driving while the indexer increments
+ *
+ * an action is any class with these three methods
+ *     void start() -> called once right before the first step
+ *     bool step()  -> called every tick, returns true when the action is done
+ *     void stop()  -> called instead of any more steps when the action is
+ *                     cancelled because it lost a race or timed out
+ *
+ * combinators hold their actions by value so building one does not allocate
+ * and a whole routine step is a few inlined calls, an example is
+ *     run(race(drive(chassis, 1100), increment(indexer)));
+ * which replaces
+ *     uid = chassis.okapi_pid_straight_drive(1100, ..., true, ...);
+ *     while(!chassis.is_finished(uid)) { indexer.increment(); pros::delay(5); }
+ *     indexer.stop();
+ */
+
+#ifndef __ACTION_HPP__
+#define __ACTION_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+#include "main.h"
+
+#include "../diagnostics/Trace.hpp"
+
+
+
+#define ACTION_TICK 5  // ms between steps, the same as the motor thread period
+
+
+
+/**
+ * steps every action each tick and finishes once all of them have
+ */
+template <typename... Ts>
+class AllAction
+{
+    private:
+        std::tuple<Ts...> actions;
+        bool finished[sizeof...(Ts)];
+
+        template <std::size_t... I>
+        bool step_all(std::index_sequence<I...>) {
+            bool done = true;
+            ((finished[I] = finished[I] || std::get<I>(actions).step(), done = done && finished[I]), ...);
+            return done;
+        }
+
+        template <std::size_t... I>
+        void stop_all(std::index_sequence<I...>) {
+            ((finished[I] ? void() : std::get<I>(actions).stop()), ...);
+        }
+
+    public:
+        explicit AllAction(Ts... a) : actions(std::move(a)...) {}
+
+        void start() {
+            for(bool& f : finished) {
+                f = false;
+            }
+            std::apply([](auto&... a) { (a.start(), ...); }, actions);
+        }
+
+        bool step() {
+            return step_all(std::index_sequence_for<Ts...>{});
+        }
+
+        void stop() {
+            stop_all(std::index_sequence_for<Ts...>{});
+        }
+};
+
+
+
+/**
+ * steps every action each tick and finishes when the first one does,
+ * the rest are stopped
+ * get_winner gives the index of the action that finished first
+ */
+template <typename... Ts>
+class RaceAction
+{
+    private:
+        std::tuple<Ts...> actions;
+        int winner;
+
+        template <std::size_t... I>
+        bool step_all(std::index_sequence<I...>) {
+            // actions after the winner are not stepped again this tick
+            ((winner < 0 && std::get<I>(actions).step() ? (void)(winner = I) : void()), ...);
+            if(winner < 0) {
+                return false;
+            }
+            ((static_cast<int>(I) != winner ? std::get<I>(actions).stop() : void()), ...);
+            return true;
+        }
+
+    public:
+        explicit RaceAction(Ts... a) : actions(std::move(a)...), winner(-1) {}
+
+        void start() {
+            winner = -1;
+            std::apply([](auto&... a) { (a.start(), ...); }, actions);
+        }
+
+        bool step() {
+            return step_all(std::index_sequence_for<Ts...>{});
+        }
+
+        void stop() {
+            std::apply([](auto&... a) { (a.stop(), ...); }, actions);
+        }
+
+        int get_winner() const {
+            return winner;
+        }
+};
+
+
+
+/**
+ * runs actions one after another, an action that finishes starts the next
+ * one in the same tick so instant actions do not cost a tick each
+ */
+template <typename... Ts>
+class SequenceAction
+{
+    private:
+        std::tuple<Ts...> actions;
+        std::size_t current;
+
+        template <std::size_t I=0>
+        void start_current() {
+            if constexpr (I < sizeof...(Ts)) {
+                if(I == current) {
+                    std::get<I>(actions).start();
+                    return;
+                }
+                start_current<I + 1>();
+            }
+        }
+
+        template <std::size_t I=0>
+        bool step_current() {
+            if constexpr (I < sizeof...(Ts)) {
+                if(I == current) {
+                    return std::get<I>(actions).step();
+                }
+                return step_current<I + 1>();
+            }
+            return true;
+        }
+
+        template <std::size_t I=0>
+        void stop_current() {
+            if constexpr (I < sizeof...(Ts)) {
+                if(I == current) {
+                    std::get<I>(actions).stop();
+                    return;
+                }
+                stop_current<I + 1>();
+            }
+        }
+
+    public:
+        explicit SequenceAction(Ts... a) : actions(std::move(a)...), current(0) {}
+
+        void start() {
+            current = 0;
+            start_current();
+        }
+
+        bool step() {
+            while(current < sizeof...(Ts)) {
+                if(!step_current()) {
+                    return false;
+                }
+                current += 1;
+                start_current();
+            }
+            return true;
+        }
+
+        void stop() {
+            stop_current();
+        }
+};
+
+
+
+/**
+ * stops the action if it has not finished after timeout ms
+ * timed_out says which way it ended
+ */
+template <typename T>
+class TimeoutAction
+{
+    private:
+        T action;
+        int timeout;
+        std::uint32_t start_time;
+        bool expired;
+
+    public:
+        TimeoutAction(T a, int timeout_ms) : action(std::move(a)), timeout(timeout_ms), start_time(0), expired(false) {}
+
+        void start() {
+            start_time = pros::millis();
+            expired = false;
+            action.start();
+        }
+
+        bool step() {
+            if(action.step()) {
+                return true;
+            }
+            if(pros::millis() - start_time >= static_cast<std::uint32_t>(timeout)) {
+                action.stop();
+                expired = true;
+                return true;
+            }
+            return false;
+        }
+
+        void stop() {
+            action.stop();
+        }
+
+        bool timed_out() const {
+            return expired;
+        }
+};
+
+
+
+/**
+ * finishes after ms have passed since it started
+ */
+class WaitAction
+{
+    private:
+        int duration;
+        std::uint32_t start_time;
+
+    public:
+        explicit WaitAction(int ms) : duration(ms), start_time(0) {}
+
+        void start() {
+            start_time = pros::millis();
+        }
+
+        bool step() {
+            return pros::millis() - start_time >= static_cast<std::uint32_t>(duration);
+        }
+
+        void stop() {}
+};
+
+
+
+/**
+ * finishes the first tick the predicate is true
+ */
+template <typename Pred>
+class UntilAction
+{
+    private:
+        Pred pred;
+
+    public:
+        explicit UntilAction(Pred p) : pred(std::move(p)) {}
+
+        void start() {}
+
+        bool step() {
+            return pred();
+        }
+
+        void stop() {}
+};
+
+
+
+/**
+ * calls fn when it starts and finishes right away
+ */
+template <typename Fn>
+class DoAction
+{
+    private:
+        Fn fn;
+
+    public:
+        explicit DoAction(Fn f) : fn(std::move(f)) {}
+
+        void start() {
+            fn();
+        }
+
+        bool step() {
+            return true;
+        }
+
+        void stop() {}
+};
+
+
+
+/**
+ * calls fn every tick and never finishes on its own, on_stop is called
+ * when it is cancelled so that subsystems are not left running
+ */
+template <typename Fn, typename StopFn>
+class EveryTickAction
+{
+    private:
+        Fn fn;
+        StopFn on_stop;
+
+    public:
+        EveryTickAction(Fn f, StopFn s) : fn(std::move(f)), on_stop(std::move(s)) {}
+
+        void start() {}
+
+        bool step() {
+            fn();
+            return false;
+        }
+
+        void stop() {
+            on_stop();
+        }
+};
+
+
+
+template <typename... Ts>
+AllAction<Ts...> all(Ts... actions) {
+    return AllAction<Ts...>(std::move(actions)...);
+}
+
+template <typename... Ts>
+RaceAction<Ts...> race(Ts... actions) {
+    return RaceAction<Ts...>(std::move(actions)...);
+}
+
+template <typename... Ts>
+SequenceAction<Ts...> sequence(Ts... actions) {
+    return SequenceAction<Ts...>(std::move(actions)...);
+}
+
+template <typename T>
+TimeoutAction<T> with_timeout(T action, int timeout_ms) {
+    return TimeoutAction<T>(std::move(action), timeout_ms);
+}
+
+inline WaitAction wait_for(int ms) {
+    return WaitAction(ms);
+}
+
+template <typename Pred>
+UntilAction<Pred> wait_until(Pred pred) {
+    return UntilAction<Pred>(std::move(pred));
+}
+
+template <typename Fn>
+DoAction<Fn> do_now(Fn fn) {
+    return DoAction<Fn>(std::move(fn));
+}
+
+template <typename Fn, typename StopFn>
+EveryTickAction<Fn, StopFn> every_tick(Fn fn, StopFn on_stop) {
+    return EveryTickAction<Fn, StopFn>(std::move(fn), std::move(on_stop));
+}
+
+
+
+/**
+ * @param: A&& action -> the action to run, an lvalue can be checked after it finishes
+ * @param: int tick -> ms between steps
+ * @return: int -> ms the action took
+ *
+ * blocks the calling task and steps the action every tick until it finishes
+ * the task sleeps between steps with delay_until so step time does not
+ * add up into drift
+ */
+template <typename A>
+int run(A&& action, int tick=ACTION_TICK) {
+    std::uint32_t start_time = pros::millis();
+    std::uint32_t wake_time = start_time;
+
+    action.start();
+    while(true) {
+        {
+            TRACE_SCOPE("action_step");
+            if(action.step()) {
+                break;
+            }
+        }
+        pros::c::task_delay_until(&wake_time, tick);
+    }
+
+    return pros::millis() - start_time;
+}
+
+
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * @file: ./RobotCode/src/objects/actions/RobotActions.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: RobotActions.hpp
+ *
+ * contains implementation for chassis, indexer, and intake actions
+ */
+
+#include "main.h"
+
+#include "../subsystems/chassis.hpp"
+#include "../subsystems/Indexer.hpp"
+#include "../subsystems/intakes.hpp"
+#include "RobotActions.hpp"
+
+
+
+DriveAction::DriveAction(Chassis& drive_chassis, double ticks, int voltage, int timeout_ms, int heading_correction)
+{
+    chassis = &drive_chassis;
+    encoder_ticks = ticks;
+    max_voltage = voltage;
+    timeout = timeout_ms;
+    max_heading_correction = heading_correction;
+    uid = 0;
+    finished = false;
+}
+
+
+
+void DriveAction::start()
+{
+    finished = false;
+    uid = chassis->okapi_pid_straight_drive(encoder_ticks, max_voltage, timeout, true, max_heading_correction);
+}
+
+
+
+bool DriveAction::step()
+{
+    finished = finished || chassis->is_finished(uid);
+    return finished;
+}
+
+
+
+void DriveAction::stop()
+{
+    if(!finished) {  // lost a race or timed out, the chassis would keep driving
+        chassis->cancel();
+    }
+}
+
+
+
+
+TurnAction::TurnAction(Chassis& drive_chassis, turn_kind turn, double angle, int velocity, int timeout_ms)
+{
+    chassis = &drive_chassis;
+    kind = turn;
+    degrees = angle;
+    max_velocity = velocity;
+    timeout = timeout_ms;
+    uid = 0;
+    finished = false;
+}
+
+
+
+void TurnAction::start()
+{
+    finished = false;
+    switch(kind) {
+        case e_action_turn_right:
+            uid = chassis->turn_right(degrees, max_velocity, timeout, true);
+            break;
+        case e_action_turn_left:
+            uid = chassis->turn_left(degrees, max_velocity, timeout, true);
+            break;
+        case e_action_turn_to_angle:
+            uid = chassis->turn_to_angle(degrees, max_velocity, timeout, true);
+            break;
+    }
+}
+
+
+
+bool TurnAction::step()
+{
+    finished = finished || chassis->is_finished(uid);
+    return finished;
+}
+
+
+
+void TurnAction::stop()
+{
+    if(!finished) {
+        chassis->cancel();
+    }
+}
+
+
+
+
+IncrementAction::IncrementAction(Indexer& robot_indexer)
+{
+    indexer = &robot_indexer;
+}
+
+
+
+bool IncrementAction::step()
+{
+    indexer->increment();
+    return false;
+}
+
+
+
+void IncrementAction::stop()
+{
+    indexer->stop();
+}
+
+
+
+
+IntakeAction::IntakeAction(Intakes& robot_intakes)
+{
+    intakes = &robot_intakes;
+}
+
+
+
+bool IntakeAction::step()
+{
+    intakes->intake();
+    return false;
+}
+
+
+
+void IntakeAction::stop()
+{
+    intakes->stop();
+}
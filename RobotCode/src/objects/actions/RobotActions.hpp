@@ -0,0 +1,177 @@
+/**
+ * @file: ./RobotCode/src/objects/actions/RobotActions.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains actions for the chassis, indexer, and intakes that can be
+ * combined with the combinators in Action.hpp
+ */
+
+#ifndef __ROBOTACTIONS_HPP__
+#define __ROBOTACTIONS_HPP__
+
+#include <cstdint>
+
+#include "main.h"
+
+#include "../subsystems/chassis.hpp"
+#include "../subsystems/Indexer.hpp"
+#include "../subsystems/intakes.hpp"
+#include "Action.hpp"
+
+
+
+typedef enum e_turn_kind {
+    e_action_turn_right,
+    e_action_turn_left,
+    e_action_turn_to_angle
+} turn_kind;
+
+
+
+/**
+ * @see: Chassis::okapi_pid_straight_drive
+ *
+ * starts an asynchronous straight drive and finishes when the chassis
+ * reports the command is finished
+ * stopping it before then cancels the drive and anything queued on the
+ * chassis after it
+ */
+class DriveAction
+{
+    private:
+        Chassis* chassis;
+        double encoder_ticks;
+        int max_voltage;
+        int timeout;
+        int max_heading_correction;
+        int uid;
+        bool finished;
+
+    public:
+        DriveAction(Chassis& drive_chassis, double ticks, int voltage, int timeout_ms, int heading_correction);
+
+        void start();
+        bool step();
+        void stop();
+};
+
+
+
+/**
+ * @see: Chassis::turn_right, Chassis::turn_left, Chassis::turn_to_angle
+ *
+ * starts an asynchronous turn and finishes when the chassis reports the
+ * command is finished, stopping it before then cancels it the same as
+ * DriveAction
+ */
+class TurnAction
+{
+    private:
+        Chassis* chassis;
+        turn_kind kind;
+        double degrees;
+        int max_velocity;
+        int timeout;
+        int uid;
+        bool finished;
+
+    public:
+        TurnAction(Chassis& drive_chassis, turn_kind turn, double angle, int velocity, int timeout_ms);
+
+        void start();
+        bool step();
+        void stop();
+};
+
+
+
+/**
+ * increments the indexer every tick, never finishes on its own and stops
+ * the indexer when it is stopped
+ */
+class IncrementAction
+{
+    private:
+        Indexer* indexer;
+
+    public:
+        explicit IncrementAction(Indexer& robot_indexer);
+
+        void start() {}
+        bool step();
+        void stop();
+};
+
+
+
+/**
+ * runs the intakes inward every tick, never finishes on its own and stops
+ * the intakes when it is stopped
+ */
+class IntakeAction
+{
+    private:
+        Intakes* intakes;
+
+    public:
+        explicit IntakeAction(Intakes& robot_intakes);
+
+        void start() {}
+        bool step();
+        void stop();
+};
+
+
+
+/**
+ * predicate for UntilAction that is true when a ball is at the top of the indexer
+ */
+struct ball_at_top {
+    bool operator()() const {
+        return Indexer::get_state().top();
+    }
+};
+
+
+
+inline DriveAction drive(Chassis& chassis, double encoder_ticks, int max_voltage=11000, int timeout=INT32_MAX, int max_heading_correction=5000) {
+    return DriveAction(chassis, encoder_ticks, max_voltage, timeout, max_heading_correction);
+}
+
+inline TurnAction turn_right(Chassis& chassis, double degrees, int max_velocity=450, int timeout=INT32_MAX) {
+    return TurnAction(chassis, e_action_turn_right, degrees, max_velocity, timeout);
+}
+
+inline TurnAction turn_left(Chassis& chassis, double degrees, int max_velocity=450, int timeout=INT32_MAX) {
+    return TurnAction(chassis, e_action_turn_left, degrees, max_velocity, timeout);
+}
+
+inline TurnAction turn_to_angle(Chassis& chassis, double theta, int max_velocity=450, int timeout=INT32_MAX) {
+    return TurnAction(chassis, e_action_turn_to_angle, theta, max_velocity, timeout);
+}
+
+inline IncrementAction increment(Indexer& indexer) {
+    return IncrementAction(indexer);
+}
+
+inline IntakeAction intake(Intakes& intakes) {
+    return IntakeAction(intakes);
+}
+
+/**
+ * @param: Indexer& indexer -> the indexer to increment
+ * @param: Pred pred -> stops incrementing the first tick this is true
+ * @return: RaceAction<IncrementAction, UntilAction<Pred>> -> the action
+ *
+ * increments until the predicate is true, such as ball_at_top()
+ */
+template <typename Pred>
+RaceAction<IncrementAction, UntilAction<Pred>> index_until(Indexer& indexer, Pred pred) {
+    return race(increment(indexer), wait_until(pred));
+}
+
+
+
+#endif
@@ -0,0 +1,475 @@
+/**
+ * @file: ./RobotCode/src/objects/actions/Routine.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: Routine.hpp
+ *
+ * contains implementation for loading and running binary autonomous routines
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+#include "../motion_planning/Trajectory.hpp"
+#include "../position_tracking/PositionTracker.hpp"
+#include "../serial/Logger.hpp"
+#include "../subsystems/chassis.hpp"
+#include "../subsystems/Indexer.hpp"
+#include "../subsystems/intakes.hpp"
+#include "Routine.hpp"
+
+
+
+Routine::Routine()
+{
+    std::memset(&header, 0, sizeof(header));
+}
+
+
+
+bool Routine::validate()
+{
+    if(header.magic != ROUTINE_MAGIC || header.version != ROUTINE_VERSION || header.num_commands > ROUTINE_MAX_COMMANDS) {
+        return false;
+    }
+
+    std::uint32_t checksum = 0;
+    const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(commands.data());
+    for(std::size_t i = 0; i < commands.size() * sizeof(routine_command); i++) {
+        checksum += bytes[i];
+    }
+    if(checksum != header.checksum) {
+        return false;
+    }
+
+    // paths have to be followed by the number of waypoints they say
+    int waypoints_left = 0;
+    for(const routine_command& command : commands) {
+        if(command.opcode >= e_routine_num_opcodes) {
+            return false;
+        } else if(command.opcode == e_routine_waypoint) {
+            if(waypoints_left == 0) {
+                return false;
+            }
+            waypoints_left -= 1;
+        } else if(waypoints_left > 0) {
+            return false;
+        } else if(command.opcode == e_routine_path) {
+            waypoints_left = command.args[0];
+        }
+    }
+
+    return waypoints_left == 0;
+}
+
+
+
+bool Routine::load(const char* filename)
+{
+    std::FILE* file = std::fopen(filename, "rb");
+    if(file == NULL) {
+        return false;  // not an error, most autons do not have a routine file
+    }
+
+    bool valid = std::fread(&header, 1, sizeof(header), file) == sizeof(header) && header.num_commands <= ROUTINE_MAX_COMMANDS;
+    if(valid) {
+        commands.resize(header.num_commands);
+        std::size_t size = header.num_commands * sizeof(routine_command);
+        valid = std::fread(commands.data(), 1, size, file) == size && validate();
+    }
+    std::fclose(file);
+
+    if(!valid) {
+        commands.clear();
+
+        Logger logger;
+        log_entry entry;
+        entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", " + std::string(filename) + " is not a valid routine";
+        entry.stream = "cerr";
+        logger.add(entry);
+        return false;
+    }
+
+    header.name[sizeof(header.name) - 1] = '\0';
+    return true;
+}
+
+
+
+const char* Routine::get_name() const
+{
+    return header.name;
+}
+
+
+
+int Routine::size() const
+{
+    return commands.size();
+}
+
+
+
+const routine_command* Routine::data() const
+{
+    return commands.data();
+}
+
+
+
+
+RoutineAction::RoutineAction(const Routine& routine_data, Chassis& robot_chassis, Indexer& robot_indexer, Intakes& robot_intakes)
+{
+    routine = &routine_data;
+    chassis = &robot_chassis;
+    indexer = &robot_indexer;
+    intakes = &robot_intakes;
+
+    pc = 0;
+    wait = e_wait_none;
+    wait_uid = 0;
+    wait_start = 0;
+    wait_duration = 0;
+    last_uid = -1;
+    num_paths = 0;
+    indexer_mode = e_routine_indexer_stop;
+    intake_mode = e_routine_intakes_stop;
+
+    int paths = 0;
+    for(int i = 0; i < routine->size(); i++) {
+        paths += routine->data()[i].opcode == e_routine_path ? 1 : 0;
+    }
+    trajectories.resize(paths);  // made here so starting a path only fills one in
+}
+
+
+
+/**
+ * checks if the command that is blocking has finished
+ */
+bool RoutineAction::wait_finished()
+{
+    switch(wait) {
+        case e_wait_none:
+            return true;
+        case e_wait_chassis:
+            if(!chassis->is_finished(wait_uid)) {
+                return false;
+            }
+            break;
+        case e_wait_time:
+            if(pros::millis() - wait_start < wait_duration) {
+                return false;
+            }
+            break;
+        case e_wait_ball_top:
+            if(!Indexer::get_state().top() && pros::millis() - wait_start < wait_duration) {
+                return false;
+            }
+            break;
+    }
+
+    wait = e_wait_none;
+    return true;
+}
+
+
+
+/**
+ * the trajectory starts where the robot is facing the way it is, so the
+ * chassis has to have finished everything before it
+ * generating a path of a few waypoints takes well under one tick, the
+ * samples of a trajectory are reused if the routine runs again
+ */
+int RoutineAction::start_path(const routine_command& command, int timeout)
+{
+    int num_waypoints = command.args[0];
+    position robot = PositionTracker::get_instance()->get_position();
+    std::vector<spline_point> points(num_waypoints + 1);
+    points.at(0).x = robot.x_pos;
+    points.at(0).y = robot.y_pos;
+    points.at(0).theta = robot.theta;
+    points.at(0).fixed_heading = true;
+    for(int i = 0; i < num_waypoints; i++) {
+        points.at(i + 1).x = routine->data()[pc + 1 + i].args[0];
+        points.at(i + 1).y = routine->data()[pc + 1 + i].args[1];
+    }
+
+    trajectory_constraints constraints;
+    constraints.max_velocity = Chassis::rpm_to_inches_per_second(command.args[1]);
+
+    Trajectory& trajectory = trajectories.at(num_paths);
+    num_paths += 1;
+    if(!trajectory.generate(points, constraints)) {
+        Logger logger;
+        log_entry entry;
+        entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", routine path at command " + std::to_string(pc) + " could not be made into a trajectory, it is skipped";
+        entry.stream = "cerr";
+        logger.add(entry);
+        return -1;
+    }
+
+    return chassis->follow_trajectory(trajectory, 1, timeout, true);
+}
+
+
+
+/**
+ * starts a command and sets what it has to wait for before the next one
+ * chassis commands are queued by the chassis so starting several
+ * asynchronously runs them back to back
+ * returns how many commands were used, 0 if the command has to wait and
+ * be run again
+ */
+int RoutineAction::execute(const routine_command& command)
+{
+    const float* a = command.args;
+    int timeout = command.timeout == 0 ? INT32_MAX : command.timeout;
+    int uid = -1;
+    int used = 1;
+
+    switch(command.opcode) {
+        case e_routine_delay:
+            wait = e_wait_time;
+            wait_start = pros::millis();
+            wait_duration = a[0];
+            break;
+        case e_routine_set_position:
+            PositionTracker::set_position({a[0], a[1], a[2]});
+            break;
+        case e_routine_drive:
+            uid = chassis->okapi_pid_straight_drive(a[0], a[1], timeout, true, a[2]);
+            break;
+        case e_routine_profiled_drive:
+            uid = chassis->profiled_straight_drive(a[0], a[1], timeout, true);
+            break;
+        case e_routine_turn_right:
+            uid = chassis->turn_right(a[0], a[1], timeout, true);
+            break;
+        case e_routine_turn_left:
+            uid = chassis->turn_left(a[0], a[1], timeout, true);
+            break;
+        case e_routine_turn_to_angle:
+            uid = chassis->turn_to_angle(a[0], a[1], timeout, true);
+            break;
+        case e_routine_drive_to_point:
+            uid = chassis->drive_to_point(a[0], a[1], 0, a[2], a[3], timeout, true, true);
+            break;
+        case e_routine_turn_to_point:
+            uid = chassis->turn_to_point(a[0], a[1], a[2], timeout, true);
+            break;
+        case e_routine_path:
+            if(last_uid != -1) {
+                wait = e_wait_chassis;
+                wait_uid = last_uid;
+                last_uid = -1;
+                return 0;
+            }
+            uid = start_path(command, timeout);
+            used = 1 + a[0];  // the waypoints are part of the trajectory
+            break;
+        case e_routine_waypoint:  // only reached through a path
+            break;
+        case e_routine_wait_chassis:
+            if(last_uid != -1) {
+                wait = e_wait_chassis;
+                wait_uid = last_uid;
+                last_uid = -1;
+            }
+            break;
+        case e_routine_indexer:
+            indexer_mode = a[0];
+            switch(indexer_mode) {
+                case e_routine_indexer_stop:
+                    indexer->stop();
+                    break;
+                case e_routine_indexer_index:
+                    indexer->index();
+                    break;
+                case e_routine_indexer_index_no_backboard:
+                    indexer->index_no_backboard();
+                    break;
+                case e_routine_indexer_run_upper:
+                    indexer->run_upper_roller();
+                    break;
+                case e_routine_indexer_run_upper_reverse:
+                    indexer->run_upper_roller_reverse();
+                    break;
+                case e_routine_indexer_run_lower_reverse:
+                    indexer->run_lower_roller_reverse();
+                    break;
+            }
+            break;
+        case e_routine_intakes:
+            intake_mode = a[0];
+            switch(intake_mode) {
+                case e_routine_intakes_stop:
+                    intakes->stop();
+                    break;
+                case e_routine_intakes_rocket_outward:
+                    intakes->rocket_outward();
+                    break;
+                case e_routine_intakes_hold_outward:
+                    intakes->hold_outward();
+                    break;
+            }
+            break;
+        case e_routine_wait_ball_top:
+            wait = e_wait_ball_top;
+            wait_start = pros::millis();
+            wait_duration = timeout;
+            break;
+    }
+
+    if(uid != -1) {
+        last_uid = uid;
+        if(!(command.flags & ROUTINE_FLAG_ASYNC)) {
+            wait = e_wait_chassis;
+            wait_uid = uid;
+            last_uid = -1;
+        }
+    }
+
+    return used;
+}
+
+
+
+void RoutineAction::apply_modes()
+{
+    if(indexer_mode == e_routine_indexer_increment) {
+        indexer->increment();
+    } else if(indexer_mode == e_routine_indexer_auto_increment) {
+        indexer->auto_increment();
+    }
+
+    if(intake_mode == e_routine_intakes_intake) {
+        intakes->intake();
+    }
+}
+
+
+
+void RoutineAction::start()
+{
+    pc = 0;
+    wait = e_wait_none;
+    last_uid = -1;
+    num_paths = 0;
+    indexer_mode = e_routine_indexer_stop;
+    intake_mode = e_routine_intakes_stop;
+}
+
+
+
+/**
+ * runs commands until one has to wait, so a run of commands that do not
+ * block all start in the same tick
+ * chassis commands run in order, so once the last one started has
+ * finished, every trajectory the chassis could be using is done with
+ */
+bool RoutineAction::step()
+{
+    apply_modes();
+
+    const routine_command* commands = routine->data();
+    while(wait_finished()) {
+        if(pc >= routine->size()) {
+            if(last_uid == -1) {
+                return true;
+            }
+            wait = e_wait_chassis;
+            wait_uid = last_uid;
+            last_uid = -1;
+            continue;
+        }
+        pc += execute(commands[pc]);
+    }
+
+    return false;
+}
+
+
+
+void RoutineAction::stop()
+{
+    indexer->stop();
+    intakes->stop();
+}
+
+
+
+/**
+ * the arguments have to match the ones the chassis functions called by
+ * execute fill in or the plan is dropped when the command is pushed
+ */
+int RoutineAction::plan_routine(const Routine& routine_data)
+{
+    Chassis::clear_plan();
+
+    int planned = 0;
+    for(int i = 0; i < routine_data.size(); i++) {
+        const float* a = routine_data.data()[i].args;
+        chassis_params args;
+        chassis_commands command;
+
+        switch(routine_data.data()[i].opcode) {
+            case e_routine_drive:
+                command = e_okapi_pid_straight_drive;
+                args.setpoint1 = a[0];
+                args.max_voltage = a[1];
+                break;
+            case e_routine_profiled_drive:
+                command = e_profiled_straight_drive;
+                args.setpoint1 = a[0];
+                args.setpoint2 = 0;
+                args.max_velocity = a[1];
+                break;
+            case e_routine_turn_right:
+                command = e_turn;
+                args.setpoint1 = a[0];
+                args.max_velocity = a[1];
+                break;
+            case e_routine_turn_left:
+                command = e_turn;
+                args.setpoint1 = -a[0];
+                args.max_velocity = a[1];
+                break;
+            case e_routine_turn_to_angle:
+                command = e_turn_to_angle;
+                args.setpoint1 = PositionTracker::to_radians(a[0]);
+                args.max_velocity = a[1];
+                break;
+            case e_routine_drive_to_point:
+                command = e_drive_to_point;
+                args.setpoint1 = a[0];
+                args.setpoint2 = a[1];
+                args.max_velocity = a[3];
+                break;
+            case e_routine_turn_to_point:
+                command = e_turn_to_point;
+                args.setpoint1 = a[0];
+                args.setpoint2 = a[1];
+                args.max_velocity = a[2];
+                break;
+            case e_routine_path:
+                return planned;  // the rest are computed when they start
+            default:
+                continue;
+        }
+
+        if(Chassis::plan_command(command, args) == -1) {
+            break;  // the rest are computed when they start
+        }
+        planned += 1;
+    }
+
+    return planned;
+}
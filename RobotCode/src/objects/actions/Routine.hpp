@@ -0,0 +1,196 @@
+/**
+ * @file: ./RobotCode/src/objects/actions/Routine.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains the binary autonomous routine format and an action that runs
+ * a routine through the chassis, indexer, and intakes
+ * routines are made on a computer by routine_compiler.py so that changing
+ * an autonomous does not need a rebuild
+ */
+
+#ifndef __ROUTINE_HPP__
+#define __ROUTINE_HPP__
+
+#include <cstdint>
+#include <vector>
+
+#include "main.h"
+
+#include "../motion_planning/Trajectory.hpp"
+#include "../subsystems/chassis.hpp"
+#include "../subsystems/Indexer.hpp"
+#include "../subsystems/intakes.hpp"
+
+
+
+#define ROUTINE_MAGIC 0x4E545256  // "VRTN"
+#define ROUTINE_VERSION 2
+#define ROUTINE_MAX_COMMANDS 512
+#define ROUTINE_FILE_FORMAT "/usd/auton%d.rtn"  // filled in with the autonomous number
+
+#define ROUTINE_FLAG_ASYNC 0x01  // start the command and go on to the next one in the same tick
+
+
+typedef enum e_routine_opcode {
+    e_routine_delay,           // a0: ms
+    e_routine_set_position,    // a0: x, a1: y, a2: theta in radians
+    e_routine_drive,           // a0: encoder ticks, a1: max voltage, a2: max heading correction
+    e_routine_turn_right,      // a0: degrees, a1: max velocity
+    e_routine_turn_left,       // a0: degrees, a1: max velocity
+    e_routine_turn_to_angle,   // a0: degrees, a1: max velocity
+    e_routine_drive_to_point,  // a0: x, a1: y, a2: explicit direction, a3: max velocity
+    e_routine_turn_to_point,   // a0: x, a1: y, a2: max velocity
+    e_routine_path,            // a0: number of waypoints that follow, a1: max velocity in rpm, followed as one trajectory
+    e_routine_waypoint,        // a0: x, a1: y, only after a path, the flags and timeout of the path are used
+    e_routine_wait_chassis,    // waits for every chassis command started so far
+    e_routine_indexer,         // a0: routine_indexer_mode
+    e_routine_intakes,         // a0: routine_intake_mode
+    e_routine_wait_ball_top,   // waits for a ball at the top of the indexer
+    e_routine_profiled_drive,  // a0: encoder ticks, a1: max velocity
+    e_routine_num_opcodes
+} routine_opcode;
+
+typedef enum e_routine_indexer_mode {
+    e_routine_indexer_stop,
+    e_routine_indexer_index,
+    e_routine_indexer_index_no_backboard,
+    e_routine_indexer_increment,       // sent every tick until the mode changes
+    e_routine_indexer_auto_increment,  // sent every tick until the mode changes
+    e_routine_indexer_run_upper,
+    e_routine_indexer_run_upper_reverse,
+    e_routine_indexer_run_lower_reverse
+} routine_indexer_mode;
+
+typedef enum e_routine_intake_mode {
+    e_routine_intakes_stop,
+    e_routine_intakes_intake,  // sent every tick until the mode changes
+    e_routine_intakes_rocket_outward,
+    e_routine_intakes_hold_outward
+} routine_intake_mode;
+
+
+/**
+ * file layout, all values little endian and the structs are written as is
+ * so loading is two freads and a checksum
+ *   routine_header
+ *   num_commands routine_commands
+ */
+typedef struct {
+    std::uint8_t opcode;
+    std::uint8_t flags;
+    std::uint16_t timeout;  // ms, 0 uses the default timeout of the command
+    float args[4];
+} routine_command;
+
+typedef struct {
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t num_commands;
+    char name[20];
+    std::uint32_t checksum;  // sum of every byte of the commands
+} routine_header;
+
+static_assert(sizeof(routine_command) == 20, "routine_command layout changed, update routine_compiler.py");
+static_assert(sizeof(routine_header) == 32, "routine_header layout changed, update routine_compiler.py");
+
+
+
+/**
+ * a routine read from the sd card
+ * every command is checked when it is loaded so running it never has to
+ */
+class Routine
+{
+    private:
+        routine_header header;
+        std::vector<routine_command> commands;
+
+        bool validate();
+
+    public:
+        Routine();
+
+        /**
+         * @param: const char* filename -> the file to read
+         * @return: bool -> false if the file is missing or not a valid routine
+         */
+        bool load(const char* filename);
+
+        const char* get_name() const;
+        int size() const;
+        const routine_command* data() const;
+};
+
+
+
+/**
+ * @see: Action.hpp
+ *
+ * runs a routine as an action
+ * chassis commands are always started asynchronously, commands without
+ * ROUTINE_FLAG_ASYNC wait for the chassis before the next command starts
+ * increment and intake modes are sent every tick like the loops in Autons.cpp
+ * plan_routine can be called while disabled so that starting each chassis
+ * command only has to look up its plan step
+ * a path is followed as one trajectory from where the robot is when the
+ * path starts, so it waits for chassis commands started before it, the
+ * trajectories are kept by the action so the routine only finishes once
+ * every chassis command it started has
+ */
+class RoutineAction
+{
+    private:
+        typedef enum {
+            e_wait_none,
+            e_wait_chassis,
+            e_wait_time,
+            e_wait_ball_top
+        } wait_type;
+
+        const Routine* routine;
+        Chassis* chassis;
+        Indexer* indexer;
+        Intakes* intakes;
+
+        int pc;
+        wait_type wait;
+        int wait_uid;
+        std::uint32_t wait_start;
+        std::uint32_t wait_duration;
+        int last_uid;
+        std::vector<Trajectory> trajectories;  // one per path in the routine
+        int num_paths;
+        int indexer_mode;
+        int intake_mode;
+
+        bool wait_finished();
+        int start_path(const routine_command& command, int timeout);
+        int execute(const routine_command& command);
+        void apply_modes();
+
+    public:
+        RoutineAction(const Routine& routine_data, Chassis& robot_chassis, Indexer& robot_indexer, Intakes& robot_intakes);
+
+        void start();
+        bool step();
+        void stop();
+
+        /**
+         * @param: const Routine& routine_data -> the routine that will be run
+         * @return: int -> the number of chassis commands planned
+         *
+         * @see: Chassis::plan_command
+         *
+         * replaces the chassis plan with the commands of the routine, they
+         * are planned with the same arguments execute will push them with
+         * planning stops at the first path because its trajectory depends
+         * on where the robot is when it starts
+         */
+        static int plan_routine(const Routine& routine_data);
+};
+
+
+
+#endif
@@ -0,0 +1,440 @@
+/**
+ * @file: ./RobotCode/src/objects/controller/InputRecorder.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: InputRecorder.hpp
+ *
+ * contains implementation for recording and replaying controller snapshots
+ */
+
+#include <cmath>
+
+#include "main.h"
+
+#include "../position_tracking/PositionTracker.hpp"
+#include "../serial/Logger.hpp"
+#include "InputRecorder.hpp"
+
+
+
+std::FILE* InputRecorder::file = NULL;
+pros::Task* InputRecorder::writer_thread = NULL;
+std::array<std::array<std::uint8_t, INPUT_RECORDER_BLOCK_SIZE>, 2> InputRecorder::blocks;
+int InputRecorder::active_block = 0;
+int InputRecorder::active_length = 0;
+std::atomic<int> InputRecorder::full_block = ATOMIC_VAR_INIT(-1);
+std::atomic<int> InputRecorder::full_length = ATOMIC_VAR_INIT(0);
+std::atomic<bool> InputRecorder::finish_requested = ATOMIC_VAR_INIT(false);
+
+std::atomic<bool> InputRecorder::recording = ATOMIC_VAR_INIT(false);
+int InputRecorder::record_start_time = 0;
+int InputRecorder::max_record_time = INT32_MAX;
+controller_snapshot InputRecorder::previous = {};
+bool InputRecorder::has_previous = false;
+int InputRecorder::idle_ticks = 0;
+input_recorder_stats InputRecorder::stats = {0, 0, 0, 0};
+
+std::atomic<bool> InputRecorder::replaying = ATOMIC_VAR_INIT(false);
+std::vector<std::uint8_t> InputRecorder::replay_data;
+int InputRecorder::replay_index = 0;
+int InputRecorder::replay_idle_ticks = 0;
+controller_snapshot InputRecorder::replay_snapshot = {};
+bool InputRecorder::closed_loop = false;
+int InputRecorder::forward_correction = 0;
+int InputRecorder::turn_correction = 0;
+
+double InputRecorder::kP_distance = 8;
+double InputRecorder::kP_heading = 60;
+int InputRecorder::max_correction = 40;
+
+
+
+void InputRecorder::writer_task(void*) {
+    while(1) {
+        int block = full_block;
+        if(block >= 0) {
+            std::fwrite(blocks.at(block).data(), 1, full_length, file);
+            std::fflush(file);
+            full_block = -1;
+        } else if(finish_requested) {  // recording stopped so the active block is no longer being written to
+            std::fwrite(blocks.at(active_block).data(), 1, active_length, file);
+            std::fclose(file);
+            active_length = 0;
+            file = NULL;
+            finish_requested = false;
+            return;
+        }
+        pros::delay(5);
+    }
+}
+
+
+
+void InputRecorder::hand_off_block() {
+    if(full_block >= 0) {  // writer has not finished the last block, drop this one instead of waiting
+        stats.dropped_blocks += 1;
+        has_previous = false;  // next record has every field so the stream can be decoded after the gap
+        active_length = 0;
+        return;
+    }
+
+    full_length = active_length;
+    full_block = active_block;
+    active_block = 1 - active_block;
+    active_length = 0;
+}
+
+
+
+void InputRecorder::write_byte(std::uint8_t byte) {
+    blocks.at(active_block).at(active_length) = byte;
+    active_length += 1;
+    stats.bytes += 1;
+}
+
+
+
+void InputRecorder::write_idle_ticks() {
+    if(idle_ticks > 0) {
+        write_byte(0x80 | (idle_ticks - 1));
+        idle_ticks = 0;
+    }
+}
+
+
+
+void InputRecorder::write_keyframe() {
+    position pos = PositionTracker::get_instance()->get_position();
+    std::int16_t x = std::round(pos.x_pos * 10);
+    std::int16_t y = std::round(pos.y_pos * 10);
+    std::int16_t theta = std::round(std::remainder((double)pos.theta, 2 * M_PI) * 1000);
+
+    write_byte(0x00);
+    write_byte(x & 0xFF);
+    write_byte((x >> 8) & 0xFF);
+    write_byte(y & 0xFF);
+    write_byte((y >> 8) & 0xFF);
+    write_byte(theta & 0xFF);
+    write_byte((theta >> 8) & 0xFF);
+    stats.keyframes += 1;
+}
+
+
+
+bool InputRecorder::start_recording(const char* filename /*INPUT_RECORDING_FILE*/, int max_time /*INT32_MAX*/) {
+    if(recording || replaying || file != NULL) {  // file is still set while the last recording is being closed
+        return false;
+    }
+
+    file = std::fopen(filename, "wb");
+    if(file == NULL) {
+        Logger logger;
+        log_entry entry;
+        entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", could not open " + std::string(filename) + " to record inputs";
+        entry.stream = "cerr";
+        logger.add(entry);
+        return false;
+    }
+
+    std::uint8_t header[8] = {'V', 'R', 'E', 'C', INPUT_RECORDER_VERSION, 5, INPUT_RECORDER_KEYFRAME_INTERVAL, 0};
+    std::fwrite(header, 1, sizeof(header), file);
+
+    active_block = 0;
+    active_length = 0;
+    full_block = -1;
+    finish_requested = false;
+    has_previous = false;
+    idle_ticks = 0;
+    stats = {0, 0, 0, 0};
+    record_start_time = pros::millis();
+    max_record_time = max_time;
+
+    if(writer_thread != NULL) {  // last writer task returned on its own
+        delete writer_thread;
+    }
+    writer_thread = new pros::Task( writer_task, (void*)NULL, TASK_PRIORITY_DEFAULT - 1, TASK_STACK_DEPTH_DEFAULT, "input_recorder_thread");
+    recording = true;
+
+    return true;
+}
+
+
+
+void InputRecorder::stop_recording() {
+    if(!recording) {
+        return;
+    }
+
+    recording = false;
+    if(active_length + 1 > INPUT_RECORDER_BLOCK_SIZE) {
+        hand_off_block();
+    }
+    write_idle_ticks();
+    finish_requested = true;
+
+    int elapsed_time = pros::millis() - record_start_time;
+    Logger logger;
+    log_entry entry;
+    entry.content = (
+        "[INFO] " + std::string("INPUT_RECORDER")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Ticks: " + std::to_string(stats.ticks)
+        + ", Bytes: " + std::to_string(stats.bytes)
+        + ", Keyframes: " + std::to_string(stats.keyframes)
+        + ", Dropped_Blocks: " + std::to_string(stats.dropped_blocks)
+        + ", Bytes_Per_Minute: " + std::to_string(60000.0 * stats.bytes / std::max(1, elapsed_time))
+    );
+    entry.stream = "clog";
+    logger.add(entry);
+}
+
+
+
+bool InputRecorder::is_recording() {
+    return recording;
+}
+
+
+
+void InputRecorder::record(const controller_snapshot& snapshot) {
+    if(!recording) {
+        return;
+    } else if(pros::millis() - record_start_time > max_record_time) {
+        stop_recording();
+        return;
+    }
+
+    // largest group of records for one tick is an idle run, a keyframe, and a full record
+    if(active_length + 24 > INPUT_RECORDER_BLOCK_SIZE) {
+        hand_off_block();
+    }
+
+    if(stats.ticks % INPUT_RECORDER_KEYFRAME_INTERVAL == 0) {
+        write_idle_ticks();
+        write_keyframe();
+    }
+    stats.ticks += 1;
+
+    std::uint8_t flags = 0;
+    if(!has_previous) {
+        flags = 0x7F;
+    } else {
+        flags |= (snapshot.buttons[0] != previous.buttons[0]) ? 0x01 : 0;
+        flags |= (snapshot.buttons[1] != previous.buttons[1]) ? 0x02 : 0;
+        for(int channel = 0; channel < NUM_ANALOG_CHANNELS; channel++) {
+            flags |= (snapshot.analog[0][channel] != previous.analog[0][channel]) ? (0x04 << channel) : 0;
+            flags |= (snapshot.analog[1][channel] != previous.analog[1][channel]) ? 0x40 : 0;
+        }
+    }
+
+    if(flags == 0) {
+        idle_ticks += 1;
+        if(idle_ticks == 128) {  // longest run that fits in one byte
+            write_idle_ticks();
+        }
+        return;
+    }
+
+    write_idle_ticks();
+    write_byte(flags);
+    if(flags & 0x01) {
+        write_byte(snapshot.buttons[0] & 0xFF);
+        write_byte(snapshot.buttons[0] >> 8);
+    }
+    if(flags & 0x02) {
+        write_byte(snapshot.buttons[1] & 0xFF);
+        write_byte(snapshot.buttons[1] >> 8);
+    }
+    for(int channel = 0; channel < NUM_ANALOG_CHANNELS; channel++) {
+        if(flags & (0x04 << channel)) {
+            write_byte(snapshot.analog[0][channel]);
+        }
+    }
+    if(flags & 0x40) {
+        for(int channel = 0; channel < NUM_ANALOG_CHANNELS; channel++) {
+            write_byte(snapshot.analog[1][channel]);
+        }
+    }
+
+    previous = snapshot;
+    has_previous = true;
+}
+
+
+
+bool InputRecorder::start_replay(const char* filename /*INPUT_RECORDING_FILE*/, bool correct_with_odometry /*false*/) {
+    if(recording || replaying) {
+        return false;
+    }
+
+    std::FILE* replay_file = std::fopen(filename, "rb");
+    if(replay_file == NULL) {
+        Logger logger;
+        log_entry entry;
+        entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", could not open " + std::string(filename) + " to replay inputs";
+        entry.stream = "cerr";
+        logger.add(entry);
+        return false;
+    }
+
+    // read the whole recording up front so replaying never waits on the sd card
+    replay_data.clear();
+    std::uint8_t buffer[INPUT_RECORDER_BLOCK_SIZE];
+    int num_read = 0;
+    while((num_read = std::fread(buffer, 1, sizeof(buffer), replay_file)) > 0) {
+        replay_data.insert(replay_data.end(), buffer, buffer + num_read);
+    }
+    std::fclose(replay_file);
+
+    if(
+        replay_data.size() < 8
+        || replay_data.at(0) != 'V' || replay_data.at(1) != 'R' || replay_data.at(2) != 'E' || replay_data.at(3) != 'C'
+        || replay_data.at(4) != INPUT_RECORDER_VERSION
+    ) {
+        Logger logger;
+        log_entry entry;
+        entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", " + std::string(filename) + " is not an input recording";
+        entry.stream = "cerr";
+        logger.add(entry);
+        return false;
+    }
+
+    replay_index = 8;
+    replay_idle_ticks = 0;
+    replay_snapshot = {};
+    replay_snapshot.connected[0] = true;
+    closed_loop = correct_with_odometry;
+    forward_correction = 0;
+    turn_correction = 0;
+    stats = {0, (int)replay_data.size(), 0, 0};
+    replaying = true;
+
+    return true;
+}
+
+
+
+void InputRecorder::stop_replay() {
+    replaying = false;
+}
+
+
+
+bool InputRecorder::is_replaying() {
+    return replaying;
+}
+
+
+
+std::uint8_t InputRecorder::read_byte() {
+    if(replay_index >= replay_data.size()) {
+        replaying = false;
+        return 0;
+    }
+    std::uint8_t byte = replay_data.at(replay_index);
+    replay_index += 1;
+    return byte;
+}
+
+
+
+std::int16_t InputRecorder::read_int16() {
+    std::uint8_t low = read_byte();  // separate statements so the bytes are read in order
+    std::uint8_t high = read_byte();
+    return low | (high << 8);
+}
+
+
+
+void InputRecorder::apply_keyframe(int x, int y, int theta) {
+    PositionTracker* tracker = PositionTracker::get_instance();
+    if(stats.keyframes == 0) {  // recorded path starts where the robot is now
+        tracker->set_position({x / 10.0, y / 10.0, theta / 1000.0});
+    }
+    stats.keyframes += 1;
+
+    position pos = tracker->get_position();
+    double dx = x / 10.0 - pos.x_pos;
+    double dy = y / 10.0 - pos.y_pos;
+    double along_track_error = dx * std::cos(pos.theta) + dy * std::sin(pos.theta);
+    double heading_error = std::remainder(theta / 1000.0 - (double)pos.theta, 2 * M_PI);
+
+    // corrections are held until the next keyframe
+    forward_correction = std::max(-max_correction, std::min(max_correction, (int)(kP_distance * along_track_error)));
+    turn_correction = std::max(-max_correction, std::min(max_correction, (int)(kP_heading * heading_error)));
+}
+
+
+
+bool InputRecorder::replay(controller_snapshot& snapshot) {
+    if(!replaying) {
+        return false;
+    }
+
+    if(replay_idle_ticks > 0) {
+        replay_idle_ticks -= 1;
+    } else {
+        std::uint8_t flags = read_byte();
+        while(flags == 0x00 && replaying) {  // keyframes come before the tick they belong to
+            std::int16_t x = read_int16();
+            std::int16_t y = read_int16();
+            std::int16_t theta = read_int16();
+            if(closed_loop) {
+                apply_keyframe(x, y, theta);
+            }
+            flags = read_byte();
+        }
+
+        if(!replaying) {
+            return false;
+        } else if(flags & 0x80) {
+            replay_idle_ticks = flags & 0x7F;  // this tick is the first of the run
+        } else {
+            if(flags & 0x01) {
+                replay_snapshot.buttons[0] = read_int16();
+            }
+            if(flags & 0x02) {
+                replay_snapshot.buttons[1] = read_int16();
+            }
+            for(int channel = 0; channel < NUM_ANALOG_CHANNELS; channel++) {
+                if(flags & (0x04 << channel)) {
+                    replay_snapshot.analog[0][channel] = read_byte();
+                }
+            }
+            if(flags & 0x40) {
+                for(int channel = 0; channel < NUM_ANALOG_CHANNELS; channel++) {
+                    replay_snapshot.analog[1][channel] = read_byte();
+                }
+            }
+        }
+    }
+    stats.ticks += 1;
+
+    // previous buttons are kept by Controller::update_snapshot so only the current values are copied
+    snapshot.buttons[0] = replay_snapshot.buttons[0];
+    snapshot.buttons[1] = replay_snapshot.buttons[1];
+    snapshot.connected[0] = true;
+    snapshot.connected[1] = false;
+    for(int i = 0; i < NUM_CONTROLLERS; i++) {
+        for(int channel = 0; channel < NUM_ANALOG_CHANNELS; channel++) {
+            snapshot.analog[i][channel] = replay_snapshot.analog[i][channel];
+        }
+    }
+
+    if(closed_loop) {  // tank drive, turning towards a larger heading speeds up the right side
+        int left = replay_snapshot.analog[0][pros::E_CONTROLLER_ANALOG_LEFT_Y] + forward_correction - turn_correction;
+        int right = replay_snapshot.analog[0][pros::E_CONTROLLER_ANALOG_RIGHT_Y] + forward_correction + turn_correction;
+        snapshot.analog[0][pros::E_CONTROLLER_ANALOG_LEFT_Y] = std::max(-127, std::min(127, left));
+        snapshot.analog[0][pros::E_CONTROLLER_ANALOG_RIGHT_Y] = std::max(-127, std::min(127, right));
+    }
+
+    return replaying;
+}
+
+
+
+input_recorder_stats InputRecorder::get_stats() {
+    return stats;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file: ./RobotCode/src/objects/controller/InputRecorder.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a recorder for controller snapshots so that driver control
+ * can be saved to the sd card and replayed as an autonomous
+ */
+
+#ifndef __INPUTRECORDER_HPP__
+#define __INPUTRECORDER_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "main.h"
+
+#include "controller.hpp"
+
+
+
+#define INPUT_RECORDING_FILE "/usd/driver_recording.bin"
+#define INPUT_RECORDER_BLOCK_SIZE 512
+#define INPUT_RECORDER_VERSION 1
+#define INPUT_RECORDER_KEYFRAME_INTERVAL 20  // ticks between odometry keyframes
+
+
+typedef struct {
+    int ticks;
+    int bytes;
+    int keyframes;
+    int dropped_blocks;  // blocks lost because the sd card fell behind
+} input_recorder_stats;
+
+
+
+/**
+ * @see: controller.hpp
+ *
+ * file format, all values little endian
+ *   header: "VREC", version, tick period in ms, keyframe interval, reserved
+ *   then one record per tick that starts with a flag byte
+ *     0x80 | (n - 1)  -> nothing changed for n ticks
+ *     0x00            -> odometry keyframe, int16 x and y in 0.1 inches and
+ *                        int16 heading in milliradians, the tick follows
+ *     otherwise       -> bit 0: master buttons (uint16), bit 1: partner buttons (uint16),
+ *                        bits 2-5: master axis 0-3 (int8), bit 6: all partner axes (4 x int8)
+ *
+ * records are written into one of two blocks by the control loop, when a
+ * block is full it is handed to a writer task so the loop never waits on
+ * the sd card
+ */
+class InputRecorder
+{
+    private:
+        static std::FILE* file;
+        static pros::Task* writer_thread;
+        static std::array<std::array<std::uint8_t, INPUT_RECORDER_BLOCK_SIZE>, 2> blocks;
+        static int active_block;
+        static int active_length;
+        static std::atomic<int> full_block;  // block waiting to be written, -1 if none
+        static std::atomic<int> full_length;
+        static std::atomic<bool> finish_requested;
+
+        static std::atomic<bool> recording;
+        static int record_start_time;
+        static int max_record_time;
+        static controller_snapshot previous;
+        static bool has_previous;
+        static int idle_ticks;
+        static input_recorder_stats stats;
+
+        static std::atomic<bool> replaying;
+        static std::vector<std::uint8_t> replay_data;
+        static int replay_index;
+        static int replay_idle_ticks;
+        static controller_snapshot replay_snapshot;
+        static bool closed_loop;
+        static int forward_correction;
+        static int turn_correction;
+
+        static void writer_task(void*);
+        static void hand_off_block();
+        static void write_byte(std::uint8_t byte);
+        static void write_idle_ticks();
+        static void write_keyframe();
+        static void apply_keyframe(int x, int y, int theta);
+        static std::uint8_t read_byte();
+        static std::int16_t read_int16();
+
+    public:
+        static double kP_distance;  // axis counts per inch of error along the heading
+        static double kP_heading;  // axis counts per radian of heading error
+        static int max_correction;
+
+        /**
+         * @param: const char* filename -> the file to write to
+         * @param: int max_time -> the time in ms to record for before stopping on its own
+         * @return: bool -> false if the file could not be opened
+         *
+         * starts saving every controller snapshot taken by Controller::update_snapshot
+         */
+        static bool start_recording(const char* filename=INPUT_RECORDING_FILE, int max_time=INT32_MAX);
+
+        /**
+         * @return: None
+         *
+         * writes what is left of the recording and closes the file
+         * the file is closed by the writer task shortly after this returns
+         */
+        static void stop_recording();
+        static bool is_recording();
+
+        /**
+         * @param: const controller_snapshot& snapshot -> the snapshot that was just taken
+         * @return: None
+         *
+         * encodes the changes since the last snapshot into the active block
+         */
+        static void record(const controller_snapshot& snapshot);
+
+        /**
+         * @param: const char* filename -> the file to read from
+         * @param: bool correct_with_odometry -> if the drive axes should be adjusted towards the recorded odometry
+         * @return: bool -> false if the file could not be read
+         *
+         * loads a recording so that Controller::update_snapshot returns it
+         * instead of the controllers, one tick at a time
+         */
+        static bool start_replay(const char* filename=INPUT_RECORDING_FILE, bool correct_with_odometry=false);
+        static void stop_replay();
+        static bool is_replaying();
+
+        /**
+         * @param: controller_snapshot& snapshot -> filled with the next tick of the recording
+         * @return: bool -> false when the recording is finished
+         */
+        static bool replay(controller_snapshot& snapshot);
+
+        static input_recorder_stats get_stats();
+};
+
+
+
+#endif
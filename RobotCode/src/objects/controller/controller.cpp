@@ -17,39 +17,14 @@
 #include "../../../include/pros/rtos.hpp"
 #include "../../../include/pros/motors.hpp"
 
+#include "../diagnostics/AllocationTracker.hpp"
 #include "controller.hpp"
+#include "InputRecorder.hpp"
 
 
 
-std::unordered_map <pros::controller_digital_e_t, std::deque<bool>* > Controller::master_btn_history = {
-    {pros::E_CONTROLLER_DIGITAL_L1, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_L2, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_R2, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_R1, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_UP, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_DOWN, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_LEFT, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_RIGHT, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_X, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_B, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_Y, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_A, new std::deque<bool>}
-};
-
-std::unordered_map <pros::controller_digital_e_t, std::deque<bool>* > Controller::partner_btn_history = {
-    {pros::E_CONTROLLER_DIGITAL_L1, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_L2, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_R2, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_R1, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_UP, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_DOWN, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_LEFT, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_RIGHT, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_X, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_B, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_Y, new std::deque<bool>},
-    {pros::E_CONTROLLER_DIGITAL_A, new std::deque<bool>}
-};
+controller_snapshot Controller::snapshot = {};
+std::atomic<bool> Controller::lock = ATOMIC_VAR_INIT(false);
 
 pros::Controller Controller::master(pros::E_CONTROLLER_MASTER);
 pros::Controller Controller::partner(pros::E_CONTROLLER_PARTNER);
@@ -113,73 +88,99 @@ Controller::~Controller()
 }
 
 
-void Controller::update_button_history()
-{
-    for (std::pair<pros::controller_digital_e_t, std::deque<bool>*> element : master_btn_history) {
-        element.second->push_back(master.get_digital(element.first));
-        if(element.second->size() > 3) {
-            element.second->pop_front();
-        } 
-        
-        while(element.second->size() < 3) {  // forces deque size to be no less than 3
-            element.second->push_back(master.get_digital(element.first));
+void Controller::read_controller(pros::Controller& controller, int index, controller_snapshot& new_snapshot) {
+    std::uint16_t buttons = 0;
+    for(int btn = pros::E_CONTROLLER_DIGITAL_L1; btn <= pros::E_CONTROLLER_DIGITAL_A; btn++) {
+        if(controller.get_digital(static_cast<pros::controller_digital_e_t>(btn))) {
+            buttons |= button_mask(static_cast<pros::controller_digital_e_t>(btn));
         }
     }
+    new_snapshot.buttons[index] = buttons;
     
-    for (std::pair<pros::controller_digital_e_t, std::deque<bool>*> element : partner_btn_history) {
-        element.second->push_back(master.get_digital(element.first));
-        if(element.second->size() > 3) {
-            element.second->pop_front();
-        }
-        
-        while(element.second->size() < 3) {  // forces deque size to be no less than 3
-            element.second->push_back(master.get_digital(element.first));
-        }
+    for(int channel = 0; channel < NUM_ANALOG_CHANNELS; channel++) {
+        new_snapshot.analog[index][channel] = controller.get_analog(static_cast<pros::controller_analog_e_t>(channel));
     }
 }
 
 
-bool Controller::btn_get_release(pros::controller_digital_e_t btn, int controller /** 0 **/) {
-    bool pressed_and_released = false;
-    if(!controller) {
-        if(master_btn_history.at(btn)->at(1) && !master_btn_history.at(btn)->at(2)) {
-            pressed_and_released = true;
-        }
+void Controller::update_snapshot()
+{
+    AllocationScope allocation_scope(e_alloc_controller);  // the snapshot does not allocate, anything counted here is new
+    // read into a copy so the lock is not held while waiting on the controllers
+    while ( lock.exchange( true ) ); //aquire lock
+    controller_snapshot new_snapshot = snapshot;
+    lock.exchange( false ); //release lock
+    
+    for(int i = 0; i < NUM_CONTROLLERS; i++) {
+        new_snapshot.previous_buttons[i] = new_snapshot.buttons[i];
     }
-    else {
-        if(partner_btn_history.at(btn)->at(1) && !partner_btn_history.at(btn)->at(2)) {
-            pressed_and_released = true;
+    
+    if(InputRecorder::is_replaying()) {  // replayed inputs take the place of the controllers
+        InputRecorder::replay(new_snapshot);
+    } else {
+        new_snapshot.connected[0] = true;  // driver control can not run without the master controller
+        read_controller(master, 0, new_snapshot);
+        
+        new_snapshot.connected[1] = partner.is_connected();
+        if(new_snapshot.connected[1]) {
+            read_controller(partner, 1, new_snapshot);
+        } else {  // avoid reading twelve buttons that can not be pressed
+            new_snapshot.buttons[1] = 0;
+            for(int channel = 0; channel < NUM_ANALOG_CHANNELS; channel++) {
+                new_snapshot.analog[1][channel] = 0;
+            }
         }
+        
+        InputRecorder::record(new_snapshot);
     }
-    return pressed_and_released;
+    new_snapshot.time = pros::millis();
+    
+    while ( lock.exchange( true ) ); //aquire lock
+    snapshot = new_snapshot;
+    lock.exchange( false ); //release lock
 }
 
 
-bool Controller::btn_get_start_press(pros::controller_digital_e_t btn, int controller /** 0 **/) {
-    bool press_start = false;
-    if(!controller) {
-        if(!master_btn_history.at(btn)->at(1) && master_btn_history.at(btn)->at(2)) {
-            press_start = true;
+controller_snapshot Controller::get_snapshot(int max_age /*INT32_MAX*/)
+{
+    while ( lock.exchange( true ) ); //aquire lock
+    controller_snapshot current_snapshot = snapshot;
+    lock.exchange( false ); //release lock
+    
+    // nothing is updating it so read the controllers into the copy only, updating the
+    // shared snapshot here would take edges from driver control and step the recorder
+    if(pros::millis() - current_snapshot.time > max_age && !InputRecorder::is_replaying()) {
+        current_snapshot.connected[0] = true;
+        read_controller(master, 0, current_snapshot);
+        current_snapshot.connected[1] = partner.is_connected();
+        if(current_snapshot.connected[1]) {
+            read_controller(partner, 1, current_snapshot);
         }
-    }
-    else {
-        if(!partner_btn_history.at(btn)->at(1) && partner_btn_history.at(btn)->at(2)) {
-            press_start = true;
+        for(int i = 0; i < NUM_CONTROLLERS; i++) {  // there is no previous read so there are no edges
+            current_snapshot.previous_buttons[i] = current_snapshot.buttons[i];
         }
+        current_snapshot.time = pros::millis();
     }
+    
+    return current_snapshot;
+}
+
+
+bool Controller::btn_get_release(pros::controller_digital_e_t btn, int controller /** 0 **/) {
+    return get_snapshot().released(controller) & button_mask(btn);
+}
 
-    return press_start;
+
+bool Controller::btn_get_start_press(pros::controller_digital_e_t btn, int controller /** 0 **/) {
+    return get_snapshot().pressed(controller) & button_mask(btn);
 }
 
 
 bool Controller::btn_is_pressing(pros::controller_digital_e_t btn, int controller /** 0 **/) {
-    bool pressing = false;
-    if(!controller) {
-        pressing = master_btn_history.at(btn)->at(2);
-    }
-    else {
-        pressing = partner_btn_history.at(btn)->at(2);
-    }
+    return get_snapshot().is_pressing(btn, controller);
+}
+
 
-    return pressing;
+int Controller::get_analog(pros::controller_analog_e_t channel, int controller /** 0 **/) {
+    return get_snapshot().analog[controller][channel];
 }
@@ -8,9 +8,10 @@
  * contains class that has data about controllers
  */
 
+#include <atomic>
+#include <cstdint>
 #include <unordered_map>
 #include <string>
-#include <deque>
 
 #include "../../../include/main.h"
 #include "../../../include/api.h"
@@ -20,6 +21,48 @@
 #ifndef __CONTROLLER_HPP__
 #define __CONTROLLER_HPP__
 
+
+#define NUM_CONTROLLERS 2
+#define NUM_ANALOG_CHANNELS 4
+
+
+/**
+ * @param: pros::controller_digital_e_t btn -> the button
+ * @return: std::uint16_t -> the bit for the button in a controller_snapshot button mask
+ */
+constexpr std::uint16_t button_mask(pros::controller_digital_e_t btn) {
+    return 1 << (btn - pros::E_CONTROLLER_DIGITAL_L1);
+}
+
+
+/**
+ * the state of both controllers read at one time
+ * buttons are stored as bitmasks from button_mask so that edges for every
+ * button are found with a couple of bit operations
+ * index 0 is the master controller and index 1 is the partner controller
+ */
+struct controller_snapshot {
+    std::uint32_t time;
+    std::uint16_t buttons[NUM_CONTROLLERS];
+    std::uint16_t previous_buttons[NUM_CONTROLLERS];
+    std::int8_t analog[NUM_CONTROLLERS][NUM_ANALOG_CHANNELS];  // indexed by pros::controller_analog_e_t
+    bool connected[NUM_CONTROLLERS];
+    
+    constexpr std::uint16_t pressed(int controller=0) const {  // went down since the last snapshot
+        return buttons[controller] & ~previous_buttons[controller];
+    }
+    constexpr std::uint16_t released(int controller=0) const {  // came up since the last snapshot
+        return ~buttons[controller] & previous_buttons[controller];
+    }
+    constexpr std::uint16_t held(int controller=0) const {  // down in this and the last snapshot
+        return buttons[controller] & previous_buttons[controller];
+    }
+    constexpr bool is_pressing(pros::controller_digital_e_t btn, int controller=0) const {
+        return buttons[controller] & button_mask(btn);
+    }
+};
+
+
 /**
  * contains controller objects as well as unordered maps that hold information
  * about what the controller does
@@ -28,8 +71,10 @@
 class Controller
 {
     private:
-        static std::unordered_map <pros::controller_digital_e_t, std::deque<bool>* > master_btn_history;
-        static std::unordered_map <pros::controller_digital_e_t, std::deque<bool>* > partner_btn_history;
+        static controller_snapshot snapshot;
+        static std::atomic<bool> lock;
+        
+        static void read_controller(pros::Controller& controller, int index, controller_snapshot& new_snapshot);
 
     public:
         Controller();
@@ -43,11 +88,34 @@ class Controller
         static std::unordered_map <pros::controller_digital_e_t, std::string> MASTER_CONTROLLER_DIGITAL_MAPPINGS;
         static std::unordered_map <pros::controller_digital_e_t, std::string>  PARTNER_CONTROLLER_DIGITAL_MAPPINGS;
         
-        void update_button_history();
+        /**
+         * @return: None
+         *
+         * reads every button and axis of both controllers into the shared snapshot
+         * and moves the current buttons to the previous buttons for edge detection
+         * the partner controller is only read if it is connected
+         * while InputRecorder is replaying the recording is used instead of the controllers
+         * and while it is recording each snapshot is saved
+         * should be called once per loop by the one loop that uses edges, ie. driver control
+         */
+        void update_snapshot();
+        
+        /**
+         * @param: int max_age -> the oldest in ms the snapshot can be before it is read again
+         * @return: controller_snapshot -> a copy of the shared snapshot
+         *
+         * lets other tasks like the lcd use the values read by driver control
+         * when nothing has updated it recently the controllers are read into the
+         * copy, the shared snapshot is only ever updated by update_snapshot so
+         * readers can not take button edges from driver control
+         */
+        static controller_snapshot get_snapshot(int max_age=INT32_MAX);
         
+        // these read a copy of the snapshot taken under the lock
         bool btn_get_release(pros::controller_digital_e_t btn, int controller=0);
         bool btn_get_start_press(pros::controller_digital_e_t btn, int controller=0);
         bool btn_is_pressing(pros::controller_digital_e_t btn, int controller=0);
+        int get_analog(pros::controller_analog_e_t channel, int controller=0);
 
 };
 
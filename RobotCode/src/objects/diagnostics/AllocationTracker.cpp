@@ -0,0 +1,334 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/AllocationTracker.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: AllocationTracker.hpp
+ *
+ * contains implementation for the heap allocation tracker and the
+ * replacement operator new and delete
+ */
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "main.h"
+
+#include "AllocationTracker.hpp"
+
+
+
+std::array<std::atomic<int>, e_alloc_num_tags> AllocationTracker::live_bytes;
+std::array<std::atomic<int>, e_alloc_num_tags> AllocationTracker::peak_bytes;
+std::array<std::atomic<int>, e_alloc_num_tags> AllocationTracker::allocations;
+std::array<std::atomic<int>, e_alloc_num_tags> AllocationTracker::frees;
+
+std::array<std::atomic<void*>, ALLOCATION_MAX_TASKS> AllocationTracker::task_handles;
+std::array<std::atomic<int>, ALLOCATION_MAX_TASKS> AllocationTracker::task_tags;
+std::atomic<int> AllocationTracker::startup_tag = ATOMIC_VAR_INIT(e_alloc_untagged);
+
+std::atomic<bool> AllocationTracker::sample_lock = ATOMIC_VAR_INIT(false);
+int AllocationTracker::last_sample_time = 0;
+std::array<int, e_alloc_num_tags> AllocationTracker::last_sample_allocations;
+std::array<int, e_alloc_num_tags> AllocationTracker::allocation_rates;
+
+// every member above is zero or constant initialized so operator new can
+// be called by other static constructors before this file is initialized
+
+
+
+bool AllocationTracker::is_enabled() {
+#ifdef ALLOCATION_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+
+alloc_tag AllocationTracker::get_current_tag() {
+    void* task = pros::c::task_get_current();
+    if(task == NULL) {
+        return static_cast<alloc_tag>(startup_tag.load());
+    }
+
+    for(int i = 0; i < ALLOCATION_MAX_TASKS; i++) {
+        if(task_handles[i] == task) {
+            return static_cast<alloc_tag>(task_tags[i].load());
+        }
+    }
+
+    return e_alloc_untagged;
+}
+
+
+
+/**
+ * a task only ever changes its own slot so the tag and handle do not need
+ * to be set together, the slot is given back when the task leaves its
+ * outermost scope
+ */
+void AllocationTracker::set_current_tag(alloc_tag tag) {
+    void* task = pros::c::task_get_current();
+    if(task == NULL) {
+        startup_tag = tag;
+        return;
+    }
+
+    for(int i = 0; i < ALLOCATION_MAX_TASKS; i++) {
+        if(task_handles[i] == task) {
+            task_tags[i] = tag;
+            if(tag == e_alloc_untagged) {
+                task_handles[i] = NULL;
+            }
+            return;
+        }
+    }
+
+    if(tag == e_alloc_untagged) {
+        return;
+    }
+
+    for(int i = 0; i < ALLOCATION_MAX_TASKS; i++) {
+        void* expected = NULL;
+        if(task_handles[i].compare_exchange_strong(expected, task)) {
+            task_tags[i] = tag;
+            return;
+        }
+    }
+}
+
+
+
+void AllocationTracker::record_allocation(alloc_tag tag, int size) {
+    int live = live_bytes[tag].fetch_add(size) + size;
+    allocations[tag] += 1;
+
+    int peak = peak_bytes[tag];
+    while(live > peak && !peak_bytes[tag].compare_exchange_weak(peak, live));
+}
+
+
+
+void AllocationTracker::record_free(alloc_tag tag, int size) {
+    live_bytes[tag] -= size;
+    frees[tag] += 1;
+}
+
+
+
+void AllocationTracker::sample() {
+    if(sample_lock.exchange( true )) {  // another task is already sampling
+        return;
+    }
+
+    int time = pros::millis();
+    int elapsed = time - last_sample_time;
+    if(elapsed >= ALLOCATION_SAMPLE_INTERVAL) {
+        for(int i = 0; i < e_alloc_num_tags; i++) {
+            int total = allocations[i];
+            allocation_rates[i] = ((total - last_sample_allocations[i]) * 1000) / elapsed;
+            last_sample_allocations[i] = total;
+        }
+        last_sample_time = time;
+    }
+
+    sample_lock.exchange( false ); //release lock
+}
+
+
+
+allocation_stats AllocationTracker::get_stats(alloc_tag tag) {
+    allocation_stats stats;
+    stats.live_bytes = live_bytes.at(tag);
+    stats.peak_bytes = peak_bytes.at(tag);
+    stats.allocations = allocations.at(tag);
+    stats.frees = frees.at(tag);
+    stats.allocations_per_second = allocation_rates.at(tag);
+
+    return stats;
+}
+
+
+
+allocation_stats AllocationTracker::get_total_stats() {
+    allocation_stats total = {0, 0, 0, 0, 0};
+    for(int i = 0; i < e_alloc_num_tags; i++) {
+        allocation_stats stats = get_stats(static_cast<alloc_tag>(i));
+        total.live_bytes += stats.live_bytes;
+        total.peak_bytes += stats.peak_bytes;
+        total.allocations += stats.allocations;
+        total.frees += stats.frees;
+        total.allocations_per_second += stats.allocations_per_second;
+    }
+
+    return total;
+}
+
+
+
+const char* AllocationTracker::get_tag_name(alloc_tag tag) {
+    const char* names[] = {
+        "untagged",
+        "motors",
+        "sensors",
+        "controller",
+        "logger",
+        "server",
+        "chassis",
+        "indexer",
+        "position",
+        "lcd",
+        "autons"
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == e_alloc_num_tags, "every tag needs a name");
+
+    if(tag < 0 || tag >= e_alloc_num_tags) {
+        return "invalid";
+    }
+
+    return names[tag];
+}
+
+
+
+std::string AllocationTracker::get_report() {
+    std::string report;
+    for(int i = 0; i < e_alloc_num_tags; i++) {
+        allocation_stats stats = get_stats(static_cast<alloc_tag>(i));
+        report += (
+            std::string(get_tag_name(static_cast<alloc_tag>(i)))
+            + "," + std::to_string(stats.live_bytes)
+            + "," + std::to_string(stats.peak_bytes)
+            + "," + std::to_string(stats.allocations_per_second)
+            + "," + std::to_string(stats.allocations)
+            + ";"
+        );
+    }
+
+    return report;
+}
+
+
+
+AllocationScope::AllocationScope(alloc_tag tag) {
+#ifdef ALLOCATION_TRACKING
+    previous_tag = AllocationTracker::get_current_tag();
+    AllocationTracker::set_current_tag(tag);
+#else
+    previous_tag = e_alloc_untagged;
+#endif
+}
+
+
+
+AllocationScope::~AllocationScope() {
+#ifdef ALLOCATION_TRACKING
+    AllocationTracker::set_current_tag(previous_tag);
+#endif
+}
+
+
+
+#ifdef ALLOCATION_TRACKING
+
+/**
+ * the header is padded to the largest alignment malloc gives so the memory
+ * after it is aligned the same way malloc would have aligned it
+ */
+typedef struct {
+    std::uint32_t size;
+    std::uint32_t tag;
+} allocation_header;
+
+static constexpr std::size_t header_size = alignof(std::max_align_t);
+static_assert(sizeof(allocation_header) <= header_size, "allocation header does not fit before the block");
+
+
+
+static void* tracked_allocate(std::size_t size) {
+    void* block = std::malloc(size + header_size);
+    if(block == NULL) {
+        return NULL;
+    }
+
+    alloc_tag tag = AllocationTracker::get_current_tag();
+    allocation_header* header = static_cast<allocation_header*>(block);
+    header->size = size;
+    header->tag = tag;
+    AllocationTracker::record_allocation(tag, size);
+
+    return static_cast<char*>(block) + header_size;
+}
+
+
+
+static void tracked_free(void* pointer) {
+    if(pointer == NULL) {
+        return;
+    }
+
+    void* block = static_cast<char*>(pointer) - header_size;
+    allocation_header* header = static_cast<allocation_header*>(block);
+    AllocationTracker::record_free(static_cast<alloc_tag>(header->tag), header->size);
+    std::free(block);
+}
+
+
+
+void* operator new(std::size_t size) {
+    void* pointer = tracked_allocate(size);
+    if(pointer == NULL) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    void* pointer = tracked_allocate(size);
+    if(pointer == NULL) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return tracked_allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return tracked_allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    tracked_free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    tracked_free(pointer);
+}
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/AllocationTracker.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a heap allocation tracker that counts memory used by each
+ * subsystem
+ * tracking is only compiled in when ALLOCATION_TRACKING is defined, add
+ * -DALLOCATION_TRACKING to EXTRA_CXXFLAGS in the Makefile to turn it on
+ */
+
+#ifndef __ALLOCATIONTRACKER_HPP__
+#define __ALLOCATIONTRACKER_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+
+
+#define ALLOCATION_MAX_TASKS 16  // tasks that can be inside a scope at the same time
+#define ALLOCATION_SAMPLE_INTERVAL 1000  // ms between updates of allocations per second
+
+
+typedef enum {
+    e_alloc_untagged,
+    e_alloc_motors,
+    e_alloc_sensors,
+    e_alloc_controller,
+    e_alloc_logger,
+    e_alloc_server,
+    e_alloc_chassis,
+    e_alloc_indexer,
+    e_alloc_position_tracker,
+    e_alloc_lcd,
+    e_alloc_autons,
+    e_alloc_num_tags
+} alloc_tag;
+
+typedef struct {
+    int live_bytes;  // allocated and not freed yet
+    int peak_bytes;
+    int allocations;  // since startup
+    int frees;
+    int allocations_per_second;  // over the last sample interval
+} allocation_stats;
+
+
+
+/**
+ * every allocation made through operator new gets a small header with its
+ * size and the tag of the scope it was made in, so a free is counted
+ * against the subsystem that allocated the memory even if another one
+ * frees it
+ * the tag is kept per task in a fixed table because the scheduler can
+ * switch tasks in the middle of a scope
+ * nothing here allocates or takes a lock that could be held by a lower
+ * priority task, the counters are atomics
+ */
+class AllocationTracker
+{
+    private:
+        static std::array<std::atomic<int>, e_alloc_num_tags> live_bytes;
+        static std::array<std::atomic<int>, e_alloc_num_tags> peak_bytes;
+        static std::array<std::atomic<int>, e_alloc_num_tags> allocations;
+        static std::array<std::atomic<int>, e_alloc_num_tags> frees;
+
+        static std::array<std::atomic<void*>, ALLOCATION_MAX_TASKS> task_handles;  // NULL if the slot is free
+        static std::array<std::atomic<int>, ALLOCATION_MAX_TASKS> task_tags;
+        static std::atomic<int> startup_tag;  // used before the scheduler has started
+
+        static std::atomic<bool> sample_lock;
+        static int last_sample_time;
+        static std::array<int, e_alloc_num_tags> last_sample_allocations;
+        static std::array<int, e_alloc_num_tags> allocation_rates;
+
+    public:
+        /**
+         * @return: bool -> true if the program was built with ALLOCATION_TRACKING
+         */
+        static bool is_enabled();
+
+        /**
+         * @return: alloc_tag -> the tag of the scope the current task is in
+         */
+        static alloc_tag get_current_tag();
+
+        /**
+         * @param: alloc_tag tag -> the tag for allocations made by the current task
+         * @return: None
+         *
+         * use AllocationScope instead of calling this directly
+         * if every slot is taken allocations stay untagged
+         */
+        static void set_current_tag(alloc_tag tag);
+
+        /**
+         * @param: alloc_tag tag -> the tag the memory is counted against
+         * @param: int size -> bytes allocated or freed
+         * @return: None
+         *
+         * called by operator new and delete
+         */
+        static void record_allocation(alloc_tag tag, int size);
+        static void record_free(alloc_tag tag, int size);
+
+        /**
+         * @return: None
+         *
+         * updates allocations per second if the sample interval has passed
+         * since the last update, safe to call from more than one task
+         */
+        static void sample();
+
+        /**
+         * @param: alloc_tag tag -> the subsystem to get stats for
+         * @return: allocation_stats -> the counters for the subsystem
+         */
+        static allocation_stats get_stats(alloc_tag tag);
+
+        /**
+         * @return: allocation_stats -> the counters summed over every subsystem
+         *
+         * the peak is the sum of the peaks, not the peak of the total
+         */
+        static allocation_stats get_total_stats();
+
+        static const char* get_tag_name(alloc_tag tag);
+
+        /**
+         * @return: std::string -> one "name,live,peak,allocations per second,allocations;"
+         *                         group per subsystem
+         */
+        static std::string get_report();
+};
+
+
+
+/**
+ * allocations made while the scope is alive are counted against the tag,
+ * scopes can be nested, the previous tag is put back when it is destroyed
+ *
+ * AllocationScope scope(e_alloc_motors);
+ *
+ * does nothing if the program was not built with ALLOCATION_TRACKING
+ */
+class AllocationScope
+{
+    private:
+        alloc_tag previous_tag;
+
+    public:
+        AllocationScope(alloc_tag tag);
+        ~AllocationScope();
+
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator=(const AllocationScope&) = delete;
+};
+
+
+
+#endif
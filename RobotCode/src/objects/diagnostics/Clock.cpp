@@ -0,0 +1,39 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/Clock.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: Clock.hpp
+ *
+ * contains implementation for the microsecond timer
+ */
+
+#include <cstdint>
+
+#ifdef HOST_BUILD
+#include <chrono>
+#endif
+
+#include "Clock.hpp"
+
+
+
+#ifdef HOST_BUILD
+
+static const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+std::uint64_t Clock::get_micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+#else
+
+// part of the vex sdk that pros links against, pros does not declare it
+extern "C" std::uint64_t vexSystemHighResTimeGet(void);
+
+std::uint64_t Clock::get_micros() {
+    return vexSystemHighResTimeGet();
+}
+
+#endif
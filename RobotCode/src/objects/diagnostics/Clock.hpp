@@ -0,0 +1,30 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/Clock.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a microsecond timer for measuring things that are shorter than
+ * the 1ms resolution of pros::millis
+ * define HOST_BUILD when compiling for a computer instead of the brain
+ */
+
+#ifndef __CLOCK_HPP__
+#define __CLOCK_HPP__
+
+#include <cstdint>
+
+
+
+class Clock
+{
+    public:
+        /**
+         * @return: std::uint64_t -> microseconds since the program started
+         */
+        static std::uint64_t get_micros();
+};
+
+
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/CommandLatency.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: CommandLatency.hpp
+ *
+ * contains implementation for the enable to first command probe
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "main.h"
+
+#include "../serial/Logger.hpp"
+#include "Clock.hpp"
+#include "CommandLatency.hpp"
+
+
+
+std::atomic<const void*> CommandLatency::probe = ATOMIC_VAR_INIT(nullptr);
+std::uint64_t CommandLatency::start_time = 0;
+std::atomic<int> CommandLatency::latency = ATOMIC_VAR_INIT(-1);
+
+
+
+void CommandLatency::start(const void* motor)
+{
+    latency = -1;
+    start_time = Clock::get_micros();
+    probe = motor;
+}
+
+
+
+void CommandLatency::record()
+{
+    // only the first command after start is recorded
+    const void* expected = probe.load();
+    if(expected == nullptr || !probe.compare_exchange_strong(expected, nullptr)) {
+        return;
+    }
+    latency = Clock::get_micros() - start_time;
+
+    Logger logger;
+    log_entry entry;
+    entry.content = (
+        "[INFO] " + std::string("Command Latency")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Enable_To_First_Command_us: " + std::to_string(latency)
+    );
+    entry.stream = "clog";
+    logger.add(entry);
+}
+
+
+
+int CommandLatency::get_latency()
+{
+    return latency;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/CommandLatency.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a probe that measures the time from when autonomous is enabled
+ * to when a motor is first told to move
+ */
+
+#ifndef __COMMANDLATENCY_HPP__
+#define __COMMANDLATENCY_HPP__
+
+#include <atomic>
+#include <cstdint>
+
+
+
+/**
+ * start is called when autonomous is enabled and check is called by the
+ * motor every time a setpoint changes, the first non zero setpoint on the
+ * probed motor after start is logged with the time it took to get there
+ * check is only a load and a compare when the probe is not armed
+ */
+class CommandLatency
+{
+    private:
+        static std::atomic<const void*> probe;
+        static std::uint64_t start_time;
+        static std::atomic<int> latency;
+
+        static void record();
+
+    public:
+        /**
+         * @param: const void* motor -> the motor to watch for its first command
+         * @return: None
+         */
+        static void start(const void* motor);
+
+        /**
+         * @param: const void* motor -> the motor whose setpoint changed
+         * @param: int setpoint -> the new setpoint
+         * @return: None
+         */
+        static void check(const void* motor, int setpoint) {
+            if(setpoint != 0 && probe.load(std::memory_order_relaxed) == motor) {
+                record();
+            }
+        }
+
+        /**
+         * @return: int -> us from the last start to the first command, -1 if
+         *                 there has not been a command since
+         */
+        static int get_latency();
+};
+
+
+
+#endif
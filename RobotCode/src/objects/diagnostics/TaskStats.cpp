@@ -0,0 +1,392 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/TaskStats.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: TaskStats.hpp
+ *
+ * contains implementation for the task statistics module
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef HOST_BUILD
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#include "main.h"
+
+#include "Clock.hpp"
+#include "TaskStats.hpp"
+
+
+
+std::array<task_stats_entry, TASK_STATS_MAX_TASKS> TaskStats::tasks;
+std::atomic<int> TaskStats::num_tasks = ATOMIC_VAR_INIT(0);
+
+pros::Task* TaskStats::sampler_thread = NULL;
+std::atomic<bool> TaskStats::sample_lock = ATOMIC_VAR_INIT(false);
+float TaskStats::total_samples = 0;
+int TaskStats::last_sample_time = 0;
+
+
+
+/**
+ * the parts that depend on the scheduler, on the host each task is a
+ * thread and its cpu time is read from the thread cpu clock
+ */
+#ifdef HOST_BUILD
+
+static std::array<clockid_t, TASK_STATS_MAX_TASKS> host_clocks;
+
+static bool read_host_cpu_time(int id, std::uint64_t& cpu_time) {
+    timespec time;
+    if(clock_gettime(host_clocks.at(id), &time) != 0) {  // fails once the thread has exited
+        return false;
+    }
+
+    cpu_time = static_cast<std::uint64_t>(time.tv_sec) * 1000000 + time.tv_nsec / 1000;
+    return true;
+}
+
+#endif
+
+
+
+void TaskStats::start() {
+#ifndef HOST_BUILD
+    if(sampler_thread == NULL) {
+        sampler_thread = new pros::Task(sampler_task, (void*)NULL, TASK_PRIORITY_MAX - 1, TASK_STACK_DEPTH_MIN, "task_stats_sampler");
+    }
+#endif
+}
+
+
+
+/**
+ * the sampler only runs for a few us each ms, it preempts every task it
+ * measures so a task that is ready at that moment was either running or
+ * waiting on another task of the same priority
+ * the lock is only tried so the sampler never waits on a lower priority task
+ */
+void TaskStats::sampler_task(void*) {
+#ifndef HOST_BUILD
+    std::array<int, TASK_STATS_MAX_TASKS> ready;
+    while(1) {
+        if(!sample_lock.exchange( true )) {
+            int count = std::min(num_tasks.load(), TASK_STATS_MAX_TASKS);
+            int num_ready = 0;
+            for(int i = 0; i < count; i++) {
+                if(!tasks.at(i).active) {
+                    continue;
+                }
+                pros::task_state_e_t state = pros::c::task_get_state(tasks.at(i).handle);
+                if(state == pros::E_TASK_STATE_READY || state == pros::E_TASK_STATE_RUNNING) {
+                    ready.at(num_ready) = i;
+                    num_ready += 1;
+                }
+            }
+
+            for(int i = 0; i < num_ready; i++) {
+                tasks.at(ready.at(i)).cpu_samples += 1.0 / num_ready;
+            }
+            total_samples += 1;
+            sample_lock.exchange( false ); //release lock
+        }
+
+        pros::delay(TASK_STATS_SAMPLER_PERIOD);
+    }
+#endif
+}
+
+
+
+/**
+ * on the host the thread library knows where the stack of each thread is
+ * on the brain a task handle points at the FreeRTOS task control block,
+ * which keeps the lowest address of the stack right before the task name,
+ * the layout is only trusted if the name pros gives back is where it should
+ * be and the stack starts below where the task is now
+ * returns 0 if the stack holding top can not be found
+ */
+std::uintptr_t TaskStats::find_stack_base(std::uintptr_t top) {
+#ifdef HOST_BUILD
+    pthread_attr_t attributes;
+    if(pthread_getattr_np(pthread_self(), &attributes) != 0) {
+        return 0;
+    }
+
+    void* base = NULL;
+    std::size_t size = 0;
+    int result = pthread_attr_getstack(&attributes, &base, &size);
+    pthread_attr_destroy(&attributes);
+
+    std::uintptr_t bottom = reinterpret_cast<std::uintptr_t>(base);
+    if(result != 0 || top < bottom || top >= bottom + size) {
+        return 0;
+    }
+    return bottom;
+#else
+    pros::task_t handle = pros::c::task_get_current();
+    const char* tcb = static_cast<const char*>(handle);
+    if(tcb == NULL || pros::c::task_get_name(handle) != tcb + TASK_STATS_TCB_NAME_OFFSET) {
+        return 0;
+    }
+
+    std::uintptr_t bottom;
+    std::memcpy(&bottom, tcb + TASK_STATS_TCB_STACK_OFFSET, sizeof(bottom));
+    if(bottom == 0 || top <= bottom) {
+        return 0;
+    }
+    return bottom;
+#endif
+}
+
+
+
+/**
+ * kept out of line so its own frame is above the area it paints, the
+ * top margin leaves room for it
+ */
+__attribute__((noinline)) void TaskStats::paint_stack(std::uintptr_t bottom, std::uintptr_t top) {
+    volatile std::uint32_t* end = reinterpret_cast<volatile std::uint32_t*>(top);
+    for(volatile std::uint32_t* word = reinterpret_cast<volatile std::uint32_t*>(bottom); word < end; word++) {
+        *word = TASK_STATS_STACK_PATTERN;
+    }
+}
+
+
+
+/**
+ * the stack grows down so the lowest word that is not the pattern
+ * anymore is the deepest the stack has been
+ * painting starts a stack depth below the top of the stack at most, so
+ * what is left of the stack depth above the deepest word is what was used
+ * returns -1 if the stack was not painted
+ */
+int TaskStats::get_stack_used(const task_stats_entry& entry) {
+    if(entry.stack_bottom == 0) {
+        return -1;
+    }
+
+    const volatile std::uint32_t* word = reinterpret_cast<const volatile std::uint32_t*>(entry.stack_bottom);
+    const volatile std::uint32_t* end = reinterpret_cast<const volatile std::uint32_t*>(entry.stack_top - TASK_STATS_TOP_MARGIN);
+    while(word < end && *word == TASK_STATS_STACK_PATTERN) {
+        word++;
+    }
+
+    int free_bytes = reinterpret_cast<std::uintptr_t>(word) - entry.stack_bottom;
+    return (entry.stack_depth * TASK_STATS_WORD_SIZE) - free_bytes;
+}
+
+
+
+bool TaskStats::is_alive(const task_stats_entry& entry) {
+#ifdef HOST_BUILD
+    std::uint64_t cpu_time;
+    return read_host_cpu_time(&entry - tasks.data(), cpu_time);
+#else
+    pros::task_state_e_t state = pros::c::task_get_state(entry.handle);
+    return state != pros::E_TASK_STATE_DELETED && state != pros::E_TASK_STATE_INVALID;
+#endif
+}
+
+
+
+/**
+ * only called with the sample lock held
+ */
+void TaskStats::update_cpu(int elapsed) {
+    int count = std::min(num_tasks.load(), TASK_STATS_MAX_TASKS);
+    for(int i = 0; i < count; i++) {
+        task_stats_entry& entry = tasks.at(i);
+        if(!entry.active) {
+            continue;
+        }
+
+#ifdef HOST_BUILD
+        std::uint64_t cpu_time;
+        if(read_host_cpu_time(i, cpu_time)) {
+            entry.cpu_percent = (100.0 * (cpu_time - entry.cpu_time)) / (elapsed * 1000.0);
+            entry.cpu_time = cpu_time;
+        } else {
+            entry.cpu_percent = 0;
+        }
+#else
+        entry.cpu_percent = total_samples > 0 ? (100 * entry.cpu_samples) / total_samples : 0;
+        entry.cpu_samples = 0;
+#endif
+    }
+
+    total_samples = 0;
+}
+
+
+
+int TaskStats::register_current_task(const char* name, int period, int stack_depth) {
+    volatile int marker = 0;  // the stack has barely been used yet so this is close to the top
+    std::uintptr_t top = reinterpret_cast<std::uintptr_t>(&marker);
+
+    int id = -1;
+    int count = std::min(num_tasks.load(), TASK_STATS_MAX_TASKS);
+    for(int i = 0; i < count; i++) {
+        if(std::strncmp(tasks.at(i).name, name, TASK_STATS_NAME_LENGTH - 1) == 0) {
+            id = i;
+            break;
+        }
+    }
+
+    if(id == -1) {  // slots are claimed without a lock so tasks of any priority can register
+        do {
+            if(count >= TASK_STATS_MAX_TASKS) {
+                return -1;
+            }
+        } while(!num_tasks.compare_exchange_weak(count, count + 1));
+        id = count;
+    }
+
+    task_stats_entry& entry = tasks.at(id);
+    entry.active = false;  // readers skip the entry while it is being filled in
+
+    std::strncpy(entry.name, name, TASK_STATS_NAME_LENGTH - 1);
+    entry.name[TASK_STATS_NAME_LENGTH - 1] = '\0';
+    entry.period = period;
+    entry.stack_depth = stack_depth;
+    entry.stack_top = top;
+
+    // the caller is already below the real top of the stack, so the depth
+    // below it can reach past the bottom, the real bottom is used instead
+    std::uintptr_t base = find_stack_base(top);
+    std::uintptr_t estimate = top - std::min<std::uintptr_t>(top, stack_depth * TASK_STATS_WORD_SIZE);
+    entry.stack_bottom = base == 0 ? 0 : (std::max(base, estimate) + 3) & ~static_cast<std::uintptr_t>(3);
+
+    entry.last_tick = 0;
+    entry.ticks = 0;
+    entry.total_period = 0;
+    entry.max_period = 0;
+    entry.missed_deadlines = 0;
+    entry.cpu_samples = 0;
+    entry.cpu_time = 0;
+    entry.cpu_percent = 0;
+
+#ifdef HOST_BUILD
+    entry.handle = NULL;
+    pthread_getcpuclockid(pthread_self(), &host_clocks.at(id));
+    read_host_cpu_time(id, entry.cpu_time);
+#else
+    entry.handle = pros::c::task_get_current();
+#endif
+
+    if(entry.stack_bottom != 0 && entry.stack_bottom < top - TASK_STATS_TOP_MARGIN) {
+        paint_stack(entry.stack_bottom, top - TASK_STATS_TOP_MARGIN);
+    } else {
+        entry.stack_bottom = 0;  // not painted, stack use is unknown
+    }
+
+    entry.active = true;
+    return id;
+}
+
+
+
+void TaskStats::loop_tick(int id) {
+    if(id < 0 || id >= TASK_STATS_MAX_TASKS || !tasks.at(id).active) {
+        return;
+    }
+
+    task_stats_entry& entry = tasks.at(id);
+    std::uint64_t now = Clock::get_micros();
+    if(entry.last_tick != 0) {
+        int period = now - entry.last_tick;
+        entry.ticks += 1;
+        entry.total_period += period;
+        entry.max_period = std::max(entry.max_period, period);
+        if(entry.period > 0 && period > 2 * 1000 * entry.period) {
+            entry.missed_deadlines += 1;
+        }
+    }
+
+    entry.last_tick = now;
+}
+
+
+
+void TaskStats::sample() {
+    if(sample_lock.exchange( true )) {  // the sampler or another task has it
+        return;
+    }
+
+    int time = pros::millis();
+    int elapsed = time - last_sample_time;
+    if(elapsed >= TASK_STATS_SAMPLE_INTERVAL) {
+        update_cpu(elapsed);
+        last_sample_time = time;
+    }
+
+    sample_lock.exchange( false ); //release lock
+}
+
+
+
+std::vector<task_report> TaskStats::get_reports() {
+    std::vector<task_report> reports;
+    int count = std::min(num_tasks.load(), TASK_STATS_MAX_TASKS);
+    for(int i = 0; i < count; i++) {
+        const task_stats_entry& entry = tasks.at(i);
+        if(!entry.active) {
+            continue;
+        }
+
+        task_report report;
+        report.name = entry.name;
+        report.alive = is_alive(entry);
+        report.cpu_percent = entry.cpu_percent;
+        report.stack_size = entry.stack_depth * TASK_STATS_WORD_SIZE;
+        report.stack_used = report.alive ? get_stack_used(entry) : 0;  // the stack of a deleted task may be reused
+
+        // half again as much as has been used, rounded up to 256 words
+        int words_used = (report.stack_used + TASK_STATS_WORD_SIZE - 1) / TASK_STATS_WORD_SIZE;
+        report.recommended_depth = std::max(((words_used * 3 / 2) + 255) / 256 * 256, TASK_STACK_DEPTH_MIN);
+        if(report.stack_used < 0) {  // no reason to change it
+            report.recommended_depth = entry.stack_depth;
+        }
+
+        report.average_period = entry.ticks > 0 ? entry.total_period / entry.ticks : 0;
+        report.max_period = entry.max_period;
+        report.max_jitter = (entry.period > 0 && entry.ticks > 0) ? std::max(0, entry.max_period - (1000 * entry.period)) : 0;
+        report.missed_deadlines = entry.missed_deadlines;
+
+        reports.push_back(report);
+    }
+
+    return reports;
+}
+
+
+
+std::string TaskStats::get_report() {
+    std::string report_text;
+    for(const task_report& report : get_reports()) {
+        report_text += (
+            report.name
+            + "," + std::to_string(static_cast<int>(report.cpu_percent + .5))
+            + "," + std::to_string(report.stack_used)
+            + "," + std::to_string(report.stack_size)
+            + "," + std::to_string(report.recommended_depth)
+            + "," + std::to_string(report.average_period)
+            + "," + std::to_string(report.max_jitter)
+            + "," + std::to_string(report.missed_deadlines)
+            + ";"
+        );
+    }
+
+    return report_text;
+}
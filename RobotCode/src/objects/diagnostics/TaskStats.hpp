@@ -0,0 +1,155 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/TaskStats.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a module that measures cpu use, stack use, and loop timing of
+ * each task
+ * define HOST_BUILD when compiling for a computer instead of the brain,
+ * the same reports are made from thread cpu clocks instead of the sampler
+ */
+
+#ifndef __TASKSTATS_HPP__
+#define __TASKSTATS_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+
+
+#define TASK_STATS_MAX_TASKS 16
+#define TASK_STATS_NAME_LENGTH 24
+#define TASK_STATS_SAMPLE_INTERVAL 1000  // ms between updates of cpu use
+#define TASK_STATS_SAMPLER_PERIOD 1  // ms between checks of which task is running
+#define TASK_STATS_WORD_SIZE 4  // bytes in one word of stack depth
+#define TASK_STATS_TOP_MARGIN 512  // bytes below the caller of register_current_task that are not painted
+#define TASK_STATS_TCB_STACK_OFFSET 48  // bytes from a FreeRTOS task handle to the lowest address of its stack
+#define TASK_STATS_TCB_NAME_OFFSET 52  // bytes from a FreeRTOS task handle to its name, right after the stack
+#define TASK_STATS_STACK_PATTERN 0xA5A5A5A5
+
+
+typedef struct {
+    char name[TASK_STATS_NAME_LENGTH];
+    pros::task_t handle;
+    int period;  // expected ms between loops, 0 if the task waits on events instead
+    int stack_depth;  // words
+
+    std::uintptr_t stack_bottom;  // lowest painted address, 0 if the bounds of the stack could not be found
+    std::uintptr_t stack_top;  // where the task registered
+
+    std::uint64_t last_tick;  // us
+    int ticks;
+    std::int64_t total_period;  // us
+    int max_period;  // us
+    int missed_deadlines;  // loops that took more than twice the expected period
+
+    float cpu_samples;  // times the task was running or waiting to run since the last update
+    std::uint64_t cpu_time;  // us of cpu time at the last update, only used by the host
+    float cpu_percent;
+
+    std::atomic<bool> active;
+} task_stats_entry;
+
+typedef struct {
+    std::string name;
+    bool alive;
+    float cpu_percent;
+    int stack_used;  // bytes, -1 if it is not known
+    int stack_size;  // bytes
+    int recommended_depth;  // words, enough for the most stack used so far with room to spare
+    int average_period;  // us
+    int max_period;  // us
+    int max_jitter;  // us past the expected period
+    int missed_deadlines;
+} task_report;
+
+
+
+/**
+ * tasks register themselves as the first thing they do, which paints the
+ * unused part of their stack with a pattern so the lowest point the stack
+ * has reached can be found later
+ * on the brain a high priority sampler task checks which registered tasks
+ * are running or waiting to run every ms and splits the sample between
+ * them, that is close to real cpu time on one core without any hooks into
+ * the scheduler
+ * nothing here waits on a lock so any task can call it
+ */
+class TaskStats
+{
+    private:
+        static std::array<task_stats_entry, TASK_STATS_MAX_TASKS> tasks;
+        static std::atomic<int> num_tasks;
+
+        static pros::Task* sampler_thread;
+        static std::atomic<bool> sample_lock;
+        static float total_samples;
+        static int last_sample_time;
+
+        static void sampler_task(void*);
+        static std::uintptr_t find_stack_base(std::uintptr_t top);
+        static void paint_stack(std::uintptr_t bottom, std::uintptr_t top);
+        static int get_stack_used(const task_stats_entry& entry);
+        static bool is_alive(const task_stats_entry& entry);
+        static void update_cpu(int elapsed);
+
+    public:
+        /**
+         * @return: None
+         *
+         * starts the sampler that measures cpu use, does nothing on the host
+         */
+        static void start();
+
+        /**
+         * @param: const char* name -> the name to show in reports
+         * @param: int period -> ms the task is expected to take per loop, 0 if it waits on events
+         * @param: int stack_depth -> the stack depth the task was created with
+         * @return: int -> the id to pass to loop_tick, -1 if too many tasks are registered
+         *
+         * must be called from the task itself as the first thing it does
+         * painting starts at the real bottom of the stack, or where this is
+         * called minus the stack depth if that is higher, and nothing is
+         * painted if the bottom of the stack can not be found, stack use is
+         * reported as unknown for that task instead
+         * a task that registers again with the same name reuses its id
+         */
+        static int register_current_task(const char* name, int period, int stack_depth);
+
+        /**
+         * @param: int id -> the id from register_current_task
+         * @return: None
+         *
+         * call once at the start of every loop of the task
+         */
+        static void loop_tick(int id);
+
+        /**
+         * @return: None
+         *
+         * updates cpu use if the sample interval has passed since the last
+         * update, safe to call from more than one task
+         */
+        static void sample();
+
+        /**
+         * @return: std::vector<task_report> -> stats for every registered task
+         */
+        static std::vector<task_report> get_reports();
+
+        /**
+         * @return: std::string -> one "name,cpu %,stack used,stack size,recommended depth,
+         *                         average period,max jitter,missed deadlines;" group per task
+         */
+        static std::string get_report();
+};
+
+
+
+#endif
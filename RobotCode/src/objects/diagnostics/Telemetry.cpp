@@ -0,0 +1,152 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/Telemetry.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: Telemetry.hpp
+ *
+ * contains implementation for the telemetry history
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+#include "../serial/Logger.hpp"
+#include "Telemetry.hpp"
+
+
+
+std::array<telemetry_signal, TELEMETRY_MAX_SIGNALS> Telemetry::signals;
+std::atomic<int> Telemetry::num_signals = ATOMIC_VAR_INIT(0);
+
+
+
+int Telemetry::add_signal(const char* name, int sample_period) {
+    int count = std::min(num_signals.load(), TELEMETRY_MAX_SIGNALS);
+    for(int i = 0; i < count; i++) {
+        if(std::strncmp(signals.at(i).name, name, TELEMETRY_NAME_LENGTH - 1) == 0) {
+            return i;
+        }
+    }
+
+    int id;
+    do {  // slots are claimed without a lock so tasks of any priority can add signals
+        if(count >= TELEMETRY_MAX_SIGNALS) {
+            Logger logger;
+            log_entry entry;
+            entry.content = (
+                "[WARNING], " + std::to_string(pros::millis())
+                + ", telemetry signal " + std::string(name) + " was not added, all "
+                + std::to_string(TELEMETRY_MAX_SIGNALS) + " slots are used"
+            );
+            entry.stream = "cerr";
+            logger.add(entry);
+            return -1;
+        }
+        id = count;
+    } while(!num_signals.compare_exchange_weak(count, count + 1));
+
+    telemetry_signal& signal = signals.at(id);
+    std::strncpy(signal.name, name, TELEMETRY_NAME_LENGTH - 1);
+    signal.name[TELEMETRY_NAME_LENGTH - 1] = '\0';
+    signal.bucket_samples = std::max(TELEMETRY_WINDOW / (std::max(sample_period, 1) * TELEMETRY_POINTS), 1);
+    signal.current_samples = 0;
+    signal.head = 0;
+    signal.active = true;
+
+    return id;
+}
+
+
+
+/**
+ * the slot is inactive while its name changes so readers skip it instead
+ * of showing a name that is half written
+ */
+bool Telemetry::rename_signal(int signal, const char* name) {
+    if(signal < 0 || signal >= std::min(num_signals.load(), TELEMETRY_MAX_SIGNALS)) {
+        return false;
+    }
+
+    telemetry_signal& entry = signals.at(signal);
+    entry.active = false;
+    std::strncpy(entry.name, name, TELEMETRY_NAME_LENGTH - 1);
+    entry.name[TELEMETRY_NAME_LENGTH - 1] = '\0';
+    entry.current_samples = 0;
+    entry.head = 0;
+    entry.active = true;
+
+    return true;
+}
+
+
+
+void Telemetry::log(int signal, float value) {
+    if(signal < 0 || signal >= TELEMETRY_MAX_SIGNALS || !signals.at(signal).active) {
+        return;
+    }
+
+    telemetry_signal& entry = signals.at(signal);
+    if(entry.current_samples == 0) {
+        entry.current.min = value;
+        entry.current.max = value;
+    } else {
+        entry.current.min = std::min(entry.current.min, value);
+        entry.current.max = std::max(entry.current.max, value);
+    }
+    entry.current_samples += 1;
+
+    if(entry.current_samples >= entry.bucket_samples) {
+        std::uint32_t head = entry.head;
+        entry.buckets.at(head % TELEMETRY_POINTS) = entry.current;
+        entry.head = head + 1;  // only counted once it is written
+        entry.current_samples = 0;
+    }
+}
+
+
+
+/**
+ * the logging task may finish buckets while they are copied, any bucket
+ * it could have reached by the time the copy is done is dropped from the
+ * front
+ */
+int Telemetry::read(int signal, telemetry_bucket* buckets) {
+    if(signal < 0 || signal >= TELEMETRY_MAX_SIGNALS || !signals.at(signal).active) {
+        return 0;
+    }
+
+    const telemetry_signal& entry = signals.at(signal);
+    std::uint32_t head = entry.head;
+    std::uint32_t count = std::min<std::uint32_t>(head, TELEMETRY_POINTS);
+    for(std::uint32_t i = 0; i < count; i++) {
+        buckets[i] = entry.buckets.at((head - count + i) % TELEMETRY_POINTS);
+    }
+
+    std::uint32_t overwritten = std::min<std::uint32_t>(entry.head - head, count);
+    if(overwritten > 0) {
+        std::copy(buckets + overwritten, buckets + count, buckets);
+    }
+
+    return count - overwritten;
+}
+
+
+
+std::vector<std::string> Telemetry::get_signal_names() {
+    std::vector<std::string> names;
+    int count = std::min(num_signals.load(), TELEMETRY_MAX_SIGNALS);
+    for(int i = 0; i < count; i++) {
+        names.push_back(signals.at(i).active ? signals.at(i).name : "");
+    }
+
+    return names;
+}
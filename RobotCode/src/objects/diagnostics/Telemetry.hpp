@@ -0,0 +1,111 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/Telemetry.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a history of recent values for signals like motor velocity so
+ * they can be charted on the lcd
+ */
+
+#ifndef __TELEMETRY_HPP__
+#define __TELEMETRY_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+
+
+#define TELEMETRY_MAX_SIGNALS 40
+#define TELEMETRY_NAME_LENGTH 24
+#define TELEMETRY_WINDOW 10000  // ms of history kept for each signal
+#define TELEMETRY_POINTS 100  // buckets the window is split into
+
+
+typedef struct {
+    float min;
+    float max;
+} telemetry_bucket;
+
+typedef struct {
+    char name[TELEMETRY_NAME_LENGTH];
+    int bucket_samples;  // samples that go into one bucket
+
+    // the bucket being filled, only touched by the task that logs the signal
+    telemetry_bucket current;
+    int current_samples;
+
+    std::array<telemetry_bucket, TELEMETRY_POINTS> buckets;
+    std::atomic<std::uint32_t> head;  // buckets ever finished, the next goes at head % TELEMETRY_POINTS
+    std::atomic<bool> active;
+} telemetry_signal;
+
+
+
+/**
+ * samples are folded into min/max buckets as they are logged, so a window
+ * of thousands of samples is always read as TELEMETRY_POINTS buckets and
+ * drawing it costs the same no matter how fast the signal is logged
+ * each signal is only logged from one task so logging never takes a lock
+ */
+class Telemetry
+{
+    private:
+        static std::array<telemetry_signal, TELEMETRY_MAX_SIGNALS> signals;
+        static std::atomic<int> num_signals;
+
+    public:
+        /**
+         * @param: const char* name -> the name to show when picking a signal
+         * @param: int sample_period -> ms between calls to log for the signal
+         * @return: int -> the signal to pass to log, -1 if there are too many signals
+         *
+         * a signal that is added again with the same name keeps its id
+         * a warning is logged if there is no slot left for the signal
+         */
+        static int add_signal(const char* name, int sample_period);
+
+        /**
+         * @param: int signal -> the signal from add_signal
+         * @param: const char* name -> the new name to show
+         * @return: bool -> false if the signal does not exist
+         *
+         * reuses the slot of a signal that now measures something else,
+         * like a motor moved to another port, the history is cleared
+         * only call from the task that logs the signal
+         */
+        static bool rename_signal(int signal, const char* name);
+
+        /**
+         * @param: int signal -> the signal from add_signal
+         * @param: float value -> the newest value
+         * @return: None
+         *
+         * only call from one task per signal, safe to call from control loops
+         */
+        static void log(int signal, float value);
+
+        /**
+         * @param: int signal -> the signal to read
+         * @param: telemetry_bucket* buckets -> at least TELEMETRY_POINTS buckets to copy into
+         * @return: int -> the number of buckets copied, oldest first
+         *
+         * buckets that were overwritten while they were being copied are
+         * left out
+         */
+        static int read(int signal, telemetry_bucket* buckets);
+
+        /**
+         * @return: std::vector<std::string> -> the name of each signal, in order of id
+         */
+        static std::vector<std::string> get_signal_names();
+};
+
+
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/Trace.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: Trace.hpp
+ *
+ * contains implementation for the trace event buffers
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "main.h"
+
+#include "../serial/Logger.hpp"
+#include "Trace.hpp"
+
+
+
+std::atomic<bool> Trace::enabled = ATOMIC_VAR_INIT(true);
+#ifdef TRACING
+std::array<trace_buffer, TRACE_MAX_TASKS> Trace::buffers;
+#endif
+
+
+
+#ifdef TRACING
+
+/**
+ * on the host each thread is a task, the address of a thread local is
+ * used as its handle
+ */
+#ifdef HOST_BUILD
+static thread_local int host_task;
+static std::atomic<int> host_task_count = ATOMIC_VAR_INIT(0);
+#endif
+
+
+
+/**
+ * a buffer is claimed with a compare exchange so tasks of any priority
+ * can record without waiting on each other
+ */
+trace_buffer* Trace::get_buffer() {
+#ifdef HOST_BUILD
+    void* task = &host_task;
+#else
+    void* task = pros::c::task_get_current();
+#endif
+
+    for(trace_buffer& buffer : buffers) {
+        if(buffer.owner == task) {
+            return &buffer;
+        }
+    }
+
+    for(trace_buffer& buffer : buffers) {
+        void* expected = NULL;
+        if(buffer.owner.compare_exchange_strong(expected, task)) {
+#ifdef HOST_BUILD
+            std::string name = "thread " + std::to_string(host_task_count++);
+            std::strncpy(buffer.task_name, name.c_str(), TRACE_TASK_NAME_LENGTH - 1);
+#else
+            std::strncpy(buffer.task_name, pros::c::task_get_name(task), TRACE_TASK_NAME_LENGTH - 1);
+#endif
+            buffer.task_name[TRACE_TASK_NAME_LENGTH - 1] = '\0';
+            return &buffer;
+        }
+    }
+
+    return NULL;
+}
+
+
+
+void Trace::record(const char* name, std::uint32_t start, std::uint32_t duration) {
+    if(!enabled) {
+        return;
+    }
+
+    trace_buffer* buffer = get_buffer();
+    if(buffer == NULL) {
+        return;
+    }
+
+    std::uint32_t head = buffer->head;
+    trace_event& event = buffer->events[head % TRACE_BUFFER_EVENTS];
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    buffer->head = head + 1;  // only counted once it is written so dump never reads half of it
+}
+
+#else
+
+trace_buffer* Trace::get_buffer() {
+    return NULL;
+}
+
+
+
+void Trace::record(const char* name, std::uint32_t start, std::uint32_t duration) { }
+
+#endif
+
+
+
+void Trace::set_enabled(bool enable) {
+    enabled = enable;
+}
+
+
+
+int Trace::dump(const char* filename /*TRACE_FILE*/) {
+    std::FILE* file = std::fopen(filename, "w");
+    if(file == NULL) {
+        Logger logger;
+        log_entry entry;
+        entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", could not open " + std::string(filename) + " for the trace dump";
+        entry.stream = "cerr";
+        logger.add(entry);
+        return -1;
+    }
+
+    std::fprintf(file, "task,event,start_us,duration_us\n");
+    int num_events = 0;
+
+#ifdef TRACING
+    bool was_enabled = enabled.exchange(false);  // so events are not overwritten while they are read
+
+    for(trace_buffer& buffer : buffers) {
+        if(buffer.owner == NULL) {
+            continue;
+        }
+
+        std::uint32_t head = buffer.head;
+        std::uint32_t count = std::min<std::uint32_t>(head, TRACE_BUFFER_EVENTS);
+        for(std::uint32_t i = head - count; i != head; i++) {
+            const trace_event& event = buffer.events[i % TRACE_BUFFER_EVENTS];
+            std::fprintf(file, "%s,%s,%u,%u\n", buffer.task_name, event.name, (unsigned int)event.start, (unsigned int)event.duration);
+            num_events += 1;
+        }
+    }
+
+    enabled = was_enabled;
+#endif
+
+    std::fclose(file);
+    return num_events;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file: ./RobotCode/src/objects/diagnostics/Trace.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains scoped trace events that record how long a block of code took
+ * tracing is only compiled in when TRACING is defined, add -DTRACING to
+ * EXTRA_CXXFLAGS in the Makefile to turn it on, otherwise TRACE_SCOPE is
+ * empty
+ * dumps are converted for chrome://tracing or perfetto by trace_exporter.py
+ */
+
+#ifndef __TRACE_HPP__
+#define __TRACE_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "Clock.hpp"
+
+
+
+#define TRACE_FILE "/usd/trace.csv"
+#define TRACE_MAX_TASKS 12
+#define TRACE_BUFFER_EVENTS 512  // events kept per task, the oldest are overwritten
+#define TRACE_TASK_NAME_LENGTH 24
+
+
+/**
+ * TRACE_SCOPE("name"); records one event from where it is to the end of
+ * the enclosing block, the name has to be a string literal because only
+ * the pointer is kept
+ * TRACE_START(variable, "name"); and TRACE_STOP(variable); record one event
+ * between them for code that should not be moved into its own block, the
+ * event still ends with the block if TRACE_STOP is not reached
+ */
+#ifdef TRACING
+#define TRACE_CONCAT_INNER(a, b) a ## b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_START(variable, name) TraceScope variable(name)
+#define TRACE_STOP(variable) variable.stop()
+#else
+#define TRACE_SCOPE(name)
+#define TRACE_START(variable, name)
+#define TRACE_STOP(variable)
+#endif
+
+
+typedef struct {
+    const char* name;
+    std::uint32_t start;  // us, wraps after about 71 minutes
+    std::uint32_t duration;  // us
+} trace_event;
+
+typedef struct {
+    std::atomic<void*> owner;  // the task that writes to this buffer, NULL if it is free
+    char task_name[TRACE_TASK_NAME_LENGTH];
+    std::atomic<std::uint32_t> head;  // events ever written, the next goes at head % TRACE_BUFFER_EVENTS
+    std::array<trace_event, TRACE_BUFFER_EVENTS> events;
+} trace_buffer;
+
+
+
+/**
+ * each task gets its own ring buffer the first time it records an event
+ * so writing an event never takes a lock or allocates, only the task that
+ * owns a buffer writes to it
+ */
+class Trace
+{
+    private:
+        static std::atomic<bool> enabled;
+#ifdef TRACING
+        static std::array<trace_buffer, TRACE_MAX_TASKS> buffers;
+#endif
+
+        static trace_buffer* get_buffer();
+
+    public:
+        /**
+         * @param: const char* name -> the name of the event
+         * @param: std::uint32_t start -> us when the event started
+         * @param: std::uint32_t duration -> us the event took
+         * @return: None
+         *
+         * called by TraceScope, the event is dropped if every buffer is
+         * owned by another task or tracing is paused
+         */
+        static void record(const char* name, std::uint32_t start, std::uint32_t duration);
+
+        /**
+         * @param: bool enable -> false to stop recording events
+         * @return: None
+         */
+        static void set_enabled(bool enable);
+
+        /**
+         * @param: const char* filename -> the file to write, it is overwritten
+         * @return: int -> the number of events written, -1 if the file could not be opened
+         *
+         * writes "task,event,start_us,duration_us" lines for every event in
+         * every buffer, recording is paused while the buffers are copied out
+         */
+        static int dump(const char* filename=TRACE_FILE);
+};
+
+
+
+/**
+ * use TRACE_SCOPE instead of making one directly so it compiles out
+ * defined here so the calls are inlined into the traced code
+ */
+class TraceScope
+{
+    private:
+        const char* name;
+        std::uint32_t start;
+
+    public:
+        TraceScope(const char* event_name) : name(event_name), start(Clock::get_micros()) { }
+
+        ~TraceScope() {
+            stop();
+        }
+
+        /**
+         * @return: None
+         *
+         * records the event now instead of at the end of the block, only
+         * the first call records
+         */
+        void stop() {
+            if(name != NULL) {
+                std::uint32_t end = Clock::get_micros();
+                Trace::record(name, start, end - start);
+                name = NULL;
+            }
+        }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+};
+
+
+
+#endif
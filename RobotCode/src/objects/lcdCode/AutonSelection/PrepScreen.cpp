@@ -183,12 +183,12 @@ void PrepScreen::getConfirmation( int auton )
 
     while ( !(nextScreen) )
     {
-        if ( controllers.master.get_digital(pros::E_CONTROLLER_DIGITAL_A) )
+        if ( controllers.get_snapshot(20).is_pressing(pros::E_CONTROLLER_DIGITAL_A) )
         {
             btn_confirm_action( NULL );
             pros::delay(200);
         }
-        else if ( controllers.master.get_digital(pros::E_CONTROLLER_DIGITAL_B) )
+        else if ( controllers.get_snapshot(20).is_pressing(pros::E_CONTROLLER_DIGITAL_B) )
         {
             btn_back_action( NULL );
             pros::delay(200);
@@ -232,17 +232,17 @@ void SelectionScreen::showSelection()
                                            //so that time is not wasted
     {
         //allow controller to press the buttons as well
-        if ( controllers.master.get_digital(pros::E_CONTROLLER_DIGITAL_R1) )
+        if ( controllers.get_snapshot(20).is_pressing(pros::E_CONTROLLER_DIGITAL_R1) )
         {
             btn_right_action( NULL );
             pros::delay(200);
         }
-        else if ( controllers.master.get_digital(pros::E_CONTROLLER_DIGITAL_L1) )
+        else if ( controllers.get_snapshot(20).is_pressing(pros::E_CONTROLLER_DIGITAL_L1) )
         {
             btn_left_action( NULL );
             pros::delay(200);
         }
-        else if ( controllers.master.get_digital(pros::E_CONTROLLER_DIGITAL_A) )
+        else if ( controllers.get_snapshot(20).is_pressing(pros::E_CONTROLLER_DIGITAL_A) )
         {
             btn_select_action( NULL );
             pros::delay(200);
@@ -12,6 +12,7 @@
 #include "../../../../include/main.h"
 #include "../../../../include/api.h"
 
+#include "../../motors/MotorThread.hpp"
 #include "../Styles.hpp"
 #include "BatteryDebug.hpp"
 
@@ -59,7 +60,11 @@ BatteryDebug::BatteryDebug()
             "battery percentage\n"
             "current\n"
             "voltage\n"
-            "temperature"
+            "temperature\n"
+            "filtered voltage\n"
+            "compensation scale\n"
+            "motor headroom\n"
+            "saturated cycles"
     );
 
     lv_label_set_text(labels_label, labels_label_text.c_str());
@@ -72,6 +77,10 @@ BatteryDebug::BatteryDebug()
     lv_label_set_align(info_label, LV_LABEL_ALIGN_LEFT);
 
     std::string info_label_text = (
+        "None\n"
+        "None\n"
+        "None\n"
+        "None\n"
         "None\n"
         "None\n"
         "None\n"
@@ -122,11 +131,16 @@ void BatteryDebug::debug()
 
     while ( cont )
     {
+        battery_compensation_stats compensation = MotorThread::get_instance()->get_battery_compensation();
         std::string info_label_text = (
             std::to_string(pros::battery::get_capacity()) + "%\n"
             + std::to_string(pros::battery::get_current()) + "\n"
             + std::to_string(pros::battery::get_voltage()) + "\n"
             + std::to_string(pros::battery::get_temperature()) + "\n"
+            + std::to_string(static_cast<int>(compensation.battery_voltage)) + "\n"
+            + std::to_string(compensation.scale) + "\n"
+            + std::to_string(compensation.min_headroom) + "\n"
+            + std::to_string(compensation.saturated_cycles) + "\n"
         );
 
         lv_label_set_text(info_label, info_label_text.c_str());
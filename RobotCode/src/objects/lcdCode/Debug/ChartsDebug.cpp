@@ -0,0 +1,177 @@
+/**
+ * @file: ./RobotCode/src/lcdCode/Debug/ChartsDebug.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see ChartsDebug.hpp
+ *
+ * contains implementation for class for charting telemetry signals
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../../../../include/main.h"
+#include "../../../../include/api.h"
+
+#include "../../diagnostics/Telemetry.hpp"
+#include "../Styles.hpp"
+#include "../TelemetryChart.hpp"
+#include "ChartsDebug.hpp"
+
+
+bool ChartsDebug::cont = true;
+int ChartsDebug::primary_selection = 0;
+int ChartsDebug::secondary_selection = 0;
+
+ChartsDebug::ChartsDebug()
+{
+    cont = true;
+
+//screen
+    charts_screen = lv_obj_create(NULL, NULL);
+    lv_obj_set_style(charts_screen, &gray);
+
+//init back button
+    //button
+    btn_back = lv_btn_create(charts_screen, NULL);
+    lv_btn_set_style(btn_back, LV_BTN_STYLE_REL, &toggle_btn_released);
+    lv_btn_set_style(btn_back, LV_BTN_STYLE_PR, &toggle_btn_pressed);
+    lv_btn_set_action(btn_back, LV_BTN_ACTION_CLICK, btn_back_action);
+    lv_obj_set_width(btn_back, 75);
+    lv_obj_set_height(btn_back, 25);
+
+    //label
+    btn_back_label = lv_label_create(btn_back, NULL);
+    lv_obj_set_style(btn_back_label, &heading_text);
+    lv_label_set_text(btn_back_label, "Back");
+
+//init title label
+    title_label = lv_label_create(charts_screen, NULL);
+    lv_label_set_style(title_label, &heading_text);
+    lv_obj_set_width(title_label, 440);
+    lv_obj_set_height(title_label, 20);
+    lv_label_set_align(title_label, LV_LABEL_ALIGN_CENTER);
+    lv_label_set_text(title_label, "Charts - Debug");
+
+//init chart
+    chart = new TelemetryChart(charts_screen, 300, 150);
+
+//init signal selection
+    // the second list is made first so the first one is drawn over it when it opens
+    ddlist_secondary = lv_ddlist_create(charts_screen, NULL);
+    lv_ddlist_set_options(ddlist_secondary, "none");
+    lv_obj_set_style(ddlist_secondary, &subheading_text);
+    lv_obj_set_width(ddlist_secondary, 150);
+    lv_ddlist_set_fix_height(ddlist_secondary, 120);
+    lv_ddlist_set_action(ddlist_secondary, ddlist_secondary_action);
+
+    ddlist_primary = lv_ddlist_create(charts_screen, NULL);
+    lv_ddlist_set_options(ddlist_primary, "none");
+    lv_obj_set_style(ddlist_primary, &subheading_text);
+    lv_obj_set_width(ddlist_primary, 150);
+    lv_ddlist_set_fix_height(ddlist_primary, 120);
+    lv_ddlist_set_action(ddlist_primary, ddlist_primary_action);
+
+//init render time label
+    render_label = lv_label_create(charts_screen, NULL);
+    lv_label_set_style(render_label, &body_text);
+    lv_obj_set_width(render_label, 150);
+    lv_obj_set_height(render_label, 40);
+    lv_label_set_align(render_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(render_label, "draw: 0 us");
+
+//set positions
+    lv_obj_set_pos(btn_back, 30, 210);
+
+    lv_obj_align(title_label, charts_screen, LV_ALIGN_IN_TOP_MID, 0, 10);
+
+    chart->set_pos(10, 35);
+    lv_obj_set_pos(ddlist_primary, 320, 35);
+    lv_obj_set_pos(ddlist_secondary, 320, 75);
+    lv_obj_set_pos(render_label, 320, 170);
+
+
+}
+
+
+
+ChartsDebug::~ChartsDebug()
+{
+    delete chart;
+    lv_obj_del(charts_screen);
+}
+
+
+
+/**
+ * sets cont to false to break main loop so main function returns
+ */
+lv_res_t ChartsDebug::btn_back_action(lv_obj_t *btn)
+{
+    cont = false;
+    return LV_RES_OK;
+}
+
+
+
+lv_res_t ChartsDebug::ddlist_primary_action(lv_obj_t *ddlist)
+{
+    primary_selection = lv_ddlist_get_selected(ddlist);
+    return LV_RES_OK; //Return OK because the drop down list was not deleted
+}
+
+
+
+lv_res_t ChartsDebug::ddlist_secondary_action(lv_obj_t *ddlist)
+{
+    secondary_selection = lv_ddlist_get_selected(ddlist);
+    return LV_RES_OK; //Return OK because the drop down list was not deleted
+}
+
+
+
+/**
+ * main loop that redraws the chart
+ * both lists start with none so option n is signal n - 1
+ */
+void ChartsDebug::debug()
+{
+    cont = true;
+
+    std::string options = "none";
+    for(const std::string& name : Telemetry::get_signal_names()) {
+        options += "\n" + name;
+    }
+    lv_ddlist_set_options(ddlist_primary, options.c_str());
+    lv_ddlist_set_options(ddlist_secondary, options.c_str());
+    lv_ddlist_set_selected(ddlist_primary, primary_selection);
+    lv_ddlist_set_selected(ddlist_secondary, secondary_selection);
+
+    lv_scr_load(charts_screen);
+
+    int shown_primary = -1;
+    int shown_secondary = -1;
+    int max_render_time = 0;
+    while ( cont )
+    {
+        if(primary_selection != shown_primary) {
+            shown_primary = primary_selection;
+            chart->set_signal(0, shown_primary - 1);
+        }
+        if(secondary_selection != shown_secondary) {
+            shown_secondary = secondary_selection;
+            chart->set_signal(1, shown_secondary - 1);
+        }
+
+        int render_time = chart->update();
+        max_render_time = std::max(max_render_time, render_time);
+
+        std::string text = "draw: " + std::to_string(render_time) + " us\nmax: " + std::to_string(max_render_time) + " us";
+        lv_label_set_text(render_label, text.c_str());
+
+        pros::delay(50);
+    }
+}
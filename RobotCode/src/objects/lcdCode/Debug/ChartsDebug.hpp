@@ -0,0 +1,92 @@
+/**
+ * @file: ./RobotCode/src/lcdCode/Debug/ChartsDebug.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains class for charting telemetry signals
+ */
+
+#ifndef __CHARTSDEBUG_HPP__
+#define __CHARTSDEBUG_HPP__
+
+
+#include "../../../../include/main.h"
+
+#include "../Styles.hpp"
+#include "../TelemetryChart.hpp"
+
+
+/**
+ * @see: ../TelemetryChart.hpp
+ * @see: ../../diagnostics/Telemetry.hpp
+ *
+ * contains methods that chart the last few seconds of up to two signals,
+ * such as a motor's velocity against its setpoint while tuning pid
+ */
+class ChartsDebug : private Styles
+{
+    private:
+        static bool cont;
+        static int primary_selection;
+        static int secondary_selection;
+
+        lv_obj_t *charts_screen;
+        lv_obj_t *title_label;
+        lv_obj_t *render_label;
+
+        TelemetryChart *chart;
+
+        lv_obj_t *ddlist_primary;
+        lv_obj_t *ddlist_secondary;
+
+        /**
+         * @param: lv_obj_t* ddlist -> the dropdown list object for the callback function
+         * @return: lv_res_t -> LV_RES_OK on successfull completion because object still exists
+         *
+         * sets the signal for the first series, it is changed in the main loop
+         */
+        static lv_res_t ddlist_primary_action(lv_obj_t *ddlist);
+
+        /**
+         * @param: lv_obj_t* ddlist -> the dropdown list object for the callback function
+         * @return: lv_res_t -> LV_RES_OK on successfull completion because object still exists
+         *
+         * sets the signal for the second series, the first option is none
+         */
+        static lv_res_t ddlist_secondary_action(lv_obj_t *ddlist);
+
+
+        //back button
+        lv_obj_t *btn_back;
+        lv_obj_t *btn_back_label;
+
+        /**
+         * @param: lv_obj_t* btn -> button that called the funtion
+         * @return: lv_res_t -> LV_RES_OK on successfull completion because object still exists
+         *
+         * button callback function used to set cont to false meaning the
+         * user wants to go to the title screen
+         */
+        static lv_res_t btn_back_action(lv_obj_t *btn);
+
+    public:
+        ChartsDebug();
+        ~ChartsDebug();
+
+
+        /**
+         * @return: None
+         *
+         * allows user to pick signals and watch them on the chart
+         * signals are listed when this is opened because they are added
+         * the first time the code that logs them runs
+         */
+        void debug();
+
+};
+
+
+
+
+#endif
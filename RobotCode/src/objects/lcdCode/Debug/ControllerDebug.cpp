@@ -366,6 +366,9 @@ void ControllerTab::update(pros::controller_id_e_t controller, bool showing_valu
     std::string values_col1 = "";
     std::string values_col2 = "";
 
+    // shares the values read by driver control if it is running
+    controller_snapshot snapshot = Controller::get_snapshot(100);
+
     if ( controller == pros::E_CONTROLLER_MASTER )
     {
         //text for functions
@@ -392,25 +395,25 @@ void ControllerTab::update(pros::controller_id_e_t controller, bool showing_valu
         );
 
         values_col1 = (
-            std::to_string(Controller::master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_X)) + "\n"
-            + std::to_string(Controller::master.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y)) + "\n"
-            + std::to_string(Controller::master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X)) + "\n"
-            + std::to_string(Controller::master.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_L1)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_L2)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_R2)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_R1))
+            std::to_string(snapshot.analog[0][pros::E_CONTROLLER_ANALOG_LEFT_X]) + "\n"
+            + std::to_string(snapshot.analog[0][pros::E_CONTROLLER_ANALOG_LEFT_Y]) + "\n"
+            + std::to_string(snapshot.analog[0][pros::E_CONTROLLER_ANALOG_RIGHT_X]) + "\n"
+            + std::to_string(snapshot.analog[0][pros::E_CONTROLLER_ANALOG_RIGHT_Y]) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_L1, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_L2, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_R2, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_R1, 0))
         );
 
         values_col2 = (
-            std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_UP)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_DOWN)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_LEFT)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_RIGHT)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_X)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_B)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_Y)) + "\n"
-            + std::to_string(Controller::master.get_digital(pros::E_CONTROLLER_DIGITAL_A))
+            std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_UP, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_DOWN, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_LEFT, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_RIGHT, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_X, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_B, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_Y, 0)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_A, 0))
         );
 
 
@@ -443,25 +446,25 @@ void ControllerTab::update(pros::controller_id_e_t controller, bool showing_valu
 
 
         values_col1 = (
-            std::to_string(Controller::partner.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_X)) + "\n"
-            + std::to_string(Controller::partner.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y)) + "\n"
-            + std::to_string(Controller::partner.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_X)) + "\n"
-            + std::to_string(Controller::partner.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_L1)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_L2)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_R2)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_R1))
+            std::to_string(snapshot.analog[1][pros::E_CONTROLLER_ANALOG_LEFT_X]) + "\n"
+            + std::to_string(snapshot.analog[1][pros::E_CONTROLLER_ANALOG_LEFT_Y]) + "\n"
+            + std::to_string(snapshot.analog[1][pros::E_CONTROLLER_ANALOG_RIGHT_X]) + "\n"
+            + std::to_string(snapshot.analog[1][pros::E_CONTROLLER_ANALOG_RIGHT_Y]) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_L1, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_L2, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_R2, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_R1, 1))
         );
 
         values_col2 = (
-            std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_UP)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_DOWN)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_LEFT)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_RIGHT)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_X)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_B)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_Y)) + "\n"
-            + std::to_string(Controller::partner.get_digital(pros::E_CONTROLLER_DIGITAL_A))
+            std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_UP, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_DOWN, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_LEFT, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_RIGHT, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_X, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_B, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_Y, 1)) + "\n"
+            + std::to_string(snapshot.is_pressing(pros::E_CONTROLLER_DIGITAL_A, 1))
         );
     }
 
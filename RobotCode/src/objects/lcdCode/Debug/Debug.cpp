@@ -13,27 +13,25 @@
 #include "../../../../include/main.h"
 #include "../../../../include/api.h"
 
+#include "../../diagnostics/AllocationTracker.hpp"
+#include "../ScreenManager.hpp"
 #include "Debug.hpp"
 
 
 
 /**
- * loads all screens at beginning
+ * only the title screen is made at the start, the others are made the
+ * first time they are opened and kept until the cache is full
  * when on titlescreen a tab number is selected and a switch statement is used
  * to let a tab take over
  */
 void debug()
 {
+    AllocationScope allocation_scope(e_alloc_lcd);
     bool cont = true;
 
     TitleScreen dbg1;
-    MotorsDebug dbgM;
-    SensorsDebug dbgS;
-    ControllerDebug dbgC;
-    BatteryDebug dbgB;
-    FieldControlDebug dbgF;
-    Wiring dbgW;
-    InternalMotorDebug dbgP;
+    ScreenManager screens;
 
 
     while ( cont )
@@ -48,30 +46,39 @@ void debug()
         switch (dbg1.option) //go to selected debug screen
         {
             case 1:
-                dbgM.debug();
+                screens.get<MotorsDebug>(1, "Motors")->debug();
                 break;
 
             case 2:
-                dbgS.debug();
+                screens.get<SensorsDebug>(2, "Sensors")->debug();
                 break;
 
             case 3:
-                dbgC.debug();
+                screens.get<ControllerDebug>(3, "Controller")->debug();
                 break;
 
             case 4:
-                dbgB.debug();
+                screens.get<BatteryDebug>(4, "Battery")->debug();
                 break;
 
             case 5:
-                dbgF.debug();
+                screens.get<FieldControlDebug>(5, "Field Control")->debug();
                 break;
 
             case 6:
-                dbgW.debug();
+                screens.get<Wiring>(6, "Wiring")->debug();
                 break;
             case 7:
-                dbgP.debug();
+                screens.get<InternalMotorDebug>(7, "Internal Motor PID")->debug();
+                break;
+            case 8:
+                screens.get<MemoryDebug>(8, "Memory")->debug(screens);
+                break;
+            case 9:
+                screens.get<TasksDebug>(9, "Tasks")->debug();
+                break;
+            case 10:
+                screens.get<ChartsDebug>(10, "Charts")->debug();
                 break;
         }
 
@@ -12,11 +12,14 @@
 #define __DEBUG_HPP__
 
 #include "BatteryDebug.hpp"
+#include "ChartsDebug.hpp"
 #include "ControllerDebug.hpp"
 #include "FieldControlDebug.hpp"
 #include "InternalMotorDebug.hpp"
+#include "MemoryDebug.hpp"
 #include "MotorsDebug.hpp"
 #include "SensorsDebug.hpp"
+#include "TasksDebug.hpp"
 #include "TitleScreen.hpp"
 #include "Wiring.hpp"
 
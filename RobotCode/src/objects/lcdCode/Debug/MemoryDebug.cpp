@@ -0,0 +1,189 @@
+/**
+ * @file: ./RobotCode/src/lcdCode/Debug/MemoryDebug.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see MemoryDebug.hpp
+ *
+ * contains implementation for class for debugging heap usage
+ */
+
+#include "../../../../include/main.h"
+#include "../../../../include/api.h"
+
+#include "../../diagnostics/AllocationTracker.hpp"
+#include "../ScreenManager.hpp"
+#include "../Styles.hpp"
+#include "MemoryDebug.hpp"
+
+
+bool MemoryDebug::cont = true;
+
+MemoryDebug::MemoryDebug()
+{
+    cont = true;
+
+//screen
+    memory_screen = lv_obj_create(NULL, NULL);
+    lv_obj_set_style(memory_screen, &gray);
+
+//init back button
+    //button
+    btn_back = lv_btn_create(memory_screen, NULL);
+    lv_btn_set_style(btn_back, LV_BTN_STYLE_REL, &toggle_btn_released);
+    lv_btn_set_style(btn_back, LV_BTN_STYLE_PR, &toggle_btn_pressed);
+    lv_btn_set_action(btn_back, LV_BTN_ACTION_CLICK, btn_back_action);
+    lv_obj_set_width(btn_back, 75);
+    lv_obj_set_height(btn_back, 25);
+
+    //label
+    btn_back_label = lv_label_create(btn_back, NULL);
+    lv_obj_set_style(btn_back_label, &heading_text);
+    lv_label_set_text(btn_back_label, "Back");
+
+//init title label
+    title_label = lv_label_create(memory_screen, NULL);
+    lv_label_set_style(title_label, &heading_text);
+    lv_obj_set_width(title_label, 440);
+    lv_obj_set_height(title_label, 20);
+    lv_label_set_align(title_label, LV_LABEL_ALIGN_CENTER);
+    lv_label_set_text(title_label, "Memory - Debug");
+
+//init headers label
+    // one line per tag plus the column headers and the total, body text
+    // is used so every line fits above the back button
+    std::string labels_label_text = "subsystem\n";
+    for(int i = 0; i < e_alloc_num_tags; i++) {
+        labels_label_text += std::string(AllocationTracker::get_tag_name(static_cast<alloc_tag>(i))) + "\n";
+    }
+    labels_label_text += "total";
+
+    labels_label = lv_label_create(memory_screen, NULL);
+    lv_label_set_style(labels_label, &body_text);
+    lv_obj_set_width(labels_label, 100);
+    lv_obj_set_height(labels_label, 200);
+    lv_label_set_align(labels_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(labels_label, labels_label_text.c_str());
+
+//init values labels
+    live_label = lv_label_create(memory_screen, NULL);
+    lv_label_set_style(live_label, &body_text);
+    lv_obj_set_width(live_label, 80);
+    lv_obj_set_height(live_label, 200);
+    lv_label_set_align(live_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(live_label, "live");
+
+    peak_label = lv_label_create(memory_screen, NULL);
+    lv_label_set_style(peak_label, &body_text);
+    lv_obj_set_width(peak_label, 80);
+    lv_obj_set_height(peak_label, 200);
+    lv_label_set_align(peak_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(peak_label, "peak");
+
+    rate_label = lv_label_create(memory_screen, NULL);
+    lv_label_set_style(rate_label, &body_text);
+    lv_obj_set_width(rate_label, 80);
+    lv_obj_set_height(rate_label, 200);
+    lv_label_set_align(rate_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(rate_label, "allocs/s");
+
+//init screens label
+    // the left column is free, long screen names wrap onto a second line
+    screens_label = lv_label_create(memory_screen, NULL);
+    lv_label_set_style(screens_label, &body_text);
+    lv_label_set_long_mode(screens_label, LV_LABEL_LONG_BREAK);
+    lv_obj_set_width(screens_label, 105);
+    lv_obj_set_height(screens_label, 170);
+    lv_label_set_align(screens_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(screens_label, "screens");
+
+//set positions
+    lv_obj_set_pos(btn_back, 10, 210);
+
+    lv_obj_align(title_label, memory_screen, LV_ALIGN_IN_TOP_MID, 0, 10);
+
+    lv_obj_set_pos(labels_label, 120, 35);
+    lv_obj_set_pos(live_label, 220, 35);
+    lv_obj_set_pos(peak_label, 300, 35);
+    lv_obj_set_pos(rate_label, 390, 35);
+    lv_obj_set_pos(screens_label, 10, 35);
+
+
+}
+
+
+
+MemoryDebug::~MemoryDebug()
+{
+    lv_obj_del(memory_screen);
+}
+
+
+
+/**
+ * sets cont to false to break main loop so main function returns
+ */
+lv_res_t MemoryDebug::btn_back_action(lv_obj_t *btn)
+{
+    cont = false;
+    return LV_RES_OK;
+}
+
+
+
+/**
+ * main loop that updates the heap usage
+ * the screen cache report is "name,bytes;" per screen then
+ * "free,bytes,min free,bytes", each value is put on its own line
+ */
+void MemoryDebug::debug(ScreenManager& screens)
+{
+    cont = true;
+
+    lv_scr_load(memory_screen);
+
+    if(!AllocationTracker::is_enabled())
+    {
+        lv_label_set_text(live_label, "live\ntracking is off,\nbuild with\n-DALLOCATION_TRACKING");
+    }
+
+    while ( cont )
+    {
+        std::string report = screens.get_report();
+        std::string screens_text = "screens (bytes)\n";
+        for(char c : report) {
+            screens_text += (c == ',' || c == ';') ? '\n' : c;
+        }
+        lv_label_set_text(screens_label, screens_text.c_str());
+
+        if(!AllocationTracker::is_enabled())
+        {
+            pros::delay(500);
+            continue;
+        }
+        AllocationTracker::sample();
+
+        std::string live_text = "live\n";
+        std::string peak_text = "peak\n";
+        std::string rate_text = "allocs/s\n";
+        for(int i = 0; i < e_alloc_num_tags; i++) {
+            allocation_stats stats = AllocationTracker::get_stats(static_cast<alloc_tag>(i));
+            live_text += std::to_string(stats.live_bytes) + "\n";
+            peak_text += std::to_string(stats.peak_bytes) + "\n";
+            rate_text += std::to_string(stats.allocations_per_second) + "\n";
+        }
+
+        allocation_stats total = AllocationTracker::get_total_stats();
+        live_text += std::to_string(total.live_bytes);
+        peak_text += std::to_string(total.peak_bytes);
+        rate_text += std::to_string(total.allocations_per_second);
+
+        lv_label_set_text(live_label, live_text.c_str());
+        lv_label_set_text(peak_label, peak_text.c_str());
+        lv_label_set_text(rate_label, rate_text.c_str());
+
+
+        pros::delay(500);
+    }
+}
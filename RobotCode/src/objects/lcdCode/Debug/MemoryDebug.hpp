@@ -0,0 +1,76 @@
+/**
+ * @file: ./RobotCode/src/lcdCode/Debug/MemoryDebug.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains class for debugging heap usage
+ */
+
+#ifndef __MEMORYDEBUG_HPP__
+#define __MEMORYDEBUG_HPP__
+
+
+#include "../../../../include/main.h"
+
+#include "../ScreenManager.hpp"
+#include "../Styles.hpp"
+
+
+/**
+ * @see: ../Styles.hpp
+ * @see: ../../diagnostics/AllocationTracker.hpp
+ * @see: ../ScreenManager.hpp
+ *
+ * contains methods that show user the live bytes, peak bytes, and
+ * allocations per second of each subsystem and the heap used by the
+ * screens the debugger has cached
+ */
+class MemoryDebug : private Styles
+{
+    private:
+        lv_obj_t *memory_screen;
+        lv_obj_t *title_label;
+
+        lv_obj_t *labels_label;
+        lv_obj_t *live_label;
+        lv_obj_t *peak_label;
+        lv_obj_t *rate_label;
+        lv_obj_t *screens_label;
+
+
+        //back button
+        lv_obj_t *btn_back;
+        lv_obj_t *btn_back_label;
+
+        /**
+         * @param: lv_obj_t* btn -> button that called the funtion
+         * @return: lv_res_t -> LV_RES_OK on successfull completion because object still exists
+         *
+         * button callback function used to set cont to false meaning the
+         * user wants to go to the title screen
+         */
+        static lv_res_t btn_back_action(lv_obj_t *btn);
+
+    public:
+        static bool cont;
+
+        MemoryDebug();
+        ~MemoryDebug();
+
+
+        /**
+         * @param: ScreenManager& screens -> the cache the debugger screens are kept in
+         * @return: None
+         *
+         * allows user to see heap usage of each subsystem and of each
+         * cached screen
+         */
+        void debug(ScreenManager& screens);
+
+};
+
+
+
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file: ./RobotCode/src/lcdCode/Debug/TasksDebug.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see TasksDebug.hpp
+ *
+ * contains implementation for class for debugging task cpu and stack use
+ */
+
+#include <vector>
+
+#include "../../../../include/main.h"
+#include "../../../../include/api.h"
+
+#include "../../diagnostics/TaskStats.hpp"
+#include "../Styles.hpp"
+#include "TasksDebug.hpp"
+
+
+bool TasksDebug::cont = true;
+
+TasksDebug::TasksDebug()
+{
+    cont = true;
+
+//screen
+    tasks_screen = lv_obj_create(NULL, NULL);
+    lv_obj_set_style(tasks_screen, &gray);
+
+//init back button
+    //button
+    btn_back = lv_btn_create(tasks_screen, NULL);
+    lv_btn_set_style(btn_back, LV_BTN_STYLE_REL, &toggle_btn_released);
+    lv_btn_set_style(btn_back, LV_BTN_STYLE_PR, &toggle_btn_pressed);
+    lv_btn_set_action(btn_back, LV_BTN_ACTION_CLICK, btn_back_action);
+    lv_obj_set_width(btn_back, 75);
+    lv_obj_set_height(btn_back, 25);
+
+    //label
+    btn_back_label = lv_label_create(btn_back, NULL);
+    lv_obj_set_style(btn_back_label, &heading_text);
+    lv_label_set_text(btn_back_label, "Back");
+
+//init title label
+    title_label = lv_label_create(tasks_screen, NULL);
+    lv_label_set_style(title_label, &heading_text);
+    lv_obj_set_width(title_label, 440);
+    lv_obj_set_height(title_label, 20);
+    lv_label_set_align(title_label, LV_LABEL_ALIGN_CENTER);
+    lv_label_set_text(title_label, "Tasks - Debug");
+
+//init column labels
+    names_label = lv_label_create(tasks_screen, NULL);
+    lv_label_set_style(names_label, &body_text);
+    lv_obj_set_width(names_label, 140);
+    lv_obj_set_height(names_label, 170);
+    lv_label_set_align(names_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(names_label, "task");
+
+    cpu_label = lv_label_create(tasks_screen, NULL);
+    lv_label_set_style(cpu_label, &body_text);
+    lv_obj_set_width(cpu_label, 50);
+    lv_obj_set_height(cpu_label, 170);
+    lv_label_set_align(cpu_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(cpu_label, "cpu %");
+
+    stack_label = lv_label_create(tasks_screen, NULL);
+    lv_label_set_style(stack_label, &body_text);
+    lv_obj_set_width(stack_label, 100);
+    lv_obj_set_height(stack_label, 170);
+    lv_label_set_align(stack_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(stack_label, "stack bytes");
+
+    recommended_label = lv_label_create(tasks_screen, NULL);
+    lv_label_set_style(recommended_label, &body_text);
+    lv_obj_set_width(recommended_label, 70);
+    lv_obj_set_height(recommended_label, 170);
+    lv_label_set_align(recommended_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(recommended_label, "rec. depth");
+
+    jitter_label = lv_label_create(tasks_screen, NULL);
+    lv_label_set_style(jitter_label, &body_text);
+    lv_obj_set_width(jitter_label, 70);
+    lv_obj_set_height(jitter_label, 170);
+    lv_label_set_align(jitter_label, LV_LABEL_ALIGN_LEFT);
+    lv_label_set_text(jitter_label, "jitter us");
+
+//set positions
+    lv_obj_set_pos(btn_back, 30, 210);
+
+    lv_obj_align(title_label, tasks_screen, LV_ALIGN_IN_TOP_MID, 0, 10);
+
+    lv_obj_set_pos(names_label, 10, 35);
+    lv_obj_set_pos(cpu_label, 150, 35);
+    lv_obj_set_pos(stack_label, 200, 35);
+    lv_obj_set_pos(recommended_label, 310, 35);
+    lv_obj_set_pos(jitter_label, 390, 35);
+
+
+}
+
+
+
+TasksDebug::~TasksDebug()
+{
+    lv_obj_del(tasks_screen);
+}
+
+
+
+/**
+ * sets cont to false to break main loop so main function returns
+ */
+lv_res_t TasksDebug::btn_back_action(lv_obj_t *btn)
+{
+    cont = false;
+    return LV_RES_OK;
+}
+
+
+
+/**
+ * main loop that updates the task stats
+ * tasks that have been deleted are shown with a star and no stack use
+ */
+void TasksDebug::debug()
+{
+    cont = true;
+
+    lv_scr_load(tasks_screen);
+
+    while ( cont )
+    {
+        TaskStats::sample();
+
+        std::string names_text = "task\n";
+        std::string cpu_text = "cpu %\n";
+        std::string stack_text = "stack bytes\n";
+        std::string recommended_text = "rec. depth\n";
+        std::string jitter_text = "jitter us\n";
+        for(const task_report& report : TaskStats::get_reports()) {
+            names_text += report.name + (report.alive ? "\n" : "*\n");
+            cpu_text += std::to_string(static_cast<int>(report.cpu_percent + .5)) + "\n";
+            stack_text += (report.stack_used < 0 ? "?" : std::to_string(report.stack_used)) + "/" + std::to_string(report.stack_size) + "\n";
+            recommended_text += std::to_string(report.recommended_depth) + "\n";
+            jitter_text += std::to_string(report.max_jitter) + "\n";
+        }
+
+        lv_label_set_text(names_label, names_text.c_str());
+        lv_label_set_text(cpu_label, cpu_text.c_str());
+        lv_label_set_text(stack_label, stack_text.c_str());
+        lv_label_set_text(recommended_label, recommended_text.c_str());
+        lv_label_set_text(jitter_label, jitter_text.c_str());
+
+
+        pros::delay(500);
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ * @file: ./RobotCode/src/lcdCode/Debug/TasksDebug.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains class for debugging task cpu and stack use
+ */
+
+#ifndef __TASKSDEBUG_HPP__
+#define __TASKSDEBUG_HPP__
+
+
+#include "../../../../include/main.h"
+
+#include "../Styles.hpp"
+
+
+/**
+ * @see: ../Styles.hpp
+ * @see: ../../diagnostics/TaskStats.hpp
+ *
+ * contains methods that show user the cpu use, stack use, recommended stack
+ * size, and loop jitter of each task
+ */
+class TasksDebug : private Styles
+{
+    private:
+        lv_obj_t *tasks_screen;
+        lv_obj_t *title_label;
+
+        lv_obj_t *names_label;
+        lv_obj_t *cpu_label;
+        lv_obj_t *stack_label;
+        lv_obj_t *recommended_label;
+        lv_obj_t *jitter_label;
+
+
+        //back button
+        lv_obj_t *btn_back;
+        lv_obj_t *btn_back_label;
+
+        /**
+         * @param: lv_obj_t* btn -> button that called the funtion
+         * @return: lv_res_t -> LV_RES_OK on successfull completion because object still exists
+         *
+         * button callback function used to set cont to false meaning the
+         * user wants to go to the title screen
+         */
+        static lv_res_t btn_back_action(lv_obj_t *btn);
+
+    public:
+        static bool cont;
+
+        TasksDebug();
+        ~TasksDebug();
+
+
+        /**
+         * @return: None
+         *
+         * allows user to see cpu and stack use of each task
+         */
+        void debug();
+
+};
+
+
+
+
+#endif
@@ -19,7 +19,7 @@
 int TitleScreen::option = 0;
 const char* TitleScreen::btnm_map[] = {
         "Motors", "Sensors", "Controller", "Battery", 
-        "\n", "Field Control", "Wiring", "Internal\nMotor PID", ""
+        "\n", "Field Control", "Wiring", "Internal\nMotor PID", "Memory", "Tasks", "Charts", ""
         };
 
 TitleScreen::TitleScreen()
@@ -117,6 +117,18 @@ lv_res_t TitleScreen::button_matrix_action(lv_obj_t *btnm, const char *btn_txt)
     {
         option = 7;
     }
+    else if (btn_txt == "Memory")
+    {
+        option = 8;
+    }
+    else if (btn_txt == "Tasks")
+    {
+        option = 9;
+    }
+    else if (btn_txt == "Charts")
+    {
+        option = 10;
+    }
     return LV_RES_OK;
 }
 
@@ -146,7 +158,7 @@ void TitleScreen::chooseOption()
     while ( !option )
     {
         //allow controller to press the buttons as well
-        if ( controllers.master.get_digital(pros::E_CONTROLLER_DIGITAL_B) )
+        if ( controllers.get_snapshot(20).is_pressing(pros::E_CONTROLLER_DIGITAL_B) )
         {
             btn_back_action( NULL );
             pros::delay(100);
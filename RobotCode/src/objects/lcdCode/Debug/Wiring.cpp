@@ -23,7 +23,7 @@ bool Wiring::cont = true;
 
 Wiring::Wiring()
 {
-    Configuration* config = Configuration::get_instance();
+    config_image config = Configuration::get_instance()->to_image();  // locked copy in case a reload is running
     
     cont = true;
 
@@ -61,14 +61,14 @@ Wiring::Wiring()
     lv_label_set_align(motor_info, LV_LABEL_ALIGN_LEFT);
 
     std::string motors_text = (
-            "front right     (200 RPM) - " + std::to_string(config->front_right_port) + "\n"
-            "back right      (200 RPM) - " + std::to_string(config->back_left_port) + "\n"
-            "front left      (200 RPM) - " + std::to_string(config->front_left_port) + "\n"
-            "back left       (200 RPM) - " + std::to_string(config->back_right_port) + "\n"
-            "left intake     (600 RPM) - " + std::to_string(config->left_intake_port) + "\n"
-            "right intake    (600 RPM) - " + std::to_string(config->right_intake_port) + "\n"
-            "upper_indexer   (600 RPM) - " + std::to_string(config->upper_indexer_port) + "\n"
-            "lower_indexer   (600 RPM) - " + std::to_string(config->lower_indexer_port) + "\n"
+            "front right     (200 RPM) - " + std::to_string(config.ports[0]) + "\n"
+            "back right      (200 RPM) - " + std::to_string(config.ports[1]) + "\n"
+            "front left      (200 RPM) - " + std::to_string(config.ports[2]) + "\n"
+            "back left       (200 RPM) - " + std::to_string(config.ports[3]) + "\n"
+            "left intake     (600 RPM) - " + std::to_string(config.ports[4]) + "\n"
+            "right intake    (600 RPM) - " + std::to_string(config.ports[5]) + "\n"
+            "upper_indexer   (600 RPM) - " + std::to_string(config.ports[6]) + "\n"
+            "lower_indexer   (600 RPM) - " + std::to_string(config.ports[7]) + "\n"
     );
 
     lv_label_set_text(motor_info, motors_text.c_str());
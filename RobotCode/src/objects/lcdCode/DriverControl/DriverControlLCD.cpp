@@ -12,6 +12,7 @@
 #include "main.h"
 
 #include "../../../Autons.hpp"
+#include "../../diagnostics/Trace.hpp"
 #include "../../serial/Logger.hpp"
 #include "../../position_tracking/PositionTracker.hpp"
 #include "../AutonSelection/OptionsScreen.hpp"
@@ -19,8 +20,8 @@
 #include "DriverControlLCD.hpp"
 
 
-bool DriverControlLCD::log_data = false;
-bool DriverControlLCD::open_debugger = false;
+std::atomic<bool> DriverControlLCD::log_data = ATOMIC_VAR_INIT(false);
+std::atomic<bool> DriverControlLCD::open_debugger = ATOMIC_VAR_INIT(false);
 std::string DriverControlLCD::toggle_logging_text = "Start Logging";
 LV_IMG_DECLARE(logo);
 
@@ -28,7 +29,25 @@ LV_IMG_DECLARE(logo);
 DriverControlLCD::DriverControlLCD()
 {
     log_data = false;
-    
+    screen = NULL;
+    shown_log_data = false;
+    shown_queue_size = -1;
+}
+
+
+
+DriverControlLCD::~DriverControlLCD()
+{
+    if(screen != NULL)
+    {
+        lv_obj_del(screen);
+    }
+}
+
+
+
+void DriverControlLCD::init_screen()
+{
     screen = lv_obj_create(NULL, NULL);
     lv_obj_set_style(screen, &gray);
     
@@ -126,13 +145,6 @@ DriverControlLCD::DriverControlLCD()
 
 
 
-DriverControlLCD::~DriverControlLCD()
-{
-    lv_obj_del(screen);
-}
-
-
-
 
 lv_res_t DriverControlLCD::btn_debugger_action(lv_obj_t *btn)
 {
@@ -188,42 +200,70 @@ lv_res_t DriverControlLCD::btn_flush_queue_action(lv_obj_t *btn)
 
 
 
+void DriverControlLCD::load()
+{
+    if(screen == NULL)
+    {
+        init_screen();
+    }
+    lv_scr_load(screen);
+    
+    // force every widget to be redrawn on the next update
+    shown_log_data = !log_data;
+    shown_queue_size = -1;
+}
+
+
+
 /**
  * updates colors and borders during driver control
  * keeps data relevent
+ * lvgl is only called for values that changed since they were last shown
  */
-void DriverControlLCD::update_labels()
+void DriverControlLCD::update()
 {
-    lv_scr_load(screen);
+    TRACE_SCOPE("DriverControlLCD::update");
     
     Logger logger;
     // PositionTracker* pos_tracker = PositionTracker::get_instance();
     
     // update toggle logging label text
-    if(log_data)
+    bool logging = log_data;
+    if(logging != shown_log_data)
     {
-        lv_label_set_text(btn_toggle_logging_label, "Stop Logging");
-        Motors::set_log_level(1);
-    
-        // pos_tracker->start_logging();
-    
-        Sensors::log_data();
+        if(logging)
+        {
+            lv_label_set_text(btn_toggle_logging_label, "Stop Logging");
+            Motors::set_log_level(1);
+            // pos_tracker->start_logging();
+        }
+        else 
+        {
+            lv_label_set_text(btn_toggle_logging_label, "Start Logging");
+            Motors::set_log_level(0);
+            // pos_tracker->stop_logging();
+        }
+        shown_log_data = logging;
     }
-    else 
-    {
-        lv_label_set_text(btn_toggle_logging_label, "Start Logging");
-        Motors::set_log_level(0);
     
-        // pos_tracker->stop_logging();
+    if(logging)
+    {
+        Sensors::log_data();
     }
     
     if(open_debugger)
     {
-        debug();
+        debug();  // blocks this thread until the debugger is closed
         open_debugger = false;
+        load();
     }
     
     //update logger queue size label 
-    std::string text = std::string("Logger Queue Size: ") + std::to_string(logger.get_count());
-    lv_label_set_text(queue_size_label, text.c_str());
+    int queue_size = logger.get_count();
+    if(queue_size != shown_queue_size)
+    {
+        std::string text = std::string("Logger Queue Size: ") + std::to_string(queue_size);
+        lv_label_set_text(queue_size_label, text.c_str());
+        shown_queue_size = queue_size;
+    }
 }
@@ -11,25 +11,35 @@
 #ifndef __DRIVERCONTROLLCD_HPP__
 #define __DRIVERCONTROLLCD_HPP__
 
+#include <atomic>
+
 #include "main.h"
 
 #include "../Styles.hpp"
+#include "../UIThread.hpp"
 
 
 /**
  * @see: ../Styles.hpp
  *
+ * @see: ../UIThread.hpp
+ *
  * contains lcd to be used during driver control
+ * the lvgl objects are made the first time the ui thread loads the screen
  */
-class DriverControlLCD : private Styles
+class DriverControlLCD : public UIScreen, private Styles
 {
     private:
-        static bool log_data;
-        static bool open_debugger;
+        static std::atomic<bool> log_data;
+        static std::atomic<bool> open_debugger;
         static std::string toggle_logging_text;
         
         lv_obj_t *screen;
         
+        // values the widgets show, compared each frame so only changes are drawn
+        bool shown_log_data;
+        int shown_queue_size;
+        
         lv_obj_t *logo_img;
         
         
@@ -83,6 +93,14 @@ class DriverControlLCD : private Styles
          * button callback function used to flush the logging queue
          */
         static lv_res_t btn_flush_queue_action(lv_obj_t *btn);
+        
+        
+        /**
+         * @return: None
+         *
+         * makes the lvgl objects for the screen
+         */
+        void init_screen();
 
 
     public:
@@ -93,11 +111,18 @@ class DriverControlLCD : private Styles
         /**
          * @return: None
          *
-         * TODO: add actual content to be updated
+         * makes the screen if it has not been made and redraws every widget
+         * only called from the ui thread
+         */
+        void load();
+
+        /**
+         * @return: None
          *
-         * function to be used to update the gui to keep data relevant
+         * updates the widgets whose values changed and opens the debugger
+         * if it was asked for, only called from the ui thread
          */
-        void update_labels();
+        void update();
 
 
 };
@@ -0,0 +1,132 @@
+/**
+ * @file: ./RobotCode/src/objects/lcdCode/ScreenManager.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: ScreenManager.hpp
+ *
+ * contains implementation for the lcd screen cache
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+#include "../serial/Logger.hpp"
+#include "ScreenManager.hpp"
+
+
+// lvgl allocates with kmalloc, which is the freertos heap in the pros kernel
+extern "C" std::size_t xPortGetFreeHeapSize(void);
+
+
+int ScreenManager::min_free_heap = INT_MAX;
+
+
+
+ScreenManager::ScreenManager(int cache_size /*SCREEN_CACHE_SIZE*/)
+{
+    max_screens = std::max(cache_size, 1);
+    uses = 0;
+}
+
+
+
+ScreenManager::~ScreenManager()
+{
+    clear();
+}
+
+
+
+void ScreenManager::destroy(std::size_t index)
+{
+    screen_cache_entry entry = screens.at(index);
+    screens.erase(screens.begin() + index);
+    entry.destroy(entry.screen);
+
+    log_screen("deleted", entry, get_free_heap());
+}
+
+
+
+void ScreenManager::trim(int keep_id)
+{
+    while(screens.size() > 1) {
+        bool over_size = screens.size() > static_cast<std::size_t>(max_screens);
+        bool low_heap = get_free_heap() < SCREEN_MIN_FREE_HEAP;
+        if(!over_size && !low_heap) {
+            break;
+        }
+
+        std::size_t oldest = screens.size();
+        for(std::size_t i = 0; i < screens.size(); i++) {
+            if(screens.at(i).id != keep_id && (oldest == screens.size() || screens.at(i).last_used < screens.at(oldest).last_used)) {
+                oldest = i;
+            }
+        }
+        destroy(oldest);
+    }
+}
+
+
+
+void ScreenManager::clear()
+{
+    while(!screens.empty()) {
+        destroy(screens.size() - 1);
+    }
+}
+
+
+
+std::string ScreenManager::get_report()
+{
+    std::string report;
+    for(const screen_cache_entry& entry : screens) {
+        report += std::string(entry.name) + "," + std::to_string(entry.heap_used) + ";";
+    }
+    report += "free," + std::to_string(get_free_heap()) + ",min free," + std::to_string(get_min_free_heap());
+
+    return report;
+}
+
+
+
+int ScreenManager::get_free_heap()
+{
+    int free_heap = xPortGetFreeHeapSize();
+    min_free_heap = std::min(min_free_heap, free_heap);
+    return free_heap;
+}
+
+
+
+int ScreenManager::get_min_free_heap()
+{
+    return min_free_heap;
+}
+
+
+
+void ScreenManager::log_screen(const char* action, const screen_cache_entry& entry, int free_heap)
+{
+    Logger logger;
+    log_entry log;
+    log.content = (
+        "[INFO] " + std::string("Screen Manager")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Screen: " + entry.name
+        + ", Action: " + action
+        + ", Heap_Used: " + std::to_string(entry.heap_used)
+        + ", Free_Heap: " + std::to_string(free_heap)
+        + ", Min_Free_Heap: " + std::to_string(min_free_heap)
+    );
+    log.stream = "clog";
+    logger.add(log);
+}
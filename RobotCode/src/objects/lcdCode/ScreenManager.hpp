@@ -0,0 +1,149 @@
+/**
+ * @file: ./RobotCode/src/objects/lcdCode/ScreenManager.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a cache that makes lcd screens the first time they are used
+ * instead of all at once
+ */
+
+#ifndef __SCREENMANAGER_HPP__
+#define __SCREENMANAGER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+
+
+#define SCREEN_CACHE_SIZE 3  // screens kept after they are closed
+#define SCREEN_MIN_FREE_HEAP (64 * 1024)  // bytes, cached screens are freed when the heap has less than this free
+
+
+typedef struct {
+    int id;
+    const char* name;
+    void* screen;
+    void (*destroy)(void*);
+    int heap_used;  // bytes of lvgl heap the screen took when it was made
+    std::uint32_t last_used;
+} screen_cache_entry;
+
+
+
+/**
+ * screens are made by get the first time they are asked for and kept so
+ * going back to them is fast, the least recently used one is deleted
+ * when there are more than the cache size or the heap is low
+ * the screen that was just asked for is never deleted so the pointer
+ * from get is good until the next call to get
+ * lvgl allocates from the kernel heap so the heap a screen uses is the
+ * drop in free kernel heap while it is made
+ */
+class ScreenManager
+{
+    private:
+        std::vector<screen_cache_entry> screens;
+        int max_screens;
+        std::uint32_t uses;
+
+        static int min_free_heap;
+
+        /**
+         * @param: int keep_id -> the screen that must not be deleted
+         * @return: None
+         *
+         * deletes least recently used screens until the cache is in size
+         * and the heap has enough free or only keep_id is left
+         */
+        void trim(int keep_id);
+
+        void destroy(std::size_t index);
+
+        template <typename T>
+        static void destroy_screen(void* screen) {
+            delete static_cast<T*>(screen);
+        }
+
+    public:
+        /**
+         * @param: int cache_size -> the most screens to keep at once
+         */
+        ScreenManager(int cache_size=SCREEN_CACHE_SIZE);
+        ~ScreenManager();
+
+        ScreenManager(const ScreenManager&) = delete;
+        ScreenManager& operator=(const ScreenManager&) = delete;
+
+        /**
+         * @param: int id -> unique id for the screen
+         * @param: const char* name -> the name used in reports, must be a string literal
+         * @return: T* -> the screen, made if it was not already
+         */
+        template <typename T>
+        T* get(int id, const char* name) {
+            uses += 1;
+            for(screen_cache_entry& entry : screens) {
+                if(entry.id == id) {
+                    entry.last_used = uses;
+                    return static_cast<T*>(entry.screen);
+                }
+            }
+
+            int free_before = get_free_heap();
+            T* screen = new T;
+            int free_after = get_free_heap();
+
+            screen_cache_entry entry;
+            entry.id = id;
+            entry.name = name;
+            entry.screen = screen;
+            entry.destroy = destroy_screen<T>;
+            entry.heap_used = free_before - free_after;
+            entry.last_used = uses;
+            screens.push_back(entry);
+
+            log_screen("made", entry, free_after);
+            trim(id);
+            return screen;
+        }
+
+        /**
+         * @return: None
+         *
+         * deletes every cached screen
+         */
+        void clear();
+
+        /**
+         * @return: std::string -> one "name,heap bytes;" group per cached screen
+         *                         and "free,bytes,min free,bytes" at the end
+         */
+        std::string get_report();
+
+        /**
+         * @return: int -> bytes free in the kernel heap that lvgl uses
+         */
+        static int get_free_heap();
+
+        /**
+         * @return: int -> the least free kernel heap seen by any screen manager
+         */
+        static int get_min_free_heap();
+
+        /**
+         * @param: const char* action -> what happened to the screen
+         * @param: const screen_cache_entry& entry -> the screen
+         * @param: int free_heap -> bytes free after it happened
+         * @return: None
+         */
+        static void log_screen(const char* action, const screen_cache_entry& entry, int free_heap);
+};
+
+
+
+#endif
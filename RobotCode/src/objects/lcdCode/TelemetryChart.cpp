@@ -0,0 +1,130 @@
+/**
+ * @file: ./RobotCode/src/objects/lcdCode/TelemetryChart.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: TelemetryChart.hpp
+ *
+ * contains implementation for the telemetry chart widget
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+#include "main.h"
+
+#include "../diagnostics/Clock.hpp"
+#include "../diagnostics/Telemetry.hpp"
+#include "../diagnostics/Trace.hpp"
+#include "TelemetryChart.hpp"
+
+
+
+TelemetryChart::TelemetryChart(lv_obj_t *parent, int width, int height)
+{
+    chart = lv_chart_create(parent, NULL);
+    lv_obj_set_size(chart, width, height);
+    lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_point_count(chart, 2 * TELEMETRY_POINTS);
+    lv_chart_set_range(chart, 0, TELEMETRY_CHART_RANGE);
+    lv_chart_set_div_line_count(chart, 3, 4);
+    lv_chart_set_series_width(chart, 1);
+
+    series.at(0) = lv_chart_add_series(chart, LV_COLOR_MAKE(0x2E, 0x86, 0xDE));
+    series.at(1) = lv_chart_add_series(chart, LV_COLOR_MAKE(0xE7, 0x4C, 0x3C));
+    for(int i = 0; i < TELEMETRY_CHART_SERIES; i++) {
+        signals.at(i) = -1;
+        lv_chart_init_points(chart, series.at(i), LV_CHART_POINT_DEF);
+    }
+
+    range_label = lv_label_create(parent, NULL);
+    lv_obj_set_style(range_label, &body_text);
+    lv_obj_set_width(range_label, width);
+    lv_label_set_text(range_label, "no data");
+}
+
+
+
+/**
+ * the chart and label are deleted with the screen they are on
+ */
+TelemetryChart::~TelemetryChart()
+{
+
+}
+
+
+
+void TelemetryChart::set_signal(int index, int signal)
+{
+    if(index < 0 || index >= TELEMETRY_CHART_SERIES) {
+        return;
+    }
+
+    signals.at(index) = signal;
+    lv_chart_init_points(chart, series.at(index), LV_CHART_POINT_DEF);
+}
+
+
+
+/**
+ * reading the buckets and scaling them is linear in TELEMETRY_POINTS,
+ * the chart is only invalidated once at the end
+ */
+int TelemetryChart::update()
+{
+    TRACE_SCOPE("TelemetryChart::update");
+    std::uint64_t start = Clock::get_micros();
+
+    std::array<int, TELEMETRY_CHART_SERIES> counts;
+    float low = 0;
+    float high = 0;
+    bool has_data = false;
+    for(int i = 0; i < TELEMETRY_CHART_SERIES; i++) {
+        counts.at(i) = Telemetry::read(signals.at(i), buckets.at(i).data());
+        for(int j = 0; j < counts.at(i); j++) {
+            const telemetry_bucket& bucket = buckets.at(i).at(j);
+            low = has_data ? std::min(low, bucket.min) : bucket.min;
+            high = has_data ? std::max(high, bucket.max) : bucket.max;
+            has_data = true;
+        }
+    }
+
+    if(high - low < .001) {  // keep a flat line in the middle instead of dividing by zero
+        low -= 1;
+        high += 1;
+    }
+    float scale = TELEMETRY_CHART_RANGE / (high - low);
+
+    for(int i = 0; i < TELEMETRY_CHART_SERIES; i++) {
+        int empty = TELEMETRY_POINTS - counts.at(i);  // the newest bucket is always on the right edge
+        std::fill(points.begin(), points.begin() + (2 * empty), LV_CHART_POINT_DEF);
+        for(int j = 0; j < counts.at(i); j++) {
+            const telemetry_bucket& bucket = buckets.at(i).at(j);
+            points.at(2 * (empty + j)) = static_cast<lv_coord_t>((bucket.min - low) * scale);
+            points.at(2 * (empty + j) + 1) = static_cast<lv_coord_t>((bucket.max - low) * scale);
+        }
+        lv_chart_set_points(chart, series.at(i), points.data());
+    }
+
+    if(has_data) {
+        char text[48];
+        std::snprintf(text, sizeof(text), "%.2f to %.2f", low, high);
+        lv_label_set_text(range_label, text);
+    } else {
+        lv_label_set_text(range_label, "no data");
+    }
+
+    return Clock::get_micros() - start;
+}
+
+
+
+void TelemetryChart::set_pos(lv_coord_t x, lv_coord_t y)
+{
+    lv_obj_set_pos(chart, x, y);
+    lv_obj_align(range_label, chart, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 2);
+}
@@ -0,0 +1,80 @@
+/**
+ * @file: ./RobotCode/src/objects/lcdCode/TelemetryChart.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a chart widget that draws the recent history of telemetry
+ * signals
+ */
+
+#ifndef __TELEMETRYCHART_HPP__
+#define __TELEMETRYCHART_HPP__
+
+#include <array>
+
+#include "main.h"
+
+#include "../diagnostics/Telemetry.hpp"
+#include "Styles.hpp"
+
+
+
+#define TELEMETRY_CHART_SERIES 2
+#define TELEMETRY_CHART_RANGE 1000  // chart units the y axis is scaled to
+
+
+/**
+ * @see: ../diagnostics/Telemetry.hpp
+ *
+ * each bucket is drawn as its min then its max point with a line between
+ * them, so a spike inside a bucket still shows up at full height
+ * every series is scaled to the same y range, the range of the first
+ * series that has data is shown in the range label
+ */
+class TelemetryChart : private Styles
+{
+    private:
+        lv_obj_t *chart;
+        lv_obj_t *range_label;
+        std::array<lv_chart_series_t*, TELEMETRY_CHART_SERIES> series;
+        std::array<int, TELEMETRY_CHART_SERIES> signals;
+
+        std::array<std::array<telemetry_bucket, TELEMETRY_POINTS>, TELEMETRY_CHART_SERIES> buckets;
+        std::array<lv_coord_t, 2 * TELEMETRY_POINTS> points;
+
+    public:
+        /**
+         * @param: lv_obj_t* parent -> the screen to put the chart on
+         * @param: int width -> width of the chart in pixels
+         * @param: int height -> height of the chart in pixels, the range label goes under it
+         */
+        TelemetryChart(lv_obj_t *parent, int width, int height);
+        ~TelemetryChart();
+
+        /**
+         * @param: int index -> which series to set, 0 to TELEMETRY_CHART_SERIES - 1
+         * @param: int signal -> the telemetry signal to draw, -1 to draw nothing
+         * @return: None
+         */
+        void set_signal(int index, int signal);
+
+        /**
+         * @return: int -> us it took to read the signals and update the chart
+         *
+         * redraws the chart from the newest buckets of each signal, takes
+         * the same time no matter how fast the signals are logged
+         */
+        int update();
+
+        /**
+         * @param: lv_coord_t x -> x position on the parent
+         * @param: lv_coord_t y -> y position on the parent
+         * @return: None
+         */
+        void set_pos(lv_coord_t x, lv_coord_t y);
+};
+
+
+
+#endif
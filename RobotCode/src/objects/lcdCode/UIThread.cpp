@@ -0,0 +1,193 @@
+/**
+ * @file: ./RobotCode/src/objects/lcdCode/UIThread.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: UIThread.hpp
+ *
+ * contains implementation for the lcd thread
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "main.h"
+
+#include "../diagnostics/AllocationTracker.hpp"
+#include "../diagnostics/Clock.hpp"
+#include "../diagnostics/TaskStats.hpp"
+#include "../diagnostics/Trace.hpp"
+#include "UIThread.hpp"
+
+
+
+UIThread *UIThread::thread_obj = NULL;
+std::atomic<UIScreen*> UIThread::screen = ATOMIC_VAR_INIT(NULL);
+std::atomic<int> UIThread::screen_version = ATOMIC_VAR_INIT(0);
+std::atomic<int> UIThread::loaded_version = ATOMIC_VAR_INIT(0);
+std::atomic<int> UIThread::frame_period = ATOMIC_VAR_INIT(UI_DEFAULT_FRAME_PERIOD);
+
+int UIThread::frames = 0;
+std::int64_t UIThread::total_frame_time = 0;
+int UIThread::max_frame_time = 0;
+int UIThread::overruns = 0;
+
+static std::atomic<bool> stats_lock = ATOMIC_VAR_INIT(false);
+
+
+
+UIThread::UIThread()
+{
+    // lowest priority so drawing only ever uses time the control loops do not need
+    thread = new pros::Task( run, (void*)NULL, TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT, "ui_thread");
+    thread->suspend();
+    running = false;
+}
+
+
+UIThread::~UIThread()
+{
+    thread->remove();
+    delete thread;
+}
+
+
+
+void UIThread::run(void*)
+{
+    AllocationScope allocation_scope(e_alloc_lcd);
+    int stats_id = TaskStats::register_current_task("ui_thread", frame_period, TASK_STACK_DEPTH_DEFAULT);
+
+    UIScreen* loaded_screen = NULL;
+    std::uint32_t wake_time = pros::millis();
+    while(1) {
+        TaskStats::loop_tick(stats_id);
+        std::uint64_t start = Clock::get_micros();
+        {
+            TRACE_SCOPE("ui_frame");
+            int version = screen_version;  // read before the screen so a newer screen is never marked as loaded
+            if(version != loaded_version) {
+                loaded_screen = screen;
+                if(loaded_screen != NULL) {
+                    loaded_screen->load();
+                }
+                loaded_version = version;
+            }
+
+            if(loaded_screen != NULL) {
+                loaded_screen->update();
+            }
+        }
+        int frame_time = Clock::get_micros() - start;
+
+        int period = frame_period;
+        bool overrun = frame_time > period * 1000;
+
+        // this task is the lowest priority so waiting here can not hold up a reader
+        while ( stats_lock.exchange( true ) );
+        frames += 1;
+        total_frame_time += frame_time;
+        max_frame_time = std::max(max_frame_time, frame_time);
+        overruns += overrun ? 1 : 0;
+        stats_lock.exchange( false ); //release lock
+
+        if(overrun) {
+            wake_time = pros::millis();
+        }
+        pros::c::task_delay_until(&wake_time, period);
+    }
+}
+
+
+
+/**
+ * inits object if object is not already initialized based on a static bool
+ * sets bool if it is not set
+ */
+UIThread* UIThread::get_instance() {
+    if ( thread_obj == NULL ) {
+        thread_obj = new UIThread;
+    }
+    return thread_obj;
+}
+
+
+void UIThread::start_thread() {
+    running = true;
+    thread->resume();
+}
+
+void UIThread::stop_thread() {
+    thread->suspend();
+    running = false;
+}
+
+
+
+void UIThread::set_screen(UIScreen* new_screen) {
+    screen = new_screen;
+    screen_version += 1;
+}
+
+
+
+/**
+ * the ui thread only switches screens at the start of a frame, so once it
+ * has switched to no screen the frame that was drawing has finished
+ */
+bool UIThread::clear_screen(int timeout /*UI_CLEAR_TIMEOUT*/) {
+    set_screen(NULL);
+    int version = screen_version;
+    std::uint32_t start = pros::millis();
+    while(running && loaded_version != version) {
+        if(pros::millis() - start > timeout) {
+            return false;
+        }
+        pros::delay(1);  // the ui thread is the lowest priority so it needs the time to finish
+    }
+    return true;
+}
+
+
+
+void UIThread::set_frame_period(int period) {
+    frame_period = std::max(period, 1);
+}
+
+
+
+/**
+ * readers are higher priority than the ui thread so they wait with a delay
+ * instead of spinning, spinning would never let the ui thread release it
+ */
+ui_frame_stats UIThread::get_frame_stats() {
+    while ( stats_lock.exchange( true ) ) {
+        pros::delay(1);
+    }
+
+    ui_frame_stats stats;
+    stats.frames = frames;
+    stats.average_frame_time = frames > 0 ? total_frame_time / frames : 0;
+    stats.max_frame_time = max_frame_time;
+    stats.overruns = overruns;
+    stats.frame_period = frame_period;
+
+    stats_lock.exchange( false ); //release lock
+    return stats;
+}
+
+
+
+std::string UIThread::get_report() {
+    ui_frame_stats stats = get_frame_stats();
+    return (
+        std::to_string(stats.frames)
+        + "," + std::to_string(stats.average_frame_time)
+        + "," + std::to_string(stats.max_frame_time)
+        + "," + std::to_string(stats.overruns)
+        + "," + std::to_string(stats.frame_period)
+    );
+}
@@ -0,0 +1,166 @@
+/**
+ * @file: ./RobotCode/src/objects/lcdCode/UIThread.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a low priority thread that owns updating the lcd so the control
+ * loops never wait on lvgl
+ */
+
+#ifndef __UITHREAD_HPP__
+#define __UITHREAD_HPP__
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "main.h"
+
+
+
+#define UI_DEFAULT_FRAME_PERIOD 50  // ms between frames
+#define UI_CLEAR_TIMEOUT 200  // ms clear_screen waits for the current frame to finish
+
+
+/**
+ * a screen shown by the ui thread, load and update are only ever called
+ * from the ui thread so they are the only place lvgl is used while the
+ * robot is running
+ */
+class UIScreen
+{
+    public:
+        virtual ~UIScreen() { }
+
+        /**
+         * @return: None
+         *
+         * called when the screen is shown, makes the lvgl objects if they
+         * do not exist yet and redraws every widget
+         */
+        virtual void load() = 0;
+
+        /**
+         * @return: None
+         *
+         * called once per frame, should only change widgets whose values
+         * changed since the last frame
+         */
+        virtual void update() = 0;
+};
+
+
+
+typedef struct {
+    int frames;
+    int average_frame_time;  // us
+    int max_frame_time;  // us
+    int overruns;  // frames that took longer than the frame period
+    int frame_period;  // ms
+} ui_frame_stats;
+
+
+
+/**
+ * @see: DriverControl/DriverControlLCD.hpp
+ *
+ * contains singleton class for running the lcd on its own thread
+ * other tasks only pick which screen is shown, the screen reads the state
+ * it shows itself each frame
+ */
+class UIThread
+{
+    private:
+        UIThread();
+        static UIThread *thread_obj;
+
+        static std::atomic<UIScreen*> screen;
+        static std::atomic<int> screen_version;  // changed by every set_screen so the same screen can be reloaded
+        static std::atomic<int> loaded_version;  // the version the ui thread has switched to
+        static std::atomic<int> frame_period;
+
+        static int frames;
+        static std::int64_t total_frame_time;
+        static int max_frame_time;
+        static int overruns;
+
+        pros::Task *thread;
+        bool running;
+
+
+        /**
+         * @param: void* -> not used, but necessary to follow thread making constructor
+         * @return: None
+         *
+         * loads the screen if it changed and updates it once per frame
+         * a frame that runs over the period pushes the next one back
+         * instead of running frames back to back to catch up
+         */
+        static void run(void*);
+
+    public:
+        ~UIThread();
+
+        /**
+         * @return: UIThread -> instance of class to be used throughout program
+         *
+         * give the instance of the singleton class or creates it if it does
+         * not yet exist
+         */
+        static UIThread* get_instance();
+
+        /**
+         * @return: None
+         *
+         * starts the thread or resumes it if it was stopped
+         */
+        void start_thread();
+
+        /**
+         * @return: None
+         *
+         * stops the thread from being scheduled
+         */
+        void stop_thread();
+
+        /**
+         * @param: UIScreen* new_screen -> the screen to show, NULL to stop updating the lcd
+         * @return: None
+         *
+         * the screen is loaded on the next frame, even if it is already
+         * shown, it has to outlive the ui thread using it so use a static
+         * or heap allocated screen
+         */
+        void set_screen(UIScreen* new_screen);
+
+        /**
+         * @param: int timeout -> ms to wait for the current frame to finish
+         * @return: bool -> true if the ui thread is not using lvgl anymore
+         *
+         * stops updating the lcd and waits until the ui thread has finished
+         * its frame, call before anything else uses lvgl, like the
+         * autonomous selector when the robot is disabled
+         */
+        bool clear_screen(int timeout=UI_CLEAR_TIMEOUT);
+
+        /**
+         * @param: int period -> ms between frames
+         * @return: None
+         */
+        void set_frame_period(int period);
+
+        /**
+         * @return: ui_frame_stats -> how long frames have taken
+         */
+        ui_frame_stats get_frame_stats();
+
+        /**
+         * @return: std::string -> "frames,average us,max us,overruns,period ms"
+         */
+        std::string get_report();
+};
+
+
+
+#endif
@@ -15,24 +15,36 @@
 #include "gui.hpp"
 #include "../../Autons.hpp"
 #include "../motors/MotorThread.hpp"
+#include "../serial/Logger.hpp"
 #include "../../DriverControl.hpp"
+#include "ScreenManager.hpp"
 #include "TemporaryScreen.hpp"
 
 
 /**
  * iterates through selecting for user to go through stages selecting an auton or the debugger
  * and then all the config options
- * loads all screens at start so there are no mem management issues
+ * only the selection screen is made at the start, the options screen is
+ * made the first time it is needed
  * finishes when all options are chosen
  */
 int chooseAuton()
 {
     Autons auton_data;
     
-    //init screens so that loading time is faster
     SelectionScreen scr1;
-    OptionsScreen scr2;
-    PrepScreen scr3;
+    ScreenManager screens;
+
+    // time is ms since boot so this is how long it took to get to the first screen
+    Logger logger;
+    log_entry entry;
+    entry.content = (
+        "[INFO] " + std::string("GUI First Screen")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Free_Heap: " + std::to_string(ScreenManager::get_free_heap())
+    );
+    entry.stream = "clog";
+    logger.add(entry);
 
     int finalAutonChoice = 0;
     int auton = 1;
@@ -41,20 +53,26 @@ int chooseAuton()
 
     while ( !(finalAutonChoice) ) //allows user to go to previous screen
     {
-        scr2.back = false;
-
         auton = scr1.selectAuton( auton ); //get auton option
 
         if ( auton == auton_data.driver_control_num ) {  //if prog with no auton is selected
-            finalAutonChoice = 1;
+            OptionsScreen* scr2 = screens.get<OptionsScreen>(2, "Options");
+            scr2->back = false;
+            Autons::options = scr2->getOptions( auton );  //lets driver control be recorded
+            if ( !(scr2->back) ) {
+                finalAutonChoice = 1;
+            }
         } else if ( auton == auton_data.debug_auton_num ) {  //if debugger is selected
             //starts driver control for debugging purposes
             MotorThread* motor_thread = MotorThread::get_instance();
             Motors::register_motors();
             motor_thread->start_thread();
             
+            static driver_control_args debug_control;
+            debug_control.stop = false;
+            debug_control.finished = false;
             pros::Task driver_control_task (driver_control,
-                                           (void*)NULL,
+                                           (void*)&debug_control,
                                            TASK_PRIORITY_DEFAULT,
                                            TASK_STACK_DEPTH_DEFAULT,
                                            "DriverControlTask");
@@ -63,7 +81,10 @@ int chooseAuton()
 
             //ends driver control because it should not be enabled when
             //auton is being selected
-            driver_control_task.remove();
+            debug_control.stop = true;
+            while(!debug_control.finished) {
+                pros::delay(5);
+            }
             
             Motors::unregister_motors();
             motor_thread->stop_thread();
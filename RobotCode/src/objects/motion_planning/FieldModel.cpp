@@ -0,0 +1,185 @@
+/**
+ * @file: ./RobotCode/src/objects/motion_planning/FieldModel.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: FieldModel.hpp
+ *
+ * contains implementation for the field occupancy grid and distance field
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "FieldModel.hpp"
+
+
+
+FieldModel::FieldModel()
+{
+    num_obstacles = 0;
+    inflation = 0;
+    distance_field.resize(FIELD_CELLS * FIELD_CELLS, 0);
+
+    double positions[3] = {FIELD_TOWER_INSET, FIELD_WIDTH / 2.0, FIELD_WIDTH - FIELD_TOWER_INSET};
+    for(double x : positions) {
+        for(double y : positions) {
+            add_obstacle(x, y, FIELD_TOWER_RADIUS);
+        }
+    }
+
+    build(0);
+}
+
+
+
+bool FieldModel::add_obstacle(double x, double y, double radius)
+{
+    if(num_obstacles >= FIELD_MAX_OBSTACLES) {
+        return false;
+    }
+
+    obstacles[num_obstacles] = {x, y, radius};
+    num_obstacles += 1;
+    return true;
+}
+
+
+
+void FieldModel::clear_obstacles()
+{
+    num_obstacles = 0;
+}
+
+
+
+/**
+ * every obstacle is a circle or a wall so the exact distance from each
+ * cell can be found directly instead of with a distance transform
+ */
+void FieldModel::build(double robot_radius)
+{
+    inflation = robot_radius;
+
+    for(int cell = 0; cell < FIELD_CELLS * FIELD_CELLS; cell++) {
+        double x = cell_x(cell);
+        double y = cell_y(cell);
+
+        double distance = std::min(std::min(x, y), std::min(FIELD_WIDTH - x, FIELD_WIDTH - y));
+        for(int i = 0; i < num_obstacles; i++) {
+            double to_edge = std::hypot(x - obstacles[i].x, y - obstacles[i].y) - obstacles[i].radius;
+            distance = std::min(distance, to_edge);
+        }
+
+        distance_field.at(cell) = std::max(distance, 0.0);
+    }
+}
+
+
+
+double FieldModel::get_distance(double x, double y) const
+{
+    int cell = to_cell(x, y);
+    return cell == -1 ? 0 : distance_field[cell];
+}
+
+
+
+double FieldModel::get_distance(int cell) const
+{
+    return distance_field.at(cell);
+}
+
+
+
+bool FieldModel::is_free(double x, double y) const
+{
+    int cell = to_cell(x, y);
+    return cell != -1 && distance_field[cell] >= inflation;
+}
+
+
+
+bool FieldModel::is_free(int cell) const
+{
+    return distance_field.at(cell) >= inflation;
+}
+
+
+
+bool FieldModel::line_is_free(double x0, double y0, double x1, double y1) const
+{
+    double length = std::hypot(x1 - x0, y1 - y0);
+    double direction_x = length > 0 ? (x1 - x0) / length : 0;
+    double direction_y = length > 0 ? (y1 - y0) / length : 0;
+    double cell_error = FIELD_RESOLUTION * M_SQRT1_2;  // farthest a point can be from the center of its cell
+
+    double s = 0;
+    while(true) {
+        double x = x0 + (s * direction_x);
+        double y = y0 + (s * direction_y);
+        int cell = to_cell(x, y);
+        if(cell == -1 || distance_field[cell] < inflation) {
+            return false;
+        }
+        if(s >= length) {
+            return true;
+        }
+
+        // distance along the line to the next cell so that no cell is skipped
+        double to_next_cell = std::numeric_limits<double>::max();
+        int column = cell % FIELD_CELLS;
+        int row = cell / FIELD_CELLS;
+        if(direction_x > 0) {
+            to_next_cell = std::min(to_next_cell, (((column + 1) * FIELD_RESOLUTION) - x) / direction_x);
+        } else if(direction_x < 0) {
+            to_next_cell = std::min(to_next_cell, ((column * FIELD_RESOLUTION) - x) / direction_x);
+        }
+        if(direction_y > 0) {
+            to_next_cell = std::min(to_next_cell, (((row + 1) * FIELD_RESOLUTION) - y) / direction_y);
+        } else if(direction_y < 0) {
+            to_next_cell = std::min(to_next_cell, ((row * FIELD_RESOLUTION) - y) / direction_y);
+        }
+
+        // nothing is closer than the clearance so it is safe to skip ahead by it
+        double clearance = distance_field[cell] - inflation - cell_error;
+        s = std::min(length, s + std::max(clearance, to_next_cell + 1e-6));
+    }
+}
+
+
+
+double FieldModel::get_inflation() const
+{
+    return inflation;
+}
+
+
+
+int FieldModel::to_cell(double x, double y)
+{
+    if(x < 0 || y < 0 || x >= FIELD_WIDTH || y >= FIELD_WIDTH) {
+        return -1;
+    }
+
+    int column = x / FIELD_RESOLUTION;
+    int row = y / FIELD_RESOLUTION;
+    return (row * FIELD_CELLS) + column;
+}
+
+
+
+double FieldModel::cell_x(int cell)
+{
+    return ((cell % FIELD_CELLS) + 0.5) * FIELD_RESOLUTION;
+}
+
+
+
+double FieldModel::cell_y(int cell)
+{
+    return ((cell / FIELD_CELLS) + 0.5) * FIELD_RESOLUTION;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file: ./RobotCode/src/objects/motion_planning/FieldModel.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a model of the field as an occupancy grid with a distance field
+ * so that paths can be planned around the towers instead of through them
+ *
+ * coordinates are in inches with the origin in a corner of the field and
+ * the walls along +x and +y, PositionTracker::set_field_origin gives where
+ * the tracked position is in this frame
+ */
+
+#ifndef __FIELDMODEL_HPP__
+#define __FIELDMODEL_HPP__
+
+#include <vector>
+
+
+
+#define FIELD_WIDTH 144  // in, the field is square
+#define FIELD_RESOLUTION 2  // in per grid cell
+#define FIELD_CELLS (FIELD_WIDTH / FIELD_RESOLUTION)  // cells per side
+#define FIELD_MAX_OBSTACLES 32
+
+#define FIELD_TOWER_RADIUS 7.5  // in
+#define FIELD_TOWER_INSET 6  // in from the walls to the center of the edge and corner towers
+
+
+typedef struct {
+    double x;
+    double y;
+    double radius;
+} field_obstacle;
+
+
+
+/**
+ * obstacles are circles, which is what the towers are, and the walls are
+ * always obstacles
+ * build has to be called after the obstacles change, it finds the distance
+ * from each cell to the closest obstacle so that a cell is free when the
+ * robot's footprint fits there
+ */
+class FieldModel
+{
+    private:
+        field_obstacle obstacles[FIELD_MAX_OBSTACLES];
+        int num_obstacles;
+        std::vector<float> distance_field;  // in from the center of each cell to the closest obstacle or wall
+        double inflation;
+
+    public:
+        /**
+         * starts with the nine towers of the field
+         */
+        FieldModel();
+
+        /**
+         * @param: double x -> the x position of the center of the obstacle in inches
+         * @param: double y -> the y position of the center of the obstacle in inches
+         * @param: double radius -> the radius of the obstacle in inches
+         * @return: bool -> false if there are already FIELD_MAX_OBSTACLES obstacles
+         */
+        bool add_obstacle(double x, double y, double radius);
+        void clear_obstacles();
+
+        /**
+         * @param: double robot_radius -> the radius in inches that has to be clear for the robot to be somewhere
+         * @return: None
+         *
+         * computes the distance field, cells closer than robot_radius to an
+         * obstacle or wall are blocked
+         */
+        void build(double robot_radius);
+
+        /**
+         * @param: double x -> the x position in inches
+         * @param: double y -> the y position in inches
+         * @return: double -> the distance in inches to the closest obstacle or wall, 0 off the field
+         */
+        double get_distance(double x, double y) const;
+        double get_distance(int cell) const;
+
+        bool is_free(double x, double y) const;
+        bool is_free(int cell) const;
+
+        /**
+         * @param: double x0 -> the x position of the start of the line
+         * @param: double y0 -> the y position of the start of the line
+         * @param: double x1 -> the x position of the end of the line
+         * @param: double y1 -> the y position of the end of the line
+         * @return: bool -> true if every cell the line passes through is free
+         *
+         * steps along the line by how far the closest obstacle is, so lines
+         * through open space only take a few steps, and goes cell by cell
+         * once it gets close to one
+         */
+        bool line_is_free(double x0, double y0, double x1, double y1) const;
+
+        double get_inflation() const;
+
+        /**
+         * @param: double x -> the x position in inches
+         * @param: double y -> the y position in inches
+         * @return: int -> the index of the cell containing the point, -1 off the field
+         */
+        static int to_cell(double x, double y);
+        static double cell_x(int cell);  // center of the cell in inches
+        static double cell_y(int cell);
+};
+
+
+
+#endif
@@ -0,0 +1,344 @@
+/**
+ * @file: ./RobotCode/src/objects/motion_planning/PathPlanner.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: PathPlanner.hpp
+ *
+ * contains implementation for planning paths around field obstacles
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "FieldModel.hpp"
+#include "PathPlanner.hpp"
+#include "Trajectory.hpp"
+
+
+
+#define CELL_NEW 0
+#define CELL_OPEN 1
+#define CELL_CLOSED 2
+
+
+PathPlanner::PathPlanner(const FieldModel& field_model)
+{
+    field = &field_model;
+    nodes_expanded = 0;
+    start_cell = -1;
+    goal_cell = -1;
+    start_x = 0;
+    start_y = 0;
+    goal_x = 0;
+    goal_y = 0;
+
+    cost.resize(FIELD_CELLS * FIELD_CELLS);
+    parent.resize(FIELD_CELLS * FIELD_CELLS);
+    state.resize(FIELD_CELLS * FIELD_CELLS);
+    open.reserve(FIELD_CELLS * FIELD_CELLS);
+}
+
+
+
+double PathPlanner::node_x(int cell) const
+{
+    if(cell == start_cell) {
+        return start_x;
+    } else if(cell == goal_cell) {
+        return goal_x;
+    }
+
+    return FieldModel::cell_x(cell);
+}
+
+
+
+double PathPlanner::node_y(int cell) const
+{
+    if(cell == start_cell) {
+        return start_y;
+    } else if(cell == goal_cell) {
+        return goal_y;
+    }
+
+    return FieldModel::cell_y(cell);
+}
+
+
+
+double PathPlanner::node_distance(int a, int b) const
+{
+    return std::hypot(node_x(a) - node_x(b), node_y(a) - node_y(b));
+}
+
+
+
+bool PathPlanner::line_of_sight(int a, int b) const
+{
+    return field->line_is_free(node_x(a), node_y(a), node_x(b), node_y(b));
+}
+
+
+
+// the free cell closest to a blocked one, searched in growing squares
+// until the square is farther away than the closest free cell found
+int PathPlanner::nearest_free(int cell) const
+{
+    if(field->is_free(cell)) {
+        return cell;
+    }
+
+    int row = cell / FIELD_CELLS;
+    int column = cell % FIELD_CELLS;
+    int closest = -1;
+    int closest_distance = INT32_MAX;  // squared, in cells
+    for(int ring = 1; ring < FIELD_CELLS && ring * ring < closest_distance; ring++) {
+        for(int dy = -ring; dy <= ring; dy++) {
+            int step = (dy == -ring || dy == ring) ? 1 : 2 * ring;  // only the edge of the square
+            for(int dx = -ring; dx <= ring; dx += step) {
+                int r = row + dy;
+                int c = column + dx;
+                int i = (r * FIELD_CELLS) + c;
+                if(r < 0 || c < 0 || r >= FIELD_CELLS || c >= FIELD_CELLS || !field->is_free(i)) {
+                    continue;
+                }
+                if((dx * dx) + (dy * dy) < closest_distance) {
+                    closest = i;
+                    closest_distance = (dx * dx) + (dy * dy);
+                }
+            }
+        }
+    }
+
+    return closest;
+}
+
+
+
+// removes waypoints that can be skipped by driving straight to a later one
+void PathPlanner::smooth(std::vector<spline_point>& waypoints) const
+{
+    std::vector<spline_point> smoothed = {waypoints.front()};
+
+    int i = 0;
+    int last = waypoints.size() - 1;
+    while(i < last) {
+        int j = last;
+        while(j > i + 1 && !field->line_is_free(waypoints.at(i).x, waypoints.at(i).y, waypoints.at(j).x, waypoints.at(j).y)) {
+            j -= 1;
+        }
+        smoothed.push_back(waypoints.at(j));
+        i = j;
+    }
+
+    waypoints = smoothed;
+}
+
+
+
+bool PathPlanner::plan(double x0, double y0, double x1, double y1, std::vector<spline_point>& waypoints)
+{
+    waypoints.clear();
+    nodes_expanded = 0;
+
+    // a blocked start or goal is replaced by the closest free cell, which
+    // is then planned from its center
+    int first = FieldModel::to_cell(x0, y0);
+    int last = FieldModel::to_cell(x1, y1);
+    int start = first == -1 ? -1 : nearest_free(first);
+    int goal = last == -1 ? -1 : nearest_free(last);
+    if(start == -1 || goal == -1) {
+        return false;
+    }
+    start_cell = start == first ? start : -1;
+    goal_cell = goal == last ? goal : -1;
+    start_x = x0;
+    start_y = y0;
+    goal_x = x1;
+    goal_y = y1;
+
+    std::fill(cost.begin(), cost.end(), std::numeric_limits<float>::max());
+    std::fill(parent.begin(), parent.end(), -1);
+    std::fill(state.begin(), state.end(), CELL_NEW);
+    open.clear();
+
+    cost.at(start) = 0;
+    parent.at(start) = start;
+    state.at(start) = CELL_OPEN;
+    open.push_back({node_distance(start, goal), start});
+
+    std::greater<std::pair<float, int>> compare;  // makes the heap smallest first
+    while(!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), compare);
+        int cell = open.back().second;
+        open.pop_back();
+
+        if(state.at(cell) == CELL_CLOSED) {  // older entry for a cell that was reached more cheaply
+            continue;
+        }
+        state.at(cell) = CELL_CLOSED;
+        nodes_expanded += 1;
+
+        int row = cell / FIELD_CELLS;
+        int column = cell % FIELD_CELLS;
+
+        // the cell was assumed to see the parent of the cell it was reached
+        // from, if it does not then connect it to the best expanded neighbor
+        // that it can see, a diagonal can clip the corner of a blocked cell
+        // so any neighbor is used if none can be seen
+        if(!line_of_sight(parent.at(cell), cell)) {
+            float best_cost = std::numeric_limits<float>::max();
+            bool best_visible = false;
+            for(int dy = -1; dy <= 1; dy++) {
+                for(int dx = -1; dx <= 1; dx++) {
+                    int r = row + dy;
+                    int c = column + dx;
+                    int neighbor = (r * FIELD_CELLS) + c;
+                    if(r < 0 || c < 0 || r >= FIELD_CELLS || c >= FIELD_CELLS || neighbor == cell || state.at(neighbor) != CELL_CLOSED) {
+                        continue;
+                    }
+                    float new_cost = cost.at(neighbor) + node_distance(neighbor, cell);
+                    bool visible = line_of_sight(neighbor, cell);
+                    if((visible && !best_visible) || (visible == best_visible && new_cost < best_cost)) {
+                        best_cost = new_cost;
+                        best_visible = visible;
+                        parent.at(cell) = neighbor;
+                    }
+                }
+            }
+            cost.at(cell) = best_cost;
+        }
+
+        if(cell == goal) {
+            break;
+        }
+
+        for(int dy = -1; dy <= 1; dy++) {
+            for(int dx = -1; dx <= 1; dx++) {
+                int r = row + dy;
+                int c = column + dx;
+                int neighbor = (r * FIELD_CELLS) + c;
+                if(r < 0 || c < 0 || r >= FIELD_CELLS || c >= FIELD_CELLS || neighbor == cell) {
+                    continue;
+                } else if(state.at(neighbor) == CELL_CLOSED || !field->is_free(neighbor)) {
+                    continue;
+                }
+
+                int from = parent.at(cell);
+                float new_cost = cost.at(from) + node_distance(from, neighbor);
+                if(new_cost < cost.at(neighbor)) {
+                    cost.at(neighbor) = new_cost;
+                    parent.at(neighbor) = from;
+                    state.at(neighbor) = CELL_OPEN;
+                    open.push_back({new_cost + node_distance(neighbor, goal), neighbor});
+                    std::push_heap(open.begin(), open.end(), compare);
+                }
+            }
+        }
+    }
+
+    if(state.at(goal) != CELL_CLOSED) {
+        return false;
+    }
+
+    std::vector<int> cells;
+    for(int cell = goal; cell != start; cell = parent.at(cell)) {
+        cells.push_back(cell);
+    }
+    cells.push_back(start);
+    std::reverse(cells.begin(), cells.end());
+
+    spline_point point;
+    if(start_cell == -1) {  // straight out of the blocked start to the free cell
+        point.x = start_x;
+        point.y = start_y;
+        waypoints.push_back(point);
+    }
+    for(int cell : cells) {
+        point.x = node_x(cell);
+        point.y = node_y(cell);
+        waypoints.push_back(point);
+    }
+    if(goal_cell == -1) {
+        point.x = goal_x;
+        point.y = goal_y;
+        waypoints.push_back(point);
+    }
+    if(waypoints.size() == 1) {  // the start and goal are in the same cell
+        waypoints.push_back(waypoints.front());
+        waypoints.back().x = goal_x;
+        waypoints.back().y = goal_y;
+    }
+
+    smooth(waypoints);
+
+    return true;
+}
+
+
+
+bool PathPlanner::plan_trajectory(double x0, double y0, double x1, double y1, trajectory_constraints constraints, Trajectory& trajectory)
+{
+    std::vector<spline_point> waypoints;
+    if(!plan(x0, y0, x1, y1, waypoints)) {
+        return false;
+    }
+
+    // a blocked start or goal is left in a straight line so samples that
+    // close to them are allowed to be blocked too, and so is the first or
+    // last step when it clips the corner of a blocked cell next to them
+    const spline_point& second = waypoints.at(1);
+    const spline_point& second_last = waypoints.at(waypoints.size() - 2);
+    double start_escape = std::hypot(second.x - x0, second.y - y0);
+    double goal_escape = std::hypot(second_last.x - x1, second_last.y - y1);
+    bool start_clips = start_cell == -1 || !field->line_is_free(x0, y0, second.x, second.y);
+    bool goal_clips = goal_cell == -1 || !field->line_is_free(second_last.x, second_last.y, x1, y1);
+    start_escape = start_clips ? start_escape + FIELD_RESOLUTION : 0;
+    goal_escape = goal_clips ? goal_escape + FIELD_RESOLUTION : 0;
+
+    for(int pass = 0; pass <= PATH_PLANNER_SMOOTHING_PASSES; pass++) {
+        if(!trajectory.generate(waypoints, constraints)) {
+            return false;
+        }
+
+        bool clear = true;
+        const trajectory_sample* samples = trajectory.data();
+        for(int i = 0; i < trajectory.size() && clear; i++) {
+            clear = (
+                field->is_free(samples[i].x, samples[i].y)
+                || std::hypot(samples[i].x - x0, samples[i].y - y0) < start_escape
+                || std::hypot(samples[i].x - x1, samples[i].y - y1) < goal_escape
+            );
+        }
+        if(clear) {
+            return true;
+        }
+
+        // pull the spline closer to the straight lines between waypoints
+        std::vector<spline_point> subdivided = {waypoints.front()};
+        for(int i = 1; i < waypoints.size(); i++) {
+            spline_point midpoint;
+            midpoint.x = (waypoints.at(i - 1).x + waypoints.at(i).x) / 2;
+            midpoint.y = (waypoints.at(i - 1).y + waypoints.at(i).y) / 2;
+            subdivided.push_back(midpoint);
+            subdivided.push_back(waypoints.at(i));
+        }
+        waypoints = subdivided;
+    }
+
+    return false;
+}
+
+
+
+int PathPlanner::get_nodes_expanded() const
+{
+    return nodes_expanded;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file: ./RobotCode/src/objects/motion_planning/PathPlanner.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a planner that finds paths around obstacles in a FieldModel
+ * so they can be driven with Chassis::drive_to_point or turned into a
+ * Trajectory for Chassis::follow_trajectory, which is what
+ * Chassis::drive_to_point_planned does
+ */
+
+#ifndef __PATHPLANNER_HPP__
+#define __PATHPLANNER_HPP__
+
+#include <utility>
+#include <vector>
+
+#include "FieldModel.hpp"
+#include "Trajectory.hpp"
+
+
+
+#define PATH_PLANNER_SMOOTHING_PASSES 3  // times plan_trajectory adds waypoints to keep a trajectory off obstacles
+
+
+/**
+ * lazy theta*, which is a* that connects each cell to the parent of the
+ * cell it was reached from when there is a clear line to it, so paths are
+ * not stuck to the 45 degree angles of the grid
+ * the line is only checked when a cell is expanded instead of for every
+ * neighbor, which is most of the time spent planning
+ * the search buffers are allocated once so planning does not allocate
+ */
+class PathPlanner
+{
+    private:
+        const FieldModel* field;
+
+        std::vector<float> cost;  // in from the start, for each cell
+        std::vector<int> parent;
+        std::vector<unsigned char> state;
+        std::vector<std::pair<float, int>> open;  // heap of estimated total cost and cell
+        int nodes_expanded;
+
+        // the exact start and goal are used in place of the centers of their cells
+        int start_cell;
+        int goal_cell;
+        double start_x;
+        double start_y;
+        double goal_x;
+        double goal_y;
+
+        double node_x(int cell) const;
+        double node_y(int cell) const;
+        double node_distance(int a, int b) const;
+        bool line_of_sight(int a, int b) const;
+        int nearest_free(int cell) const;
+        void smooth(std::vector<spline_point>& waypoints) const;
+
+    public:
+        explicit PathPlanner(const FieldModel& field_model);
+
+        /**
+         * @param: double start_x -> the x position to start from in inches
+         * @param: double start_y -> the y position to start from in inches
+         * @param: double goal_x -> the x position to get to in inches
+         * @param: double goal_y -> the y position to get to in inches
+         * @param: std::vector<spline_point>& waypoints -> filled with the path, including the start and goal
+         * @return: bool -> false if there is no path
+         *
+         * a start or goal that is too close to an obstacle, such as against
+         * a wall or scoring in a tower, is connected to the closest free cell
+         * with a straight line
+         * the step from the start or to the goal and the center of the cell
+         * next to it can clip the corner of a blocked cell
+         * waypoints that can be skipped with a clear line are removed
+         */
+        bool plan(double start_x, double start_y, double goal_x, double goal_y, std::vector<spline_point>& waypoints);
+
+        /**
+         * @param: double start_x -> the x position to start from in inches
+         * @param: double start_y -> the y position to start from in inches
+         * @param: double goal_x -> the x position to get to in inches
+         * @param: double goal_y -> the y position to get to in inches
+         * @param: trajectory_constraints constraints -> the limits of the trajectory
+         * @param: Trajectory& trajectory -> the trajectory to generate
+         * @return: bool -> false if there is no path or the trajectory could not be kept off obstacles
+         *
+         * plans a path and fits a trajectory to it, splines can bulge out
+         * between waypoints so waypoints are added halfway along each segment
+         * until every sample is free
+         */
+        bool plan_trajectory(double start_x, double start_y, double goal_x, double goal_y, trajectory_constraints constraints, Trajectory& trajectory);
+
+        /**
+         * @return: int -> the number of cells expanded by the last plan
+         */
+        int get_nodes_expanded() const;
+};
+
+
+
+#endif
@@ -0,0 +1,332 @@
+/**
+ * @file: ./RobotCode/src/objects/motion_planning/Trajectory.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: Trajectory.hpp
+ *
+ * contains implementation for generating and sampling spline trajectories
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+#include "../serial/Logger.hpp"
+#include "Trajectory.hpp"
+
+
+
+// polynomial coefficients of one quintic hermite segment, t goes from 0 to 1
+typedef struct {
+    double x[6];
+    double y[6];
+} hermite_segment;
+
+typedef struct {
+    double s;  // arc length from the start of the path
+    int segment;
+    double t;
+} arc_length_entry;
+
+
+
+static void fit_axis(double p0, double v0, double a0, double p1, double v1, double a1, double* c)
+{
+    c[0] = p0;
+    c[1] = v0;
+    c[2] = a0 / 2;
+    c[3] = (-10 * p0) - (6 * v0) - (1.5 * a0) + (0.5 * a1) - (4 * v1) + (10 * p1);
+    c[4] = (15 * p0) + (8 * v0) + (1.5 * a0) - a1 + (7 * v1) - (15 * p1);
+    c[5] = (-6 * p0) - (3 * v0) - (0.5 * a0) + (0.5 * a1) - (3 * v1) + (6 * p1);
+}
+
+
+
+// fills in the value and first two derivatives of a quintic at t
+static void evaluate_axis(const double* c, double t, double& p, double& d1, double& d2)
+{
+    p = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+    d1 = c[1] + t * (2 * c[2] + t * (3 * c[3] + t * (4 * c[4] + t * 5 * c[5])));
+    d2 = 2 * c[2] + t * (6 * c[3] + t * (12 * c[4] + t * 20 * c[5]));
+}
+
+
+
+static double wrap_angle(double theta)
+{
+    while(theta > M_PI) {
+        theta -= 2 * M_PI;
+    }
+    while(theta < -M_PI) {
+        theta += 2 * M_PI;
+    }
+
+    return theta;
+}
+
+
+
+Trajectory::Trajectory()
+{
+    length = 0;
+}
+
+
+
+/**
+ * tangents come from the neighbouring waypoints like a catmull-rom spline
+ * and second derivatives are the average of what a cubic spline would have
+ * on either side so curvature does not jump much at waypoints
+ */
+bool Trajectory::generate(const std::vector<spline_point>& points, trajectory_constraints constraints)
+{
+    samples.clear();
+    length = 0;
+
+    std::vector<spline_point> path;
+    for(const spline_point& point : points) {  // repeated points make segments with no tangent
+        if(path.empty() || std::hypot(point.x - path.back().x, point.y - path.back().y) > 1e-6) {
+            path.push_back(point);
+        }
+    }
+
+    bool valid = (
+        path.size() >= 2
+        && constraints.max_velocity > 0
+        && constraints.max_acceleration > 0
+        && constraints.max_centripetal_acceleration > 0
+        && constraints.spacing > 0
+    );
+
+    // tangents and second derivatives at each waypoint
+    int n = path.size();
+    std::vector<double> vx(n), vy(n), ax(n), ay(n);
+    for(int i = 0; valid && i < n; i++) {
+        const spline_point& previous = path.at(std::max(i - 1, 0));
+        const spline_point& next = path.at(std::min(i + 1, n - 1));
+        double scale = (i == 0 || i == n - 1) ? 1 : 0.5;
+        vx.at(i) = scale * (next.x - previous.x);
+        vy.at(i) = scale * (next.y - previous.y);
+
+        if(path.at(i).fixed_heading) {  // theta of 0 faces +y and increases clockwise
+            double magnitude = std::hypot(vx.at(i), vy.at(i));
+            int direction = constraints.reversed ? -1 : 1;
+            vx.at(i) = direction * magnitude * std::sin(path.at(i).theta);
+            vy.at(i) = direction * magnitude * std::cos(path.at(i).theta);
+        }
+    }
+    for(int i = 0; valid && i < n; i++) {
+        double sum_x = 0;
+        double sum_y = 0;
+        int count = 0;
+        if(i > 0) {  // end of the cubic segment before
+            sum_x += (-6 * (path.at(i).x - path.at(i - 1).x)) + (2 * vx.at(i - 1)) + (4 * vx.at(i));
+            sum_y += (-6 * (path.at(i).y - path.at(i - 1).y)) + (2 * vy.at(i - 1)) + (4 * vy.at(i));
+            count += 1;
+        }
+        if(i < n - 1) {  // start of the cubic segment after
+            sum_x += (6 * (path.at(i + 1).x - path.at(i).x)) - (4 * vx.at(i)) - (2 * vx.at(i + 1));
+            sum_y += (6 * (path.at(i + 1).y - path.at(i).y)) - (4 * vy.at(i)) - (2 * vy.at(i + 1));
+            count += 1;
+        }
+        ax.at(i) = sum_x / count;
+        ay.at(i) = sum_y / count;
+    }
+
+    std::vector<hermite_segment> segments(valid ? n - 1 : 0);
+    for(int i = 0; i < segments.size(); i++) {
+        fit_axis(path.at(i).x, vx.at(i), ax.at(i), path.at(i + 1).x, vx.at(i + 1), ax.at(i + 1), segments.at(i).x);
+        fit_axis(path.at(i).y, vy.at(i), ay.at(i), path.at(i + 1).y, vy.at(i + 1), ay.at(i + 1), segments.at(i).y);
+    }
+
+    // arc length lookup table so samples can be spaced evenly by distance
+    std::vector<arc_length_entry> table;
+    table.reserve(segments.size() * TRAJECTORY_LUT_SIZE + 1);
+    table.push_back({0, 0, 0});
+    double previous_x = valid ? path.front().x : 0;
+    double previous_y = valid ? path.front().y : 0;
+    for(int i = 0; i < segments.size(); i++) {
+        for(int j = 1; j <= TRAJECTORY_LUT_SIZE; j++) {
+            double t = static_cast<double>(j) / TRAJECTORY_LUT_SIZE;
+            double x, y, unused1, unused2;
+            evaluate_axis(segments.at(i).x, t, x, unused1, unused2);
+            evaluate_axis(segments.at(i).y, t, y, unused1, unused2);
+            table.push_back({table.back().s + std::hypot(x - previous_x, y - previous_y), i, t});
+            previous_x = x;
+            previous_y = y;
+        }
+    }
+    length = table.back().s;
+
+    int num_samples = valid ? std::ceil(length / constraints.spacing) + 1 : 0;
+    if(!valid || num_samples > TRAJECTORY_MAX_SAMPLES) {
+        length = 0;
+
+        Logger logger;
+        log_entry entry;
+        entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", could not generate trajectory through " + std::to_string(points.size()) + " points";
+        entry.stream = "cerr";
+        logger.add(entry);
+        return false;
+    }
+
+    // sample the spline evenly and find the velocity limit at each sample
+    samples.resize(num_samples);
+    std::vector<double> distances(num_samples);
+    std::vector<double> velocities(num_samples);
+    int cursor = 1;
+    for(int i = 0; i < num_samples; i++) {
+        double s = std::min(i * constraints.spacing, length);
+        while(cursor < table.size() - 1 && table.at(cursor).s < s) {
+            cursor += 1;
+        }
+
+        const arc_length_entry& before = table.at(cursor - 1);
+        const arc_length_entry& after = table.at(cursor);
+        double t_before = before.segment == after.segment ? before.t : 0;
+        double fraction = after.s > before.s ? (s - before.s) / (after.s - before.s) : 0;
+        double t = t_before + (fraction * (after.t - t_before));
+
+        double x, dx, ddx, y, dy, ddy;
+        evaluate_axis(segments.at(after.segment).x, t, x, dx, ddx);
+        evaluate_axis(segments.at(after.segment).y, t, y, dy, ddy);
+        double curvature = ((dx * ddy) - (dy * ddx)) / std::pow(std::hypot(dx, dy), 3);
+        double theta = (M_PI / 2) - std::atan2(dy, dx);
+
+        double max_velocity = constraints.max_velocity;
+        if(std::abs(curvature) > 1e-9) {
+            max_velocity = std::min(max_velocity, std::sqrt(constraints.max_centripetal_acceleration / std::abs(curvature)));
+            max_velocity = std::min(max_velocity, constraints.max_velocity / (1 + (std::abs(curvature) * constraints.track_width / 2)));
+        }
+
+        trajectory_sample& sample = samples.at(i);
+        sample.x = x;
+        sample.y = y;
+        sample.theta = wrap_angle(constraints.reversed ? theta + M_PI : theta);
+        sample.curvature = constraints.reversed ? -curvature : curvature;  // so velocity * curvature is still the yaw rate
+        distances.at(i) = s;
+        velocities.at(i) = max_velocity;
+    }
+
+    // forward pass limits acceleration, backward pass limits decceleration
+    double a = constraints.max_acceleration;
+    velocities.front() = std::min(velocities.front(), constraints.start_velocity);
+    for(int i = 1; i < num_samples; i++) {
+        double ds = distances.at(i) - distances.at(i - 1);
+        velocities.at(i) = std::min(velocities.at(i), std::sqrt((velocities.at(i - 1) * velocities.at(i - 1)) + (2 * a * ds)));
+    }
+    velocities.back() = std::min(velocities.back(), constraints.end_velocity);
+    for(int i = num_samples - 2; i >= 0; i--) {
+        double ds = distances.at(i + 1) - distances.at(i);
+        velocities.at(i) = std::min(velocities.at(i), std::sqrt((velocities.at(i + 1) * velocities.at(i + 1)) + (2 * a * ds)));
+    }
+
+    // constant acceleration between samples gives the time between them
+    double time = 0;
+    for(int i = 0; i < num_samples; i++) {
+        if(i > 0) {
+            double ds = distances.at(i) - distances.at(i - 1);
+            double v = velocities.at(i - 1) + velocities.at(i);
+            time += v > 1e-9 ? (2 * ds) / v : 2 * std::sqrt(ds / a);
+        }
+        samples.at(i).velocity = constraints.reversed ? -velocities.at(i) : velocities.at(i);
+        samples.at(i).time = time;
+    }
+
+    return true;
+}
+
+
+
+trajectory_sample Trajectory::sample(double t) const
+{
+    if(samples.empty()) {
+        return {0, 0, 0, 0, 0, 0};
+    } else if(t <= 0) {
+        return samples.front();
+    } else if(t >= samples.back().time) {
+        return samples.back();
+    }
+
+    auto later = std::upper_bound(samples.begin(), samples.end(), t, [](double time, const trajectory_sample& sample) {
+        return time < sample.time;
+    });
+    const trajectory_sample& s1 = *later;
+    const trajectory_sample& s0 = *(later - 1);
+
+    double dt = s1.time - s0.time;
+    double tau = t - s0.time;
+    double average_velocity = (s0.velocity + s1.velocity) / 2;
+    double fraction;
+    if(std::abs(average_velocity) > 1e-9) {  // distance covered so far over the distance between the samples
+        double acceleration = (s1.velocity - s0.velocity) / dt;
+        fraction = ((s0.velocity * tau) + (0.5 * acceleration * tau * tau)) / (average_velocity * dt);
+    } else {
+        fraction = tau / dt;
+    }
+
+    trajectory_sample point;
+    point.x = s0.x + (fraction * (s1.x - s0.x));
+    point.y = s0.y + (fraction * (s1.y - s0.y));
+    point.theta = wrap_angle(s0.theta + (fraction * wrap_angle(s1.theta - s0.theta)));
+    point.curvature = s0.curvature + (fraction * (s1.curvature - s0.curvature));
+    point.velocity = s0.velocity + ((tau / dt) * (s1.velocity - s0.velocity));
+    point.time = t;
+
+    return point;
+}
+
+
+
+void Trajectory::transform(double x, double y, double theta)
+{
+    double cos_theta = std::cos(theta);
+    double sin_theta = std::sin(theta);
+    for(trajectory_sample& point : samples) {
+        double point_x = point.x;
+        double point_y = point.y;
+        point.x = x + point_x * cos_theta + point_y * sin_theta;
+        point.y = y - point_x * sin_theta + point_y * cos_theta;
+        point.theta = wrap_angle(point.theta + theta);
+    }
+}
+
+
+
+double Trajectory::get_duration() const
+{
+    return samples.empty() ? 0 : samples.back().time;
+}
+
+
+
+double Trajectory::get_length() const
+{
+    return length;
+}
+
+
+
+int Trajectory::size() const
+{
+    return samples.size();
+}
+
+
+
+const trajectory_sample* Trajectory::data() const
+{
+    return samples.data();
+}
+
+
+
+std::size_t Trajectory::get_memory_usage() const
+{
+    return samples.capacity() * sizeof(trajectory_sample);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file: ./RobotCode/src/objects/motion_planning/Trajectory.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a trajectory generator that fits quintic hermite splines through
+ * waypoints and gives them a time optimal velocity profile
+ * the result is an array of samples spaced evenly along the path that the
+ * chassis follows by time with Chassis::follow_trajectory
+ *
+ * units are the same as PositionTracker, inches and radians with a theta of
+ * 0 facing +y and increasing clockwise
+ */
+
+#ifndef __TRAJECTORY_HPP__
+#define __TRAJECTORY_HPP__
+
+#include <cstddef>
+#include <vector>
+
+
+
+#define TRAJECTORY_LUT_SIZE 32  // arc length table entries per spline segment
+#define TRAJECTORY_MAX_SAMPLES 4096  // about 100 ft of path at the default spacing
+
+
+typedef struct {
+    double x=0;
+    double y=0;
+    double theta=0;             // heading the path has to pass through, only used if fixed_heading is set
+    bool fixed_heading=false;   // otherwise the heading is picked from the waypoints on either side
+} spline_point;
+
+typedef struct {
+    double max_velocity=40;                  // in/s
+    double max_acceleration=60;              // in/s^2, also used for decceleration
+    double max_centripetal_acceleration=40;  // in/s^2, slows the robot down in tight curves
+    double track_width=0;                    // in, keeps the outside wheel under max velocity, 0 to ignore
+    double start_velocity=0;                 // in/s
+    double end_velocity=0;                   // in/s
+    double spacing=1;                        // in between samples
+    bool reversed=false;                     // drive the path backwards
+} trajectory_constraints;
+
+/**
+ * velocities are negative when the trajectory is reversed and theta is the
+ * heading of the robot, so it is flipped from the path when reversed
+ */
+typedef struct {
+    float x;
+    float y;
+    float theta;
+    float curvature;  // 1/in of the robot's motion, positive turns left
+    float velocity;   // in/s
+    float time;       // s from the start of the trajectory
+} trajectory_sample;
+
+
+
+/**
+ * a path with a velocity profile made ahead of time
+ * generating allocates so it should be done while disabled or before the
+ * trajectory is needed, sampling does not allocate
+ */
+class Trajectory
+{
+    private:
+        std::vector<trajectory_sample> samples;
+        double length;
+
+    public:
+        Trajectory();
+
+        /**
+         * @param: const std::vector<spline_point>& points -> the waypoints to pass through, at least two
+         * @param: trajectory_constraints constraints -> the limits of the velocity profile
+         * @return: bool -> false if there are not enough points, the constraints are not positive,
+         *                  or the path needs more than TRAJECTORY_MAX_SAMPLES samples
+         *
+         * fits a quintic hermite spline through the points, samples it evenly
+         * by arc length using a lookup table, and limits the velocity at each
+         * sample by max velocity, centripetal acceleration, and acceleration
+         * with a forward and backward pass
+         */
+        bool generate(const std::vector<spline_point>& points, trajectory_constraints constraints);
+
+        /**
+         * @param: double t -> the time in seconds since the start of the trajectory
+         * @return: trajectory_sample -> the setpoint at time t
+         *
+         * interpolates between samples assuming constant acceleration between them
+         * times past the end give the last sample
+         */
+        trajectory_sample sample(double t) const;
+
+        /**
+         * @param: double x -> the x position in the new frame of the origin of the current one
+         * @param: double y -> the y position in the new frame of the origin of the current one
+         * @param: double theta -> the angle in radians the current frame is turned clockwise in the new one
+         * @return: None
+         *
+         * moves the samples into another frame, such as from the field to
+         * the frame of PositionTracker, velocities and curvatures do not change
+         * and headings stay wrapped to [-pi, pi] like generate leaves them
+         */
+        void transform(double x, double y, double theta);
+
+        double get_duration() const;  // s
+        double get_length() const;  // in
+        int size() const;
+        const trajectory_sample* data() const;
+
+        /**
+         * @return: std::size_t -> bytes used by the samples
+         */
+        std::size_t get_memory_usage() const;
+};
+
+
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * @file: ./RobotCode/src/objects/motors/BatteryCompensator.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: BatteryCompensator.hpp
+ *
+ * contains implementation for scaling motor voltage commands to a nominal
+ * battery voltage
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+#include "BatteryCompensator.hpp"
+
+
+
+BatteryCompensator::BatteryCompensator()
+{
+    enabled = false;
+    filtered_voltage = 0;
+    scale = 1;
+    cycle_headroom = MOTOR_MAX_VOLTAGE;
+    cycle_saturated = 0;
+    reset_stats();
+}
+
+
+
+void BatteryCompensator::configure(battery_compensation_constants new_constants)
+{
+    constants = new_constants;
+}
+
+
+
+void BatteryCompensator::enable()
+{
+    enabled = true;
+}
+
+
+
+void BatteryCompensator::disable()
+{
+    enabled = false;
+}
+
+
+
+bool BatteryCompensator::is_enabled() const
+{
+    return enabled;
+}
+
+
+
+void BatteryCompensator::update(int battery_voltage, int delta_t)
+{
+    stats.headroom = cycle_headroom;
+    stats.min_headroom = std::min(stats.min_headroom, cycle_headroom);
+    stats.saturated_motors = cycle_saturated;
+    if(cycle_saturated > 0) {
+        stats.saturated_cycles += 1;
+    }
+    cycle_headroom = MOTOR_MAX_VOLTAGE;
+    cycle_saturated = 0;
+
+    if(battery_voltage > 0) {
+        if(filtered_voltage <= 0) {
+            filtered_voltage = battery_voltage;
+        } else {  // first order low pass
+            double alpha = static_cast<double>(std::max(delta_t, 0)) / (constants.time_constant + std::max(delta_t, 0));
+            filtered_voltage += alpha * (battery_voltage - filtered_voltage);
+        }
+    }
+
+    scale = 1;
+    if(enabled && filtered_voltage > 0) {
+        scale = std::max(constants.min_scale, std::min(constants.max_scale, constants.nominal_voltage / filtered_voltage));
+    }
+
+    stats.battery_voltage = filtered_voltage;
+    stats.scale = scale;
+}
+
+
+
+int BatteryCompensator::compensate(int voltage)
+{
+    int compensated = static_cast<int>(voltage * scale);
+    int headroom = MOTOR_MAX_VOLTAGE - std::abs(compensated);
+    cycle_headroom = std::min(cycle_headroom, headroom);
+
+    if(headroom < 0) {
+        cycle_saturated += 1;
+        compensated = compensated > 0 ? MOTOR_MAX_VOLTAGE : -MOTOR_MAX_VOLTAGE;
+    }
+
+    return compensated;
+}
+
+
+
+battery_compensation_stats BatteryCompensator::get_stats() const
+{
+    return stats;
+}
+
+
+
+void BatteryCompensator::reset_stats()
+{
+    stats = {filtered_voltage, scale, MOTOR_MAX_VOLTAGE, MOTOR_MAX_VOLTAGE, 0, 0};
+}
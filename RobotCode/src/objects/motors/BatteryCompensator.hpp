@@ -0,0 +1,95 @@
+/**
+ * @file: ./RobotCode/src/objects/motors/BatteryCompensator.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a correction for battery voltage so that a voltage command
+ * moves a motor the same on a full battery as on a low one
+ * the motors treat a command as a fraction of the battery voltage, so
+ * 11000 mv is about 11900 mv at the motor on a 13 V battery and about
+ * 11200 mv on a 12.2 V one
+ */
+
+#ifndef __BATTERYCOMPENSATOR_HPP__
+#define __BATTERYCOMPENSATOR_HPP__
+
+#include <cstdint>
+
+
+
+#define MOTOR_MAX_VOLTAGE 12000  // mv, largest command a motor accepts
+
+
+typedef struct {
+    int nominal_voltage=12000;  // mv the battery is treated as being at, commands are scaled to what they would do at this voltage
+    int time_constant=50;       // ms of the filter on the battery voltage
+    double min_scale=0.8;       // limits on the scale so a bad reading can not make the motors jump
+    double max_scale=1.25;
+} battery_compensation_constants;
+
+typedef struct {
+    double battery_voltage;  // mv, filtered
+    double scale;            // commands are multiplied by this, 1 when compensation is disabled
+    int headroom;            // mv the largest command of the last cycle could still be raised, negative when it was cut off
+    int min_headroom;        // mv, smallest headroom since the stats were reset
+    int saturated_motors;    // motors whose command was cut off in the last cycle
+    std::uint32_t saturated_cycles;  // cycles with a cut off command since the stats were reset
+} battery_compensation_stats;
+
+
+
+/**
+ * has no sensor of its own so that it can be run with simulated battery
+ * voltages, MotorThread reads the battery once per cycle and each motor
+ * passes its voltage command through compensate
+ * the battery sags by a few hundred mv when the drive accelerates, the
+ * filter keeps that from coupling back into the command in a single cycle
+ */
+class BatteryCompensator
+{
+    private:
+        battery_compensation_constants constants;
+        bool enabled;
+        double filtered_voltage;  // mv, 0 until the first reading
+        double scale;
+
+        int cycle_headroom;
+        int cycle_saturated;
+        battery_compensation_stats stats;
+
+    public:
+        BatteryCompensator();
+
+        void configure(battery_compensation_constants new_constants);
+
+        void enable();
+        void disable();
+        bool is_enabled() const;
+
+        /**
+         * @param: int battery_voltage -> the battery voltage in mv, readings of 0 or less are ignored
+         * @param: int delta_t -> ms since the last call
+         * @return: None
+         *
+         * filters the battery voltage and finds the scale for this cycle,
+         * also finishes the headroom of the last cycle
+         */
+        void update(int battery_voltage, int delta_t);
+
+        /**
+         * @param: int voltage -> the voltage command in mv on interval [-12000, 12000]
+         * @return: int -> the command to send to the motor
+         *
+         * scales the command to the nominal voltage, commands that would be
+         * larger than MOTOR_MAX_VOLTAGE are cut off and counted as saturated
+         */
+        int compensate(int voltage);
+
+        battery_compensation_stats get_stats() const;
+        void reset_stats();
+};
+
+
+
+#endif
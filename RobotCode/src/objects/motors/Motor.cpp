@@ -13,7 +13,12 @@
 #include "main.h"
 
 #include "../../Configuration.hpp"
+#include "../diagnostics/AllocationTracker.hpp"
+#include "../diagnostics/CommandLatency.hpp"
+#include "../diagnostics/Telemetry.hpp"
+#include "../diagnostics/Trace.hpp"
 #include "../serial/Logger.hpp"
+#include "BatteryCompensator.hpp"
 #include "Motor.hpp"
 
 
@@ -27,6 +32,7 @@ Motor::Motor( int port, pros::motor_gearset_e_t gearset, bool reversed )
     
     motor_port = port;
     
+    AllocationScope allocation_scope(e_alloc_motors);
     motor = new pros::Motor(port, gearset, reversed, pros::E_MOTOR_ENCODER_DEGREES);
         
     prev_velocity = 0;
@@ -39,12 +45,16 @@ Motor::Motor( int port, pros::motor_gearset_e_t gearset, bool reversed )
     prev_voltage_setpoint = 0;
     voltage_setpoint = 0;
     velocity_setpoint = 0;
-    
-    Configuration *configuration = Configuration::get_instance();
-    internal_motor_pid.kP = configuration->internal_motor_pid.kP;
-    internal_motor_pid.kI = configuration->internal_motor_pid.kI;
-    internal_motor_pid.kD = configuration->internal_motor_pid.kD;
-    internal_motor_pid.I_max = configuration->internal_motor_pid.I_max;
+    velocity_signal = -1;
+    setpoint_signal = -1;
+    voltage_signal = -1;
+    signal_port = -1;
+    
+    config_image configuration = Configuration::get_instance()->to_image();  // locked copy in case a reload is running
+    internal_motor_pid.kP = configuration.internal_motor_pid[0];
+    internal_motor_pid.kI = configuration.internal_motor_pid[1];
+    internal_motor_pid.kD = configuration.internal_motor_pid[2];
+    internal_motor_pid.I_max = configuration.internal_motor_pid[3];
     integral = 0;
     prev_error = 0;
     
@@ -61,6 +71,7 @@ Motor::Motor(int port, pros::motor_gearset_e_t gearset, bool reversed, pid pid_c
     
     motor_port = port;
     
+    AllocationScope allocation_scope(e_alloc_motors);
     motor = new pros::Motor(port, gearset, reversed, pros::E_MOTOR_ENCODER_DEGREES);
         
     prev_velocity = 0;
@@ -73,6 +84,10 @@ Motor::Motor(int port, pros::motor_gearset_e_t gearset, bool reversed, pid pid_c
     prev_voltage_setpoint = 0;
     voltage_setpoint = 0;
     velocity_setpoint = 0;
+    velocity_signal = -1;
+    setpoint_signal = -1;
+    voltage_signal = -1;
+    signal_port = -1;
     
     internal_motor_pid.kP = pid_consts.kP;
     internal_motor_pid.kI = pid_consts.kI;
@@ -409,9 +424,10 @@ int Motor::set_port( int port )
     
     try
     {
+        AllocationScope allocation_scope(e_alloc_motors);
         delete motor;
         motor = new pros::Motor(port, gearset, reversed, pros::E_MOTOR_ENCODER_DEGREES);
-        motor_port = port;
+        motor_port = port;  // the next run renames the signals, only the motor thread touches them
     }
     catch(...) //ensure lock will be released
     {
@@ -668,6 +684,7 @@ int Motor::set_voltage_setpoint( int voltage )
         integral = 0;
     }
     lock.exchange(false);     
+    CommandLatency::check(this, voltage);
     
     return 1; 
 }
@@ -677,6 +694,7 @@ int Motor::set_velocity_setpoint(int new_velocity) {
     while ( lock.exchange( true ) );
     velocity_setpoint = new_velocity;
     lock.exchange(false);     
+    CommandLatency::check(this, new_velocity);
     
     return 1; 
 }
@@ -785,21 +803,39 @@ int Motor::driver_control_allowed()
  * calculates what log message is to be based on the log level set and adds it to 
  * the logger queue
  */      
-int Motor::run( int delta_t )
+int Motor::run( int delta_t, BatteryCompensator &compensator )
 {
+    TRACE_SCOPE("Motor::run");
     switch(mode) {
         case e_builtin_velocity_pid: {
             motor->move_velocity(velocity_setpoint);
             break;
         } case e_voltage: {
-            motor->move_voltage(voltage_setpoint);
+            motor->move_voltage(compensator.compensate(voltage_setpoint));
             break;
         } case e_custom_velocity_pid: {
             int voltage = get_target_voltage( delta_t );
-            motor->move_voltage(voltage);
+            motor->move_voltage(compensator.compensate(voltage));
             break;
         }
     }
+    
+    if(signal_port != motor_port) {  // slots are reused after the port changes so there is one set per motor
+        std::string name = "motor " + std::to_string(motor_port);
+        if(signal_port == -1) {
+            velocity_signal = Telemetry::add_signal((name + " velocity").c_str(), 5);
+            setpoint_signal = Telemetry::add_signal((name + " setpoint").c_str(), 5);
+            voltage_signal = Telemetry::add_signal((name + " voltage").c_str(), 5);
+        } else {
+            Telemetry::rename_signal(velocity_signal, (name + " velocity").c_str());
+            Telemetry::rename_signal(setpoint_signal, (name + " setpoint").c_str());
+            Telemetry::rename_signal(voltage_signal, (name + " voltage").c_str());
+        }
+        signal_port = motor_port;
+    }
+    Telemetry::log(velocity_signal, get_actual_velocity());
+    Telemetry::log(setpoint_signal, mode == e_builtin_velocity_pid ? velocity_setpoint : to_velocity(voltage_setpoint));
+    Telemetry::log(voltage_signal, get_actual_voltage());
 
     
     
@@ -16,6 +16,7 @@
 #include "main.h"
 
 #include "../../Configuration.hpp"
+#include "BatteryCompensator.hpp"
 
 
 typedef enum {
@@ -56,6 +57,12 @@ class Motor
         int prev_voltage_setpoint;
         int velocity_setpoint;
         
+        // telemetry signals, named by port on the first run and renamed when the port changes
+        int velocity_signal;
+        int setpoint_signal;
+        int voltage_signal;
+        int signal_port;  // the port the signals are named for, -1 before the first run
+        
         
         int to_voltage(int velocity);
         int to_velocity(int voltage);
@@ -468,6 +475,7 @@ class Motor
     //function to run on thread     
         /**
          * @param: int delta_t -> the amount of time elapsed since the last time the function was called
+         * @param: BatteryCompensator &compensator -> scales voltage commands for the battery voltage
          * @return: int -> the voltage to set the motor to
          *
          * @see: pros::Motor
@@ -475,8 +483,9 @@ class Motor
          * used to be run on long living thread so that motor can have PID and 
          * slew rate code built into it easier
          * also contains logging implementation and adds to logger queue
+         * builtin velocity pid is not compensated, the motor already holds its velocity
          */   
-        int run( int delta_t );
+        int run( int delta_t, BatteryCompensator &compensator );
 };
 
 
@@ -13,7 +13,11 @@
 
 #include "main.h"
 
+#include "../diagnostics/AllocationTracker.hpp"
+#include "../diagnostics/TaskStats.hpp"
+#include "../diagnostics/Telemetry.hpp"
 #include "../serial/Logger.hpp"
+#include "BatteryCompensator.hpp"
 #include "Motor.hpp"
 #include "MotorThread.hpp"
 
@@ -21,6 +25,7 @@
 MotorThread *MotorThread::thread_obj = NULL;
 std::vector<Motor*> MotorThread::motors;
 std::atomic<bool> MotorThread::lock = ATOMIC_VAR_INIT(false);
+BatteryCompensator MotorThread::compensator;
 
 
 MotorThread::MotorThread()
@@ -39,14 +44,25 @@ MotorThread::~MotorThread()
 
 void MotorThread::run(void*)
 {
+    AllocationScope allocation_scope(e_alloc_motors);
+    int stats_id = TaskStats::register_current_task("motor_thread", 5, TASK_STACK_DEPTH_DEFAULT);
+    int battery_signal = Telemetry::add_signal("battery voltage", 5);
+    int headroom_signal = Telemetry::add_signal("motor headroom", 5);
     int start = pros::millis();
     while (1) {
+        TaskStats::loop_tick(stats_id);
         while ( lock.exchange( true ) );
+        // one reading per cycle so every motor is scaled the same
+        compensator.update(pros::battery::get_voltage(), pros::millis() - start);
         for ( int i = 0; i < motors.size(); i++ ) {
-            motors.at(i)->run( pros::millis() - start );
+            motors.at(i)->run( pros::millis() - start, compensator );
         }
         start = pros::millis();
+        battery_compensation_stats stats = compensator.get_stats();
         lock.exchange(false);
+        
+        Telemetry::log(battery_signal, stats.battery_voltage);
+        Telemetry::log(headroom_signal, stats.headroom);
         pros::delay(5);
     }
 }
@@ -155,4 +171,47 @@ int MotorThread::is_registered(Motor &motor) {
     lock.exchange(false);
     
     return registered;
-}
\ No newline at end of file
+}
+
+
+
+void MotorThread::enable_battery_compensation()
+{
+    while ( lock.exchange( true ) );
+    compensator.enable();
+    lock.exchange(false);
+}
+
+
+void MotorThread::disable_battery_compensation()
+{
+    while ( lock.exchange( true ) );
+    compensator.disable();
+    lock.exchange(false);
+}
+
+
+void MotorThread::configure_battery_compensation(battery_compensation_constants constants)
+{
+    while ( lock.exchange( true ) );
+    compensator.configure(constants);
+    lock.exchange(false);
+}
+
+
+battery_compensation_stats MotorThread::get_battery_compensation()
+{
+    while ( lock.exchange( true ) );
+    battery_compensation_stats stats = compensator.get_stats();
+    lock.exchange(false);
+    
+    return stats;
+}
+
+
+void MotorThread::reset_battery_compensation_stats()
+{
+    while ( lock.exchange( true ) );
+    compensator.reset_stats();
+    lock.exchange(false);
+}
@@ -17,6 +17,7 @@
 #include "main.h"
 
 #include "../../Configuration.hpp"
+#include "BatteryCompensator.hpp"
 #include "Motor.hpp"
 
 
@@ -35,6 +36,7 @@ class MotorThread
         
         static std::vector<Motor*> motors;
         static std::atomic<bool> lock;  //protect vector from concurrent access
+        static BatteryCompensator compensator;  // protected by lock too
         
         
         /**
@@ -99,6 +101,29 @@ class MotorThread
         int unregister_motor( Motor &motor );
         
         int is_registered(Motor &motor);
+        
+        
+        
+        
+        /**
+         * @return: None
+         *
+         * @see: BatteryCompensator.hpp
+         *
+         * scales voltage commands of every motor to the nominal battery
+         * voltage so routines run the same on a full battery as on a low one
+         * commands of 12000 are scaled down on a full battery, so it is left
+         * off for driver control
+         */
+        void enable_battery_compensation();
+        void disable_battery_compensation();
+        void configure_battery_compensation(battery_compensation_constants constants);
+        
+        /**
+         * @return: battery_compensation_stats -> the filtered battery voltage, scale, and headroom of the motors
+         */
+        battery_compensation_stats get_battery_compensation();
+        void reset_battery_compensation_stats();
     
     
 };
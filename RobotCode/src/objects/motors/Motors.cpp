@@ -7,19 +7,28 @@
  * contains definition of global struct
  */
  
+#include <cmath>
+
 #include "Motors.hpp"
 #include "MotorThread.hpp"
 
+namespace
+{
+    // one locked copy so every motor starts with the same configuration
+    const config_image startup_config = Configuration::get_instance()->to_image();
+}
+
 namespace Motors
 {
-    Motor front_right {Configuration::get_instance()->front_right_port, pros::E_MOTOR_GEARSET_06, Configuration::get_instance()->front_right_reversed};
-    Motor front_left {Configuration::get_instance()->front_left_port, pros::E_MOTOR_GEARSET_06, Configuration::get_instance()->front_left_reversed};
-    Motor back_right {Configuration::get_instance()->back_right_port, pros::E_MOTOR_GEARSET_06, Configuration::get_instance()->back_right_reversed};
-    Motor back_left {Configuration::get_instance()->back_left_port, pros::E_MOTOR_GEARSET_06, Configuration::get_instance()->back_left_reversed};
-    Motor left_intake {Configuration::get_instance()->left_intake_port, pros::E_MOTOR_GEARSET_06, Configuration::get_instance()->left_intake_reversed};
-    Motor right_intake {Configuration::get_instance()->right_intake_port, pros::E_MOTOR_GEARSET_06, Configuration::get_instance()->right_intake_reversed};
-    Motor upper_indexer {Configuration::get_instance()->upper_indexer_port, pros::E_MOTOR_GEARSET_06, Configuration::get_instance()->upper_indexer_reversed};
-    Motor lower_indexer {Configuration::get_instance()->lower_indexer_port, pros::E_MOTOR_GEARSET_06, Configuration::get_instance()->lower_indexer_reversed};
+    // same indices as config_image
+    Motor front_right {startup_config.ports[0], pros::E_MOTOR_GEARSET_06, (bool)startup_config.reversed[0]};
+    Motor front_left {startup_config.ports[2], pros::E_MOTOR_GEARSET_06, (bool)startup_config.reversed[2]};
+    Motor back_right {startup_config.ports[3], pros::E_MOTOR_GEARSET_06, (bool)startup_config.reversed[3]};
+    Motor back_left {startup_config.ports[1], pros::E_MOTOR_GEARSET_06, (bool)startup_config.reversed[1]};
+    Motor left_intake {startup_config.ports[4], pros::E_MOTOR_GEARSET_06, (bool)startup_config.reversed[4]};
+    Motor right_intake {startup_config.ports[5], pros::E_MOTOR_GEARSET_06, (bool)startup_config.reversed[5]};
+    Motor upper_indexer {startup_config.ports[6], pros::E_MOTOR_GEARSET_06, (bool)startup_config.reversed[6]};
+    Motor lower_indexer {startup_config.ports[7], pros::E_MOTOR_GEARSET_06, (bool)startup_config.reversed[7]};
 
     double chassis_gear_ratio = 3 / 5;
 
@@ -124,4 +133,55 @@ namespace Motors
         motor_thread->unregister_motor(Motors::lower_indexer);
     }
     
+    int apply_configuration() {
+        // motors are changed one at a time, so a drive that is running would
+        // have its sides on different configurations until every motor is done
+        // off the field the brain is never disabled, so there the motors have
+        // to be stopped instead
+        bool stopped = true;
+        for(Motor* motor : motor_array) {
+            stopped = stopped && std::abs(motor->get_actual_velocity()) < 1;
+        }
+        if(!pros::competition::is_disabled() && (pros::competition::is_connected() || !stopped)) {
+            return -1;
+        }
+        
+        Configuration* config = Configuration::get_instance();
+        config_image image = config->to_image();  // one consistent copy even if a reload happens during this
+        
+        // same order as config_image
+        std::array<Motor*, CONFIG_NUM_MOTORS> motors = {
+            &Motors::front_right,
+            &Motors::back_left,
+            &Motors::front_left,
+            &Motors::back_right,
+            &Motors::left_intake,
+            &Motors::right_intake,
+            &Motors::upper_indexer,
+            &Motors::lower_indexer
+        };
+        
+        pid internal_motor_pid;
+        internal_motor_pid.kP = image.internal_motor_pid[0];
+        internal_motor_pid.kI = image.internal_motor_pid[1];
+        internal_motor_pid.kD = image.internal_motor_pid[2];
+        internal_motor_pid.I_max = image.internal_motor_pid[3];
+        
+        int changed = 0;
+        for(int i = 0; i < CONFIG_NUM_MOTORS; i++) {
+            Motor* motor = motors.at(i);
+            if(motor->get_port() != image.ports[i]) {
+                motor->set_port(image.ports[i]);
+                changed += 1;
+            }
+            if(motor->is_reversed() != image.reversed[i]) {
+                motor->reverse_motor();
+                changed += 1;
+            }
+            motor->set_pid(internal_motor_pid);
+        }
+        
+        return changed;
+    }
+    
 };
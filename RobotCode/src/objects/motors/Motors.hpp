@@ -41,6 +41,19 @@ namespace Motors
     void set_log_level(int log_level);
     void register_motors();
     void unregister_motors();
+    
+    /**
+     * @return: int -> the number of ports and reversals that were changed, -1 if the motors could be moving
+     *
+     * @see: Configuration::reload
+     *
+     * moves the motors to the ports, directions, and pid constants in the
+     * configuration, motors stay registered so the motor thread keeps running
+     * only runs while the robot is disabled, or off the field while every
+     * motor is stopped, disabled() calls this again so a reload made while
+     * enabled is used from then on
+     */
+    int apply_configuration();
 };
 
 
@@ -9,17 +9,29 @@
  */
 
 #include <atomic>
+#include <cmath>
+#include <cstdint>
 
 #include "main.h"
 
+#include "../diagnostics/AllocationTracker.hpp"
+#include "../diagnostics/TaskStats.hpp"
+#include "../diagnostics/Telemetry.hpp"
+#include "../diagnostics/Trace.hpp"
+#include "../serial/BlackBox.hpp"
 #include "../serial/Logger.hpp"
 #include "../sensors/Sensors.hpp"
 #include "PositionTracker.hpp"
+#include "WallRelocalizer.hpp"
 
 
 PositionTracker *PositionTracker::tracker_obj = NULL;
 std::atomic<bool> PositionTracker::lock = ATOMIC_VAR_INIT(false);
 position PositionTracker::current_position;
+position PositionTracker::field_origin;
+
+bool PositionTracker::use_relocalization = false;
+WallRelocalizer PositionTracker::relocalizer;
 
 long double PositionTracker::initial_l_enc;
 long double PositionTracker::initial_r_enc; 
@@ -95,14 +107,23 @@ long double PositionTracker::to_radians(long double degrees) {
 
 void PositionTracker::calc_position(void*)
 {
+    AllocationScope allocation_scope(e_alloc_position_tracker);
+    int stats_id = TaskStats::register_current_task("position_tracking", 5, TASK_STACK_DEPTH_DEFAULT);
     int s_id = Sensors::strafe_encoder.get_unique_id();
 
     prev_l_enc = std::get<0>(Sensors::get_average_encoders(l_id, r_id));
     prev_r_enc = std::get<1>(Sensors::get_average_encoders(l_id, r_id));
     long double prev_s_enc = Sensors::strafe_encoder.get_position(s_id);
+    int blackbox_channel = BlackBox::add_channel("position", {"x", "y", "theta"});
+    int x_signal = Telemetry::add_signal("odometry x", 5);
+    int y_signal = Telemetry::add_signal("odometry y", 5);
+    int theta_signal = Telemetry::add_signal("odometry theta", 5);
+    std::uint32_t last_relocalization = 0;
     
     while(1)
     {
+        TaskStats::loop_tick(stats_id);
+        TRACE_START(trace_update, "calc_position");  // stopped before the delay so it is not included
         while ( lock.exchange( true ) );
         
         long double l_enc = std::get<0>(Sensors::get_average_encoders(l_id, r_id));
@@ -129,8 +150,9 @@ void PositionTracker::calc_position(void*)
 
         long double new_abs_theta_rad;
         long double imu_reading_rad;
-        if(use_imu) {
-            imu_reading_rad = imu_offset + to_radians(Sensors::imu.get_heading());
+        double imu_heading = use_imu ? Sensors::imu.get_heading() : PROS_ERR_F;
+        if(imu_heading != PROS_ERR_F) {  // the imu can also be unplugged during a match
+            imu_reading_rad = imu_offset + to_radians(imu_heading);
             imu_reading_rad = std::atan2(std::sin(imu_reading_rad), std::cos(imu_reading_rad));  // wrap angle to [-pi, pi]
             // make sure that imu_reading and theta from encoders have the same sign
             // to ensure that they are telling the same reading when merging
@@ -189,6 +211,26 @@ void PositionTracker::calc_position(void*)
         current_position.x_pos = current_position.x_pos + delta_global_x;
         current_position.y_pos = current_position.y_pos + delta_global_y;
         current_position.theta = new_abs_theta_rad;
+        
+        // the sensor has to be read in this thread so the correction
+        // is applied to the position the reading was taken at
+        // the walls are in the field frame so the position is moved there and back
+        relocalization_result relocalization = {e_wall_none, false, 0, 0, 0};
+        if(use_relocalization) {
+            relocalizer.predict(radius_pol);
+            if(pros::millis() - last_relocalization >= WALL_RELOCALIZATION_PERIOD) {
+                last_relocalization = pros::millis();
+                position field_position = field_transform(current_position, field_origin);
+                relocalization = relocalizer.update(field_position, Sensors::wall_distance.get() / 25.4, last_relocalization);
+                if(relocalization.accepted) {
+                    current_position = inverse_field_transform(field_position, field_origin);
+                }
+            }
+        }
+        BlackBox::log(blackbox_channel, {(float)current_position.x_pos, (float)current_position.y_pos, (float)current_position.theta});
+        Telemetry::log(x_signal, current_position.x_pos);
+        Telemetry::log(y_signal, current_position.y_pos);
+        Telemetry::log(theta_signal, current_position.theta);
 
 
         Logger logger;
@@ -249,8 +291,23 @@ void PositionTracker::calc_position(void*)
             logger.add(entry);
         }
         
+        if(relocalization.accepted && log_level > 0) {
+            relocalization_stats stats = relocalizer.get_stats();
+            entry.content = ("[INFO], " + std::string("Relocalization")
+                + ", Time: " + std::to_string(pros::millis())
+                + ", Wall: " + std::to_string(relocalization.wall)
+                + ", Expected: " + std::to_string(relocalization.expected)
+                + ", Measured: " + std::to_string(relocalization.measured)
+                + ", Correction: " + std::to_string(relocalization.correction)
+                + ", Latency: " + std::to_string(stats.last_latency)
+                + ", Compute_us: " + std::to_string(stats.last_compute)
+            );
+            logger.add(entry);
+        }
+        
         lock.exchange(false);
         
+        TRACE_STOP(trace_update);
         pros::delay(5);
     }
 }
@@ -280,10 +337,25 @@ void PositionTracker::set_log_level(int log_lvl) {
     lock.exchange(false);
 }
 
-void PositionTracker::enable_imu() {
+/**
+ * an imu that failed calibration reads PROS_ERR_F so it is never used,
+ * the encoders alone are used instead
+ */
+bool PositionTracker::enable_imu() {
+    bool calibrated = Sensors::imu_is_calibrated;
     while ( lock.exchange( true ) );
-    use_imu = true;
+    use_imu = calibrated;
     lock.exchange(false);
+    
+    if(!calibrated) {
+        Logger logger;
+        log_entry entry;
+        entry.content = "[WARNING], " + std::to_string(pros::millis()) + ", imu is not calibrated, position tracking is using only the encoders";
+        entry.stream = "cerr";
+        logger.add(entry);
+    }
+    
+    return calibrated;
 }
 
 void PositionTracker::disable_imu() {
@@ -292,6 +364,23 @@ void PositionTracker::disable_imu() {
     lock.exchange(false);
 }
 
+void PositionTracker::enable_relocalization() {
+    while ( lock.exchange( true ) );
+    relocalizer.reset();
+    use_relocalization = true;
+    lock.exchange(false);
+}
+
+void PositionTracker::disable_relocalization() {
+    while ( lock.exchange( true ) );
+    use_relocalization = false;
+    lock.exchange(false);
+}
+
+WallRelocalizer* PositionTracker::get_relocalizer() {
+    return &relocalizer;
+}
+
 
 long double PositionTracker::get_delta_theta_rad() {
     while ( lock.exchange( true ) );
@@ -338,7 +427,7 @@ void PositionTracker::set_position(position robot_coordinates) {
     initial_r_enc = std::get<1>(Sensors::get_average_encoders(l_id, r_id));
     initial_theta = robot_coordinates.theta;
     
-    if(use_imu) {
+    if(use_imu && Sensors::imu.get_heading() != PROS_ERR_F) {
         imu_offset = initial_theta - to_radians(Sensors::imu.get_heading());  // offset + imu_reading = initial_theta
     } else {
         imu_offset = initial_theta;
@@ -350,6 +439,67 @@ void PositionTracker::set_position(position robot_coordinates) {
     delta_theta_rad = 0;
 
     current_position = robot_coordinates;
+    relocalizer.reset();
     
     lock.exchange(false);
-}
\ No newline at end of file
+}
+
+
+
+void PositionTracker::set_field_origin(position origin) {
+    while ( lock.exchange( true ) );
+    field_origin = origin;
+    lock.exchange(false);
+}
+
+
+
+position PositionTracker::get_field_origin() {
+    while ( lock.exchange( true ) );
+    position origin = field_origin;
+    lock.exchange(false);
+
+    return origin;
+}
+
+
+
+position PositionTracker::field_transform(position robot_coordinates, position origin) {
+    long double cos_theta = std::cos(origin.theta);
+    long double sin_theta = std::sin(origin.theta);
+
+    position field_coordinates;
+    field_coordinates.x_pos = origin.x_pos + robot_coordinates.x_pos * cos_theta + robot_coordinates.y_pos * sin_theta;
+    field_coordinates.y_pos = origin.y_pos - robot_coordinates.x_pos * sin_theta + robot_coordinates.y_pos * cos_theta;
+    field_coordinates.theta = robot_coordinates.theta + origin.theta;
+
+    return field_coordinates;
+}
+
+
+
+position PositionTracker::inverse_field_transform(position field_coordinates, position origin) {
+    long double cos_theta = std::cos(origin.theta);
+    long double sin_theta = std::sin(origin.theta);
+    long double dx = field_coordinates.x_pos - origin.x_pos;
+    long double dy = field_coordinates.y_pos - origin.y_pos;
+
+    position robot_coordinates;
+    robot_coordinates.x_pos = dx * cos_theta - dy * sin_theta;
+    robot_coordinates.y_pos = dx * sin_theta + dy * cos_theta;
+    robot_coordinates.theta = field_coordinates.theta - origin.theta;
+
+    return robot_coordinates;
+}
+
+
+
+position PositionTracker::to_field_frame(position robot_coordinates) {
+    return field_transform(robot_coordinates, get_field_origin());
+}
+
+
+
+position PositionTracker::from_field_frame(position field_coordinates) {
+    return inverse_field_transform(field_coordinates, get_field_origin());
+}
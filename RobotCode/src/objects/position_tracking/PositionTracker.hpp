@@ -32,6 +32,8 @@ typedef struct
     };
 } position;
 
+class WallRelocalizer;
+
 
 class PositionTracker 
 {
@@ -40,6 +42,7 @@ class PositionTracker
         static PositionTracker *tracker_obj;
         
         static position current_position;
+        static position field_origin;
 
         static long double initial_l_enc;
         static long double initial_r_enc; 
@@ -57,7 +60,13 @@ class PositionTracker
         
         static int log_level;
         static bool use_imu;
+        static bool use_relocalization;
+        static WallRelocalizer relocalizer;
+        
         
+        // the same as to_field_frame and from_field_frame for when the lock is already held
+        static position field_transform(position robot_coordinates, position origin);
+        static position inverse_field_transform(position field_coordinates, position origin);
         
         static void calc_position(void*);
         pros::Task *thread;  // the thread for keeping track of position
@@ -97,15 +106,66 @@ class PositionTracker
         
         void set_log_level(int log_lvl);
 
-        void enable_imu();
+        /**
+         * @return: bool -> true if the imu is used, false if it did not calibrate and only the encoders are used
+         */
+        bool enable_imu();
         void disable_imu();
         
+        /**
+         * @return: None
+         *
+         * @see: WallRelocalizer.hpp
+         *
+         * corrects x and y with Sensors::wall_distance whenever it is square
+         * to a field wall, the relocalizer should be configured before this
+         * is called since it is used by the position tracking thread
+         * the walls are found with the field origin, so it has to be set to
+         * where the robot started
+         */
+        void enable_relocalization();
+        void disable_relocalization();
+        
+        /**
+         * @return: WallRelocalizer* -> the relocalizer used by the position tracking thread
+         */
+        WallRelocalizer* get_relocalizer();
+        
         long double get_delta_theta_rad();
         long double get_heading_rad();
         
         position get_position();
         
         static void set_position(position robot_coordinates);
+
+        /**
+         * @param: position origin -> the position on the field, from the corner used by FieldModel, of {0, 0, 0}
+         * @return: None
+         *
+         * routines are written from where the robot starts, so the position
+         * is usually set to {0, 0, 0} and the field frame is found from
+         * where that is on the field
+         * the origin is not changed by set_position
+         */
+        static void set_field_origin(position origin);
+        static position get_field_origin();
+
+        /**
+         * @param: position robot_coordinates -> a position in the same frame as get_position
+         * @return: position -> the same position on the field
+         *
+         * rotates clockwise by the theta of the field origin, the same way
+         * theta turns, then moves it by the x and y of the field origin
+         */
+        static position to_field_frame(position robot_coordinates);
+
+        /**
+         * @param: position field_coordinates -> a position on the field
+         * @return: position -> the same position in the frame of get_position
+         *
+         * the inverse of to_field_frame
+         */
+        static position from_field_frame(position field_coordinates);
 };
 
 #endif
@@ -0,0 +1,158 @@
+/**
+ * @file: ./RobotCode/src/objects/position_tracking/WallRelocalizer.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: WallRelocalizer.hpp
+ *
+ * contains implementation for correcting odometry with wall distance readings
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "../diagnostics/Clock.hpp"
+#include "../motion_planning/FieldModel.hpp"
+#include "PositionTracker.hpp"
+#include "WallRelocalizer.hpp"
+
+
+
+WallRelocalizer::WallRelocalizer()
+{
+    stats = {0, 0, -1, 0, 0, 0};
+    reset();
+}
+
+
+
+void WallRelocalizer::configure(distance_sensor_mount sensor_mount, relocalization_constants new_constants)
+{
+    mount = sensor_mount;
+    constants = new_constants;
+    reset();
+}
+
+
+
+void WallRelocalizer::reset()
+{
+    variance_x = constants.initial_variance;
+    variance_y = constants.initial_variance;
+    square_since = 0;
+    corrected_since_square = false;
+}
+
+
+
+void WallRelocalizer::predict(double distance)
+{
+    variance_x += constants.drift_variance * std::abs(distance);
+    variance_y += constants.drift_variance * std::abs(distance);
+}
+
+
+
+/**
+ * theta of 0 faces +y and increases clockwise, so a heading of a points
+ * along (sin(a), cos(a))
+ * if the position is off by e along the direction of the beam the reading
+ * is off by -e, so the reading says the robot is at position + (expected - measured) * beam
+ */
+relocalization_result WallRelocalizer::update(position& pose, double measured, std::uint32_t time)
+{
+    std::uint64_t start = Clock::get_micros();
+    relocalization_result result = {e_wall_none, false, 0, measured, 0};
+
+    double sensor_x = pose.x_pos + (mount.forward * std::sin(pose.theta)) - (mount.left * std::cos(pose.theta));
+    double sensor_y = pose.y_pos + (mount.forward * std::cos(pose.theta)) + (mount.left * std::sin(pose.theta));
+    double beam_x = std::sin(pose.theta + mount.angle);
+    double beam_y = std::cos(pose.theta + mount.angle);
+
+    // the wall the beam reaches first
+    double to_x_wall = std::numeric_limits<double>::max();
+    double to_y_wall = std::numeric_limits<double>::max();
+    if(beam_x < -1e-6) {
+        to_x_wall = sensor_x / -beam_x;
+    } else if(beam_x > 1e-6) {
+        to_x_wall = (FIELD_WIDTH - sensor_x) / beam_x;
+    }
+    if(beam_y < -1e-6) {
+        to_y_wall = sensor_y / -beam_y;
+    } else if(beam_y > 1e-6) {
+        to_y_wall = (FIELD_WIDTH - sensor_y) / beam_y;
+    }
+    bool x_wall = to_x_wall < to_y_wall;
+    double beam = x_wall ? beam_x : beam_y;
+    result.expected = std::min(to_x_wall, to_y_wall);
+
+    // only readings square to the wall are used, at an angle the beam
+    // spreads across the wall and small heading errors change the reading a lot
+    bool square = std::abs(beam) >= std::cos(constants.max_angle) && result.expected > 0;
+    if(square) {
+        result.wall = x_wall ? (beam_x < 0 ? e_wall_left : e_wall_right) : (beam_y < 0 ? e_wall_bottom : e_wall_top);
+        if(square_since == 0) {
+            square_since = std::max(time, static_cast<std::uint32_t>(1));
+            corrected_since_square = false;
+        }
+    } else {
+        square_since = 0;
+    }
+
+    if(square && measured >= constants.min_distance && measured <= constants.max_distance) {
+        double& variance = x_wall ? variance_x : variance_y;
+        double sensor_deviation = (constants.sensor_noise + (constants.sensor_noise_scale * measured)) * beam;
+        double measurement_variance = sensor_deviation * sensor_deviation;
+        double innovation = (result.expected - measured) * beam;
+
+        if(innovation * innovation <= constants.gate * constants.gate * (variance + measurement_variance)) {
+            double gain = variance / (variance + measurement_variance);
+            result.correction = gain * innovation;
+            result.accepted = true;
+            if(x_wall) {
+                pose.x_pos += result.correction;
+            } else {
+                pose.y_pos += result.correction;
+            }
+            variance = (1 - gain) * variance;
+
+            stats.accepted += 1;
+            stats.last_correction = result.correction;
+            if(!corrected_since_square) {
+                stats.last_latency = time - square_since;
+                corrected_since_square = true;
+            }
+        } else {  // probably a tower, ball, or robot between the sensor and the wall
+            stats.rejected += 1;
+        }
+    }
+
+    stats.last_compute = Clock::get_micros() - start;
+    stats.max_compute = std::max(stats.max_compute, stats.last_compute);
+
+    return result;
+}
+
+
+
+double WallRelocalizer::get_variance_x() const
+{
+    return variance_x;
+}
+
+
+
+double WallRelocalizer::get_variance_y() const
+{
+    return variance_y;
+}
+
+
+
+relocalization_stats WallRelocalizer::get_stats() const
+{
+    return stats;
+}
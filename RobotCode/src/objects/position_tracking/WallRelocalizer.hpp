@@ -0,0 +1,129 @@
+/**
+ * @file: ./RobotCode/src/objects/position_tracking/WallRelocalizer.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a correction for odometry drift that uses a distance sensor
+ * pointed at the field walls
+ * when the sensor is square to a wall the reading gives the distance of
+ * the robot from that wall, which is merged into x or y with a kalman
+ * measurement update so a noisy reading only moves the position as much
+ * as it is trusted
+ */
+
+#ifndef __WALLRELOCALIZER_HPP__
+#define __WALLRELOCALIZER_HPP__
+
+#include <cmath>
+#include <cstdint>
+
+#include "PositionTracker.hpp"
+
+
+
+#define WALL_RELOCALIZATION_PERIOD 50  // ms between readings, the sensor does not have a new reading every odometry tick
+
+
+typedef struct {
+    double forward=0;   // in the sensor is in front of the tracking center
+    double left=0;      // in the sensor is to the left of the tracking center
+    double angle=M_PI;  // rad the sensor faces from the front of the robot, clockwise like theta
+} distance_sensor_mount;
+
+typedef struct {
+    double initial_variance=0.25;     // in^2 of x and y after the position is set
+    double drift_variance=0.015;      // in^2 of variance added per inch driven
+    double sensor_noise=0.4;          // in standard deviation of a reading
+    double sensor_noise_scale=0.03;   // added to the standard deviation per inch of reading
+    double max_angle=0.14;            // rad from square to a wall that readings are used, about 8 degrees
+    double gate=3;                    // standard deviations a reading can be from expected, farther is something in the way
+    double min_distance=1;            // in
+    double max_distance=70;           // in
+} relocalization_constants;
+
+typedef enum {
+    e_wall_none,
+    e_wall_left,    // x = 0
+    e_wall_right,   // x = FIELD_WIDTH
+    e_wall_bottom,  // y = 0
+    e_wall_top      // y = FIELD_WIDTH
+} field_wall;
+
+typedef struct {
+    field_wall wall;   // e_wall_none if the sensor is not square to a wall
+    bool accepted;
+    double expected;   // in the reading should be from the current position
+    double measured;   // in
+    double correction;  // in the position moved along the wall normal
+} relocalization_result;
+
+typedef struct {
+    int accepted;
+    int rejected;
+    int last_latency;            // ms from becoming square to a wall to the first accepted reading
+    double last_correction;      // in
+    std::uint32_t last_compute;  // us
+    std::uint32_t max_compute;   // us
+} relocalization_stats;
+
+
+
+/**
+ * has no sensor of its own so that it can be run with simulated readings,
+ * PositionTracker reads the sensor and calls update from the odometry task
+ */
+class WallRelocalizer
+{
+    private:
+        distance_sensor_mount mount;
+        relocalization_constants constants;
+
+        double variance_x;
+        double variance_y;
+        std::uint32_t square_since;  // ms, 0 when the sensor is not square to a wall
+        bool corrected_since_square;
+        relocalization_stats stats;
+
+    public:
+        WallRelocalizer();
+
+        void configure(distance_sensor_mount sensor_mount, relocalization_constants new_constants);
+
+        /**
+         * @return: None
+         *
+         * sets the uncertainty back to the initial variance, call when the
+         * position is set
+         */
+        void reset();
+
+        /**
+         * @param: double distance -> inches driven since the last call
+         * @return: None
+         *
+         * grows the uncertainty of x and y by how far the robot has driven
+         */
+        void predict(double distance);
+
+        /**
+         * @param: position& pose -> the position from odometry, x or y is corrected in place
+         * @param: double measured -> the sensor reading in inches
+         * @param: std::uint32_t time -> the time of the reading in ms, only used for latency
+         * @return: relocalization_result -> what the reading was used for
+         *
+         * finds the wall the sensor points at and the distance it should
+         * read, if it is square to the wall and the reading is close enough
+         * to expected the position is moved toward what the reading says
+         * by how much the reading is trusted compared to odometry
+         */
+        relocalization_result update(position& pose, double measured, std::uint32_t time);
+
+        double get_variance_x() const;
+        double get_variance_y() const;
+        relocalization_stats get_stats() const;
+};
+
+
+
+#endif
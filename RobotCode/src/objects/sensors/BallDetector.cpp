@@ -7,33 +7,247 @@
  * contains implementation for ball detector class
  */
 
+#include <algorithm>
+
+#include "../diagnostics/AllocationTracker.hpp"
 #include "../serial/Logger.hpp"
 #include "BallDetector.hpp"
 
 
+std::array<std::uint8_t, 360> BallDetector::hue_lut;
+bool BallDetector::hue_lut_built = false;
 
+    
 BallDetector::BallDetector(
     int optical_port, 
     int distance_port,
     int detector_threshold
 ) {
+    AllocationScope allocation_scope(e_alloc_sensors);
     optical_sensor = new pros::Optical(optical_port);
     distance_sensor = new pros::Distance(distance_port);
     
     optical_sensor->disable_gesture();
     optical_sensor->set_led_pwm(50);
-    
+
     threshold = detector_threshold;
     time_since_last_ball = 0;
     log_data = false;
+
+    sampler_thread = NULL;
+    sample_rate = 10;
+    debounce_samples = 2;
+    sample_count = 0;
+    event_count = 0;
+    lock = false;
+    state = 0;
+    middle_color = 0;
+    top_debounce_count = 0;
+    middle_debounce_count = 0;
+    middle_seen_time = -1;
+    detection_latency = {0, 0, 0, 0};
+
+    if(!hue_lut_built) {
+        build_hue_lut();
+    }
 }
 
 BallDetector::~BallDetector() {
+    stop_sampling();
     delete optical_sensor;
     delete distance_sensor;
 }
 
 
+    
+void BallDetector::build_hue_lut() {
+    for(int hue = 0; hue < 360; hue++) {
+        if(hue > 170 && hue < 260) {  // color is blue
+            hue_lut.at(hue) = 1;
+        } else if(hue > 335 || hue < 25) {  // color is red
+            hue_lut.at(hue) = 2;
+        } else if(hue > 155 && hue < 275) {  // near blue
+            hue_lut.at(hue) = 3;
+        } else if(hue > 320 || hue < 40) {  // near red
+            hue_lut.at(hue) = 4;
+        } else {
+            hue_lut.at(hue) = 0;
+        }
+    }
+    hue_lut_built = true;
+}
+            
+    
+    
+int BallDetector::classify_hue(int hue, int previous_color) {
+    switch(hue_lut.at(((hue % 360) + 360) % 360)) {
+        case 1:
+            return 1;
+        case 2:
+            return 2;
+        case 3:  // only stay blue if the ball was already blue
+            return previous_color == 1 ? 1 : -1;
+        case 4:
+            return previous_color == 2 ? 2 : -1;
+        default:
+            return -1;
+    }
+}
+
+
+
+void BallDetector::add_sample(ball_detector_sample sample) {
+    while ( lock.exchange( true ) ); //aquire lock
+    samples.at(sample_count % BALL_DETECTOR_SAMPLE_BUFFER_SIZE) = sample;
+    sample_count += 1;
+    lock.exchange( false ); //release lock
+}
+
+
+
+void BallDetector::add_event(ball_detector_event_type type, int color, int time) {
+    while ( lock.exchange( true ) ); //aquire lock
+    events.at(event_count % BALL_DETECTOR_EVENT_BUFFER_SIZE) = {type, color, time};
+    event_count += 1;
+    lock.exchange( false ); //release lock
+
+    if(log_data) {
+        Logger logger;
+        log_entry entry;
+        entry.content = (
+            "[INFO] " + std::string("BALL_DETECT_EVENT")
+            + ", Time: " + std::to_string(time)
+            + ", Event: " + std::to_string(type)
+            + ", Color: " + std::to_string(color)
+        );
+        entry.stream = "clog";
+        logger.add(entry);  
+    }
+}
+
+
+
+void BallDetector::sampler_task(void* detector) {
+    BallDetector* self = static_cast<BallDetector*>(detector);
+    std::uint32_t wake_time = pros::millis();
+
+    while(1) {
+        ball_detector_sample sample;
+        sample.time = pros::millis();
+        sample.proximity = self->optical_sensor->get_proximity();
+        sample.distance = self->distance_sensor->get();
+        sample.hue = self->optical_sensor->get_hue();
+        self->process_sample(sample);
+
+        pros::Task::delay_until(&wake_time, self->sample_rate);
+    }
+}
+
+
+
+std::uint8_t BallDetector::process_sample(ball_detector_sample sample) {
+    add_sample(sample);
+
+    bool raw_top = sample.distance < 60;
+    bool raw_middle = sample.proximity > 245;
+    std::uint8_t current_state = state;
+    bool top = current_state & BALL_TOP;
+    bool middle = current_state & BALL_MIDDLE;
+
+    if(raw_middle && !middle && middle_seen_time < 0) {
+        middle_seen_time = sample.time;
+    } else if(!raw_middle && !middle) {  // was noise, not a ball
+        middle_seen_time = -1;
+    }
+
+    // only change state once enough consecutive samples agree
+    top_debounce_count = (raw_top != top) ? top_debounce_count + 1 : 0;
+    if(top_debounce_count >= debounce_samples) {
+        top = raw_top;
+        top_debounce_count = 0;
+        add_event(top ? e_top_ball_arrived : e_top_ball_left, 0, sample.time);
+    }
+
+    middle_debounce_count = (raw_middle != middle) ? middle_debounce_count + 1 : 0;
+    if(middle_debounce_count >= debounce_samples) {
+        middle = raw_middle;
+        middle_debounce_count = 0;
+        if(!middle) {
+            add_event(e_middle_ball_left, middle_color, sample.time);
+            middle_color = 0;
+            middle_seen_time = -1;
+        }
+    }
+
+    if(middle) {
+        int color = classify_hue(sample.hue, middle_color);
+        bool arrived = !(current_state & BALL_MIDDLE);
+        if(color > 0 || arrived) {
+            middle_color = color;
+        }
+        if(arrived) {
+            add_event(e_middle_ball_arrived, middle_color, sample.time);
+        }
+    }
+
+    std::uint8_t new_state = 0;
+    new_state |= top ? BALL_TOP : 0;
+    new_state |= middle ? BALL_MIDDLE : 0;
+    new_state |= (middle && middle_color == 1) ? BALL_MIDDLE_BLUE : 0;
+    new_state |= (middle && middle_color == 2) ? BALL_MIDDLE_RED : 0;
+    state = new_state;
+
+    std::uint8_t colors = BALL_MIDDLE_BLUE | BALL_MIDDLE_RED;
+    if((new_state & colors) && !(current_state & colors) && middle_seen_time >= 0) {
+        int latency = sample.time - middle_seen_time;
+        while ( lock.exchange( true ) ); //aquire lock
+        detection_latency.count += 1;
+        detection_latency.last = latency;
+        detection_latency.max = std::max(detection_latency.max, latency);
+        detection_latency.total += latency;
+        lock.exchange( false ); //release lock
+        middle_seen_time = -1;
+    }
+
+    return new_state;
+}
+
+
+
+int BallDetector::state_color(std::uint8_t detector_state) {
+    if(!(detector_state & BALL_MIDDLE)) {
+        return 0;
+    } else if(detector_state & BALL_MIDDLE_BLUE) {
+        return 1;
+    } else if(detector_state & BALL_MIDDLE_RED) {
+        return 2;
+    }
+
+    return -1;
+}
+
+
+
+void BallDetector::start_sampling(int rate /*10*/, int debounce /*2*/) {
+    sample_rate = rate;
+    debounce_samples = debounce;
+    if(sampler_thread == NULL) {
+        sampler_thread = new pros::Task( sampler_task, (void*)this, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "ball_detector_thread");
+    }
+}
+
+
+
+void BallDetector::stop_sampling() {
+    if(sampler_thread != NULL) {
+        sampler_thread->remove();
+        delete sampler_thread;
+        sampler_thread = NULL;
+    }
+}
+
+
+
 int BallDetector::set_threshold(int new_threshold) {
     threshold = new_threshold;
     return 1;
@@ -42,21 +256,18 @@ int BallDetector::set_threshold(int new_threshold) {
 
 int BallDetector::check_filter_level() {
     int return_code = 0;
-    if(optical_sensor->get_proximity() > 245) {  // ball is detected
-        time_since_last_ball = 0;  // ball detected so there is no time since last ball
-
-        double hue = optical_sensor->get_hue();
-        if(hue > 170 && hue < 260) {  // color is blue
-            return_code = 1;
-        } else if(hue > 335 || hue < 25) {  // color is red
-            return_code = 2;
-        } else {  // could not determine color based on ranges
-            return_code = -1;
+    if(sampler_thread != NULL) {  // use the classification from the sampler
+        return_code = state_color(state);
+        if(return_code != 0) {
+            time_since_last_ball = 0;
         }
+    } else if(optical_sensor->get_proximity() > 245) {  // ball is detected
+        time_since_last_ball = 0;  // ball detected so there is no time since last ball
+        return_code = classify_hue(optical_sensor->get_hue(), 0);
     } else {
         time_since_last_ball = pros::millis() - time_since_last_ball;  // get time elapsed
     }
-    
+
     if(log_data) {
         Logger logger;
         log_entry entry;
@@ -66,50 +277,138 @@ int BallDetector::check_filter_level() {
             + ", ball_detected: " + std::to_string(return_code)
             + ", time_since_last_ball " + std::to_string(time_since_last_ball)
             + ", threshold: " + std::to_string(threshold)
-            
+
         );
         entry.stream = "clog";
-        logger.add(entry);  
+        logger.add(entry);
     }
-    
-    
+
+
     return return_code;  // no ball is detected
 }
 
 
-std::vector<bool> BallDetector::locate_balls() {
-    std::vector<bool> locations;
+std::uint8_t BallDetector::get_state() {
+    if(sampler_thread != NULL) {
+        return state;
+    }
+
+    std::uint8_t current_state = 0;
     if(distance_sensor->get() < 60) {
-        locations.push_back(true);
-    } else {
-        locations.push_back(false);
+        current_state |= BALL_TOP;
     }
-    
-    if(optical_sensor->get_proximity() > 245) {
-        locations.push_back(true);
-    } else {
-        locations.push_back(false);
+    int color = check_filter_level();
+    if(color != 0) {
+        current_state |= BALL_MIDDLE;
     }
-    
-    locations.push_back(false);  // 3rd state is unknown, no sensor
-    
-    if(log_data) {
-        Logger logger;
-        log_entry entry;
-        entry.content = (
-            "[INFO] " + std::string("BALL_DETECT_MIDDLE")
-            + ", time: " + std::to_string(pros::millis())
-            + ", top_present: " + std::to_string(locations.at(0))
-            + ", middle_present: " + std::to_string(locations.at(1))
-            + ", bottom_present: " + std::to_string(locations.at(2))
-            + ", threshold: " + std::to_string(threshold)
-        );
-        entry.stream = "clog";
-        logger.add(entry);  
+    if(color == 1) {
+        current_state |= BALL_MIDDLE_BLUE;
+    } else if(color == 2) {
+        current_state |= BALL_MIDDLE_RED;
     }
-    
-    
-    return locations;
+
+    return current_state;
+}
+
+
+int BallDetector::get_event_count() {
+    return event_count;
+}
+
+
+std::vector<ball_detector_event> BallDetector::get_events(int since_time /*0*/) {
+    std::vector<ball_detector_event> recent_events;
+    while ( lock.exchange( true ) ); //aquire lock
+    int first = std::max(0, event_count - BALL_DETECTOR_EVENT_BUFFER_SIZE);
+    for(int i = first; i < event_count; i++) {
+        ball_detector_event event = events.at(i % BALL_DETECTOR_EVENT_BUFFER_SIZE);
+        if(event.time >= since_time) {
+            recent_events.push_back(event);
+        }
+    }
+    lock.exchange( false ); //release lock
+
+    return recent_events;
+}
+
+
+std::vector<ball_detector_sample> BallDetector::get_samples(int num_samples /*BALL_DETECTOR_SAMPLE_BUFFER_SIZE*/) {
+    std::vector<ball_detector_sample> recent_samples;
+    while ( lock.exchange( true ) ); //aquire lock
+    num_samples = std::min(num_samples, std::min(sample_count, BALL_DETECTOR_SAMPLE_BUFFER_SIZE));
+    for(int i = sample_count - num_samples; i < sample_count; i++) {
+        recent_samples.push_back(samples.at(i % BALL_DETECTOR_SAMPLE_BUFFER_SIZE));
+    }
+    lock.exchange( false ); //release lock
+
+    return recent_samples;
+}
+
+
+ball_detector_latency BallDetector::get_detection_latency() {
+    while ( lock.exchange( true ) ); //aquire lock
+    ball_detector_latency latency = detection_latency;
+    lock.exchange( false ); //release lock
+
+    return latency;
+}
+
+
+void BallDetector::log_classification_cost(int iterations /*5000*/) {
+    // there is no microsecond timer so run enough iterations for millis to resolve them
+    // direct read and chained float comparisons, the previous classification path
+    std::uint32_t start = pros::millis();
+    int direct_color = 0;
+    for(int i = 0; i < iterations; i++) {
+        if(optical_sensor->get_proximity() > 245) {
+            double hue = optical_sensor->get_hue();
+            if(hue > 170 && hue < 260) {
+                direct_color = 1;
+            } else if(hue > 335 || hue < 25) {
+                direct_color = 2;
+            } else {
+                direct_color = -1;
+            }
+        }
+    }
+    double direct_time = 1000.0 * (pros::millis() - start) / iterations;
+
+    // lookup table on a hue that was already sampled
+    int hue = optical_sensor->get_hue();
+    start = pros::millis();
+    int lut_color = 0;
+    for(int i = 0; i < iterations; i++) {
+        lut_color = classify_hue(hue + (i % 2), lut_color);
+    }
+    double lut_time = 1000.0 * (pros::millis() - start) / iterations;
+
+    // reading the published state
+    start = pros::millis();
+    std::uint8_t current_state = 0;
+    for(int i = 0; i < iterations; i++) {
+        current_state |= get_state();
+    }
+    double state_time = 1000.0 * (pros::millis() - start) / iterations;
+
+    ball_detector_latency latency = get_detection_latency();
+
+    Logger logger;
+    log_entry entry;
+    entry.content = (
+        "[INFO] " + std::string("BALL_DETECT_COST")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Iterations: " + std::to_string(iterations)
+        + ", Direct_us: " + std::to_string(direct_time)
+        + ", LUT_us: " + std::to_string(lut_time)
+        + ", State_us: " + std::to_string(state_time)
+        + ", Sample_Period_ms: " + std::to_string(sample_rate)
+        + ", Debounce_ms: " + std::to_string(sample_rate * debounce_samples)
+        + ", Detect_ms: " + std::to_string(latency.count > 0 ? latency.total / latency.count : 0)
+        + ", Detect_Max_ms: " + std::to_string(latency.max)
+        + ", Colors: " + std::to_string(direct_color) + " " + std::to_string(lut_color) + " " + std::to_string(current_state)
+    );
+    entry.stream = "clog";
+    logger.add(entry);
 }
 
 
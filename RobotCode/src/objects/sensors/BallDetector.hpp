@@ -10,6 +10,9 @@
 #ifndef __BALLDETECTOR_HPP__
 #define __BALLDETECTOR_HPP__
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <tuple>
 
 #include "main.h"
@@ -17,14 +20,81 @@
 #include "AnalogInSensor.hpp"
 
 
-class BallDetector 
+// bits of the ball detector state
+constexpr std::uint8_t BALL_TOP = 0x01;
+constexpr std::uint8_t BALL_MIDDLE = 0x02;
+constexpr std::uint8_t BALL_MIDDLE_BLUE = 0x04;
+constexpr std::uint8_t BALL_MIDDLE_RED = 0x08;
+        
+#define BALL_DETECTOR_SAMPLE_BUFFER_SIZE 32
+#define BALL_DETECTOR_EVENT_BUFFER_SIZE 16
+
+        
+typedef enum {
+    e_middle_ball_arrived,
+    e_middle_ball_left,
+    e_top_ball_arrived,
+    e_top_ball_left
+} ball_detector_event_type;
+                        
+typedef struct {
+    ball_detector_event_type type;
+    int color;  // same codes as check_filter_level
+    int time;
+} ball_detector_event;
+        
+typedef struct {
+    int time;
+    int proximity;
+    int distance;
+    int hue;
+} ball_detector_sample;
+
+typedef struct {
+    int count;  // balls classified
+    int last;   // ms from the first sample that saw the ball to its color being published
+    int max;
+    int total;  // ms, divide by count for the mean
+} ball_detector_latency;
+    
+
+class BallDetector
 {
     private:        
         int time_since_last_ball;
         bool log_data;
-        
+
         int threshold;
-                        
+
+        // hue classification, indexed by hue in degrees
+        // 0 is unknown, 1 and 2 are blue and red, 3 and 4 are the hysteresis
+        // bands around blue and red that only keep a color that was already seen
+        static std::array<std::uint8_t, 360> hue_lut;
+        static bool hue_lut_built;
+        static void build_hue_lut();
+        int classify_hue(int hue, int previous_color);
+
+        pros::Task *sampler_thread;
+        static void sampler_task(void* detector);
+        int sample_rate;
+        int debounce_samples;
+
+        std::array<ball_detector_sample, BALL_DETECTOR_SAMPLE_BUFFER_SIZE> samples;
+        int sample_count;
+        std::array<ball_detector_event, BALL_DETECTOR_EVENT_BUFFER_SIZE> events;
+        int event_count;
+        std::atomic<bool> lock;
+
+        std::atomic<std::uint8_t> state;
+        int middle_color;
+        int top_debounce_count;
+        int middle_debounce_count;
+        int middle_seen_time;  // time of the first sample that saw the current ball, -1 if there is none
+        ball_detector_latency detection_latency;
+
+        void add_sample(ball_detector_sample sample);
+        void add_event(ball_detector_event_type type, int color, int time);
+
     public:
         BallDetector(
             int optical_port, 
@@ -32,21 +102,95 @@ class BallDetector
             int detector_threshold
         );
         ~BallDetector();
-        
+
         pros::Optical* optical_sensor;
         pros::Distance* distance_sensor;
-                        
+
         int set_threshold(int new_threshold);
         int check_filter_level();
-        std::vector<bool> locate_balls();
-        
+
+        /**
+         * @return: std::uint8_t -> bitmask of BALL_TOP, BALL_MIDDLE, BALL_MIDDLE_BLUE, and BALL_MIDDLE_RED
+         *
+         * returns the debounced state from the sampler if it is running,
+         * otherwise reads the sensors directly
+         */
+        std::uint8_t get_state();
+
+        /**
+         * @param: int rate -> the time in ms between samples
+         * @param: int debounce -> the number of consecutive samples needed to change state
+         * @return: None
+         *
+         * starts a task that samples the optical and distance sensors into a
+         * ring buffer, classifies the ball at the filter level, and publishes
+         * debounced events
+         * should be called after the rtos is running, ie. from initialize
+         */
+        void start_sampling(int rate=10, int debounce=2);
+        void stop_sampling();
+
+        /**
+         * @return: int -> the total number of events published
+         *
+         * the count only increases so it can be compared to a previous value
+         * to check for new events
+         */
+        int get_event_count();
+
+        /**
+         * @param: int since_time -> the earliest time in ms to include
+         * @return: std::vector<ball_detector_event> -> buffered events after since_time, oldest first
+         */
+        std::vector<ball_detector_event> get_events(int since_time=0);
+
+        /**
+         * @param: int num_samples -> the number of samples to get, capped by the buffer size
+         * @return: std::vector<ball_detector_sample> -> the most recent samples, oldest first
+         */
+        std::vector<ball_detector_sample> get_samples(int num_samples=BALL_DETECTOR_SAMPLE_BUFFER_SIZE);
+
+        /**
+         * @return: ball_detector_latency -> time from a ball reaching the filter level sensor to its color being published
+         *
+         * includes the debounce and any samples where the hue could not be
+         * classified yet
+         */
+        ball_detector_latency get_detection_latency();
+
+        /**
+         * @param: int iterations -> the number of times to run each path
+         * @return: None
+         *
+         * logs the average cpu time in microseconds of one call to the direct
+         * sensor read and float comparison classification, the lookup table,
+         * and the sampled state, along with the detection latency
+         */
+        void log_classification_cost(int iterations=5000);
+
+        /**
+         * @param: ball_detector_sample sample -> a reading of the optical and distance sensors
+         * @return: std::uint8_t -> the debounced state after the sample
+         *
+         * debounces and classifies one sample and publishes events, called by
+         * the sampler task for each reading and by the host tests with
+         * simulated readings
+         */
+        std::uint8_t process_sample(ball_detector_sample sample);
+
+        /**
+         * @param: std::uint8_t detector_state -> a state from get_state or process_sample
+         * @return: int -> the color of the ball at the filter level with the codes of check_filter_level
+         */
+        static int state_color(std::uint8_t detector_state);
+
         void set_led_brightness(int pct);
         void auto_set_led_brightness();
-        
+
         std::tuple<int, int> debug_color();
         void start_logging();
         void stop_logging();
-    
+
 };
 
 
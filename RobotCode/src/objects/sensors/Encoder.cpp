@@ -12,6 +12,7 @@
 
 #include "main.h"
 
+#include "../diagnostics/AllocationTracker.hpp"
 #include "../serial/Logger.hpp"
 #include "Encoder.hpp" 
 
@@ -20,6 +21,7 @@
 Encoder::Encoder( char upper_port, char lower_port, bool reverse ) {        
     lock = ATOMIC_VAR_INIT(false);
 
+    AllocationScope allocation_scope(e_alloc_sensors);
     encoder = new pros::ADIEncoder(upper_port, lower_port, reverse);
     
     
@@ -9,6 +9,9 @@
  * contains definitions for sensors and implementation for sensor class
  */
 
+#include <string>
+#include <vector>
+
 #include "Sensors.hpp"
 #include "../motors/Motors.hpp"
 #include "../../Configuration.hpp"
@@ -27,25 +30,82 @@ namespace Sensors
     BallDetector ball_detector{
         OPTICAL_PORT,
         DISTANCE_PORT,
-        Configuration::get_instance()->filter_threshold
+        Configuration::get_instance()->to_image().filter_threshold
     };
     
     pros::Imu imu{IMU_PORT};
-    bool imu_is_calibrated = false;
+    std::atomic<bool> imu_is_calibrated(false);
+    
+    pros::Distance wall_distance{WALL_DISTANCE_PORT};
     
     RGBLedString rgb_leds{pros::ext_adi_port_pair_t(EXPANDER_PORT, 'A'), pros::ext_adi_port_pair_t(EXPANDER_PORT, 'B'), pros::ext_adi_port_pair_t(EXPANDER_PORT, 'C')};
 
 
-    void calibrate_imu() {
-        bool calibrated = false;
-        while(!calibrated) {  // block until imu is connected and calibrated
-            imu.reset();  // calibrate imu
-            while(imu.is_calibrating()) {
-                pros::delay(10);
-                calibrated = true;
+    /**
+     * a missing imu never reports that it finished calibrating so the
+     * calibration is given up on after the timeout instead of waiting forever
+     */
+    bool calibrate_imu(int timeout) {
+        Logger logger;
+        log_entry entry;
+        entry.stream = "cerr";
+
+        imu_is_calibrated = false;
+        int start_time = pros::millis();
+        if(imu.reset() == PROS_ERR) {
+            entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", imu could not be reset, it is not plugged in";
+            logger.add(entry);
+            return false;
+        }
+
+        pros::delay(20);  // calibrating status is not set right away
+        while(imu.is_calibrating() || imu.get_status() == pros::c::E_IMU_STATUS_ERROR) {
+            if(pros::millis() - start_time > timeout) {
+                entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", imu did not finish calibrating";
+                logger.add(entry);
+                return false;
             }
+            pros::delay(10);
         }
+
         imu_is_calibrated = true;
+        return true;
+    }
+
+    /**
+     * reads one value from every smart device and logs the ones that
+     * return an error because they are unplugged
+     */
+    int probe_devices() {
+        Logger logger;
+        log_entry entry;
+        entry.stream = "cerr";
+
+        std::vector<std::string> missing;
+        if(pros::c::imu_get_status(IMU_PORT) == pros::c::E_IMU_STATUS_ERROR) {
+            missing.push_back("imu");
+        }
+        if(pros::c::optical_get_hue(OPTICAL_PORT) == PROS_ERR_F) {
+            missing.push_back("optical sensor");
+        }
+        if(pros::c::distance_get(DISTANCE_PORT) == PROS_ERR) {
+            missing.push_back("distance sensor");
+        }
+        if(pros::c::distance_get(WALL_DISTANCE_PORT) == PROS_ERR) {
+            missing.push_back("wall distance sensor");
+        }
+        for(int i = 0; i < Motors::motor_array.size(); i++) {
+            if(Motors::motor_array.at(i)->get_temperature() == PROS_ERR_F) {
+                missing.push_back(Motors::motor_names_array.at(i) + " motor");
+            }
+        }
+
+        for(std::string device : missing) {
+            entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", " + device + " is not plugged in";
+            logger.add(entry);
+        }
+
+        return missing.size();
     }
 
     void log_data() {
@@ -55,9 +115,7 @@ namespace Sensors
             + ", Sensor Data"
             +  ", Right_Enc: " + std::to_string(right_encoder.get_absolute_position(false))
             +  ", Left_Enc: " + std::to_string(left_encoder.get_absolute_position(false))
-            +  ", Top Detector" + std::to_string(ball_detector.locate_balls().at(0))
-            +  ", Middle Detector" + std::to_string(ball_detector.locate_balls().at(1))
-            +  ", Bottom Detector" + std::to_string(ball_detector.locate_balls().at(2))
+            +  ", Ball Detector" + std::to_string(ball_detector.get_state())
         );
         entry.stream = "clog";
         logger.add(entry);
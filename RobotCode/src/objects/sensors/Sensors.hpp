@@ -10,6 +10,8 @@
 #ifndef __SENSORS_HPP__
 #define __SENSORS_HPP__
 
+#include <atomic>
+
 #include "main.h"
 
 #include "BallDetector.hpp"
@@ -31,11 +33,22 @@ namespace Sensors
     extern BallDetector ball_detector;
     
     extern pros::Imu imu;
-    extern bool imu_is_calibrated;
+    extern std::atomic<bool> imu_is_calibrated;  // set by calibrate_imu from the startup task
+    
+    extern pros::Distance wall_distance;
     
     extern RGBLedString rgb_leds;
     
-    void calibrate_imu();
+    /**
+     * @param: int timeout -> ms to wait for calibration to finish
+     * @return: bool -> true if the imu calibrated, false if it is missing or took too long
+     */
+    bool calibrate_imu(int timeout=3000);
+
+    /**
+     * @return: int -> the number of smart devices that are not responding
+     */
+    int probe_devices();
     void log_data();
     std::tuple<double, double> get_average_encoders(int l_id, int r_id);
 }
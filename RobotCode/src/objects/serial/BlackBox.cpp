@@ -0,0 +1,478 @@
+/**
+ * @file: ./RobotCode/src/objects/serial/BlackBox.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: BlackBox.hpp
+ *
+ * contains implementation for the sd card telemetry recorder
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "main.h"
+
+#include "Logger.hpp"
+#include "BlackBox.hpp"
+
+
+
+std::FILE* BlackBox::file = NULL;
+pros::Task* BlackBox::writer_thread = NULL;
+std::atomic<bool> BlackBox::lock = ATOMIC_VAR_INIT(false);
+std::atomic<bool> BlackBox::channel_lock = ATOMIC_VAR_INIT(false);
+std::atomic<bool> BlackBox::running = ATOMIC_VAR_INIT(false);
+std::atomic<bool> BlackBox::stop_requested = ATOMIC_VAR_INIT(false);
+
+std::array<blackbox_block, BLACKBOX_NUM_BLOCKS> BlackBox::blocks;
+int BlackBox::active_block = 0;
+int BlackBox::write_block = 0;
+std::atomic<int> BlackBox::full_blocks = ATOMIC_VAR_INIT(0);
+
+std::array<blackbox_channel, BLACKBOX_MAX_CHANNELS> BlackBox::channels;
+std::atomic<int> BlackBox::num_channels = ATOMIC_VAR_INIT(0);
+int BlackBox::written_channels = 0;
+
+std::uint32_t BlackBox::sequence = 0;
+char BlackBox::filename[BLACKBOX_FILENAME_LENGTH] = "";
+
+std::array<std::uint32_t, BLACKBOX_INDEX_ENTRIES> BlackBox::block_times;
+int BlackBox::num_block_times = 0;
+std::uint32_t BlackBox::first_indexed_block = 0;
+std::uint32_t BlackBox::last_index_block = BLACKBOX_NO_BLOCK;
+int BlackBox::num_index_blocks = 0;
+blackbox_stats BlackBox::stats = {0, 0, 0, 0, 0};
+std::atomic<int> BlackBox::dropped_records = ATOMIC_VAR_INIT(0);
+
+
+
+static constexpr std::array<std::uint32_t, 256> build_crc_table() {
+    std::array<std::uint32_t, 256> table{};
+    for(std::uint32_t i = 0; i < 256; i++) {
+        std::uint32_t crc = i;
+        for(int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+static constexpr std::array<std::uint32_t, 256> crc_table = build_crc_table();
+
+
+
+static void copy_name(char* destination, const std::string& name) {
+    std::memset(destination, 0, BLACKBOX_NAME_LENGTH);
+    name.copy(destination, BLACKBOX_NAME_LENGTH);
+}
+
+
+
+std::uint32_t BlackBox::compute_checksum(const blackbox_block& block) {
+    const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(&block);
+    std::uint32_t crc = 0xFFFFFFFF;
+    for(int i = 0; i < offsetof(blackbox_block, checksum); i++) {
+        crc = crc_table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+
+
+void BlackBox::reset_block(blackbox_block& block, std::uint32_t magic) {
+    block.magic = magic;
+    block.sequence = 0;
+    block.time = 0;
+    block.length = 0;
+    block.count = 0;
+    block.previous_index = BLACKBOX_NO_BLOCK;
+    block.checksum = 0;
+}
+
+
+
+/**
+ * only called with the lock held
+ * moves to the next block in the ring unless every other block is still
+ * waiting to be written, the sealed block is only counted as full once the
+ * next one is ready so the writer never sees a block that is still in use
+ */
+bool BlackBox::seal_active_block() {
+    if(full_blocks >= BLACKBOX_NUM_BLOCKS - 1) {
+        return false;
+    }
+
+    active_block = (active_block + 1) % BLACKBOX_NUM_BLOCKS;
+    reset_block(blocks.at(active_block), BLACKBOX_DATA_MAGIC);
+    full_blocks += 1;
+    return true;
+}
+
+
+
+/**
+ * the unused end of the payload is zeroed so the file does not depend
+ * on what was left in the ring
+ * every block except the index and end blocks goes in the index, an index
+ * block is written as soon as one fills up
+ */
+bool BlackBox::write_block_to_file(blackbox_block& block) {
+    std::fill(block.payload + block.length, block.payload + BLACKBOX_PAYLOAD_SIZE, 0);
+    block.sequence = sequence;
+    block.checksum = compute_checksum(block);
+
+    int start_time = pros::millis();
+    bool success = std::fwrite(&block, 1, sizeof(blackbox_block), file) == sizeof(blackbox_block);
+    std::fflush(file);  // so a power cut does not lose blocks sitting in the file buffer
+    stats.max_write_time = std::max(stats.max_write_time, (int)(pros::millis() - start_time));
+
+    if(success) {
+        sequence += 1;
+        stats.blocks_written += 1;
+        stats.bytes_written += sizeof(blackbox_block);
+
+        if(block.magic != BLACKBOX_INDEX_MAGIC && block.magic != BLACKBOX_END_MAGIC) {
+            block_times.at(num_block_times) = block.time;
+            num_block_times += 1;
+            if(num_block_times == BLACKBOX_INDEX_ENTRIES) {
+                write_index_block();
+            }
+        }
+    }
+
+    return success;
+}
+
+
+
+/**
+ * writes every channel added since the last schema block, as many blocks
+ * as it takes
+ */
+void BlackBox::write_schema() {
+    int total_channels = num_channels;
+    blackbox_block block;
+    reset_block(block, BLACKBOX_SCHEMA_MAGIC);
+    block.time = pros::millis();
+
+    while(written_channels < total_channels) {
+        const blackbox_channel& channel = channels.at(written_channels);
+        int size = 2 + BLACKBOX_NAME_LENGTH * (1 + channel.num_fields);
+        if(block.length + size > BLACKBOX_PAYLOAD_SIZE) {
+            write_block_to_file(block);
+            reset_block(block, BLACKBOX_SCHEMA_MAGIC);
+            block.time = pros::millis();
+        }
+
+        std::uint8_t* destination = block.payload + block.length;
+        destination[0] = written_channels;
+        destination[1] = channel.num_fields;
+        std::memcpy(destination + 2, channel.name, BLACKBOX_NAME_LENGTH);
+        std::memcpy(destination + 2 + BLACKBOX_NAME_LENGTH, channel.field_names, BLACKBOX_NAME_LENGTH * channel.num_fields);
+        block.length += size;
+        block.count += 1;
+        written_channels += 1;
+    }
+
+    if(block.count > 0) {
+        write_block_to_file(block);
+    }
+}
+
+
+
+/**
+ * the index has the time of every block so that a reader can seek without
+ * scanning the file, index blocks link back to the one before them so a
+ * reader starts from the end block and follows previous_index
+ * if recording ends with a power cut there is no end block and readers
+ * have to scan the block headers for the last index block instead
+ */
+void BlackBox::write_index_block() {
+    if(num_block_times == 0) {
+        return;
+    }
+
+    blackbox_block block;
+    reset_block(block, BLACKBOX_INDEX_MAGIC);
+    block.time = pros::millis();
+    block.count = num_block_times;
+    block.length = 4 * (block.count + 1);
+    block.previous_index = last_index_block;
+    std::memcpy(block.payload, &first_indexed_block, 4);
+    std::memcpy(block.payload + 4, block_times.data(), 4 * block.count);
+
+    std::uint32_t index_sequence = sequence;
+    num_block_times = 0;  // cleared first because writing the block does not add to the index
+    if(write_block_to_file(block)) {
+        last_index_block = index_sequence;
+        num_index_blocks += 1;
+    }
+    first_indexed_block = sequence;
+}
+
+
+
+void BlackBox::write_end() {
+    write_index_block();
+
+    blackbox_block block;
+    reset_block(block, BLACKBOX_END_MAGIC);
+    block.time = pros::millis();
+    block.length = 8;
+    std::memcpy(block.payload, &last_index_block, 4);
+    std::memcpy(block.payload + 4, &num_index_blocks, 4);
+    write_block_to_file(block);
+}
+
+
+
+void BlackBox::writer_task(void*) {
+    while(1) {
+        if(written_channels < num_channels) {  // channels have to be in the file before data that uses them
+            write_schema();
+        }
+
+        if(!lock.exchange( true )) {  // try to seal a block that has waited too long, next loop if a producer has the lock
+            blackbox_block& active = blocks.at(active_block);
+            bool expired = active.count > 0 && pros::millis() - active.time > BLACKBOX_FLUSH_INTERVAL;
+            if(expired || (stop_requested && active.count > 0)) {
+                seal_active_block();
+            }
+            lock.exchange( false ); //release lock
+        } else if(stop_requested) {
+            pros::delay(1);
+            continue;
+        }
+
+        if(full_blocks > 0) {
+            write_block_to_file(blocks.at(write_block));  // producers do not touch full blocks
+            write_block = (write_block + 1) % BLACKBOX_NUM_BLOCKS;
+            full_blocks -= 1;
+            continue;
+        }
+
+        if(stop_requested) {
+            write_end();
+            std::fclose(file);
+            file = NULL;
+            stop_requested = false;
+            return;
+        }
+
+        pros::delay(5);
+    }
+}
+
+
+
+/**
+ * uses its own lock so that it never waits on the writer
+ */
+int BlackBox::add_channel(const char* name, std::vector<std::string> field_names) {
+    while ( channel_lock.exchange( true ) ); //aquire lock
+    int id = num_channels;
+    if(id >= BLACKBOX_MAX_CHANNELS || field_names.size() > BLACKBOX_MAX_FIELDS) {
+        channel_lock.exchange( false ); //release lock
+        return -1;
+    }
+
+    blackbox_channel& channel = channels.at(id);
+    copy_name(channel.name, name);
+    channel.num_fields = field_names.size();
+    for(int i = 0; i < field_names.size(); i++) {
+        copy_name(channel.field_names[i], field_names.at(i));
+    }
+
+    num_channels = id + 1;  // only counted once it is filled in so the writer never sees half of it
+    channel_lock.exchange( false ); //release lock
+
+    return id;
+}
+
+
+
+/**
+ * a missing or empty file is where the next recording goes, if there is
+ * none the ring starts over at 0
+ */
+int BlackBox::next_file_number() {
+    char name[BLACKBOX_FILENAME_LENGTH];
+    for(int i = 0; i < BLACKBOX_MAX_FILES; i++) {
+        std::snprintf(name, sizeof(name), BLACKBOX_FILE_FORMAT, i);
+        std::FILE* existing = std::fopen(name, "rb");
+        if(existing == NULL) {
+            return i;
+        }
+        std::fseek(existing, 0, SEEK_END);
+        long size = std::ftell(existing);
+        std::fclose(existing);
+        if(size <= 0) {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+
+
+bool BlackBox::start(const char* file_name /*NULL*/) {
+    if(running || file != NULL) {  // file is still set while the last recording is being closed
+        return false;
+    }
+
+    int number = -1;
+    if(file_name == NULL) {
+        number = next_file_number();
+        std::snprintf(filename, sizeof(filename), BLACKBOX_FILE_FORMAT, number);
+    } else {
+        std::snprintf(filename, sizeof(filename), "%s", file_name);
+    }
+
+    Logger logger;
+    log_entry entry;
+    file = std::fopen(filename, "wb");
+    if(file == NULL) {
+        entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", could not open " + std::string(filename) + " for the black box";
+        entry.stream = "cerr";
+        logger.add(entry);
+        return false;
+    }
+
+    if(number >= 0) {  // empty the oldest recording so the next start goes after this one
+        char next_name[BLACKBOX_FILENAME_LENGTH];
+        std::snprintf(next_name, sizeof(next_name), BLACKBOX_FILE_FORMAT, (number + 1) % BLACKBOX_MAX_FILES);
+        std::FILE* next_file = std::fopen(next_name, "wb");
+        if(next_file != NULL) {
+            std::fclose(next_file);
+        }
+    }
+
+    entry.content = "[INFO] " + std::string("BLACKBOX_START") + ", Time: " + std::to_string(pros::millis()) + ", File: " + std::string(filename);
+    entry.stream = "clog";
+    logger.add(entry);
+
+    sequence = 0;
+    written_channels = 0;
+    num_block_times = 0;
+    first_indexed_block = 0;
+    last_index_block = BLACKBOX_NO_BLOCK;
+    num_index_blocks = 0;
+    stats = {0, 0, 0, 0, 0};
+    dropped_records = 0;
+
+    blackbox_block header;
+    reset_block(header, BLACKBOX_HEADER_MAGIC);
+    header.time = pros::millis();
+    header.length = 4;
+    std::uint16_t version = BLACKBOX_VERSION;
+    std::uint16_t block_size = BLACKBOX_BLOCK_SIZE;
+    std::memcpy(header.payload, &version, 2);
+    std::memcpy(header.payload + 2, &block_size, 2);
+    write_block_to_file(header);
+
+    active_block = 0;
+    write_block = 0;
+    full_blocks = 0;
+    reset_block(blocks.at(active_block), BLACKBOX_DATA_MAGIC);
+
+    stop_requested = false;
+    running = true;
+
+    delete writer_thread;  // the last writer task already returned, only the handle is left
+    writer_thread = new pros::Task(writer_task, (void*)NULL, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT, "blackbox_writer");
+
+    return true;
+}
+
+
+
+void BlackBox::stop() {
+    if(!running) {
+        return;
+    }
+
+    running = false;
+    stop_requested = true;
+    while(stop_requested) {
+        pros::delay(5);
+    }
+}
+
+
+
+bool BlackBox::is_running() {
+    return running;
+}
+
+
+
+const char* BlackBox::get_filename() {
+    return filename;
+}
+
+
+
+/**
+ * a record that does not fit in the active block or is too long after the
+ * start of the block seals it and goes in the next one
+ * the lock is only tried once, if another task has it the record is dropped
+ */
+bool BlackBox::log(int channel, std::initializer_list<float> values) {
+    if(!running || channel < 0 || channel >= num_channels) {
+        return false;
+    }
+
+    int num_fields = channels.at(channel).num_fields;
+    int size = 3 + 4 * num_fields;
+    std::uint32_t time = pros::millis();
+
+    if(lock.exchange( true )) {  //try to aquire lock
+        dropped_records += 1;
+        return false;
+    }
+
+    blackbox_block* block = &blocks.at(active_block);
+    if(block->count > 0 && (block->length + size > BLACKBOX_PAYLOAD_SIZE || time - block->time > UINT16_MAX)) {
+        if(!seal_active_block()) {
+            dropped_records += 1;
+            lock.exchange( false ); //release lock
+            return false;
+        }
+        block = &blocks.at(active_block);
+    }
+
+    if(block->count == 0) {
+        block->time = time;
+    }
+
+    std::uint8_t* destination = block->payload + block->length;
+    std::uint16_t offset = time - block->time;
+    destination[0] = channel;
+    std::memcpy(destination + 1, &offset, 2);
+
+    float field_values[BLACKBOX_MAX_FIELDS] = {0};
+    std::copy(values.begin(), values.begin() + std::min((int)values.size(), num_fields), field_values);
+    std::memcpy(destination + 3, field_values, 4 * num_fields);
+
+    block->length += size;
+    block->count += 1;
+    stats.records += 1;
+    lock.exchange( false ); //release lock
+
+    return true;
+}
+
+
+
+blackbox_stats BlackBox::get_stats() {
+    blackbox_stats current = stats;
+    current.dropped_records = dropped_records;
+    return current;
+}
@@ -0,0 +1,201 @@
+/**
+ * @file: ./RobotCode/src/objects/serial/BlackBox.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a telemetry recorder that writes binary blocks to the sd card
+ * so that data is kept when the robot is not tethered to a laptop
+ */
+
+#ifndef __BLACKBOX_HPP__
+#define __BLACKBOX_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+
+
+#ifndef BLACKBOX_FILE_FORMAT  // host tests write somewhere else
+#define BLACKBOX_FILE_FORMAT "/usd/bbox%02d.bin"  // recordings are numbered so a reboot does not overwrite the last one
+#endif
+#define BLACKBOX_MAX_FILES 20
+#define BLACKBOX_FILENAME_LENGTH 32
+#define BLACKBOX_VERSION 2
+#define BLACKBOX_BLOCK_SIZE 512
+#define BLACKBOX_PAYLOAD_SIZE (BLACKBOX_BLOCK_SIZE - 24)  // block minus the header and checksum
+#define BLACKBOX_INDEX_ENTRIES ((BLACKBOX_PAYLOAD_SIZE / 4) - 1)  // block times in one index block
+#define BLACKBOX_NO_BLOCK 0xFFFFFFFF
+#define BLACKBOX_NUM_BLOCKS 8  // blocks in the ring, one is filled while the others are written
+#define BLACKBOX_MAX_CHANNELS 16
+#define BLACKBOX_MAX_FIELDS 8
+#define BLACKBOX_NAME_LENGTH 12
+#define BLACKBOX_FLUSH_INTERVAL 500  // ms before a partly full block is written anyway
+
+#define BLACKBOX_HEADER_MAGIC 0x58424256  // "VBBX"
+#define BLACKBOX_DATA_MAGIC   0x54414442  // "BDAT"
+#define BLACKBOX_SCHEMA_MAGIC 0x48435342  // "BSCH"
+#define BLACKBOX_INDEX_MAGIC  0x58444942  // "BIDX"
+#define BLACKBOX_END_MAGIC    0x444E4542  // "BEND"
+
+
+/**
+ * every block in the file has this layout, the magic says what the payload is
+ *   header: uint16 version, uint16 block size
+ *   schema: per channel uint8 id, uint8 number of fields, then the channel
+ *           name and each field name in BLACKBOX_NAME_LENGTH bytes
+ *   data:   per record uint8 channel, uint16 ms after the block time, then
+ *           one float per field of the channel
+ *   index:  uint32 sequence of the first block it covers, then the uint32
+ *           time of each block after that, an index block is written right
+ *           after the last block it covers and previous_index links it to
+ *           the index block before it
+ *   end:    uint32 sequence of the last index block, uint32 number of index blocks
+ */
+typedef struct {
+    std::uint32_t magic;
+    std::uint32_t sequence;  // position of the block in the file
+    std::uint32_t time;  // ms when the first record was added
+    std::uint16_t length;  // bytes of the payload that are used
+    std::uint16_t count;  // records in the payload
+    std::uint32_t previous_index;  // sequence of the index block before an index block, BLACKBOX_NO_BLOCK otherwise
+    std::uint8_t payload[BLACKBOX_PAYLOAD_SIZE];
+    std::uint32_t checksum;  // crc32 of everything before it
+} blackbox_block;
+
+static_assert(sizeof(blackbox_block) == BLACKBOX_BLOCK_SIZE, "blackbox blocks must line up with sd card sectors");
+
+
+typedef struct {
+    char name[BLACKBOX_NAME_LENGTH];
+    int num_fields;
+    char field_names[BLACKBOX_MAX_FIELDS][BLACKBOX_NAME_LENGTH];
+} blackbox_channel;
+
+typedef struct {
+    int blocks_written;
+    int bytes_written;
+    int records;
+    int dropped_records;  // records lost because every block was waiting to be written or the lock was taken
+    int max_write_time;  // longest time in ms for one block to be written
+} blackbox_stats;
+
+
+
+/**
+ * @see: Logger.hpp
+ *
+ * records are copied into the active block of a ring of blocks under a
+ * lock that is only held for the copy, when the lock is taken or the ring
+ * is full the record is dropped instead of waiting
+ * the lock is never spun on because the writer runs at a lower priority
+ * than the control loops, a control loop spinning on a lock held by the
+ * writer would never let the writer run to release it
+ * a low priority writer task writes full blocks to the sd card one at a
+ * time and flushes after each one so a power cut loses at most the block
+ * that was being filled, a block that was cut off while being written
+ * fails its checksum
+ */
+class BlackBox
+{
+    private:
+        static std::FILE* file;
+        static pros::Task* writer_thread;
+        static std::atomic<bool> lock;  // only ever tried, never waited on, see log
+        static std::atomic<bool> channel_lock;
+        static std::atomic<bool> running;
+        static std::atomic<bool> stop_requested;
+
+        static std::array<blackbox_block, BLACKBOX_NUM_BLOCKS> blocks;
+        static int active_block;
+        static int write_block;
+        static std::atomic<int> full_blocks;
+
+        static std::array<blackbox_channel, BLACKBOX_MAX_CHANNELS> channels;
+        static std::atomic<int> num_channels;
+        static int written_channels;  // channels already in a schema block
+
+        static std::uint32_t sequence;
+        static char filename[BLACKBOX_FILENAME_LENGTH];
+
+        // the index is written in pieces as blocks are written so it does not grow with the file
+        static std::array<std::uint32_t, BLACKBOX_INDEX_ENTRIES> block_times;
+        static int num_block_times;
+        static std::uint32_t first_indexed_block;
+        static std::uint32_t last_index_block;
+        static int num_index_blocks;
+        static blackbox_stats stats;
+        static std::atomic<int> dropped_records;
+
+        static void writer_task(void*);
+        static bool seal_active_block();
+        static void reset_block(blackbox_block& block, std::uint32_t magic);
+        static bool write_block_to_file(blackbox_block& block);
+        static void write_schema();
+        static void write_index_block();
+        static void write_end();
+        static int next_file_number();
+
+    public:
+        /**
+         * @param: const char* name -> the name of the channel in the file
+         * @param: std::vector<std::string> field_names -> the name of each value logged on the channel
+         * @return: int -> the channel to pass to log, -1 if there are too many channels or fields
+         *
+         * channels can be added at any time, they are written to the file
+         * before any data that uses them
+         */
+        static int add_channel(const char* name, std::vector<std::string> field_names);
+
+        /**
+         * @param: const char* file -> the file to write to, it is overwritten, NULL to use the next numbered file
+         * @return: bool -> false if the file could not be opened or it is already recording
+         *
+         * numbered files are reused in a ring of BLACKBOX_MAX_FILES, the file
+         * after the one being written is emptied so the empty file marks
+         * where the next recording goes and the one before it is the newest
+         */
+        static bool start(const char* file=NULL);
+
+        /**
+         * @return: None
+         *
+         * writes what is left in the ring and the index, then closes the file
+         * blocks until the writer task is finished
+         */
+        static void stop();
+        static bool is_running();
+
+        /**
+         * @return: const char* -> the file of the current or last recording
+         */
+        static const char* get_filename();
+
+        /**
+         * @param: int channel -> the channel from add_channel
+         * @param: std::initializer_list<float> values -> one value per field, missing fields are 0
+         * @return: bool -> false if it is not recording or the record was dropped
+         *
+         * never waits on the sd card, safe to call from control loops
+         */
+        static bool log(int channel, std::initializer_list<float> values);
+
+        static blackbox_stats get_stats();
+
+        /**
+         * @param: const blackbox_block& block -> the block to check
+         * @return: std::uint32_t -> crc32 of the block up to the checksum
+         */
+        static std::uint32_t compute_checksum(const blackbox_block& block);
+};
+
+
+
+#endif
@@ -17,6 +17,7 @@
 
 #include "main.h"
 
+#include "../diagnostics/AllocationTracker.hpp"
 #include "Logger.hpp"
 
 std::queue<log_entry> Logger::logger_queue;
@@ -68,6 +69,7 @@ bool Logger::add( log_entry entry ) {
     if ( !entry.stream.empty() && !entry.content.empty() )
     {
         if(use_queue) {  // save the message in a queue to be viewed later
+            AllocationScope allocation_scope(e_alloc_logger);  // the queue has no limit so this is where it shows up
             while ( lock.exchange( true ) ); //aquire lock
             logger_queue.push( entry );
             lock.exchange( false ); //release lock
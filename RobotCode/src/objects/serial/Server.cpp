@@ -15,6 +15,10 @@
 #include "pros/apix.h"
 
 #include "../../Configuration.hpp"
+#include "../diagnostics/AllocationTracker.hpp"
+#include "../diagnostics/TaskStats.hpp"
+#include "../diagnostics/Trace.hpp"
+#include "../lcdCode/UIThread.hpp"
 #include "../motors/Motors.hpp"
 #include "../motors/MotorThread.hpp"
 #include "Logger.hpp"
@@ -53,6 +57,8 @@ Server::~Server() {
 
 
 void Server::read_stdin(void*) {
+    AllocationScope allocation_scope(e_alloc_server);
+    TaskStats::register_current_task("server_thread", 0, TASK_STACK_DEPTH_DEFAULT);  // blocks on stdin so it has no period
     int read_check = 0;
     Logger logger;
     log_entry entry;
@@ -138,6 +144,8 @@ void Server::read_stdin(void*) {
 
 int Server::handle_request(server_request request) {
     // cases are defined in commands.ods
+    AllocationScope allocation_scope(e_alloc_server);
+    TRACE_SCOPE("Server::handle_request");
     Logger logger;
     log_entry entry;
     entry.stream = "clog";
@@ -457,6 +465,69 @@ int Server::handle_request(server_request request) {
             delay = 100;
             return_msg_body = "server is no longer running";
             break;            
+            
+        case 43939: {  // 0xAB 0xA3  reload configuration
+                // msg is either empty for config.bin, a file name, or a whole config image
+                Configuration* config = Configuration::get_instance();
+                config_image image;
+                if(request.msg.size() == sizeof(config_image)) {
+                    std::copy(request.msg.begin(), request.msg.end(), reinterpret_cast<char*>(&image));
+                    status = config->apply_image(image);
+                    if(status) {
+                        config->write_image(CONFIG_IMAGE_FILE);  // keep it for the next startup
+                    }
+                } else if(request.msg.empty()) {
+                    status = config->reload();
+                } else {
+                    status = config->reload(("/usd/" + request.msg).c_str());
+                }
+                
+                if(status) {
+                    int changed = Motors::apply_configuration();
+                    if(changed < 0) {
+                        return_msg_body = "configuration reloaded, motors are changed when the robot is next disabled";
+                    } else {
+                        return_msg_body = "configuration reloaded, " + std::to_string(changed) + " motor changes";
+                    }
+                } else {
+                    return_msg_body = "configuration not reloaded, image or file is invalid";
+                }
+            }
+            break;
+        
+        case 43940: {  // 0xAB 0xA4  heap usage
+                // one "name,live bytes,peak bytes,allocations per second,allocations;" group per subsystem
+                status = 1;
+                if(AllocationTracker::is_enabled()) {
+                    AllocationTracker::sample();
+                    return_msg_body = AllocationTracker::get_report();
+                } else {
+                    return_msg_body = "allocation tracking is not enabled, build with -DALLOCATION_TRACKING";
+                }
+            }
+            break;
+        
+        case 43941: {  // 0xAB 0xA5  task stats
+                // one "name,cpu %,stack used,stack size,recommended depth,average period,max jitter,missed deadlines;" group per task
+                status = 1;
+                TaskStats::sample();
+                return_msg_body = TaskStats::get_report();
+            }
+            break;
+            
+        case 43942: {  // 0xAB 0xA6  dump trace
+                // writes the trace buffers to the sd card, returns the number of events or -1
+                status = 1;
+                return_msg_body = std::to_string(Trace::dump());
+            }
+            break;
+            
+        case 43943: {  // 0xAB 0xA7  ui frame stats
+                // "frames,average us,max us,overruns,period ms"
+                status = 1;
+                return_msg_body = UIThread::get_instance()->get_report();
+            }
+            break;
         
         default:
             status = 1;
@@ -0,0 +1,211 @@
+/**
+ * @file: ./RobotCode/src/objects/startup/StartupGraph.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: StartupGraph.hpp
+ *
+ * contains implementation for the startup graph
+ */
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+#include "../serial/Logger.hpp"
+#include "StartupGraph.hpp"
+
+
+
+StartupGraph::StartupGraph() {
+    num_stages = 0;
+    start_time = 0;
+    end_time = 0;
+    for(startup_stage& stage : stages) {
+        stage.task = NULL;
+    }
+}
+
+
+
+StartupGraph::~StartupGraph() {
+    // tasks delete themselves when they return, only the handles are freed here
+    for(int i = 0; i < num_stages; i++) {
+        delete stages.at(i).task;
+        stages.at(i).task = NULL;
+    }
+}
+
+
+
+/**
+ * the status is only moved out of running if the graph has not already
+ * timed the stage out, a timed out stage keeps its status and the task
+ * just exits
+ */
+void StartupGraph::stage_task(void* stage) {
+    startup_stage* current = static_cast<startup_stage*>(stage);
+    bool success = current->function();
+
+    int running = e_stage_running;
+    int end_time = pros::millis();
+    if(current->status.compare_exchange_strong(running, success ? e_stage_done : e_stage_failed)) {
+        current->end_time = end_time;
+    }
+}
+
+
+
+bool StartupGraph::is_finished(int stage_id) {
+    int status = stages.at(stage_id).status;
+    return status != e_stage_waiting && status != e_stage_running;
+}
+
+
+
+int StartupGraph::add_stage(std::string name, std::function<bool()> function, std::vector<int> dependencies, int timeout, bool required) {
+    if(num_stages >= STARTUP_MAX_STAGES) {
+        return -1;
+    }
+
+    startup_stage& stage = stages.at(num_stages);
+    stage.name = name;
+    stage.function = function;
+    stage.dependencies = dependencies;
+    stage.timeout = timeout;
+    stage.required = required;
+    stage.start_time = 0;
+    stage.end_time = 0;
+    stage.status = e_stage_waiting;
+
+    num_stages += 1;
+    return num_stages - 1;
+}
+
+
+
+/**
+ * polls every stage until all of them are finished
+ * waiting stages are started when their dependencies are finished or are
+ * skipped if a required dependency did not succeed, running stages are
+ * checked against their timeout
+ * a stage that times out is not removed because it could be holding a lock
+ * like the logger's or the allocator's, it is only marked as timed out so
+ * startup can continue while it finishes on its own
+ */
+bool StartupGraph::run() {
+    start_time = pros::millis();
+
+    bool finished = false;
+    while(!finished) {
+        finished = true;
+        for(int i = 0; i < num_stages; i++) {
+            startup_stage& stage = stages.at(i);
+
+            if(stage.status == e_stage_waiting) {
+                bool ready = true;
+                bool blocked = false;
+                for(int dependency : stage.dependencies) {
+                    if(dependency < 0 || dependency >= num_stages) {
+                        blocked = true;
+                    } else if(is_finished(dependency) && !succeeded(dependency) && stages.at(dependency).required) {
+                        blocked = true;
+                    } else if(!is_finished(dependency)) {
+                        ready = false;
+                    }
+                }
+
+                if(blocked) {
+                    stage.status = e_stage_skipped;
+                    stage.start_time = pros::millis();
+                    stage.end_time = stage.start_time;
+                } else if(ready) {
+                    stage.start_time = pros::millis();
+                    stage.status = e_stage_running;
+                    stage.task = new pros::Task(stage_task, &stage, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, stage.name.c_str());
+                }
+            }
+
+            if(stage.status == e_stage_running && stage.timeout != STARTUP_NO_TIMEOUT && pros::millis() - stage.start_time > stage.timeout) {
+                int running = e_stage_running;
+                if(stage.status.compare_exchange_strong(running, e_stage_timed_out)) {
+                    stage.end_time = pros::millis();
+                }
+            }
+
+            if(!is_finished(i)) {
+                finished = false;
+            }
+        }
+
+        if(!finished) {
+            pros::delay(1);
+        }
+    }
+
+    end_time = pros::millis();
+    return !is_degraded();
+}
+
+
+
+bool StartupGraph::succeeded(int stage_id) {
+    if(stage_id < 0 || stage_id >= num_stages) {
+        return false;
+    }
+
+    return stages.at(stage_id).status == e_stage_done;
+}
+
+
+
+bool StartupGraph::is_degraded() {
+    for(int i = 0; i < num_stages; i++) {
+        if(!succeeded(i)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+int StartupGraph::get_total_time() {
+    return end_time - start_time;
+}
+
+
+
+void StartupGraph::log_breakdown() {
+    const char* status_names[] = {"waiting", "running", "done", "failed", "timed out", "skipped"};
+
+    Logger logger;
+    log_entry entry;
+    entry.stream = "clog";
+
+    for(int i = 0; i < num_stages; i++) {
+        startup_stage& stage = stages.at(i);
+        entry.content = (
+            "[INFO] " + std::string("STARTUP_STAGE")
+            + ", Time: " + std::to_string(pros::millis())
+            + ", Name: " + stage.name
+            + ", Status: " + status_names[stage.status]
+            + ", Start: " + std::to_string(stage.start_time - start_time)
+            + ", Duration: " + std::to_string(stage.end_time - stage.start_time)
+        );
+        logger.add(entry);
+    }
+
+    entry.content = (
+        "[INFO] " + std::string("STARTUP_TOTAL")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Duration: " + std::to_string(get_total_time())
+        + ", Degraded: " + std::to_string(is_degraded())
+    );
+    logger.add(entry);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file: ./RobotCode/src/objects/startup/StartupGraph.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a class for running the startup stages of the robot in
+ * parallel while respecting the order some of them have to run in
+ */
+
+#ifndef __STARTUPGRAPH_HPP__
+#define __STARTUPGRAPH_HPP__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "main.h"
+
+
+
+#define STARTUP_MAX_STAGES 12
+#define STARTUP_NO_TIMEOUT 0
+
+
+typedef enum {
+    e_stage_waiting,    // dependencies are not finished yet
+    e_stage_running,
+    e_stage_done,
+    e_stage_failed,     // the stage returned false
+    e_stage_timed_out,  // the stage ran too long and counts as failed, it keeps running until it returns
+    e_stage_skipped     // a dependency did not finish so the stage was never started
+} stage_status;
+
+typedef struct {
+    std::string name;
+    std::function<bool()> function;  // returns false if the stage failed
+    std::vector<int> dependencies;
+    int timeout;  // ms, STARTUP_NO_TIMEOUT to wait forever
+    bool required;  // if stages that depend on this one are skipped when it does not finish
+    int start_time;
+    int end_time;
+    std::atomic<int> status;
+    pros::Task* task;
+} startup_stage;
+
+
+
+/**
+ * each stage is started in its own task as soon as every stage it depends
+ * on is done
+ * a stage that fails or times out does not stop the rest of startup, the
+ * stages that depend on it are skipped if it is required and the robot
+ * starts in degraded mode
+ * a timed out stage is left running, so the graph and anything its stages
+ * capture by reference have to outlive it
+ */
+class StartupGraph
+{
+    private:
+        std::array<startup_stage, STARTUP_MAX_STAGES> stages;
+        int num_stages;
+        int start_time;
+        int end_time;
+
+        static void stage_task(void* stage);
+
+        bool is_finished(int stage_id);
+
+    public:
+        StartupGraph();
+        ~StartupGraph();
+
+        /**
+         * @param: std::string name -> the name to show in the boot time breakdown
+         * @param: std::function<bool()> function -> the stage, returns false if it failed
+         * @param: std::vector<int> dependencies -> ids of stages that have to be done before this one starts
+         * @param: int timeout -> the time in ms the stage can run for before it counts as failed
+         * @param: bool required -> false if stages depending on this one should still run when it does not finish
+         * @return: int -> the id of the stage or -1 if there are too many stages
+         */
+        int add_stage(std::string name, std::function<bool()> function, std::vector<int> dependencies={}, int timeout=STARTUP_NO_TIMEOUT, bool required=true);
+
+        /**
+         * @return: bool -> true if every stage is done, false if startup is degraded
+         *
+         * blocks until every stage is done, failed, timed out, or skipped
+         */
+        bool run();
+
+        /**
+         * @param: int stage_id -> the stage to check
+         * @return: bool -> true if the stage finished successfully
+         */
+        bool succeeded(int stage_id);
+
+        /**
+         * @return: bool -> true if any stage did not finish successfully
+         */
+        bool is_degraded();
+
+        /**
+         * @return: int -> ms that run() took
+         */
+        int get_total_time();
+
+        /**
+         * @return: None
+         *
+         * logs the status, start time, and duration of every stage
+         */
+        void log_breakdown();
+};
+
+
+
+#endif
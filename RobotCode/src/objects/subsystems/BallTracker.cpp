@@ -0,0 +1,271 @@
+/**
+ * @file: ./RobotCode/src/objects/subsystems/BallTracker.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: BallTracker.hpp
+ *
+ * contains implementation for the indexer ball tracking model
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "main.h"
+
+#include "../serial/Logger.hpp"
+#include "BallTracker.hpp"
+
+
+
+BallTracker::BallTracker(double top_travel /*290*/, double eject_distance /*180*/, double score_distance /*120*/, int sensor_lag /*15*/) {
+    top_position = top_travel;
+    detection_lag = sensor_lag;
+    eject_travel = eject_distance;
+    score_travel = score_distance;
+    match_window = top_travel / 3;
+
+    num_balls = 0;
+    history_start = 0;
+    history_length = 0;
+    for(int i = 0; i < 4; i++) {
+        event_counts[i] = 0;
+    }
+    total_events = 0;
+    logged_events = 0;
+
+    prev_top_present = false;
+    prev_middle_present = false;
+    prev_upper_position = 0;
+    prev_time = 0;
+    has_position = false;
+    next_id = 0;
+
+    lock = false;
+}
+
+
+BallTracker::~BallTracker() { }
+
+
+
+// records an event, lock must be held by the caller
+void BallTracker::add_event(ball_event_type type, tracked_ball ball, int time) {
+    ball_event event = {type, ball.id, ball.color, time, ball.position};
+    if(history_length == BALL_TRACKER_HISTORY_SIZE) {  // overwrite the oldest event
+        history_start = (history_start + 1) % BALL_TRACKER_HISTORY_SIZE;
+        history_length -= 1;
+    }
+    event_history.at((history_start + history_length) % BALL_TRACKER_HISTORY_SIZE) = event;
+    history_length += 1;
+    event_counts[type] += 1;
+    total_events += 1;
+}
+
+
+
+// adds a ball below the others and publishes that it entered, lock must be held by the caller
+void BallTracker::add_ball(tracked_ball ball, int time) {
+    if(num_balls == BALL_TRACKER_MAX_BALLS) {  // the top ball was missed leaving, forget it to make room
+        for(int i = 1; i < num_balls; i++) {
+            balls.at(i - 1) = balls.at(i);
+        }
+        num_balls -= 1;
+    }
+    balls.at(num_balls) = ball;
+    num_balls += 1;
+    add_event(e_ball_entered, ball, time);
+}
+
+
+
+// removes a ball from the model and publishes why, lock must be held by the caller
+void BallTracker::remove_ball(int index, ball_event_type type, int time) {
+    add_event(type, balls.at(index), time);
+    for(int i = index + 1; i < num_balls; i++) {
+        balls.at(i - 1) = balls.at(i);
+    }
+    num_balls -= 1;
+}
+
+
+
+void BallTracker::update(bool top_present, bool middle_present, int middle_color, double upper_position, int time) {
+    while ( lock.exchange( true ) ); //aquire lock
+
+    if(!has_position) {  // first reading, there is no travel to apply yet
+        prev_upper_position = upper_position;
+        has_position = true;
+    }
+    double delta_upper = upper_position - prev_upper_position;
+    prev_upper_position = upper_position;
+
+    // the detector only reports a transition after debouncing it, so a ball
+    // has already moved past the edge of a sensor by the time it is seen
+    double lag_travel = 0;
+    if(time > prev_time) {
+        lag_travel = delta_upper * detection_lag / (time - prev_time);
+    }
+    prev_time = time;
+
+    // balls at or above the filter level move with the upper roller
+    for(int i = 0; i < num_balls; i++) {
+        balls.at(i).position += delta_upper;
+    }
+
+    // ball arrived at the filter level
+    if(middle_present && !prev_middle_present) {
+        bool matched = false;
+        for(int i = 0; i < num_balls; i++) {  // ball moving back down from above
+            if(std::abs(balls.at(i).position) < match_window) {
+                if(delta_upper >= 0) {  // only the bottom edge of the sensor is at 0
+                    balls.at(i).position = lag_travel;
+                }
+                matched = true;
+                break;
+            }
+        }
+        if(!matched) {
+            tracked_ball ball = {next_id, middle_color, std::max(lag_travel, 0.0)};
+            next_id += 1;
+            add_ball(ball, time);
+        }
+    }
+
+    // color is usually not known until the ball is fully in front of the sensor
+    if(middle_present && middle_color != 0 && num_balls > 0 && std::abs(balls.at(num_balls - 1).position) < match_window) {
+        balls.at(num_balls - 1).color = middle_color;
+    }
+
+    // ball left the filter level going down, it is back where it was first seen
+    // so the eject travel is counted from there
+    if(!middle_present && prev_middle_present && num_balls > 0 && delta_upper < 0) {
+        balls.at(num_balls - 1).position = std::min(balls.at(num_balls - 1).position, std::min(lag_travel, 0.0));
+    }
+
+    // ball arrived at the top, snap the highest ball that is below the top to the sensor
+    if(top_present && !prev_top_present) {
+        int index = -1;
+        for(int i = 0; i < num_balls; i++) {
+            if(balls.at(i).position < top_position + match_window) {
+                index = i;
+                break;
+            }
+        }
+        if(index < 0) {  // ball was missed at the filter level
+            tracked_ball ball = {next_id, 0, top_position};
+            next_id += 1;
+            add_ball(ball, time);
+            index = num_balls - 1;
+        }
+        balls.at(index).position = top_position + std::max(lag_travel, 0.0);
+        add_event(e_ball_at_top, balls.at(index), time);
+    }
+
+    // ball left the top sensor while moving up so it was scored
+    if(!top_present && prev_top_present && delta_upper >= 0 && num_balls > 0) {
+        balls.at(0).position = std::max(balls.at(0).position, top_position + score_travel);
+    }
+
+    // remove balls that have left the indexer
+    for(int i = num_balls - 1; i >= 0; i--) {
+        if(balls.at(i).position >= top_position + score_travel && !(top_present && i == 0)) {
+            remove_ball(i, e_ball_scored, time);
+        } else if(balls.at(i).position <= -eject_travel && !(middle_present && i == num_balls - 1)) {
+            remove_ball(i, e_ball_ejected, time);
+        }
+    }
+
+    prev_top_present = top_present;
+    prev_middle_present = middle_present;
+
+    lock.exchange( false ); //release lock
+}
+
+
+
+void BallTracker::reset(double upper_position) {
+    while ( lock.exchange( true ) ); //aquire lock
+    num_balls = 0;
+    prev_upper_position = upper_position;
+    prev_time = 0;
+    has_position = true;
+    prev_top_present = false;
+    prev_middle_present = false;
+    lock.exchange( false ); //release lock
+}
+
+
+
+int BallTracker::get_event_count(ball_event_type type) {
+    return event_counts[type];
+}
+
+
+
+std::vector<ball_event> BallTracker::get_events(int since_time /*0*/) {
+    std::vector<ball_event> events;
+    while ( lock.exchange( true ) ); //aquire lock
+    for(int i = 0; i < history_length; i++) {
+        ball_event event = event_history.at((history_start + i) % BALL_TRACKER_HISTORY_SIZE);
+        if(event.time >= since_time) {
+            events.push_back(event);
+        }
+    }
+    lock.exchange( false ); //release lock
+
+    return events;
+}
+
+
+
+int BallTracker::get_ball_count() {
+    while ( lock.exchange( true ) ); //aquire lock
+    int count = num_balls;
+    lock.exchange( false ); //release lock
+
+    return count;
+}
+
+
+
+std::vector<tracked_ball> BallTracker::get_balls() {
+    while ( lock.exchange( true ) ); //aquire lock
+    std::vector<tracked_ball> tracked_balls(balls.begin(), balls.begin() + num_balls);
+    lock.exchange( false ); //release lock
+
+    return tracked_balls;
+}
+
+
+
+int BallTracker::log_events() {
+    std::array<ball_event, BALL_TRACKER_HISTORY_SIZE> pending;
+    int num_pending = 0;
+    while ( lock.exchange( true ) ); //aquire lock
+    num_pending = std::min(total_events - logged_events, history_length);
+    for(int i = 0; i < num_pending; i++) {
+        pending.at(i) = event_history.at((history_start + history_length - num_pending + i) % BALL_TRACKER_HISTORY_SIZE);
+    }
+    logged_events = total_events;
+    lock.exchange( false ); //release lock
+
+    // strings are built after the lock is released so update is never held up
+    Logger logger;
+    log_entry entry;
+    entry.stream = "clog";
+    for(int i = 0; i < num_pending; i++) {
+        entry.content = (
+            "[INFO] " + std::string("INDEXER_BALL_EVENT")
+            + ", Time: " + std::to_string(pending.at(i).time)
+            + ", Event: " + std::to_string(pending.at(i).type)
+            + ", Ball: " + std::to_string(pending.at(i).ball_id)
+            + ", Color: " + std::to_string(pending.at(i).color)
+            + ", Position: " + std::to_string(pending.at(i).position)
+        );
+        logger.add(entry);
+    }
+
+    return num_pending;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file: ./RobotCode/src/objects/subsystems/BallTracker.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a model of where each ball is in the indexer
+ * balls are followed from the filter level to the top of the tower using
+ * upper roller encoder travel and corrected by the ball detector sensors
+ */
+
+#ifndef __BALLTRACKER_HPP__
+#define __BALLTRACKER_HPP__
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+
+
+#define BALL_TRACKER_MAX_BALLS 8      // more than the indexer holds so a ball that was never removed can not fill it
+#define BALL_TRACKER_HISTORY_SIZE 16
+
+
+typedef enum {
+    e_unknown_ball=-1,
+    e_no_ball=0,
+    e_blue_ball=1,
+    e_red_ball=2
+} ball_color;  // same codes as BallDetector::check_filter_level
+
+typedef enum {
+    e_ball_entered,  // ball reached the filter level
+    e_ball_at_top,   // ball reached the top sensor
+    e_ball_scored,   // ball left the top of the indexer
+    e_ball_ejected   // ball was filtered out the back
+} ball_event_type;
+
+typedef struct {
+    ball_event_type type;
+    int ball_id;
+    int color;  // uses the same codes as BallDetector::check_filter_level
+    int time;
+    double position;  // where the ball was when the event happened
+} ball_event;
+
+typedef struct {
+    int id;
+    int color;
+    double position;  // degrees of upper roller travel above the filter level
+} tracked_ball;
+
+
+
+/**
+ * @see: Indexer.hpp
+ *
+ * tracks balls in the indexer and publishes events as they move through it
+ * all sensor reads are done by the caller so that the model can be updated
+ * from wherever the sensors are already being read
+ */
+class BallTracker
+{
+    private:
+        // fixed size so that updating from the indexer task never allocates
+        std::array<tracked_ball, BALL_TRACKER_MAX_BALLS> balls;  // ordered from top to bottom
+        int num_balls;
+        std::array<ball_event, BALL_TRACKER_HISTORY_SIZE> event_history;  // ring buffer of the most recent events
+        int history_start;
+        int history_length;
+        int event_counts[4];
+        int total_events;
+        int logged_events;
+
+        bool prev_top_present;
+        bool prev_middle_present;
+        double prev_upper_position;
+        int prev_time;
+        bool has_position;
+        int next_id;
+
+        double top_position;
+        double eject_travel;
+        double score_travel;
+        double match_window;
+        int detection_lag;
+
+        std::atomic<bool> lock;
+
+        void add_event(ball_event_type type, tracked_ball ball, int time);
+        void add_ball(tracked_ball ball, int time);
+        void remove_ball(int index, ball_event_type type, int time);
+
+    public:
+        /**
+         * @param: double top_travel -> upper roller degrees from the filter level to the top sensor
+         * @param: double eject_distance -> upper roller degrees in reverse for a ball at the filter level to leave the robot
+         * @param: double score_distance -> upper roller degrees past the top sensor for a ball to be scored
+         * @param: int sensor_lag -> ms from a ball reaching a sensor to the detector reporting it, 10 to 20 ms with the BallDetector::start_sampling defaults
+         *
+         * positions are measured from where the filter level sensor first sees a ball
+         */
+        BallTracker(double top_travel=290, double eject_distance=180, double score_distance=120, int sensor_lag=15);
+        ~BallTracker();
+
+        /**
+         * @param: bool top_present -> if the top sensor sees a ball
+         * @param: bool middle_present -> if the filter level sensor sees a ball
+         * @param: int middle_color -> the color of the ball at the filter level from BallDetector::check_filter_level
+         * @param: double upper_position -> the encoder position of the upper roller in degrees
+         * @param: int time -> the time in ms of the reading
+         * @return: None
+         *
+         * advances every tracked ball by the upper roller travel since the last update
+         * and snaps them to sensor positions on sensor transitions
+         * events are published when balls enter, reach the top, score, or are ejected
+         */
+        void update(bool top_present, bool middle_present, int middle_color, double upper_position, int time);
+
+        /**
+         * @param: double upper_position -> the encoder position of the upper roller in degrees
+         * @return: None
+         *
+         * forgets all tracked balls, used when the indexer is cleared by hand
+         */
+        void reset(double upper_position);
+
+        /**
+         * @param: ball_event_type type -> the type of event
+         * @return: int -> the number of events of that type since the tracker was created
+         *
+         * counts only increase so they can be compared against a previous
+         * value to wait for the next event
+         */
+        int get_event_count(ball_event_type type);
+
+        /**
+         * @param: int since_time -> the earliest time in ms to include
+         * @return: std::vector<ball_event> -> the recent events after since_time, oldest first
+         */
+        std::vector<ball_event> get_events(int since_time=0);
+
+        /**
+         * @return: int -> the number of events logged
+         *
+         * logs the events since the last call, update only records events so
+         * that the task running the indexer never builds log strings
+         * should be called from a slower task at least every
+         * BALL_TRACKER_HISTORY_SIZE events, older events are dropped
+         */
+        int log_events();
+
+        int get_ball_count();
+        std::vector<tracked_ball> get_balls();
+};
+
+
+
+#endif
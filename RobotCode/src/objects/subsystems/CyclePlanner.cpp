@@ -0,0 +1,201 @@
+/**
+ * @file: ./RobotCode/src/objects/subsystems/CyclePlanner.cpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * @see: CyclePlanner.hpp
+ *
+ * contains implementation for the tower cycling planner
+ */
+
+#include "CyclePlanner.hpp"
+
+
+
+// a stack of n balls is encoded as (2^n - 1) + bits where bit i is set if
+// the i-th ball from the top is red
+static constexpr int stack_length(std::uint8_t stack) {
+    return stack >= 7 ? 3 : stack >= 3 ? 2 : stack >= 1 ? 1 : 0;
+}
+
+static constexpr int stack_bits(std::uint8_t stack) {
+    return stack - ((1 << stack_length(stack)) - 1);
+}
+
+static constexpr std::uint8_t make_stack(int length, int bits) {
+    return ((1 << length) - 1) + bits;
+}
+
+// removes the ball at index from the top and shifts the balls below it up
+static constexpr std::uint8_t remove_ball(std::uint8_t stack, int index) {
+    int bits = stack_bits(stack);
+    int above = bits & ((1 << index) - 1);
+    int below = (bits >> (index + 1)) << index;
+    return make_stack(stack_length(stack) - 1, above | below);
+}
+
+
+
+static constexpr bool step(cycle_action action, std::uint8_t& indexer, std::uint8_t& tower) {
+    int indexer_length = stack_length(indexer);
+    int tower_length = stack_length(tower);
+    switch(action) {
+        case e_cycle_score: {
+            if(indexer_length == 0 || tower_length == CYCLE_STACK_SIZE) {
+                return false;
+            }
+            int ball = stack_bits(indexer) & 1;
+            indexer = remove_ball(indexer, 0);
+            tower = make_stack(tower_length + 1, (stack_bits(tower) << 1) | ball);
+            return true;
+        } case e_cycle_descore: {
+            // the ball has to reach the filter level for the sensor to confirm it, so
+            // the indexer can not already have balls at the top and the filter level
+            if(tower_length == 0 || indexer_length >= CYCLE_STACK_SIZE - 1) {
+                return false;
+            }
+            int ball = (stack_bits(tower) >> (tower_length - 1)) & 1;
+            tower = remove_ball(tower, tower_length - 1);
+            indexer = make_stack(indexer_length + 1, stack_bits(indexer) | (ball << indexer_length));
+            return true;
+        } case e_cycle_filter: {
+            // the filter sensor is at the second ball, a lone ball is pulled down to it from the top
+            if(indexer_length == 0) {
+                return false;
+            }
+            indexer = remove_ball(indexer, indexer_length > 1 ? 1 : 0);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+// each entry is (steps to goal << 2) | next action, indexed by goal, then indexer, then tower
+typedef std::array<std::uint8_t, CYCLE_NUM_STACKS * CYCLE_NUM_STACKS * CYCLE_NUM_STACKS> cycle_table;
+static constexpr std::uint8_t unreachable = 0xFF;
+
+static constexpr int table_index(std::uint8_t indexer, std::uint8_t tower, std::uint8_t goal) {
+    return (goal * CYCLE_NUM_STACKS + indexer) * CYCLE_NUM_STACKS + tower;
+}
+
+static constexpr cycle_table build_table() {
+    cycle_table table{};
+    for(int i = 0; i < table.size(); i++) {
+        table[i] = unreachable;
+    }
+
+    for(int goal = 0; goal < CYCLE_NUM_STACKS; goal++) {
+        for(int indexer = 0; indexer < CYCLE_NUM_STACKS; indexer++) {
+            table[table_index(indexer, goal, goal)] = 0;
+        }
+
+        // relax every state until no distance improves, the state space is
+        // small enough that this is cheaper to write than a queue
+        bool changed = true;
+        while(changed) {
+            changed = false;
+            for(int indexer = 0; indexer < CYCLE_NUM_STACKS; indexer++) {
+                for(int tower = 0; tower < CYCLE_NUM_STACKS; tower++) {
+                    for(int action = e_cycle_score; action <= e_cycle_filter; action++) {
+                        std::uint8_t next_indexer = indexer;
+                        std::uint8_t next_tower = tower;
+                        if(!step(static_cast<cycle_action>(action), next_indexer, next_tower)) {
+                            continue;
+                        }
+                        std::uint8_t next = table[table_index(next_indexer, next_tower, goal)];
+                        std::uint8_t& current = table[table_index(indexer, tower, goal)];
+                        if(next != unreachable && (current == unreachable || (next >> 2) + 1 < (current >> 2))) {
+                            current = (((next >> 2) + 1) << 2) | action;
+                            changed = true;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+static constexpr cycle_table plan_table = build_table();
+
+// example from cycle_test.py, red in the indexer and blue, blue, red in the tower to red, red
+static_assert((plan_table[table_index(make_stack(1, 0b1), make_stack(3, 0b100), make_stack(2, 0b11))] >> 2) == 5, "cycle plan table is wrong");
+static_assert(plan_table[table_index(0, make_stack(3, 0b000), make_stack(3, 0b111))] == unreachable, "cycle plan table is wrong");
+
+
+
+std::uint8_t CyclePlanner::encode_stack(const std::array<ball_color, CYCLE_STACK_SIZE>& balls) {
+    int length = 0;
+    int bits = 0;
+    for(ball_color ball : balls) {
+        if(ball == e_red_ball) {
+            bits |= 1 << length;
+            length += 1;
+        } else if(ball == e_blue_ball) {
+            length += 1;
+        } else if(ball != e_no_ball) {
+            return CYCLE_INVALID_STACK;
+        }
+    }
+
+    return make_stack(length, bits);
+}
+
+
+
+std::array<ball_color, CYCLE_STACK_SIZE> CyclePlanner::decode_stack(std::uint8_t stack) {
+    std::array<ball_color, CYCLE_STACK_SIZE> balls;
+    balls.fill(e_no_ball);
+    if(stack >= CYCLE_NUM_STACKS) {
+        return balls;
+    }
+
+    for(int i = 0; i < stack_length(stack); i++) {
+        balls.at(i) = ((stack_bits(stack) >> i) & 1) ? e_red_ball : e_blue_ball;
+    }
+
+    return balls;
+}
+
+
+
+bool CyclePlanner::apply_action(cycle_action action, std::uint8_t& indexer, std::uint8_t& tower) {
+    if(indexer >= CYCLE_NUM_STACKS || tower >= CYCLE_NUM_STACKS) {
+        return false;
+    }
+
+    return step(action, indexer, tower);
+}
+
+
+
+int CyclePlanner::get_plan_length(std::uint8_t indexer, std::uint8_t tower, std::uint8_t goal) {
+    if(indexer >= CYCLE_NUM_STACKS || tower >= CYCLE_NUM_STACKS || goal >= CYCLE_NUM_STACKS) {
+        return -1;
+    }
+
+    std::uint8_t entry = plan_table[table_index(indexer, tower, goal)];
+    return entry == unreachable ? -1 : entry >> 2;
+}
+
+
+
+cycle_plan CyclePlanner::plan(std::uint8_t indexer, std::uint8_t tower, std::uint8_t goal) {
+    cycle_plan result;
+    result.length = get_plan_length(indexer, tower, goal);
+    if(result.length < 0) {
+        return result;
+    }
+
+    for(int i = 0; i < result.length; i++) {
+        cycle_action action = static_cast<cycle_action>(plan_table[table_index(indexer, tower, goal)] & 0x03);
+        result.actions.at(i) = action;
+        step(action, indexer, tower);
+    }
+
+    return result;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file: ./RobotCode/src/objects/subsystems/CyclePlanner.hpp
+ * @author: Aiden Carney
+ * @reviewed_on:
+ * @reviewed_by:
+ *
+ * contains a planner for cycling balls through a tower
+ * finds the fewest score, descore, and filter steps to get from the
+ * current indexer and tower contents to a goal tower arrangement
+ */
+
+#ifndef __CYCLEPLANNER_HPP__
+#define __CYCLEPLANNER_HPP__
+
+#include <array>
+#include <cstdint>
+
+#include "BallTracker.hpp"
+
+
+
+#define CYCLE_STACK_SIZE 3  // balls that fit in the tower and in the indexer
+#define CYCLE_PLAN_MAX_LENGTH 16
+#define CYCLE_NUM_STACKS 15  // empty, 2 with one ball, 4 with two balls, and 8 with three balls
+#define CYCLE_INVALID_STACK 0xFF
+
+
+typedef enum {
+    e_cycle_score,    // top ball in the indexer goes into the top of the tower
+    e_cycle_descore,  // bottom ball in the tower is intaked into the bottom of the indexer, only with room for it at the filter level
+    e_cycle_filter    // ball at the filter level is ejected out the back
+} cycle_action;
+
+typedef struct {
+    int length;  // -1 if the goal can not be reached
+    std::array<cycle_action, CYCLE_PLAN_MAX_LENGTH> actions;
+} cycle_plan;
+
+
+
+/**
+ * @see: Indexer.hpp
+ *
+ * the tower and the indexer are each stored as a stack of up to three balls
+ * ordered from top to bottom and encoded into a number from 0 to 14
+ * a lookup table of the next step and remaining steps to every goal is built
+ * at compile time so a plan only costs following the table
+ */
+class CyclePlanner
+{
+    public:
+        /**
+         * @param: std::array<ball_color, CYCLE_STACK_SIZE> balls -> colors from top to bottom, e_no_ball slots are skipped
+         * @return: std::uint8_t -> the encoded stack or CYCLE_INVALID_STACK if a color is unknown
+         */
+        static std::uint8_t encode_stack(const std::array<ball_color, CYCLE_STACK_SIZE>& balls);
+
+        /**
+         * @param: std::uint8_t stack -> the encoded stack
+         * @return: std::array<ball_color, CYCLE_STACK_SIZE> -> colors from top to bottom with empty slots at the end
+         */
+        static std::array<ball_color, CYCLE_STACK_SIZE> decode_stack(std::uint8_t stack);
+
+        /**
+         * @param: cycle_action action -> the step to take
+         * @param: std::uint8_t& indexer -> the encoded indexer contents, updated in place
+         * @param: std::uint8_t& tower -> the encoded tower contents, updated in place
+         * @return: bool -> false if the step is not possible, the stacks are unchanged
+         */
+        static bool apply_action(cycle_action action, std::uint8_t& indexer, std::uint8_t& tower);
+
+        /**
+         * @param: std::uint8_t indexer -> the encoded indexer contents
+         * @param: std::uint8_t tower -> the encoded tower contents
+         * @param: std::uint8_t goal -> the encoded goal tower contents
+         * @return: int -> the fewest steps to reach the goal or -1 if it can not be reached
+         */
+        static int get_plan_length(std::uint8_t indexer, std::uint8_t tower, std::uint8_t goal);
+
+        /**
+         * @param: std::uint8_t indexer -> the encoded indexer contents
+         * @param: std::uint8_t tower -> the encoded tower contents
+         * @param: std::uint8_t goal -> the encoded goal tower contents
+         * @return: cycle_plan -> the steps to take in order, length is -1 if the goal can not be reached
+         *
+         * the goal only constrains the tower, the indexer can hold anything when it is reached
+         */
+        static cycle_plan plan(std::uint8_t indexer, std::uint8_t tower, std::uint8_t goal);
+};
+
+
+
+#endif
@@ -11,23 +11,34 @@
 #include "main.h"
 
 
+#include "../diagnostics/AllocationTracker.hpp"
+#include "../diagnostics/TaskStats.hpp"
 #include "../serial/Logger.hpp"
 #include "../sensors/BallDetector.hpp"
 #include "Indexer.hpp"
 
 int Indexer::num_instances = 0;
-std::queue<indexer_action> Indexer::command_queue;
-std::vector<int> Indexer::commands_finished;
+std::array<indexer_action, INDEXER_COMMAND_QUEUE_SIZE> Indexer::command_queue;
+int Indexer::queue_start = 0;
+int Indexer::queue_length = 0;
+std::array<int, INDEXER_COMMAND_QUEUE_SIZE> Indexer::commands_finished;
+int Indexer::num_finished = 0;
+int Indexer::running_uid = -1;
 std::atomic<bool> Indexer::command_start_lock = ATOMIC_VAR_INIT(false);
 std::atomic<bool> Indexer::command_finish_lock = ATOMIC_VAR_INIT(false);
 
 Motor* Indexer::upper_indexer;
 Motor* Indexer::lower_indexer;
 BallDetector* Indexer::ball_detector;
-std::string Indexer::filter_color;
+BallTracker Indexer::tracker;
+ball_color Indexer::filter_color = e_no_ball;
+int Indexer::max_filter_time = 400;
 
 
-Indexer::Indexer(Motor &upper, Motor &lower, BallDetector &detector, std::string color)
+Indexer::Indexer(Motor &upper, Motor &lower, BallDetector &detector, std::string color) : Indexer(upper, lower, detector, parse_color(color)) { }
+
+
+Indexer::Indexer(Motor &upper, Motor &lower, BallDetector &detector, ball_color color)
 {    
     upper_indexer = &upper;
     lower_indexer = &lower;
@@ -61,22 +72,126 @@ Indexer::~Indexer() {
 
 
 
+void Indexer::update_tracker() {
+    std::uint8_t locations = ball_detector->get_state();
+    int color = ball_detector->check_filter_level();
+    tracker.update(locations & BALL_TOP, locations & BALL_MIDDLE, color, upper_indexer->get_encoder_position(), pros::millis());
+}
+
+
+
+bool Indexer::eject_ball(int timeout) {
+    upper_indexer->set_voltage(-12000); 
+    lower_indexer->set_voltage(12000);
+    
+    // run until the tracker sees the ball leave instead of for a fixed time
+    int ejected = tracker.get_event_count(e_ball_ejected);
+    int start_time = pros::millis();
+    while(tracker.get_event_count(e_ball_ejected) == ejected && pros::millis() - start_time < timeout) {
+        update_tracker();
+        pros::delay(5);
+    }
+    upper_indexer->set_voltage(0); 
+    lower_indexer->set_voltage(0);
+    
+    return tracker.get_event_count(e_ball_ejected) != ejected;
+}
+
+
+
+bool Indexer::score_ball(int timeout) {
+    upper_indexer->set_voltage(12000);  // only the upper roller so the next ball is not pushed up behind it
+    lower_indexer->set_voltage(0);
+    
+    int scored = tracker.get_event_count(e_ball_scored);
+    int start_time = pros::millis();
+    while(tracker.get_event_count(e_ball_scored) == scored && pros::millis() - start_time < timeout) {
+        update_tracker();
+        pros::delay(5);
+    }
+    upper_indexer->set_voltage(0); 
+    
+    return tracker.get_event_count(e_ball_scored) != scored;
+}
+
+
+
+bool Indexer::descore_ball(Intakes* intakes, int timeout) {
+    if(intakes == NULL) {
+        return false;
+    }
+    
+    // a ball is only descored once the filter level sensor sees it, with
+    // balls at the top and the filter level it would stay in the intakes
+    // where it can not be seen
+    std::uint8_t locations = ball_detector->get_state();
+    if((locations & BALL_TOP) && (locations & BALL_MIDDLE)) {
+        return false;
+    }
+    
+    // a ball at the filter level is moved to the top to make room
+    intakes->intake();
+    lower_indexer->set_voltage(12000);
+    upper_indexer->set_voltage((locations & BALL_MIDDLE) ? 12000 : 0);
+    
+    bool filter_level_cleared = !(locations & BALL_MIDDLE);
+    int start_time = pros::millis();
+    bool finished = false;
+    while(!finished && pros::millis() - start_time < timeout) {
+        update_tracker();
+        locations = ball_detector->get_state();
+        if(locations & BALL_TOP) {
+            upper_indexer->set_voltage(0);
+        }
+        if(!(locations & BALL_MIDDLE)) {
+            filter_level_cleared = true;
+        } else if(filter_level_cleared) {  // the descored ball reached the filter level
+            finished = true;
+        }
+        pros::delay(5);
+    }
+    upper_indexer->set_voltage(0);
+    lower_indexer->set_voltage(0);
+    intakes->stop();
+    
+    return finished;
+}
+
+
+
+std::uint8_t Indexer::get_indexer_stack() {
+    std::vector<tracked_ball> balls = tracker.get_balls();  // ordered from top to bottom
+    if(balls.size() > CYCLE_STACK_SIZE) {
+        return CYCLE_INVALID_STACK;
+    }
+    
+    std::array<ball_color, CYCLE_STACK_SIZE> colors;
+    colors.fill(e_no_ball);
+    for(int i = 0; i < balls.size(); i++) {
+        colors.at(i) = balls.at(i).color > 0 ? static_cast<ball_color>(balls.at(i).color) : e_unknown_ball;
+    }
+    
+    return CyclePlanner::encode_stack(colors);
+}
+
+
+
 bool Indexer::auto_filter_ball() {
+    static bool reported_unknown = false;
     int color = ball_detector->check_filter_level();
-    if((color == 1 && filter_color == "blue") || (color == 2 && filter_color == "red")) {  // ball should be filtered
-        upper_indexer->set_voltage(-12000); 
-        lower_indexer->set_voltage(12000);
-        pros::delay(225);  // let ball filter out
-        upper_indexer->set_voltage(0); 
-        lower_indexer->set_voltage(0);
+    if(color > 0 && color == filter_color) {  // ball should be filtered
+        eject_ball(max_filter_time);
         
         return true;  // did filter out ball
-    } else if(color < 0) {  // ball was detected but color could not be determined: print error message and default to intaking
+    } else if(color < 0 && !reported_unknown) {  // ball was detected but color could not be determined: print error message and default to intaking
+        reported_unknown = true;  // only report once per ball so that commands do not build a string every loop
         Logger logger;
         log_entry entry;
         entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", ball was detected but color could not be determined";
         entry.stream = "cerr";
         logger.add(entry);
+    } else if(color >= 0) {
+        reported_unknown = false;
     }
     
     return false;  // did not filter out ball
@@ -86,6 +201,8 @@ bool Indexer::auto_filter_ball() {
 
 
 void Indexer::indexer_motion_task(void*) {
+    AllocationScope allocation_scope(e_alloc_indexer);
+    TaskStats::register_current_task("indexer_thread", 0, TASK_STACK_DEPTH_DEFAULT);  // waits on commands so it has no period
     int end_of_run_time = pros::millis();
     int start_of_run_time = pros::millis();
     bool stagger_state = false;
@@ -94,17 +211,21 @@ void Indexer::indexer_motion_task(void*) {
     while(1) {
         while(1) { // delay unitl there is a command in the queue
             while ( command_start_lock.exchange( true ) ); //aquire lock and release it later if there is stuff in the queue 
-            if(!command_queue.empty()) {
+            if(queue_length > 0) {
                 break;
             }
             
             command_start_lock.exchange( false ); //release lock
+            update_tracker();
             pros::delay(5);
         }
         
-        indexer_action action = command_queue.front(); // lock is already owned
-        command_queue.pop();
+        indexer_action action = command_queue.at(queue_start); // lock is already owned
+        queue_start = (queue_start + 1) % INDEXER_COMMAND_QUEUE_SIZE;
+        queue_length -= 1;
+        running_uid = action.uid;
         command_start_lock.exchange( false ); //release lock
+        update_tracker();
                     
         // execute command
         switch(action.command) {
@@ -131,10 +252,9 @@ void Indexer::indexer_motion_task(void*) {
                 auto_filter_ball();     
                 // fallthrough and index staggered like normal now that it doesn't need to filter
             } case e_staggered_index: {
-                std::cout << end_of_run_time << " " <<  start_of_run_time << " " << pros::millis() << "\n";
-                std::vector<bool> locations = ball_detector->locate_balls();
+                std::uint8_t locations = ball_detector->get_state();
                 
-                if(!locations.at(0)) {  // bring ball to top if it is not there
+                if(!(locations & BALL_TOP)) {  // bring ball to top if it is not there
                     upper_indexer->set_voltage(9000); 
                     lower_indexer->set_voltage(9000);
                 } else if(pros::millis() - end_of_run_time > 300 && pros::millis() - start_of_run_time < 300) {  // 300ms between indexing, index for 300ms
@@ -177,27 +297,101 @@ void Indexer::indexer_motion_task(void*) {
                         auto_filter_ball();  // attempt to filter
                     } 
                     
-                    if(current_state.top != action.args.end_state.top) {
+                    if(current_state.top() != action.args.end_state.top()) {
                         upper_indexer->set_voltage(12000); 
                     }
                     
-                    if(current_state.middle != action.args.end_state.middle) {
+                    if(current_state.middle() != action.args.end_state.middle()) {
                         lower_indexer->set_voltage(12000);   
                     }
                 } while(current_state != action.args.end_state);
                 
+                break;
+            } case e_index_balls: {
+                upper_indexer->set_voltage(12000); 
+                lower_indexer->set_voltage(12000);
+                
+                int scored = tracker.get_event_count(e_ball_scored);
+                int start_time = pros::millis();
+                while(
+                    tracker.get_event_count(e_ball_scored) - scored < action.args.num_balls
+                    && pros::millis() - start_time < action.args.timeout
+                ) {
+                    update_tracker();
+                    pros::delay(5);
+                }
+                
+                upper_indexer->set_voltage(0); 
+                lower_indexer->set_voltage(0);
+                break;
+            } case e_cycle_to: {
+                std::uint8_t indexer_stack = get_indexer_stack();
+                std::uint8_t tower_stack = action.args.tower;
+                cycle_plan plan = CyclePlanner::plan(indexer_stack, tower_stack, action.args.goal);
+                
+                std::string steps;
+                for(int i = 0; i < plan.length; i++) {
+                    steps += std::to_string(plan.actions.at(i));
+                }
+                Logger logger;
+                log_entry entry;
+                entry.content = (
+                    "[INFO] " + std::string("INDEXER_CYCLE_PLAN")
+                    + ", Time: " + std::to_string(pros::millis())
+                    + ", Indexer: " + std::to_string(indexer_stack)
+                    + ", Tower: " + std::to_string(tower_stack)
+                    + ", Goal: " + std::to_string(action.args.goal)
+                    + ", Length: " + std::to_string(plan.length)
+                    + ", Steps: " + steps
+                );
+                entry.stream = "clog";
+                logger.add(entry);
+                
+                int start_time = pros::millis();
+                int steps_taken = 0;
+                while(steps_taken < plan.length) {
+                    int time_left = action.args.timeout - (pros::millis() - start_time);
+                    bool finished = false;
+                    switch(plan.actions.at(steps_taken)) {
+                        case e_cycle_score: {
+                            finished = score_ball(time_left);
+                            break;
+                        } case e_cycle_descore: {
+                            finished = descore_ball(action.args.intakes, time_left);
+                            break;
+                        } case e_cycle_filter: {
+                            finished = eject_ball(std::min(time_left, max_filter_time));
+                            break;
+                        }
+                    }
+                    if(!finished) {  // the model no longer matches the robot so the rest of the plan is wrong
+                        break;
+                    }
+                    CyclePlanner::apply_action(plan.actions.at(steps_taken), indexer_stack, tower_stack);
+                    steps_taken += 1;
+                }
+                
+                entry.content = (
+                    "[INFO] " + std::string("INDEXER_CYCLE_RESULT")
+                    + ", Time: " + std::to_string(pros::millis())
+                    + ", Steps_Taken: " + std::to_string(steps_taken)
+                    + ", Tower: " + std::to_string(tower_stack)
+                    + ", Reached_Goal: " + std::to_string(tower_stack == action.args.goal)
+                    + ", Elapsed_Time: " + std::to_string(pros::millis() - start_time)
+                );
+                logger.add(entry);
                 break;
             } case e_auto_increment: {
                 // try to filter out ball at second level if necessary
                 auto_filter_ball();
                 // fall through to increment
             } case e_increment: {
-                std::vector<bool> locations = ball_detector->locate_balls();
+                std::uint8_t locations = ball_detector->get_state();
                 
-                if(!locations.at(0)) {  // move ball into top position
+                if(!(locations & BALL_TOP)) {  // move ball into top position
                     upper_indexer->set_voltage(12000); 
                     lower_indexer->set_voltage(12000);
-                } else if(locations.at(0) && !locations.at(1)) { // move ball from lowest/no position to middle position
+                } else if((locations & BALL_TOP) && !(locations & BALL_MIDDLE)) { // move ball from lowest/no position to middle position
                     upper_indexer->set_voltage(0); 
                     lower_indexer->set_voltage(12000);
                 } else { // indexer can't do anything to increment so don't run
@@ -231,21 +425,65 @@ void Indexer::indexer_motion_task(void*) {
             }
         }
         
-        if(action.command == e_index_until_filtered || action.command == e_index_to_state || action.command == e_fix_ball) {
+        if(is_waited_on(action.command)) {
             while ( command_finish_lock.exchange( true ) ); //aquire lock
-            commands_finished.push_back(action.uid);
+            if(num_finished == INDEXER_COMMAND_QUEUE_SIZE) {  // nobody collected the oldest uid yet, take_finished still reports it as finished
+                std::copy(commands_finished.begin() + 1, commands_finished.end(), commands_finished.begin());
+                num_finished -= 1;
+            }
+            commands_finished.at(num_finished) = action.uid;
+            num_finished += 1;
             command_finish_lock.exchange( false ); //release lock
+            
+            tracker.log_events();  // waited on commands are not sent every loop so logging here is not on the driver control path
         }
+        
+        while ( command_start_lock.exchange( true ) ); //aquire lock
+        running_uid = -1;
+        command_start_lock.exchange( false ); //release lock
     }
 }
 
 int Indexer::send_command(indexer_command command, indexer_args args /*{}*/) {
-    while ( command_start_lock.exchange( true ) ); //aquire lock
     indexer_action action;
     action.command = command;
     action.args = args;
     action.uid = pros::millis() + lower_indexer->get_actual_voltage() + upper_indexer->get_actual_voltage();
-    command_queue.push(action);
+    
+    bool waited_on = is_waited_on(command);
+    
+    while ( command_start_lock.exchange( true ) ); //aquire lock
+    if(queue_length > 0 && !waited_on) {  // driver control sends commands every loop, skip ones that are already waiting to run
+        indexer_action& last = command_queue.at((queue_start + queue_length - 1) % INDEXER_COMMAND_QUEUE_SIZE);
+        if(last.command == command && last.args.run_lower_roller == args.run_lower_roller) {
+            int uid = last.uid;
+            command_start_lock.exchange( false ); //release lock
+            return uid;
+        }
+    }
+    if(queue_length == INDEXER_COMMAND_QUEUE_SIZE) {  // drop the oldest command nobody waits on so the newest is always run
+        int dropped = 0;
+        while(dropped < queue_length && is_waited_on(command_queue.at((queue_start + dropped) % INDEXER_COMMAND_QUEUE_SIZE).command)) {
+            dropped += 1;
+        }
+        if(dropped == queue_length) {  // every command has a uid someone may wait on, so nothing can be dropped
+            command_start_lock.exchange( false ); //release lock
+            
+            Logger logger;
+            log_entry entry;
+            entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", indexer command queue is full of waited on commands, command " + std::to_string(command) + " was not sent";
+            entry.stream = "cerr";
+            logger.add(entry);
+            
+            return -1;
+        }
+        for(int i = dropped; i < queue_length - 1; i++) {  // close the gap so commands still run in order
+            command_queue.at((queue_start + i) % INDEXER_COMMAND_QUEUE_SIZE) = command_queue.at((queue_start + i + 1) % INDEXER_COMMAND_QUEUE_SIZE);
+        }
+        queue_length -= 1;
+    }
+    command_queue.at((queue_start + queue_length) % INDEXER_COMMAND_QUEUE_SIZE) = action;
+    queue_length += 1;
     command_start_lock.exchange( false ); //release lock
     
     return action.uid;
@@ -294,6 +532,40 @@ int Indexer::index_to_state(bool allow_filter, ball_positions end_state, bool as
     return uid;
 }
 
+int Indexer::index_balls(int num_balls, int timeout /*1500*/, bool asynch /*false*/) {
+    indexer_args args;
+    args.num_balls = num_balls;
+    args.timeout = timeout;
+    int uid = send_command(e_index_balls, args);
+    
+    if(!asynch) {
+        wait_until_finished(uid);
+    }
+    
+    return uid;
+}
+
+int Indexer::cycle_to(
+    const std::array<ball_color, CYCLE_STACK_SIZE>& goal,
+    const std::array<ball_color, CYCLE_STACK_SIZE>& tower,
+    Intakes& intakes,
+    int timeout /*4000*/,
+    bool asynch /*false*/
+) {
+    indexer_args args;
+    args.goal = CyclePlanner::encode_stack(goal);
+    args.tower = CyclePlanner::encode_stack(tower);
+    args.intakes = &intakes;
+    args.timeout = timeout;
+    int uid = send_command(e_cycle_to, args);
+    
+    if(!asynch) {
+        wait_until_finished(uid);
+    }
+    
+    return uid;
+}
+
 void Indexer::increment() {
     send_command(e_increment);
 }
@@ -357,65 +629,104 @@ void Indexer::stop() {
 }
 
 ball_positions Indexer::get_state() {
-    ball_positions state;
-    
-    int color = ball_detector->check_filter_level();
-    std::vector<bool> ball_locations = ball_detector->locate_balls();
-    if(ball_locations.at(0)) {
-        state.top = true;
-    } else {
-        state.top = false;
-    }
-    if(ball_locations.at(1)) {
-        state.middle = true;
-    } else {
-        state.middle = false;
-    }
-    
-    if (color == 0) {
-        state.middle_color = "none";
-    } else if(color == 1) {
-        state.middle_color = "blue";
-    } else if (color == 2) {
-        state.middle_color = "red";
-    } else {
-        state.middle_color = "unknown";
-    }
+    ball_positions state(ball_detector->get_state());
     
     return state;
 }
 
+int Indexer::get_event_count(ball_event_type type) {
+    return tracker.get_event_count(type);
+}
+
+std::vector<ball_event> Indexer::get_events(int since_time /*0*/) {
+    return tracker.get_events(since_time);
+}
+
+int Indexer::get_ball_count() {
+    return tracker.get_ball_count();
+}
+
+int Indexer::log_ball_events() {
+    return tracker.log_events();
+}
+
 void Indexer::reset_command_queue() {
     while ( command_start_lock.exchange( true ) ); //aquire lock
-    std::queue<indexer_action> empty_queue;
-    std::swap( command_queue, empty_queue );  // replace command queue with an empty queue
+    queue_start = 0;
+    queue_length = 0;
     command_start_lock.exchange( false ); //release lock    
 }
 
 
 void Indexer::update_filter_color(std::string new_color) {
+    filter_color = parse_color(new_color);
+}
+
+
+void Indexer::update_filter_color(ball_color new_color) {
     filter_color = new_color;
 }
 
 
-void Indexer::wait_until_finished(int uid) {
-    while(std::find(commands_finished.begin(), commands_finished.end(), uid) == commands_finished.end()) {
-        pros::delay(10);
+ball_color Indexer::parse_color(const std::string& color) {
+    if(color == "red") {
+        return e_red_ball;
+    } else if(color == "blue") {
+        return e_blue_ball;
     }
-    while ( command_finish_lock.exchange( true ) ); //aquire lock
-    commands_finished.erase(std::remove(commands_finished.begin(), commands_finished.end(), uid), commands_finished.end()); 
-    command_finish_lock.exchange( false ); //release lock
+    
+    return e_no_ball;
 }
 
 
-bool Indexer::is_finished(int uid) {
-    if(std::find(commands_finished.begin(), commands_finished.end(), uid) == commands_finished.end()) {
-        return false;  // command is not finished because it is not in the list
+bool Indexer::is_waited_on(indexer_command command) {
+    return command == e_index_until_filtered || command == e_index_to_state || command == e_index_balls || command == e_cycle_to || command == e_fix_ball;
+}
+
+
+// removes uid from the finished commands, returns false if it has not finished yet
+bool Indexer::take_finished(int uid) {
+    if(uid == -1) {  // the command was never sent
+        return true;
     }
     
+    bool finished = false;
     while ( command_finish_lock.exchange( true ) ); //aquire lock
-    commands_finished.erase(std::remove(commands_finished.begin(), commands_finished.end(), uid), commands_finished.end()); 
+    for(int i = 0; i < num_finished; i++) {
+        if(commands_finished.at(i) == uid) {
+            std::copy(commands_finished.begin() + i + 1, commands_finished.begin() + num_finished, commands_finished.begin() + i);
+            num_finished -= 1;
+            finished = true;
+            break;
+        }
+    }
     command_finish_lock.exchange( false ); //release lock
     
-    return true;
+    if(finished) {
+        return true;
+    }
+    
+    // a uid that is not queued or running has finished even if it was pushed
+    // out of the finished list or cleared by reset_command_queue
+    bool pending = false;
+    while ( command_start_lock.exchange( true ) ); //aquire lock
+    pending = (uid == running_uid);
+    for(int i = 0; i < queue_length && !pending; i++) {
+        pending = (command_queue.at((queue_start + i) % INDEXER_COMMAND_QUEUE_SIZE).uid == uid);
+    }
+    command_start_lock.exchange( false ); //release lock
+    
+    return !pending;
+}
+
+
+void Indexer::wait_until_finished(int uid) {
+    while(!take_finished(uid)) {
+        pros::delay(10);
+    }
+}
+
+
+bool Indexer::is_finished(int uid) {
+    return take_finished(uid);
 }
@@ -11,54 +11,55 @@
 #ifndef __INDEXER_HPP__
 #define __INDEXER_HPP__
 
+#include <array>
+#include <cstdint>
 #include <tuple>
-#include <queue>
 
 #include "main.h"
 
 #include "../motors/Motor.hpp"
 #include "../sensors/Sensors.hpp"
 #include "../sensors/BallDetector.hpp"
+#include "BallTracker.hpp"
+#include "CyclePlanner.hpp"
+#include "intakes.hpp"
 
 
 
-struct ball_positions{
-    bool top;
-    bool middle;
-    std::string middle_color;
-    bool operator== (const ball_positions &state) {
-        bool top_equal = (top == state.top);
-        bool middle_equal = (middle == state.middle);
-        bool middle_color_equal;
-        if(middle_color == "present" && state.middle_color != "none") {
-            middle_color_equal = true;
-        } else if (middle_color == "any") {
-            middle_color_equal = true;
-        }else if (middle_color == "red" && state.middle_color == "red") {
-            middle_color_equal = true;
-        } else if (middle_color == "blue" && state.middle_color == "blue") {
-            middle_color_equal = true;
-        } else if (middle_color == "none" && state.middle_color == "none") {
-            middle_color_equal = true;
-        }
-        
-        return (top_equal && middle_equal && middle_color_equal);
+#define INDEXER_COMMAND_QUEUE_SIZE 16
+
+
+// masks of the BallDetector state bits that have to match for two states to be equal
+constexpr std::uint8_t BALL_MATCH_ALL = BALL_TOP | BALL_MIDDLE | BALL_MIDDLE_BLUE | BALL_MIDDLE_RED;
+constexpr std::uint8_t BALL_MATCH_PRESENCE = BALL_TOP | BALL_MIDDLE;  // ignores the color of the middle ball
+
+
+/**
+ * positions of balls in the indexer stored as the BallDetector state bits
+ * with a mask of which bits matter when comparing states
+ */
+struct ball_positions {
+    std::uint8_t state;
+    std::uint8_t mask;
+    
+    constexpr ball_positions(std::uint8_t state_bits=0, std::uint8_t match_mask=BALL_MATCH_ALL) : state(state_bits), mask(match_mask) {}
+    
+    constexpr bool top() const {
+        return state & BALL_TOP;
     }
-    bool operator!= (const ball_positions &state) {
-        bool top_equal = (top == state.top);
-        bool middle_equal = (middle == state.middle);
-        bool middle_color_equal;
-        if(middle_color == "any" && state.middle_color != "none") {
-            middle_color_equal = true;
-        } else if (middle_color == "red" && state.middle_color == "red") {
-            middle_color_equal = true;
-        } else if (middle_color == "blue" && state.middle_color == "blue") {
-            middle_color_equal = true;
-        } else if (middle_color == "none" && state.middle_color == "none") {
-            middle_color_equal = true;
-        }
-        
-        return !(top_equal && middle_equal && middle_color_equal);
+    constexpr bool middle() const {
+        return state & BALL_MIDDLE;
+    }
+    constexpr ball_color middle_color() const {
+        return (state & BALL_MIDDLE_BLUE) ? e_blue_ball : (state & BALL_MIDDLE_RED) ? e_red_ball : (state & BALL_MIDDLE) ? e_unknown_ball : e_no_ball;
+    }
+    
+    // states are equal when every bit that both states care about is the same
+    constexpr bool operator== (const ball_positions &other) const {
+        return ((state ^ other.state) & mask & other.mask) == 0;
+    }
+    constexpr bool operator!= (const ball_positions &other) const {
+        return !(*this == other);
     }
 };
 
@@ -73,6 +74,8 @@ typedef enum e_indexer_command {
     e_increment,
     e_auto_increment,
     e_index_to_state,
+    e_index_balls,
+    e_cycle_to,
     e_fix_ball,
     e_run_upper,
     e_run_lower,
@@ -82,9 +85,14 @@ typedef enum e_indexer_command {
 } indexer_command;
 
 typedef struct {
-    bool run_lower_roller;
+    bool run_lower_roller=true;
     ball_positions end_state;
-    bool allow_filter;
+    bool allow_filter=false;
+    int num_balls=0;
+    int timeout=0;
+    std::uint8_t tower=0;  // encoded CyclePlanner stacks
+    std::uint8_t goal=0;
+    Intakes* intakes=NULL;
 }indexer_args;
 
 typedef struct {
@@ -104,23 +112,44 @@ class Indexer
         static Motor *upper_indexer;
         static Motor *lower_indexer;
         static BallDetector *ball_detector;
-        static std::string filter_color;
+        static BallTracker tracker;
+        static ball_color filter_color;
+        static int max_filter_time;
         
         static int num_instances;
                 
         pros::Task *thread;  // the motor thread
-        static std::queue<indexer_action> command_queue;
-        static std::vector<int> commands_finished;
+        static std::array<indexer_action, INDEXER_COMMAND_QUEUE_SIZE> command_queue;  // ring buffer so commands never allocate
+        static int queue_start;
+        static int queue_length;
+        static std::array<int, INDEXER_COMMAND_QUEUE_SIZE> commands_finished;  // uids of waited on commands, oldest first
+        static int num_finished;
+        static int running_uid;  // uid of the command the task is running, -1 when it is waiting for one
         static std::atomic<bool> command_start_lock;
         static std::atomic<bool> command_finish_lock;
         
+        /**
+         * @param: indexer_command command -> the command to run
+         * @param: indexer_args args -> what the command runs with
+         * @return: int -> the uid of the command, -1 if the queue is full of waited on commands
+         *
+         * when the queue is full the oldest command nobody waits on is dropped
+         */
         int send_command(indexer_command command, indexer_args args={});
+        static bool is_waited_on(indexer_command command);
+        static bool take_finished(int uid);
 
+        static void update_tracker();
+        static bool eject_ball(int timeout);
+        static bool score_ball(int timeout);
+        static bool descore_ball(Intakes* intakes, int timeout);
+        static std::uint8_t get_indexer_stack();
         static bool auto_filter_ball();
         static void indexer_motion_task(void*);
                 
     public:
         Indexer(Motor &upper, Motor &lower, BallDetector &detector, std::string color);
+        Indexer(Motor &upper, Motor &lower, BallDetector &detector, ball_color color);
         ~Indexer();
     
         void index(bool run_lower=true);
@@ -132,6 +161,39 @@ class Indexer
         int index_until_filtered(bool asynch=false);
         int index_to_state(bool allow_filter, ball_positions end_state, bool asynch=false);
         
+        /**
+         * @param: int num_balls -> the number of balls to score
+         * @param: int timeout -> the max time in ms to run for
+         * @param: bool asynch -> if the function should wait for the balls to be scored
+         * @return: int -> the uid of the command
+         *
+         * runs the indexer until the ball tracker sees the given number of
+         * balls leave the top of the indexer
+         */
+        int index_balls(int num_balls, int timeout=1500, bool asynch=false);
+        
+        /**
+         * @param: std::array<ball_color, CYCLE_STACK_SIZE> goal -> the tower colors to end with from top to bottom
+         * @param: std::array<ball_color, CYCLE_STACK_SIZE> tower -> the tower colors now from top to bottom
+         * @param: Intakes& intakes -> used to pull balls out of the bottom of the tower
+         * @param: int timeout -> the max time in ms to run for
+         * @param: bool asynch -> if the function should wait for the tower to be cycled
+         * @return: int -> the uid of the command
+         *
+         * plans the fewest score, descore, and filter steps from the balls
+         * in the indexer when the command starts and runs them in order
+         * the tower has to be in front of the robot, the command stops early
+         * if a step does not finish or the contents of the indexer are unknown
+         * @see: CyclePlanner.hpp
+         */
+        int cycle_to(
+            const std::array<ball_color, CYCLE_STACK_SIZE>& goal,
+            const std::array<ball_color, CYCLE_STACK_SIZE>& tower,
+            Intakes& intakes,
+            int timeout=4000,
+            bool asynch=false
+        );
+        
         void increment();
         void auto_increment();
         
@@ -146,10 +208,43 @@ class Indexer
         void stop();
 
         static ball_positions get_state();
+        
+        /**
+         * @param: ball_event_type type -> the type of event
+         * @return: int -> the number of events of that type seen so far
+         *
+         * @see: BallTracker.hpp
+         */
+        static int get_event_count(ball_event_type type);
+        static std::vector<ball_event> get_events(int since_time=0);
+        static int get_ball_count();
+        
+        /**
+         * @return: int -> the number of ball events logged
+         *
+         * the indexer task only records ball events, this logs them from
+         * whichever task calls it
+         * @see: BallTracker::log_events
+         */
+        static int log_ball_events();
 
         void reset_command_queue();
         void update_filter_color(std::string new_color);
+        void update_filter_color(ball_color new_color);
+        
+        /**
+         * @param: std::string color -> "red", "blue", or anything else for no color
+         * @return: ball_color -> the matching color
+         */
+        static ball_color parse_color(const std::string& color);
         
+        /**
+         * @param: int uid -> the uid a command returned
+         * @return: None
+         *
+         * returns right away for a uid of -1 or a command that was cleared
+         * from the queue since it will never run
+         */
         void wait_until_finished(int uid);
         bool is_finished(int uid);
 
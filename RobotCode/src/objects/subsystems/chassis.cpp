@@ -17,6 +17,9 @@
 #include "main.h"
 #include "okapi/api.hpp"
 
+#include "../diagnostics/AllocationTracker.hpp"
+#include "../diagnostics/TaskStats.hpp"
+#include "../diagnostics/Telemetry.hpp"
 #include "../serial/Logger.hpp"
 #include "../position_tracking/PositionTracker.hpp"
 #include "chassis.hpp"
@@ -40,7 +43,7 @@ std::vector<double> generate_chassis_velocity_profile(int encoder_ticks, const s
         throw std::invalid_argument("Cannot generate profile with negative or 0 encoder ticks");
     }
     
-    if(max_decceleration || max_acceleration == 0) {
+    if(max_decceleration <= 0) {
         Logger logger;
         log_entry entry;
         entry.content = (
@@ -80,11 +83,95 @@ std::vector<double> generate_chassis_velocity_profile(int encoder_ticks, const s
 
 
 
+double trapezoidal_profile_duration(double distance, double max_velocity, double max_acceleration) {
+    double abs_distance = std::abs(distance);
+    double t_accel = max_velocity / max_acceleration;
+    double d_accel = 0.5 * max_acceleration * t_accel * t_accel;
+    
+    if(2 * d_accel >= abs_distance) {  // triangular profile, never reaches max velocity
+        return 2 * std::sqrt(abs_distance / max_acceleration);
+    }
+    
+    return (2 * t_accel) + ((abs_distance - (2 * d_accel)) / max_velocity);
+}
+
+
+
+profile_point sample_trapezoidal_profile(double distance, double max_velocity, double max_acceleration, double t) {
+    double abs_distance = std::abs(distance);
+    int direction = distance < 0 ? -1 : 1;
+    
+    // find the peak velocity and how long each segment of the profile lasts
+    double t_accel = max_velocity / max_acceleration;
+    double d_accel = 0.5 * max_acceleration * t_accel * t_accel;
+    double peak_velocity = max_velocity;
+    if(2 * d_accel >= abs_distance) {
+        t_accel = std::sqrt(abs_distance / max_acceleration);
+        d_accel = abs_distance / 2;
+        peak_velocity = max_acceleration * t_accel;
+    }
+    double t_cruise = (abs_distance - (2 * d_accel)) / peak_velocity;
+    double t_total = (2 * t_accel) + t_cruise;
+    
+    profile_point point;
+    if(t <= 0) {
+        point.position = 0;
+        point.velocity = 0;
+        point.acceleration = 0;
+    } else if(t < t_accel) {  // accelerating
+        point.position = 0.5 * max_acceleration * t * t;
+        point.velocity = max_acceleration * t;
+        point.acceleration = max_acceleration;
+    } else if(t < t_accel + t_cruise) {  // cruising
+        point.position = d_accel + (peak_velocity * (t - t_accel));
+        point.velocity = peak_velocity;
+        point.acceleration = 0;
+    } else if(t < t_total) {  // deccelerating
+        double t_left = t_total - t;
+        point.position = abs_distance - (0.5 * max_acceleration * t_left * t_left);
+        point.velocity = max_acceleration * t_left;
+        point.acceleration = -max_acceleration;
+    } else {  // profile is finished
+        point.position = abs_distance;
+        point.velocity = 0;
+        point.acceleration = 0;
+    }
+    
+    point.position *= direction;
+    point.velocity *= direction;
+    point.acceleration *= direction;
+    
+    return point;
+}
+
+
+
+// a proportional controller drives at its limit until the error is small
+// enough for the gain to bring it under the limit, then the error decays
+// exponentially until the velocity drops under the velocity it settles at
+// gain is velocity per unit of error, so 1 / gain is the time constant of the decay
+static double p_controller_duration(double distance, double max_velocity, double max_acceleration, double gain, double settle_velocity) {
+    double abs_distance = std::abs(distance);
+    double peak_velocity = std::min(max_velocity, gain * abs_distance);
+    if(peak_velocity <= settle_velocity) {
+        return 0;
+    }
+    
+    double decay_distance = peak_velocity / gain;
+    double duration = (abs_distance - decay_distance) / peak_velocity;
+    duration += peak_velocity / (2 * max_acceleration);  // time lost getting up to speed
+    duration += std::log(peak_velocity / settle_velocity) / gain;
+    
+    return duration;
+}
+
+
 int Chassis::num_instances = 0;
 std::queue<chassis_action> Chassis::command_queue;
 std::vector<int> Chassis::commands_finished;
 std::atomic<bool> Chassis::command_start_lock = ATOMIC_VAR_INIT(false);
 std::atomic<bool> Chassis::command_finish_lock = ATOMIC_VAR_INIT(false);
+std::atomic<bool> Chassis::cancel_running = ATOMIC_VAR_INIT(false);
 
 Motor* Chassis::front_left_drive;
 Motor* Chassis::front_right_drive;
@@ -100,6 +187,29 @@ double Chassis::wheel_diameter;
 pid_gains Chassis::pos_gains = {0.77, 0.000002, 7, INT32_MAX, 0.2};
 pid_gains Chassis::heading_gains = {0.05, 0, 0, INT32_MAX, INT32_MAX};
 pid_gains Chassis::turn_gains = {2.8, 0.0005, 50, INT32_MAX, 15};
+profiled_turn_constants Chassis::profiled_turn_limits;
+trajectory_follower_constants Chassis::follower_constants;
+chassis_characterization Chassis::characterization;
+
+std::unordered_map<int, int> Chassis::predicted_durations;
+std::unordered_map<int, int> Chassis::expected_finish_times;
+int Chassis::queue_finish_time = 0;
+std::atomic<bool> Chassis::estimate_lock = ATOMIC_VAR_INIT(false);
+
+std::array<chassis_plan_step, CHASSIS_PLAN_MAX_STEPS> Chassis::plan;
+std::array<double, CHASSIS_PLAN_PROFILE_SIZE> Chassis::plan_profiles;
+int Chassis::plan_size = 0;
+int Chassis::plan_profiles_used = 0;
+int Chassis::plan_cursor = 0;
+
+FieldModel Chassis::field_model;
+PathPlanner Chassis::path_planner(Chassis::field_model);
+bool Chassis::field_model_built = false;
+std::array<Trajectory, CHASSIS_PLANNED_TRAJECTORIES> Chassis::planned_trajectories;
+std::array<int, CHASSIS_PLANNED_TRAJECTORIES> Chassis::planned_uids = {-1, -1, -1, -1};
+int Chassis::num_planned_trajectories = 0;
+int Chassis::last_pushed_uid = -1;
+int Chassis::last_planned_uid = -1;
 
 
 
@@ -234,7 +344,199 @@ double Chassis::get_angle_to_turn(double theta) {
 
 
 
+std::vector<double> Chassis::get_straight_drive_profile(double encoder_ticks, int max_velocity) {
+    auto accel_func = [](double n) -> double { return 0.005 * n; };
+    // auto accel_func = [](double n) -> double { return 1; };
+    return generate_chassis_velocity_profile(std::abs(encoder_ticks), accel_func, .55, max_velocity, 50);  // .55 is decceleration, 50 is initial velocity
+}
+
+
+
+int Chassis::estimate_duration(chassis_commands command, chassis_params args) {
+    double ticks_per_rpm = characterization.ticks_per_rpm;
+    double max_acceleration = characterization.max_linear_acceleration;
+    double duration = 0;  // seconds
+    
+    switch(command) {
+        case e_pid_straight_drive: {
+            double ticks = std::max(std::abs(args.setpoint1), std::abs(args.setpoint2));
+            double acceleration = std::min(max_acceleration, args.motor_slew * 1000 * ticks_per_rpm);  // slew is in rpm/ms
+            double gain = pos_gains.kP * ticks_per_rpm;  // kP is rpm per tick of error
+            duration = p_controller_duration(ticks, args.max_velocity * ticks_per_rpm, acceleration, gain, CHASSIS_SETTLE_VELOCITY * ticks_per_rpm);
+            duration += CHASSIS_SETTLE_HISTORY / 1000.0;
+            break;
+        } case e_okapi_pid_straight_drive: {
+            double max_velocity = args.max_voltage * characterization.rpm_per_millivolt * ticks_per_rpm;
+            double gain = CHASSIS_OKAPI_DRIVE_KP * max_velocity;  // the output of the controller is a fraction of max_voltage
+            duration = p_controller_duration(args.setpoint1, max_velocity, max_acceleration, gain, CHASSIS_SETTLE_VELOCITY * ticks_per_rpm);
+            duration += CHASSIS_SETTLE_HISTORY / 1000.0;
+            break;
+        } case e_profiled_straight_drive: {
+            if(std::abs(args.setpoint1) < 1) {
+                break;
+            }
+            std::vector<double> profile = get_straight_drive_profile(args.setpoint1, args.max_velocity);
+            duration = get_profile_duration(profile.data(), args.setpoint1);
+            duration += characterization.pid_settle_time / 1000.0;
+            break;
+        } case e_turn: {
+            duration = estimate_pid_turn_duration(args.setpoint1, args.max_velocity);
+            break;
+        } case e_profiled_turn: {
+            duration = predict_profiled_turn_time(args.setpoint1, args.max_velocity) / 1000.0;
+            break;
+        } case e_drive_to_point: {
+            PositionTracker* tracker = PositionTracker::get_instance();
+            long double dx = args.setpoint1 - tracker->get_position().x_pos;
+            long double dy = args.setpoint2 - tracker->get_position().y_pos;
+            
+            chassis_params turn_args;
+            turn_args.setpoint1 = get_angle_to_turn(args.setpoint1, args.setpoint2, args.explicit_direction);
+            turn_args.max_velocity = args.max_velocity;
+            
+            chassis_params drive_args;  // waypoints are driven to with the default voltage
+            drive_args.setpoint1 = tracker->to_encoder_ticks(std::sqrt((dx * dx) + (dy * dy)), wheel_diameter);
+            
+            duration = (estimate_duration(e_turn, turn_args) + estimate_duration(e_okapi_pid_straight_drive, drive_args)) / 1000.0;
+            duration += args.recalculations * 2 * characterization.pid_settle_time / 1000.0;  // each recalculation is a small turn and drive
+            break;
+        } case e_turn_to_point: {
+            chassis_params turn_args;
+            turn_args.setpoint1 = get_angle_to_turn(args.setpoint1, args.setpoint2);
+            turn_args.max_velocity = args.max_velocity;
+            duration = estimate_duration(e_turn, turn_args) / 1000.0;
+            break;
+        } case e_turn_to_angle: {
+            chassis_params turn_args;
+            turn_args.setpoint1 = get_angle_to_turn(args.setpoint1);
+            turn_args.max_velocity = args.max_velocity;
+            duration = estimate_duration(e_turn, turn_args) / 1000.0;
+            break;
+        } case e_follow_trajectory: {
+            if(args.trajectory != NULL) {
+                duration = args.trajectory->get_duration();
+            }
+            break;
+        }
+    }
+    
+    return duration * 1000;
+}
+
+
+
+// t_turn has no profile, so its control law is stepped against a drive that
+// turns at the characterized rate for the velocity it is given
+// t_turn measures slew from 0 every loop, which caps its velocity at
+// dt * slew instead of limiting its acceleration, and the velocity is
+// truncated to a whole rpm like it is by move_velocity
+double Chassis::estimate_pid_turn_duration(double degrees, int max_velocity) {
+    pid_gains gains = turn_gains;
+    int dt = 10;  // ms, the loop rate of t_turn
+    std::array<double, 15> error_history;  // same length as the history t_turn settles on
+    int history_size = 0;
+    
+    double angle = 0;
+    double integral = 0;
+    double prev_error = 0;
+    int t = 0;
+    for(; t < CHASSIS_TURN_ESTIMATE_LIMIT; t += dt) {
+        double error = degrees - angle;
+        integral = std::clamp(integral + (error * dt), -gains.I_max, gains.I_max);
+        double derivative = error - prev_error;
+        prev_error = error;
+        
+        double velocity = (gains.kP * error) + (gains.kI * integral) + (gains.kD * derivative);
+        if(std::abs(velocity) > dt * gains.motor_slew) {
+            velocity = velocity > 0 ? dt * gains.motor_slew : -dt * gains.motor_slew;
+        }
+        velocity = std::clamp<double>(velocity, -max_velocity, max_velocity);
+        velocity = static_cast<int>(velocity);
+        
+        error_history.at(history_size % error_history.size()) = error;
+        history_size += 1;
+        if(history_size >= error_history.size() && t > 500) {
+            auto limits = std::minmax_element(error_history.begin(), error_history.end());
+            if(*limits.second - *limits.first < .007) {
+                break;
+            }
+        }
+        
+        angle += (velocity / characterization.rpm_per_degree_per_second) * (dt / 1000.0);
+    }
+    
+    return t / 1000.0;
+}
+
+
+// the profile is indexed by tick, so sum the time in seconds spent on each tick
+double Chassis::get_profile_duration(const double* profile, double encoder_ticks) {
+    double duration = 0;
+    for(int i = 0; i < std::abs(encoder_ticks); i++) {
+        duration += 1 / (std::max(profile[i], 1.0) * characterization.ticks_per_rpm);
+    }
+    
+    return duration;
+}
+
+
+
+int Chassis::default_timeout(int predicted_duration) {
+    return (predicted_duration * characterization.timeout_scale) + characterization.timeout_margin;
+}
+
+
+
+// moves the expected finish time of a command and shifts every command queued
+// after it by the same amount, estimate_lock must be held by the caller
+void Chassis::set_expected_finish_time(int uid, int finish_time) {
+    if(expected_finish_times.find(uid) == expected_finish_times.end()) {
+        expected_finish_times[uid] = finish_time;
+        return;
+    }
+    
+    int previous_finish_time = expected_finish_times.at(uid);
+    int shift = finish_time - previous_finish_time;
+    for(auto& command : expected_finish_times) {
+        if(command.second > previous_finish_time) {
+            command.second += shift;
+        }
+    }
+    expected_finish_times[uid] = finish_time;
+    if(queue_finish_time >= previous_finish_time) {
+        queue_finish_time += shift;
+    }
+}
+
+
+
+void Chassis::push_command(chassis_action command) {
+    match_plan_step(command);
+    int predicted_duration;
+    if(command.args.plan_step != -1 && plan.at(command.args.plan_step).predicted_duration != -1) {
+        predicted_duration = plan.at(command.args.plan_step).predicted_duration;
+    } else {
+        predicted_duration = estimate_duration(command.command, command.args);
+    }
+    
+    while ( estimate_lock.exchange( true ) ); //aquire lock
+    int start_time = std::max(queue_finish_time, (int)pros::millis());
+    queue_finish_time = start_time + predicted_duration;
+    predicted_durations[command.command_uid] = predicted_duration;
+    expected_finish_times[command.command_uid] = queue_finish_time;
+    estimate_lock.exchange( false ); //release lock
+    
+    while ( command_start_lock.exchange( true ) ); //aquire lock
+    command_queue.push(command);
+    last_pushed_uid = command.command_uid;
+    command_start_lock.exchange( false ); //release lock
+}
+
+
+
 void Chassis::chassis_motion_task(void*) {
+    AllocationScope allocation_scope(e_alloc_chassis);
+    TaskStats::register_current_task("chassis_thread", 0, TASK_STACK_DEPTH_DEFAULT);  // waits on commands so it has no period
     while(1) {
         while(1) { // delay unitl there is a command in the queue
             while ( command_start_lock.exchange( true ) ); //aquire lock and release it later
@@ -248,8 +550,27 @@ void Chassis::chassis_motion_task(void*) {
         
         chassis_action action = command_queue.front();
         command_queue.pop();
+        cancel_running = false;  // a cancel from before this command was popped was for an earlier one
         command_start_lock.exchange( false ); //release lock
         
+        // re-estimate now that the starting position is known and use it
+        // for the timeout if one was not given, planned estimates do not
+        // depend on the starting position so they are used as is
+        int predicted_duration;
+        if(action.args.plan_step != -1 && plan.at(action.args.plan_step).predicted_duration != -1) {
+            predicted_duration = plan.at(action.args.plan_step).predicted_duration;
+        } else {
+            predicted_duration = estimate_duration(action.command, action.args);
+        }
+        if(action.args.timeout == INT32_MAX) {
+            action.args.timeout = default_timeout(predicted_duration);
+        }
+        int start_time = pros::millis();
+        while ( estimate_lock.exchange( true ) ); //aquire lock
+        predicted_durations[action.command_uid] = predicted_duration;
+        set_expected_finish_time(action.command_uid, start_time + predicted_duration);
+        estimate_lock.exchange( false ); //release lock
+        
         // execute command
         switch(action.command) {
             case e_pid_straight_drive:
@@ -264,6 +585,9 @@ void Chassis::chassis_motion_task(void*) {
             case e_turn:
                 t_turn(action.args);
                 break;
+            case e_profiled_turn:
+                t_profiled_turn(action.args);
+                break;
             case e_drive_to_point: {
                 PositionTracker* tracker = PositionTracker::get_instance();
                 std::vector<waypoint> waypoints;  // calculate waypoints based on starting position
@@ -311,7 +635,7 @@ void Chassis::chassis_motion_task(void*) {
                 
                 int start = pros::millis();
                 for(waypoint point : waypoints) {  // move to each generated waypoint
-                    if(pros::millis() - start > action.args.timeout) {  // end early if past the timeout point
+                    if(pros::millis() - start > action.args.timeout || cancel_running) {  // end early if past the timeout point
                         break;
                     }
                     t_move_to_waypoint(action.args, point);
@@ -326,7 +650,7 @@ void Chassis::chassis_motion_task(void*) {
                 chassis_params turn_args;
                 turn_args.setpoint1 = to_turn;
                 turn_args.max_velocity = action.args.max_velocity;
-                turn_args.timeout = action.args.timeout; // TODO: add time estimation
+                turn_args.timeout = action.args.timeout;
                 turn_args.log_data = action.args.log_data;
                 
                 t_turn(turn_args);
@@ -356,7 +680,7 @@ void Chassis::chassis_motion_task(void*) {
                 chassis_params turn_args;
                 turn_args.setpoint1 = to_turn;
                 turn_args.max_velocity = action.args.max_velocity;
-                turn_args.timeout = action.args.timeout; // TODO: add time estimation
+                turn_args.timeout = action.args.timeout;
                 turn_args.motor_slew = action.args.motor_slew;
                 turn_args.log_data = action.args.log_data;
 
@@ -379,9 +703,30 @@ void Chassis::chassis_motion_task(void*) {
                 t_turn(turn_args);
                 
                 break;
-            }
+            } case e_follow_trajectory:
+                t_follow_trajectory(action.args);
+                break;
         }
         
+        int end_time = pros::millis();
+        while ( estimate_lock.exchange( true ) ); //aquire lock
+        set_expected_finish_time(action.command_uid, end_time);
+        estimate_lock.exchange( false ); //release lock
+        
+        Logger logger;
+        log_entry entry;
+        entry.content = (
+            "[INFO] " + std::string("CHASSIS_COMMAND_DURATION")
+            + ", Time: " + std::to_string(end_time)
+            + ", Command: " + std::to_string(action.command)
+            + ", Uid: " + std::to_string(action.command_uid)
+            + ", Predicted_Time: " + std::to_string(predicted_duration)
+            + ", Actual_Time: " + std::to_string(end_time - start_time)
+            + ", Timeout: " + std::to_string(action.args.timeout)
+        );
+        entry.stream = "clog";
+        logger.add(entry);
+        
         while ( command_finish_lock.exchange( true ) ); //aquire lock
         commands_finished.push_back(action.command_uid);
         command_finish_lock.exchange( false ); //release lock
@@ -441,6 +786,10 @@ void Chassis::t_pid_straight_drive(chassis_params args) {
     bool use_integral_l = true;
     bool use_integral_r = true;
     
+    int left_error_signal = Telemetry::add_signal("chassis left error", 10);
+    int right_error_signal = Telemetry::add_signal("chassis right error", 10);
+    int heading_error_signal = Telemetry::add_signal("chassis heading error", 10);
+    
     int current_time = pros::millis();
     int start_time = current_time;
 
@@ -449,6 +798,8 @@ void Chassis::t_pid_straight_drive(chassis_params args) {
         // pid distance controller
         double error_l = args.setpoint1 - std::get<0>(Sensors::get_average_encoders(l_id, r_id));
         double error_r = args.setpoint2 - std::get<1>(Sensors::get_average_encoders(l_id, r_id));
+        Telemetry::log(left_error_signal, error_l);
+        Telemetry::log(right_error_signal, error_r);
 
         if ( std::abs(integral_l) > I_max_l || !use_integral_l) {
             integral_l = 0;  // reset integral if greater than max allowable value
@@ -478,7 +829,7 @@ void Chassis::t_pid_straight_drive(chassis_params args) {
     // slew rate code
         double delta_velocity_l = left_velocity - prev_velocity_l;
         double delta_velocity_r = right_velocity - prev_velocity_r;
-        double slew_rate = pos_gains.motor_slew;
+        double slew_rate = args.motor_slew;
         if(std::abs(delta_velocity_l) > (dt * slew_rate) && (std::signbit(delta_velocity_l) == std::signbit(left_velocity)) ) {  // ignore deceleration
             if(delta_velocity_l == 0) {
                 std::cout << "delta_velocity_l was equal to 0\n";
@@ -518,6 +869,7 @@ void Chassis::t_pid_straight_drive(chassis_params args) {
         
         
         double heading_error = 0 - relative_angle;  // 0 is the setpoint because we want to drive straight
+        Telemetry::log(heading_error_signal, heading_error);
         integral_heading = integral_heading + (heading_error * dt);
         double d_heading_error = heading_error - prev_heading_error;
         prev_heading_error = heading_error;
@@ -605,7 +957,7 @@ void Chassis::t_pid_straight_drive(chassis_params args) {
         back_right_drive->move_velocity(right_velocity);
 
         pros::delay(10);
-    } while ( pros::millis() < start_time + args.timeout ); 
+    } while ( pros::millis() < start_time + args.timeout && !cancel_running ); 
     
     front_left_drive->set_motor_mode(e_voltage);
     front_right_drive->set_motor_mode(e_voltage);
@@ -630,8 +982,8 @@ void Chassis::t_pid_straight_drive(chassis_params args) {
 void Chassis::t_okapi_pid_straight_drive(chassis_params args) {
     PositionTracker* tracker = PositionTracker::get_instance();
     int start_time = pros::millis();
-    auto pos_r_controller = okapi::IterativeControllerFactory::posPID(.0015, 0, 0);
-    auto pos_l_controller = okapi::IterativeControllerFactory::posPID(.0015, 0, 0);
+    auto pos_r_controller = okapi::IterativeControllerFactory::posPID(CHASSIS_OKAPI_DRIVE_KP, 0, 0);
+    auto pos_l_controller = okapi::IterativeControllerFactory::posPID(CHASSIS_OKAPI_DRIVE_KP, 0, 0);
     auto heading_controller = okapi::IterativeControllerFactory::posPID(0.001, 0, 0);
     pos_l_controller.setTarget(args.setpoint1);
     pos_r_controller.setTarget(args.setpoint1);
@@ -658,7 +1010,7 @@ void Chassis::t_okapi_pid_straight_drive(chassis_params args) {
     std::vector<double> previous_r_velocities;
     int velocity_history = 15;
 
-    while (pros::millis() < start_time + args.timeout) {
+    while (pros::millis() < start_time + args.timeout && !cancel_running) {
         abs_angle = tracker->get_heading_rad();
         abs_angle = std::atan2(std::sin(abs_angle), std::cos(abs_angle));
         long double delta_theta;
@@ -767,9 +1119,15 @@ void Chassis::t_profiled_straight_drive(chassis_params args) {
     std::vector<double> previous_r_velocities;
     int velocity_history = 15;
     
-    auto accel_func = [](double n) -> double { return 0.005 * n; };
-    // auto accel_func = [](double n) -> double { return 1; };
-    std::vector<double> velocity_profile = generate_chassis_velocity_profile(std::abs(args.setpoint1), accel_func, .55, args.max_velocity, 50);  // .45 is decceleration, 10 is initial velocity
+    // a planned profile is already in the plan buffer, otherwise make it now
+    std::vector<double> generated_profile;
+    const double* velocity_profile;
+    if(args.plan_step != -1 && plan.at(args.plan_step).profile_offset != -1) {
+        velocity_profile = &plan_profiles.at(plan.at(args.plan_step).profile_offset);
+    } else {
+        generated_profile = get_straight_drive_profile(args.setpoint1, args.max_velocity);
+        velocity_profile = generated_profile.data();
+    }
     
     do {
         int dt = pros::millis() - current_time;
@@ -778,14 +1136,14 @@ void Chassis::t_profiled_straight_drive(chassis_params args) {
         double velocity_l;
         double velocity_r;
         if(std::abs(std::get<0>(Sensors::get_average_encoders(l_id, r_id))) <= std::abs(args.setpoint1)) {
-            velocity_l = velocity_profile.at(std::abs(std::get<0>(Sensors::get_average_encoders(l_id, r_id))));
+            velocity_l = velocity_profile[static_cast<int>(std::abs(std::get<0>(Sensors::get_average_encoders(l_id, r_id))))];
         } else {
             was_at_target_l = true;
             velocity_l = 0;
         }
         
         if(std::abs(std::get<1>(Sensors::get_average_encoders(l_id, r_id))) <= std::abs(args.setpoint1)) {
-            velocity_r = velocity_profile.at(std::abs(std::get<1>(Sensors::get_average_encoders(l_id, r_id))));
+            velocity_r = velocity_profile[static_cast<int>(std::abs(std::get<1>(Sensors::get_average_encoders(l_id, r_id))))];
         } else {
             was_at_target_l = true;
             velocity_r = 0;
@@ -930,7 +1288,7 @@ void Chassis::t_profiled_straight_drive(chassis_params args) {
         back_right_drive->move_velocity(velocity_r);
         
         pros::delay(10);
-    } while (pros::millis() < start_time + args.timeout); 
+    } while (pros::millis() < start_time + args.timeout && !cancel_running); 
     
     front_left_drive->set_motor_mode(e_voltage);
     front_right_drive->set_motor_mode(e_voltage);
@@ -1161,7 +1519,7 @@ void Chassis::t_turn(chassis_params args) {
     
 
         pros::delay(10);
-    } while ( pros::millis() < (start_time + args.timeout) ); 
+    } while ( pros::millis() < (start_time + args.timeout) && !cancel_running ); 
     
     front_left_drive->set_motor_mode(e_voltage);
     front_right_drive->set_motor_mode(e_voltage);
@@ -1184,6 +1542,148 @@ void Chassis::t_turn(chassis_params args) {
 
 
 
+void Chassis::t_profiled_turn(chassis_params args) {
+    PositionTracker* tracker = PositionTracker::get_instance();
+    
+    profiled_turn_constants limits = profiled_turn_limits;
+    double max_angular_velocity = std::min(limits.max_angular_velocity, args.max_velocity / limits.kV);
+    double duration = trapezoidal_profile_duration(args.setpoint1, max_angular_velocity, limits.max_angular_acceleration);
+    int predicted_time = duration * 1000;
+    
+    front_left_drive->disable_driver_control();
+    front_right_drive->disable_driver_control();
+    back_left_drive->disable_driver_control();
+    back_right_drive->disable_driver_control();
+    
+    front_left_drive->set_motor_mode(e_builtin_velocity_pid);
+    front_right_drive->set_motor_mode(e_builtin_velocity_pid);
+    back_left_drive->set_motor_mode(e_builtin_velocity_pid);
+    back_right_drive->set_motor_mode(e_builtin_velocity_pid);
+    
+    long double relative_angle = 0;
+    long double prev_abs_angle = tracker->get_heading_rad();
+    long double prev_relative_angle = 0;
+    long double error = args.setpoint1;
+    double yaw_rate = 0;
+    bool settled = false;
+    
+    int current_time = pros::millis();
+    int start_time = current_time;
+    int timeout = args.timeout;
+    if(timeout == INT32_MAX) {  // derive timeout from the profile if one was not given
+        timeout = predicted_time + limits.settle_time;
+    }
+    
+    do {
+        int dt = pros::millis() - current_time;
+        current_time = pros::millis();
+        double t = (current_time - start_time) / 1000.0;
+        
+        // accumulate heading change, wrapping the delta to [-pi, pi] to
+        // account for the heading rolling over
+        long double abs_angle = tracker->get_heading_rad();
+        long double delta_theta = std::atan2(std::sin(abs_angle - prev_abs_angle), std::cos(abs_angle - prev_abs_angle));
+        prev_abs_angle = abs_angle;
+        relative_angle += tracker->to_degrees(delta_theta);
+        
+        // use the imu for yaw rate because differentiating the heading is noisy
+        // at this loop rate, fall back to the heading if the imu is not available
+        if(Sensors::imu_is_calibrated) {
+            yaw_rate = limits.imu_rate_direction * Sensors::imu.get_gyro_rate().z;
+        } else if(dt > 0) {
+            yaw_rate = (relative_angle - prev_relative_angle) / (dt / 1000.0);
+        }
+        prev_relative_angle = relative_angle;
+        
+        profile_point setpoint = sample_trapezoidal_profile(args.setpoint1, max_angular_velocity, limits.max_angular_acceleration, t);
+        error = args.setpoint1 - relative_angle;
+        
+        double velocity = (
+            (limits.kV * setpoint.velocity)
+            + (limits.kA * setpoint.acceleration)
+            + (limits.kP * (setpoint.position - relative_angle))
+            + (limits.kRate * (setpoint.velocity - yaw_rate))
+        );
+        
+        if(std::abs(velocity) > args.max_velocity) {
+            velocity = velocity > 0 ? args.max_velocity : -args.max_velocity;
+        }
+        
+        if ( args.log_data ) {
+            Logger logger;
+            log_entry entry;
+            entry.content = (
+                "[INFO] " + std::string("CHASSIS_PROFILED_TURN")
+                + ", Time: " + std::to_string(pros::millis())
+                + ", Actual_Vol1: " + std::to_string(front_left_drive->get_actual_voltage())
+                + ", Actual_Vol2: " + std::to_string(front_right_drive->get_actual_voltage())
+                + ", Actual_Vol3: " + std::to_string(back_left_drive->get_actual_voltage())
+                + ", Actual_Vol4: " + std::to_string(back_right_drive->get_actual_voltage())
+                + ", Brake: " + std::to_string(front_left_drive->get_brake_mode())
+                + ", Gear: " + std::to_string(front_left_drive->get_gearset())
+                + ", kP: " + std::to_string(limits.kP)
+                + ", Heading_Sp: " + std::to_string(setpoint.position)
+                + ", Relative_Heading: " + std::to_string(relative_angle)
+                + ", Yaw_Rate_Sp: " + std::to_string(setpoint.velocity)
+                + ", Yaw_Rate: " + std::to_string(yaw_rate)
+                + ", Vel_Sp: " + std::to_string(velocity)
+                + ", Actual_Vel1: " + std::to_string(front_left_drive->get_actual_velocity())
+                + ", Actual_Vel2: " + std::to_string(front_right_drive->get_actual_velocity())
+                + ", Actual_Vel3: " + std::to_string(back_left_drive->get_actual_velocity())
+                + ", Actual_Vel4: " + std::to_string(back_right_drive->get_actual_velocity())
+            );
+            entry.stream = "clog";
+            logger.add(entry);            
+        }
+        
+        // done once the profile has finished and the robot has come to rest within tolerance
+        if(t >= duration && std::abs(error) < args.tolerance && std::abs(yaw_rate) < limits.settle_rate) {
+            settled = true;
+            break;
+        }
+        
+        front_left_drive->move_velocity(velocity);
+        front_right_drive->move_velocity(-velocity);
+        back_left_drive->move_velocity(velocity);
+        back_right_drive->move_velocity(-velocity);
+        
+        pros::delay(10);
+    } while ( pros::millis() < (start_time + timeout) && !cancel_running );
+    
+    front_left_drive->set_motor_mode(e_voltage);
+    front_right_drive->set_motor_mode(e_voltage);
+    back_left_drive->set_motor_mode(e_voltage);
+    back_right_drive->set_motor_mode(e_voltage);
+    
+    front_left_drive->set_voltage(0);
+    front_right_drive->set_voltage(0);
+    back_left_drive->set_voltage(0);
+    back_right_drive->set_voltage(0);
+    
+    front_left_drive->enable_driver_control();
+    front_right_drive->enable_driver_control();
+    back_left_drive->enable_driver_control();
+    back_right_drive->enable_driver_control();
+    
+    // always record the outcome so turn times can be compared against the prediction
+    Logger logger;
+    log_entry entry;
+    entry.content = (
+        "[INFO] " + std::string("CHASSIS_PROFILED_TURN_RESULT")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Heading_Sp: " + std::to_string(args.setpoint1)
+        + ", Relative_Heading: " + std::to_string(relative_angle)
+        + ", Error: " + std::to_string(error)
+        + ", Predicted_Time: " + std::to_string(predicted_time)
+        + ", Actual_Time: " + std::to_string(pros::millis() - start_time)
+        + ", Settled: " + std::to_string(settled)
+    );
+    entry.stream = "clog";
+    logger.add(entry);
+}
+
+
+
 void Chassis::t_move_to_waypoint(chassis_params args, waypoint point) {
     PositionTracker* tracker = PositionTracker::get_instance();
     
@@ -1243,7 +1743,7 @@ void Chassis::t_move_to_waypoint(chassis_params args, waypoint point) {
     chassis_params turn_args;
     turn_args.setpoint1 = to_turn;
     turn_args.max_velocity = args.max_velocity;
-    turn_args.timeout = args.timeout; // TODO: add time estimation
+    turn_args.timeout = std::min(args.timeout, default_timeout(estimate_duration(e_turn, turn_args)));
     args.kP = 2.8;
     args.kI = 0.0005;
     args.kD = 50;
@@ -1306,12 +1806,138 @@ void Chassis::t_move_to_waypoint(chassis_params args, waypoint point) {
 
 
 
+/**
+ * ramsete controller, errors are found in the frame of the robot and the
+ * reference yaw rate is the trajectory velocity times its curvature
+ */
+void Chassis::t_follow_trajectory(chassis_params args) {
+    PositionTracker* tracker = PositionTracker::get_instance();
+    const Trajectory* trajectory = args.trajectory;
+    trajectory_follower_constants constants = follower_constants;
+    double duration = trajectory->get_duration();
+    double rpm_per_inch = tracker->to_encoder_ticks(1, wheel_diameter) / characterization.ticks_per_rpm;  // motor rpm per in/s
+    trajectory_sample end = trajectory->sample(duration);
+    
+    front_left_drive->disable_driver_control();
+    front_right_drive->disable_driver_control();
+    back_left_drive->disable_driver_control();
+    back_right_drive->disable_driver_control();
+    
+    front_left_drive->set_motor_mode(e_builtin_velocity_pid);
+    front_right_drive->set_motor_mode(e_builtin_velocity_pid);
+    back_left_drive->set_motor_mode(e_builtin_velocity_pid);
+    back_right_drive->set_motor_mode(e_builtin_velocity_pid);
+    
+    double distance_to_end = 0;
+    bool settled = false;
+    int start_time = pros::millis();
+    
+    do {
+        double t = (pros::millis() - start_time) / 1000.0;
+        trajectory_sample setpoint = trajectory->sample(t);
+        position robot = tracker->get_position();
+        
+        // theta of 0 faces +y and increases clockwise, so left and counterclockwise are positive here
+        double dx = setpoint.x - robot.x_pos;
+        double dy = setpoint.y - robot.y_pos;
+        double forward_error = (std::sin(robot.theta) * dx) + (std::cos(robot.theta) * dy);
+        double left_error = (-std::cos(robot.theta) * dx) + (std::sin(robot.theta) * dy);
+        double theta_error = std::atan2(std::sin(robot.theta - setpoint.theta), std::cos(robot.theta - setpoint.theta));
+        double sinc = std::abs(theta_error) < 1e-9 ? 1 : std::sin(theta_error) / theta_error;
+        
+        double v_ref = setpoint.velocity;
+        double w_ref = setpoint.velocity * setpoint.curvature;
+        double k = 2 * constants.zeta * std::sqrt((w_ref * w_ref) + (constants.b * v_ref * v_ref));
+        double v = (v_ref * std::cos(theta_error)) + (k * forward_error);
+        double w = w_ref + (k * theta_error) + (constants.b * v_ref * sinc * left_error);
+        
+        double velocity_l = (v - (w * width / 2)) * rpm_per_inch;
+        double velocity_r = (v + (w * width / 2)) * rpm_per_inch;
+        double largest = std::max(std::abs(velocity_l), std::abs(velocity_r));
+        if(largest > args.max_velocity) {  // scale both sides so the curvature is kept
+            velocity_l = velocity_l * args.max_velocity / largest;
+            velocity_r = velocity_r * args.max_velocity / largest;
+        }
+        
+        distance_to_end = std::hypot(end.x - robot.x_pos, end.y - robot.y_pos);
+        
+        if ( args.log_data ) {
+            Logger logger;
+            log_entry entry;
+            entry.content = (
+                "[INFO] " + std::string("CHASSIS_FOLLOW_TRAJECTORY")
+                + ", Time: " + std::to_string(pros::millis())
+                + ", X_Sp: " + std::to_string(setpoint.x)
+                + ", Y_Sp: " + std::to_string(setpoint.y)
+                + ", Theta_Sp: " + std::to_string(setpoint.theta)
+                + ", X: " + std::to_string(robot.x_pos)
+                + ", Y: " + std::to_string(robot.y_pos)
+                + ", Theta: " + std::to_string(robot.theta)
+                + ", Vel_Sp: " + std::to_string(v_ref)
+                + ", Vel_L: " + std::to_string(velocity_l)
+                + ", Vel_R: " + std::to_string(velocity_r)
+                + ", Actual_Vel1: " + std::to_string(front_left_drive->get_actual_velocity())
+                + ", Actual_Vel2: " + std::to_string(front_right_drive->get_actual_velocity())
+            );
+            entry.stream = "clog";
+            logger.add(entry);
+        }
+        
+        // done once the trajectory has finished and the robot is at the end
+        if(t >= duration && distance_to_end < args.tolerance) {
+            settled = true;
+            break;
+        } else if(t >= duration + (constants.settle_time / 1000.0)) {
+            break;
+        }
+        
+        front_left_drive->move_velocity(velocity_l);
+        front_right_drive->move_velocity(velocity_r);
+        back_left_drive->move_velocity(velocity_l);
+        back_right_drive->move_velocity(velocity_r);
+        
+        pros::delay(10);
+    } while ( pros::millis() < (start_time + args.timeout) && !cancel_running );
+    
+    front_left_drive->set_motor_mode(e_voltage);
+    front_right_drive->set_motor_mode(e_voltage);
+    back_left_drive->set_motor_mode(e_voltage);
+    back_right_drive->set_motor_mode(e_voltage);
+    
+    front_left_drive->set_voltage(0);
+    front_right_drive->set_voltage(0);
+    back_left_drive->set_voltage(0);
+    back_right_drive->set_voltage(0);
+    
+    front_left_drive->enable_driver_control();
+    front_right_drive->enable_driver_control();
+    back_left_drive->enable_driver_control();
+    back_right_drive->enable_driver_control();
+    
+    Logger logger;
+    log_entry entry;
+    entry.content = (
+        "[INFO] " + std::string("CHASSIS_TRAJECTORY_RESULT")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Length: " + std::to_string(trajectory->get_length())
+        + ", Error: " + std::to_string(distance_to_end)
+        + ", Predicted_Time: " + std::to_string(static_cast<int>(duration * 1000))
+        + ", Actual_Time: " + std::to_string(pros::millis() - start_time)
+        + ", Settled: " + std::to_string(settled)
+    );
+    entry.stream = "clog";
+    logger.add(entry);
+}
+
+
+
 int Chassis::pid_straight_drive(double encoder_ticks, int relative_heading /*0*/, int max_velocity /*450*/, int timeout /*INT32_MAX*/, bool asynch /*false*/, bool correct_heading /*true*/, double slew /*0.2*/, bool log_data /*false*/) {
     chassis_params args;
     args.setpoint1 = encoder_ticks;
     args.setpoint2 = encoder_ticks;
     args.max_velocity = max_velocity;
     args.timeout = timeout;
+    args.motor_slew = slew;
     args.correct_heading = correct_heading;
     args.log_data = log_data;
     
@@ -1319,9 +1945,7 @@ int Chassis::pid_straight_drive(double encoder_ticks, int relative_heading /*0*/
     int uid = pros::millis() * (std::abs(encoder_ticks) + 1) + max_velocity + front_left_drive->get_actual_voltage();
     
     chassis_action command = {args, uid, e_pid_straight_drive};
-    while ( command_start_lock.exchange( true ) ); //aquire lock
-    command_queue.push(command);
-    command_start_lock.exchange( false ); //release lock
+    push_command(command);
     
     if(!asynch) {
         wait_until_finished(uid);
@@ -1347,9 +1971,7 @@ int Chassis::profiled_straight_drive(double encoder_ticks, int max_velocity  /*4
     int uid = pros::millis() * (std::abs(encoder_ticks) + 1) + max_velocity + front_left_drive->get_actual_voltage();
     
     chassis_action command = {args, uid, e_profiled_straight_drive};
-    while ( command_start_lock.exchange( true ) ); //aquire lock
-    command_queue.push(command);
-    command_start_lock.exchange( false ); //release lock
+    push_command(command);
     
     if(!asynch) {
         wait_until_finished(uid);
@@ -1369,9 +1991,7 @@ int Chassis::okapi_pid_straight_drive(double encoder_ticks, int max_voltage /*11
     int uid = pros::millis() * (std::abs(encoder_ticks) + 1) + front_left_drive->get_actual_voltage();
     
     chassis_action command = {args, uid, e_okapi_pid_straight_drive};
-    while ( command_start_lock.exchange( true ) ); //aquire lock
-    command_queue.push(command);
-    command_start_lock.exchange( false ); //release lock
+    push_command(command);
     
     if(!asynch) {
         wait_until_finished(uid);
@@ -1398,9 +2018,7 @@ int Chassis::uneven_drive(double l_enc_ticks, double r_enc_ticks, int max_veloci
     int uid = pros::millis() * (std::abs(l_enc_ticks) + 1) + max_velocity + front_left_drive->get_actual_voltage();
     
     chassis_action command = {args, uid, e_pid_straight_drive};
-    while ( command_start_lock.exchange( true ) ); //aquire lock
-    command_queue.push(command);
-    command_start_lock.exchange( false ); //release lock
+    push_command(command);
     
     if(!asynch) {
         wait_until_finished(uid);
@@ -1422,9 +2040,7 @@ int Chassis::turn_right(double degrees, int max_velocity /*450*/, int timeout /*
     int uid = pros::millis() * (std::abs(degrees) + 1) + max_velocity + front_left_drive->get_actual_voltage();
     
     chassis_action command = {args, uid, e_turn};
-    while ( command_start_lock.exchange( true ) ); //aquire lock
-    command_queue.push(command);
-    command_start_lock.exchange( false ); //release lock
+    push_command(command);
     
     if(!asynch) {
         wait_until_finished(uid);
@@ -1446,9 +2062,29 @@ int Chassis::turn_left(double degrees, int max_velocity /*450*/, int timeout /*I
     int uid = pros::millis() * (std::abs(degrees) + 1) + max_velocity + front_left_drive->get_actual_voltage();
     
     chassis_action command = {args, uid, e_turn};
-    while ( command_start_lock.exchange( true ) ); //aquire lock
-    command_queue.push(command);
-    command_start_lock.exchange( false ); //release lock
+    push_command(command);
+    
+    if(!asynch) {
+        wait_until_finished(uid);
+    }
+    
+    return uid;
+}
+
+
+int Chassis::profiled_turn(double degrees, int max_velocity /*450*/, double tolerance /*1*/, int timeout /*INT32_MAX*/, bool asynch /*false*/, bool log_data /*false*/) {
+    chassis_params args;
+    args.setpoint1 = degrees;
+    args.max_velocity = max_velocity;
+    args.tolerance = tolerance;
+    args.timeout = timeout;
+    args.log_data = log_data;
+    
+    // generate a unique id based on time, parameters, and seemingly random value of the voltage of one of the motors
+    int uid = pros::millis() * (std::abs(degrees) + 1) + max_velocity + front_left_drive->get_actual_voltage();
+    
+    chassis_action command = {args, uid, e_profiled_turn};
+    push_command(command);
     
     if(!asynch) {
         wait_until_finished(uid);
@@ -1458,6 +2094,21 @@ int Chassis::turn_left(double degrees, int max_velocity /*450*/, int timeout /*I
 }
 
 
+
+int Chassis::predict_profiled_turn_time(double degrees, int max_velocity /*450*/) {
+    double max_angular_velocity = std::min(profiled_turn_limits.max_angular_velocity, max_velocity / profiled_turn_limits.kV);
+    return trapezoidal_profile_duration(degrees, max_angular_velocity, profiled_turn_limits.max_angular_acceleration) * 1000;
+}
+
+
+
+// same conversion t_follow_trajectory uses to turn in/s into motor rpm
+double Chassis::rpm_to_inches_per_second(double rpm) {
+    return rpm * characterization.ticks_per_rpm / PositionTracker::to_encoder_ticks(1, wheel_diameter);
+}
+
+
+
 int Chassis::drive_to_point(double x, double y, int recalculations /*0*/, int explicit_direction /*0*/, int max_velocity /*450*/, int timeout /*INT32_MAX*/, bool correct_heading /*true*/, bool asynch /*false*/, double slew /*10*/, bool log_data /*true*/) {
     chassis_params args;
     args.setpoint1 = x;
@@ -1474,10 +2125,131 @@ int Chassis::drive_to_point(double x, double y, int recalculations /*0*/, int ex
     int uid = pros::millis() * (std::abs(x) + 1) + max_velocity + front_left_drive->get_actual_voltage();
     
     chassis_action command = {args, uid, e_drive_to_point};
+    push_command(command);
+    
+    if(!asynch) {
+        wait_until_finished(uid);
+    }
+    
+    return uid;
+}
+
+
+
+int Chassis::follow_trajectory(const Trajectory& trajectory, double tolerance /*1*/, int timeout /*INT32_MAX*/, bool asynch /*false*/, bool log_data /*false*/) {
+    chassis_params args;
+    args.setpoint1 = trajectory.get_length();
+    args.max_velocity = 600;  // capped by the trajectory constraints instead
+    args.tolerance = tolerance;
+    args.timeout = timeout;
+    args.log_data = log_data;
+    args.trajectory = &trajectory;
+    
+    // generate a unique id based on time, parameters, and seemingly random value of the voltage of one of the motors
+    int uid = pros::millis() * (trajectory.size() + 1) + front_left_drive->get_actual_voltage();
+    
+    chassis_action command = {args, uid, e_follow_trajectory};
+    push_command(command);
+    
+    if(!asynch) {
+        wait_until_finished(uid);
+    }
+    
+    return uid;
+}
+
+
+
+// a command is pending from when it is pushed until it finishes, commands
+// removed by cancel are pushed to the finished list so they are not pending
+bool Chassis::is_pending(int uid) {
+    while ( estimate_lock.exchange( true ) ); //aquire lock
+    bool pushed = predicted_durations.find(uid) != predicted_durations.end();
+    estimate_lock.exchange( false ); //release lock
+    
+    while ( command_finish_lock.exchange( true ) ); //aquire lock
+    bool finished = std::find(commands_finished.begin(), commands_finished.end(), uid) != commands_finished.end();
+    command_finish_lock.exchange( false ); //release lock
+    
+    return pushed && !finished;
+}
+
+
+
+int Chassis::drive_to_point_planned(double x, double y, int max_velocity /*450*/, int timeout /*INT32_MAX*/, bool asynch /*false*/, bool log_data /*false*/) {
+    if(!field_model_built) {
+        field_model.build(CHASSIS_PLANNING_RADIUS);
+        field_model_built = true;
+    }
+    
+    // each slot of the ring is only reused once the drive following it is done
+    int slot = num_planned_trajectories % CHASSIS_PLANNED_TRAJECTORIES;
+    std::string error;
+    if(is_pending(planned_uids.at(slot))) {
+        error = "more than " + std::to_string(CHASSIS_PLANNED_TRAJECTORIES) + " planned drives queued";
+    }
+    
+    // commands run in order so the robot is where the last one leaves it,
+    // which is only known for planned drives
     while ( command_start_lock.exchange( true ) ); //aquire lock
-    command_queue.push(command);
+    int last_uid = last_pushed_uid;
     command_start_lock.exchange( false ); //release lock
     
+    PositionTracker* tracker = PositionTracker::get_instance();
+    position robot = tracker->get_position();
+    double heading = tracker->get_heading_rad();
+    if(is_pending(last_uid)) {
+        if(last_uid == last_planned_uid) {
+            const Trajectory& previous = planned_trajectories.at((num_planned_trajectories - 1) % CHASSIS_PLANNED_TRAJECTORIES);
+            const trajectory_sample& end = previous.data()[previous.size() - 1];
+            robot = {end.x, end.y, end.theta};
+            heading = end.theta;
+        } else if(error.empty()) {
+            error = "planned drive queued behind a command that is not planned";
+        }
+    }
+    
+    position start = tracker->to_field_frame(robot);
+    position goal = tracker->to_field_frame({x, y, 0});
+    
+    trajectory_constraints constraints;
+    constraints.max_velocity = rpm_to_inches_per_second(max_velocity);
+    constraints.track_width = width;
+    
+    Trajectory& trajectory = planned_trajectories.at(slot);
+    if(error.empty() && !path_planner.plan_trajectory(start.x_pos, start.y_pos, goal.x_pos, goal.y_pos, constraints, trajectory)) {
+        error = (
+            "no path from (" + std::to_string(start.x_pos) + ", " + std::to_string(start.y_pos)
+            + ") to (" + std::to_string(goal.x_pos) + ", " + std::to_string(goal.y_pos) + ") on the field"
+        );
+    }
+    if(!error.empty()) {
+        Logger logger;
+        log_entry entry;
+        entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", " + error;
+        entry.stream = "cerr";
+        logger.add(entry);
+        return -1;
+    }
+    num_planned_trajectories += 1;
+    
+    // where the corner of the field is in the frame of the tracker moves the trajectory back to it
+    position field_corner = tracker->from_field_frame({0, 0, 0});
+    trajectory.transform(field_corner.x_pos, field_corner.y_pos, field_corner.theta);
+    
+    // the turn is measured from the heading the robot will have when it starts
+    double start_theta = trajectory.data()[0].theta;
+    double to_turn = std::remainder(start_theta - heading, 2 * M_PI);
+    if(std::abs(tracker->to_degrees(to_turn)) > CHASSIS_PLANNED_TURN_TOLERANCE) {
+        if(start_theta < 0) {  // turn_to_angle takes [0, 2pi]
+            start_theta += 2 * M_PI;
+        }
+        turn_to_angle(tracker->to_degrees(start_theta), max_velocity, INT32_MAX, true, 10, log_data);
+    }
+    
+    int uid = follow_trajectory(trajectory, 1, timeout, true, log_data);
+    planned_uids.at(slot) = uid;
+    last_planned_uid = uid;
     if(!asynch) {
         wait_until_finished(uid);
     }
@@ -1500,9 +2272,7 @@ int Chassis::turn_to_point(double x, double y, int max_velocity /*450*/, int tim
     int uid = pros::millis() * (std::abs(x) + 1) + max_velocity + front_left_drive->get_actual_voltage();
     
     chassis_action command = {args, uid, e_turn_to_point};
-    while ( command_start_lock.exchange( true ) ); //aquire lock
-    command_queue.push(command);
-    command_start_lock.exchange( false ); //release lock
+    push_command(command);
     
     if(!asynch) {
         wait_until_finished(uid);
@@ -1526,9 +2296,7 @@ int Chassis::turn_to_angle(double theta, int max_velocity /*450*/, int timeout /
     int uid = pros::millis() * (std::abs(theta) + 1) + max_velocity + front_left_drive->get_actual_voltage();
     
     chassis_action command = {args, uid, e_turn_to_angle};
-    while ( command_start_lock.exchange( true ) ); //aquire lock
-    command_queue.push(command);
-    command_start_lock.exchange( false ); //release lock
+    push_command(command);
     
     if(!asynch) {
         wait_until_finished(uid);
@@ -1555,6 +2323,18 @@ void Chassis::set_heading_gains(pid_gains new_gains) {
     heading_gains.motor_slew = new_gains.motor_slew;
 }
 
+void Chassis::set_profiled_turn_constants(profiled_turn_constants new_constants) {
+    profiled_turn_limits = new_constants;
+}
+
+void Chassis::set_trajectory_follower_constants(trajectory_follower_constants new_constants) {
+    follower_constants = new_constants;
+}
+
+void Chassis::set_characterization(chassis_characterization new_characterization) {
+    characterization = new_characterization;
+}
+
 void Chassis::set_turn_gains(pid_gains new_gains) {
     turn_gains.kP = new_gains.kP;
     turn_gains.kI = new_gains.kI;
@@ -1639,6 +2419,44 @@ void Chassis::wait_until_finished(int uid) {
     while ( command_finish_lock.exchange( true ) ); //aquire lock
     commands_finished.erase(std::remove(commands_finished.begin(), commands_finished.end(), uid), commands_finished.end()); 
     command_finish_lock.exchange( false ); //release lock
+    
+    while ( estimate_lock.exchange( true ) ); //aquire lock
+    predicted_durations.erase(uid);
+    expected_finish_times.erase(uid);
+    estimate_lock.exchange( false ); //release lock
+}
+
+
+// queued commands are reported as finished so nothing waits on them, the
+// running command sees the flag within one loop and stops the motors the
+// same way it does at its timeout
+void Chassis::cancel() {
+    std::vector<int> removed;
+    while ( command_start_lock.exchange( true ) ); //aquire lock
+    while(!command_queue.empty()) {
+        removed.push_back(command_queue.front().command_uid);
+        command_queue.pop();
+    }
+    cancel_running = true;
+    command_start_lock.exchange( false ); //release lock
+    
+    while ( estimate_lock.exchange( true ) ); //aquire lock
+    queue_finish_time = pros::millis();
+    estimate_lock.exchange( false ); //release lock
+    
+    while ( command_finish_lock.exchange( true ) ); //aquire lock
+    commands_finished.insert(commands_finished.end(), removed.begin(), removed.end());
+    command_finish_lock.exchange( false ); //release lock
+    
+    Logger logger;
+    log_entry entry;
+    entry.content = (
+        "[INFO] " + std::string("CHASSIS_CANCEL")
+        + ", Time: " + std::to_string(pros::millis())
+        + ", Removed_Commands: " + std::to_string(removed.size())
+    );
+    entry.stream = "clog";
+    logger.add(entry);
 }
 
 
@@ -1652,5 +2470,129 @@ bool Chassis::is_finished(int uid) {
     commands_finished.erase(std::remove(commands_finished.begin(), commands_finished.end(), uid), commands_finished.end()); 
     command_finish_lock.exchange( false ); //release lock
     
+    while ( estimate_lock.exchange( true ) ); //aquire lock
+    predicted_durations.erase(uid);
+    expected_finish_times.erase(uid);
+    estimate_lock.exchange( false ); //release lock
+    
     return true;
 }
+
+
+
+int Chassis::get_predicted_duration(int uid) {
+    int predicted_duration = -1;
+    while ( estimate_lock.exchange( true ) ); //aquire lock
+    if(predicted_durations.find(uid) != predicted_durations.end()) {
+        predicted_duration = predicted_durations.at(uid);
+    }
+    estimate_lock.exchange( false ); //release lock
+    
+    return predicted_duration;
+}
+
+
+
+int Chassis::get_time_until_finished(int uid) {
+    int time_left = -1;
+    while ( estimate_lock.exchange( true ) ); //aquire lock
+    if(expected_finish_times.find(uid) != expected_finish_times.end()) {
+        time_left = std::max(0, expected_finish_times.at(uid) - (int)pros::millis());
+    }
+    estimate_lock.exchange( false ); //release lock
+    
+    return time_left;
+}
+
+
+
+void Chassis::match_plan_step(chassis_action& command) {
+    if(plan_cursor >= plan_size) {
+        return;
+    }
+    
+    const chassis_plan_step& step = plan.at(plan_cursor);
+    if(
+        step.command == command.command
+        && step.setpoint1 == command.args.setpoint1
+        && step.setpoint2 == command.args.setpoint2
+        && step.max_velocity == command.args.max_velocity
+        && step.max_voltage == command.args.max_voltage
+    ) {
+        command.args.plan_step = plan_cursor;
+        plan_cursor += 1;
+        return;
+    }
+    
+    Logger logger;
+    log_entry entry;
+    entry.content = "[ERROR], " + std::to_string(pros::millis()) + ", chassis command does not match plan step " + std::to_string(plan_cursor) + ", the rest of the plan is not used";
+    entry.stream = "cerr";
+    logger.add(entry);
+    plan_cursor = plan_size;
+}
+
+
+
+int Chassis::plan_command(chassis_commands command, chassis_params args) {
+    if(plan_size >= CHASSIS_PLAN_MAX_STEPS) {
+        return -1;
+    }
+    
+    chassis_plan_step step;
+    step.command = command;
+    step.setpoint1 = args.setpoint1;
+    step.setpoint2 = args.setpoint2;
+    step.max_velocity = args.max_velocity;
+    step.max_voltage = args.max_voltage;
+    step.predicted_duration = -1;
+    step.profile_offset = -1;
+    step.profile_length = 0;
+    
+    switch(command) {
+        case e_profiled_straight_drive: {
+            if(std::abs(args.setpoint1) < 1) {
+                step.predicted_duration = estimate_duration(command, args);
+                break;
+            }
+            std::vector<double> profile = get_straight_drive_profile(args.setpoint1, args.max_velocity);
+            step.predicted_duration = (get_profile_duration(profile.data(), args.setpoint1) * 1000) + characterization.pid_settle_time;
+            if(plan_profiles_used + profile.size() <= plan_profiles.size()) {  // too long a profile is made when the drive starts
+                std::copy(profile.begin(), profile.end(), plan_profiles.begin() + plan_profiles_used);
+                step.profile_offset = plan_profiles_used;
+                step.profile_length = profile.size();
+                plan_profiles_used += profile.size();
+            }
+            break;
+        } case e_pid_straight_drive:
+        case e_okapi_pid_straight_drive:
+        case e_turn:
+        case e_profiled_turn:
+        case e_follow_trajectory:
+            step.predicted_duration = estimate_duration(command, args);
+            break;
+        case e_drive_to_point:  // depend on where the robot starts
+        case e_turn_to_point:
+        case e_turn_to_angle:
+            break;
+    }
+    
+    plan.at(plan_size) = step;
+    plan_size += 1;
+    
+    return plan_size - 1;
+}
+
+
+
+void Chassis::clear_plan() {
+    plan_size = 0;
+    plan_profiles_used = 0;
+    plan_cursor = 0;
+}
+
+
+
+int Chassis::get_plan_remaining() {
+    return plan_size - plan_cursor;
+}
@@ -11,11 +11,16 @@
 #ifndef __CHASSIS_HPP__
 #define __CHASSIS_HPP__
 
+#include <array>
 #include <tuple>
 #include <queue>
+#include <unordered_map>
 
 #include "main.h"
 
+#include "../motion_planning/FieldModel.hpp"
+#include "../motion_planning/PathPlanner.hpp"
+#include "../motion_planning/Trajectory.hpp"
 #include "../motors/Motor.hpp"
 #include "../sensors/Sensors.hpp"
 
@@ -23,14 +28,46 @@
 std::vector<double> generate_chassis_velocity_profile(int encoder_ticks, const std::function<double(double)>& max_acceleration, double max_decceleration, double max_velocity, double initial_velocity);
 
 
+typedef struct {
+    double position=0;
+    double velocity=0;
+    double acceleration=0;
+} profile_point;
+
+/**
+ * @param: double distance -> the signed distance to travel
+ * @param: double max_velocity -> the cruising velocity of the profile, must be positive
+ * @param: double max_acceleration -> the acceleration and decceleration of the profile, must be positive
+ * @return: double -> the time in seconds it takes to complete the profile
+ *
+ * calculates the duration of a trapezoidal profile, triangular profiles
+ * are used when the cruising velocity can not be reached
+ */
+double trapezoidal_profile_duration(double distance, double max_velocity, double max_acceleration);
+
+/**
+ * @param: double distance -> the signed distance to travel
+ * @param: double max_velocity -> the cruising velocity of the profile, must be positive
+ * @param: double max_acceleration -> the acceleration and decceleration of the profile, must be positive
+ * @param: double t -> the time in seconds since the start of the profile
+ * @return: profile_point -> the position, velocity, and acceleration setpoints at time t
+ *
+ * samples a trapezoidal profile at a given time
+ * times past the end of the profile return the final position at rest
+ */
+profile_point sample_trapezoidal_profile(double distance, double max_velocity, double max_acceleration, double t);
+
+
 typedef enum {
     e_pid_straight_drive,
     e_okapi_pid_straight_drive,
     e_profiled_straight_drive,
     e_turn,
+    e_profiled_turn,
     e_drive_to_point,
     e_turn_to_point,
-    e_turn_to_angle
+    e_turn_to_angle,
+    e_follow_trajectory
 } chassis_commands;
 
 typedef struct {
@@ -69,8 +106,11 @@ typedef struct {
     int recalculations=0;
     int explicit_direction=0;
     double motor_slew=INT32_MAX;
+    double tolerance=1;
     bool correct_heading=true;
     bool log_data=false;
+    int plan_step=-1;  // index into the chassis plan, -1 when the command was not planned
+    const Trajectory* trajectory=NULL;  // only for e_follow_trajectory, owned by the caller
 } chassis_params;
 
 typedef struct {
@@ -81,6 +121,34 @@ typedef struct {
     double motor_slew=INT32_MAX;
 } pid_gains;
 
+typedef struct {
+    double max_angular_velocity=300;      // deg/s
+    double max_angular_acceleration=900;  // deg/s^2
+    double kV=1.37;                       // rpm per deg/s
+    double kA=0.08;                       // rpm per deg/s^2
+    double kP=10;                         // rpm per deg of heading error
+    double kRate=0.3;                     // rpm per deg/s of yaw rate error
+    double settle_rate=10;                // deg/s
+    int imu_rate_direction=1;             // flip if the imu reports yaw rate opposite to the heading
+    int settle_time=300;                  // ms allowed past the end of the profile to get in tolerance
+} profiled_turn_constants;
+
+typedef struct {
+    double b=0.0013;      // 1/in^2, how hard position error is corrected, 2 in 1/m^2
+    double zeta=0.7;      // damping of the correction, between 0 and 1
+    int settle_time=300;  // ms allowed past the end of the trajectory to get in tolerance
+} trajectory_follower_constants;
+
+typedef struct {
+    double ticks_per_rpm=3.6;                // tracking wheel ticks/s per motor rpm
+    double max_linear_acceleration=3000;     // ticks/s^2
+    double rpm_per_millivolt=0.05;           // free speed of the drive motors per mV for voltage controlled drives
+    double rpm_per_degree_per_second=1.37;   // drive motor rpm in opposite directions for the robot to turn at 1 deg/s
+    int pid_settle_time=350;                 // ms for pid controllers to settle once at the setpoint
+    double timeout_scale=1.5;                // default timeout is the predicted duration times this
+    int timeout_margin=500;                  // plus this many ms
+} chassis_characterization;
+
 
 typedef struct {
     chassis_params args;
@@ -89,6 +157,35 @@ typedef struct {
 } chassis_action;
 
 
+#define CHASSIS_PLAN_MAX_STEPS 64
+#define CHASSIS_TURN_ESTIMATE_LIMIT 10000  // ms, pid turns that would take longer are estimated at this
+#define CHASSIS_SETTLE_VELOCITY 2  // rpm, pid drives are settled once they are slower than this
+#define CHASSIS_SETTLE_HISTORY 150  // ms of velocities pid drives check are steady before finishing
+#define CHASSIS_OKAPI_DRIVE_KP 0.0015  // fraction of max voltage per tick of error for okapi_pid_straight_drive
+#define CHASSIS_PLAN_PROFILE_SIZE 8192  // velocity profile points shared by every planned profiled drive
+
+#define CHASSIS_PLANNED_TRAJECTORIES 4  // planned drives that can be queued at once, each one needs its trajectory until it finishes
+#define CHASSIS_PLANNING_RADIUS 9  // in kept between the tracking center and the towers, corners of the robot can brush them
+#define CHASSIS_PLANNED_TURN_TOLERANCE 10  // degrees off from the start of a planned path that is left to the follower instead of turning first
+
+/**
+ * work done ahead of time for one chassis command
+ * commands that depend on where the robot starts, such as drive_to_point,
+ * are still estimated when they start because the plan does not know the
+ * real starting position
+ */
+typedef struct {
+    chassis_commands command;
+    double setpoint1;
+    double setpoint2;
+    int max_velocity;
+    int max_voltage;
+    int predicted_duration;  // ms, -1 when it is estimated when the command starts
+    int profile_offset;  // index of the first velocity in the plan profile buffer, -1 if there is no profile
+    int profile_length;
+} chassis_plan_step;
+
+
 /**
  * @see: Motors.hpp
  *
@@ -111,11 +208,60 @@ class Chassis
         static std::vector<int> commands_finished;
         static std::atomic<bool> command_start_lock;
         static std::atomic<bool> command_finish_lock;
+        static std::atomic<bool> cancel_running;  // set to end the running command early, cleared when the next one starts
         static int num_instances;
         
         static pid_gains pos_gains;
         static pid_gains heading_gains;
         static pid_gains turn_gains;
+        static profiled_turn_constants profiled_turn_limits;
+        static trajectory_follower_constants follower_constants;
+        static chassis_characterization characterization;
+        
+        static std::unordered_map<int, int> predicted_durations;  // uid -> predicted duration in ms
+        static std::unordered_map<int, int> expected_finish_times;  // uid -> time in ms the command should finish at
+        static int queue_finish_time;
+        static std::atomic<bool> estimate_lock;
+        
+        // written while disabled and only read once commands start, so it has no lock
+        static std::array<chassis_plan_step, CHASSIS_PLAN_MAX_STEPS> plan;
+        static std::array<double, CHASSIS_PLAN_PROFILE_SIZE> plan_profiles;
+        static int plan_size;
+        static int plan_profiles_used;
+        static int plan_cursor;
+        
+        // the field model is built the first time a planned drive is used
+        static FieldModel field_model;
+        static PathPlanner path_planner;
+        static bool field_model_built;
+        static std::array<Trajectory, CHASSIS_PLANNED_TRAJECTORIES> planned_trajectories;
+        static std::array<int, CHASSIS_PLANNED_TRAJECTORIES> planned_uids;  // the command following each trajectory, -1 if none
+        static int num_planned_trajectories;
+        static int last_pushed_uid;  // guarded by command_start_lock
+        static int last_planned_uid;
+        
+        /**
+         * @param: int uid -> the uid of the command
+         * @return: bool -> if the command is queued or running, does not collect it
+         */
+        static bool is_pending(int uid);
+        
+        /**
+         * @param: chassis_action& command -> the command being pushed, its plan step is set if it matches
+         * @return: None
+         *
+         * commands have to be pushed in the same order they were planned, the
+         * plan is dropped the first time one does not match
+         */
+        static void match_plan_step(chassis_action& command);
+        static double get_profile_duration(const double* profile, double encoder_ticks);
+        
+        static std::vector<double> get_straight_drive_profile(double encoder_ticks, int max_velocity);
+        static int estimate_duration(chassis_commands command, chassis_params args);
+        static double estimate_pid_turn_duration(double degrees, int max_velocity);
+        static int default_timeout(int predicted_duration);
+        static void set_expected_finish_time(int uid, int finish_time);
+        static void push_command(chassis_action command);
         
         static double get_angle_to_turn(double x, double y, int explicit_direction=1);
         static double get_angle_to_turn(double theta);
@@ -124,7 +270,9 @@ class Chassis
         static void t_okapi_pid_straight_drive(chassis_params args);
         static void t_profiled_straight_drive(chassis_params args);
         static void t_turn(chassis_params args);
+        static void t_profiled_turn(chassis_params args);
         static void t_move_to_waypoint(chassis_params args, waypoint point);
+        static void t_follow_trajectory(chassis_params args);
         
         static double wheel_diameter;
         static double width;
@@ -137,19 +285,99 @@ class Chassis
         Chassis( Motor &front_left, Motor &front_right, Motor &back_left, Motor &back_right, Encoder &l_encoder, Encoder &r_encoder, double chassis_width, double gearing=1, double wheel_size=3.25);
         ~Chassis();
 
+        // timeouts left as INT32_MAX are replaced by the predicted duration of the command plus a margin
         int pid_straight_drive(double encoder_ticks, int relative_heading=0, int max_velocity=450, int timeout=INT32_MAX, bool asynch=false, bool correct_heading=true, double slew=0.2, bool log_data=false);
         int profiled_straight_drive(double encoder_ticks, int max_velocity=450, int timeout=INT32_MAX, bool asynch=false, bool correct_heading=true, int relative_heading=0, bool log_data=false);
         int okapi_pid_straight_drive(double encoder_ticks, int max_voltage=11000, int timeout=INT32_MAX, bool asynch=false, int max_heading_correction=5000);
         int uneven_drive(double l_enc_ticks, double r_enc_ticks, int max_velocity=450, int timeout=INT32_MAX, bool asynch=false, double slew=10, bool log_data=false);
         int turn_right(double degrees, int max_velocity=450, int timeout=INT32_MAX, bool asynch=false, bool log_data=false);
         int turn_left(double degrees, int max_velocity=450, int timeout=INT32_MAX, bool asynch=false, bool log_data=false);
+        
+        /**
+         * @param: double degrees -> the relative angle to turn, positive is to the right
+         * @param: int max_velocity -> the max velocity of the motors in rpm
+         * @param: double tolerance -> the error in degrees the turn must end within
+         * @param: int timeout -> the timeout in ms, defaults to the predicted duration plus a settling margin
+         * @param: bool asynch -> if the function should wait for the turn to finish
+         * @param: bool log_data -> if data should be logged
+         * @return: int -> the uid of the command
+         *
+         * @see: predict_profiled_turn_time
+         *
+         * turns by following a trapezoidal angular velocity profile
+         * uses feedforward from the profile with heading and imu yaw rate feedback
+         * so that the duration of the turn is known before it starts
+         */
+        int profiled_turn(double degrees, int max_velocity=450, double tolerance=1, int timeout=INT32_MAX, bool asynch=false, bool log_data=false);
+        
+        /**
+         * @param: double degrees -> the relative angle to turn
+         * @param: int max_velocity -> the max velocity of the motors in rpm
+         * @return: int -> the predicted time in ms for the turn to reach its setpoint
+         *
+         * finds the duration of the profile that profiled_turn will follow
+         */
+        static int predict_profiled_turn_time(double degrees, int max_velocity=450);
+
+        /**
+         * @param: double rpm -> the velocity of the drive motors
+         * @return: double -> the velocity of the robot in in/s, the units of trajectory constraints
+         */
+        static double rpm_to_inches_per_second(double rpm);
         int drive_to_point(double x, double y, int recalculations=0, int explicit_direction=0, int max_velocity=450, int timeout=INT32_MAX, bool correct_heading=true, bool asynch=false, double slew=10, bool log_data=false);
         int turn_to_point(double x, double y, int max_velocity=450, int timeout=INT32_MAX, bool asynch = false, double slew=10, bool log_data=false);
         int turn_to_angle(double theta, int max_velocity=450, int timeout=INT32_MAX, bool asynch = false, double slew=10, bool log_data=false);
+        
+        /**
+         * @param: double x -> the x position to drive to, in the same frame as drive_to_point
+         * @param: double y -> the y position to drive to, in the same frame as drive_to_point
+         * @param: int max_velocity -> the max velocity of the motors in rpm
+         * @param: int timeout -> the timeout in ms, defaults to the duration of the trajectory plus a settling margin
+         * @param: bool asynch -> if the function should wait for the robot to get there
+         * @param: bool log_data -> if data should be logged
+         * @return: int -> the uid of the command, -1 if there is no path
+         *
+         * @see: PathPlanner.hpp
+         * @see: PositionTracker::set_field_origin
+         *
+         * drives around the towers instead of straight through them
+         * the start and goal are moved to the field with
+         * PositionTracker::to_field_frame since that is where the towers are,
+         * the path is planned and made into a trajectory there, and the
+         * trajectory is moved back with from_field_frame before it is followed
+         * the path is planned from where the robot is, or from the end of the
+         * planned drive queued before it, so it can be queued behind other
+         * planned drives but not behind any other command that moves the
+         * robot, -1 is returned in that case
+         * if the robot is not facing along the start of the path it turns first
+         * only CHASSIS_PLANNED_TRAJECTORIES planned drives can be queued or
+         * running at once, -1 is returned if there are that many already
+         */
+        int drive_to_point_planned(double x, double y, int max_velocity=450, int timeout=INT32_MAX, bool asynch=false, bool log_data=false);
+        
+        /**
+         * @param: const Trajectory& trajectory -> the trajectory to follow, has to exist until the command finishes
+         * @param: double tolerance -> the distance in inches from the end of the trajectory to finish within
+         * @param: int timeout -> the timeout in ms, defaults to the duration of the trajectory plus a settling margin
+         * @param: bool asynch -> if the function should wait for the trajectory to finish
+         * @param: bool log_data -> if data should be logged
+         * @return: int -> the uid of the command
+         *
+         * @see: Trajectory.hpp
+         *
+         * follows the trajectory by time with wheel velocities from its
+         * velocity and curvature, corrected by a ramsete controller using
+         * the position from PositionTracker
+         * the robot should start near the first sample of the trajectory
+         */
+        int follow_trajectory(const Trajectory& trajectory, double tolerance=1, int timeout=INT32_MAX, bool asynch=false, bool log_data=false);
 
         void set_pos_gains(pid_gains new_gains);
         void set_heading_gains(pid_gains new_gains);
         void set_turn_gains(pid_gains new_gains);
+        void set_profiled_turn_constants(profiled_turn_constants new_constants);
+        void set_trajectory_follower_constants(trajectory_follower_constants new_constants);
+        void set_characterization(chassis_characterization new_characterization);
         
         /**
          * @param: int voltage -> the voltage on interval [-127, 127] to set the motor to
@@ -197,6 +425,59 @@ class Chassis
         
         void wait_until_finished(int uid);
         bool is_finished(int uid);
+        
+        /**
+         * @return: None
+         *
+         * ends the running command within one loop of its controller and
+         * removes every queued command, the motors are stopped the same as
+         * when a command reaches its timeout
+         * removed commands are reported as finished so nothing waits on them
+         */
+        void cancel();
+        
+        /**
+         * @param: int uid -> the uid of the command
+         * @return: int -> the predicted duration of the command in ms, -1 if the uid is unknown
+         *
+         * predictions are made from the profile each command follows and the
+         * characterized limits of the chassis, they are recalculated when the
+         * command starts running since the position of the robot may have changed
+         */
+        int get_predicted_duration(int uid);
+        
+        /**
+         * @param: int uid -> the uid of the command
+         * @return: int -> the predicted time in ms until the command finishes, -1 if the uid is unknown
+         *
+         * accounts for commands queued before the command
+         * useful for timing other subsystems so that they finish when the chassis does
+         */
+        int get_time_until_finished(int uid);
+        
+        /**
+         * @param: chassis_commands command -> the command that will be pushed
+         * @param: chassis_params args -> the arguments it will be pushed with
+         * @return: int -> the index of the step in the plan, -1 if the plan is full
+         *
+         * does the work for a command that does not depend on where the robot
+         * is, such as velocity profiles and duration estimates, so that when
+         * the command is pushed it only has to look it up
+         * call while disabled in the order the commands will be pushed
+         */
+        static int plan_command(chassis_commands command, chassis_params args);
+        
+        /**
+         * @return: None
+         *
+         * empties the plan so that commands are computed when they start
+         */
+        static void clear_plan();
+        
+        /**
+         * @return: int -> the number of steps left in the plan
+         */
+        static int get_plan_remaining();
 
 
 };
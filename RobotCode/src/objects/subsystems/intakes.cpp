@@ -11,6 +11,7 @@
 #include "main.h"
 
 
+#include "../diagnostics/TaskStats.hpp"
 #include "../sensors/Sensors.hpp"
 #include "../serial/Logger.hpp"
 #include "intakes.hpp"
@@ -54,6 +55,7 @@ Intakes::~Intakes() {
 
 
 void Intakes::intake_motion_task(void*) {
+    TaskStats::register_current_task("intakes_thread", 0, TASK_STACK_DEPTH_DEFAULT);  // waits on commands so it has no period
     l_intake->tare_encoder();
     r_intake->tare_encoder();
     l_intake->set_brake_mode(pros::E_MOTOR_BRAKE_BRAKE);
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Created on Mon Oct 19 14:37:05 2026
+
+@author: aiden
+
+converts trace.csv written by Trace::dump to the chrome trace json format
+open the output in chrome://tracing or https://ui.perfetto.dev
+each task is shown as its own thread
+
+usage: python3 trace_exporter.py [trace.csv] [trace.json]
+"""
+
+import csv
+import json
+import sys
+
+WRAP = 2**32  # the us timer is stored in 32 bits
+
+
+def unwrap(starts):
+    """
+    shifts starts that came after the timer wrapped so they are after
+    the ones that came before it, a trace never spans more than half the
+    range so anything more than that apart wrapped
+    """
+    if not starts or max(starts) - min(starts) <= WRAP // 2:
+        return starts
+    return [start + WRAP if start < WRAP // 2 else start for start in starts]
+
+
+def export_trace(rows):
+    tasks = {}
+    for row in rows:
+        tasks.setdefault(row["task"], len(tasks) + 1)
+
+    starts = unwrap([int(row["start_us"]) for row in rows])
+    first = min(starts) if starts else 0
+
+    events = []
+    for task, tid in tasks.items():
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid, "args": {"name": task}})
+
+    for row, start in zip(rows, starts):
+        events.append({
+            "name": row["event"],
+            "ph": "X",
+            "pid": 1,
+            "tid": tasks[row["task"]],
+            "ts": start - first,
+            "dur": int(row["duration_us"])
+        })
+
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+if __name__ == "__main__":
+    in_file = sys.argv[1] if len(sys.argv) > 1 else "trace.csv"
+    out_file = sys.argv[2] if len(sys.argv) > 2 else "trace.json"
+
+    with open(in_file, newline="") as f:
+        rows = list(csv.DictReader(f))
+
+    with open(out_file, "w") as f:
+        json.dump(export_trace(rows), f)
+
+    print("wrote", len(rows), "events to", out_file)